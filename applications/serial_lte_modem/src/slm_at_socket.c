@@ -18,6 +18,9 @@
 #if defined(CONFIG_SLM_NATIVE_TLS)
 #include "slm_native_tls.h"
 #endif
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+#include "slm_cmux.h"
+#endif
 
 LOG_MODULE_REGISTER(slm_sock, CONFIG_SLM_LOG_LEVEL);
 
@@ -280,12 +283,18 @@ static int do_socket_close(void)
 	}
 
 	if (sock.fd_peer != INVALID_SOCKET) {
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+		slm_cmux_sock_unbind(sock.fd_peer);
+#endif
 		ret = close(sock.fd_peer);
 		if (ret) {
 			LOG_WRN("peer close() error: %d", -errno);
 		}
 		sock.fd_peer = INVALID_SOCKET;
 	}
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+	slm_cmux_sock_unbind(sock.fd);
+#endif
 	ret = close(sock.fd);
 	if (ret) {
 		LOG_WRN("close() error: %d", -errno);
@@ -1688,6 +1697,27 @@ static int handle_at_poll(enum at_cmd_type cmd_type, const struct at_param_list
 	return err;
 }
 
+bool slm_at_socket_is_stream(int fd)
+{
+	if (fd == INVALID_SOCKET) {
+		return false;
+	}
+
+	/* The socket accepted by the current TCP or TLS server socket */
+	if (fd == sock.fd_peer) {
+		return true;
+	}
+
+	for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
+		if (socks[i].fd == fd) {
+			return socks[i].type == SOCK_STREAM &&
+			       socks[i].role == AT_SOCKET_ROLE_CLIENT;
+		}
+	}
+
+	return false;
+}
+
 /**@brief API to initialize Socket AT commands handler
  */
 int slm_at_socket_init(void)
@@ -1708,9 +1738,15 @@ int slm_at_socket_uninit(void)
 	(void)do_socket_close();
 	for (int i = 0; i < SLM_MAX_SOCKET_COUNT; i++) {
 		if (socks[i].fd_peer != INVALID_SOCKET) {
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+			slm_cmux_sock_unbind(socks[i].fd_peer);
+#endif
 			close(socks[i].fd_peer);
 		}
 		if (socks[i].fd != INVALID_SOCKET) {
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+			slm_cmux_sock_unbind(socks[i].fd);
+#endif
 			close(socks[i].fd);
 		}
 	}
@@ -7,6 +7,8 @@
 #ifndef SLM_AT_SOCKET_
 #define SLM_AT_SOCKET_
 
+#include <stdbool.h>
+
 /**@file slm_at_socket.h
  *
  * @brief Vendor-specific AT command for Socket service.
@@ -28,6 +30,18 @@ int slm_at_socket_init(void);
  *           Otherwise, a (negative) error code is returned.
  */
 int slm_at_socket_uninit(void);
+
+/**
+ * @brief Check whether a socket opened with the socket AT commands carries a byte stream.
+ *
+ * These are the TCP and TLS client sockets, and the socket accepted by the current TCP or
+ * TLS server socket.
+ *
+ * @param fd Socket descriptor.
+ *
+ * @retval true If the socket is such a stream socket.
+ */
+bool slm_at_socket_is_stream(int fd);
 /** @} */
 
 #endif /* SLM_AT_SOCKET_ */
@@ -9,6 +9,11 @@
 #include "slm_ppp.h"
 #endif
 #include <zephyr/logging/log.h>
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+#include "slm_at_socket.h"
+#include <zephyr/net/socket.h>
+#include <zephyr/posix/sys/eventfd.h>
+#endif
 #include <zephyr/modem/backend/uart.h>
 #include <zephyr/modem/cmux.h>
 #include <zephyr/modem/pipe.h>
@@ -17,7 +22,11 @@
 /* This makes use of part of the Zephyr modem subsystem which has a CMUX module. */
 LOG_MODULE_REGISTER(slm_cmux, CONFIG_SLM_LOG_LEVEL);
 
-#define CHANNEL_COUNT (1 + IS_ENABLED(CONFIG_SLM_PPP))
+/* The AT channel and the PPP channel. */
+#define BASE_CHANNEL_COUNT (1 + IS_ENABLED(CONFIG_SLM_PPP))
+/* The socket channels follow the base channels. */
+#define SOCK_CHANNEL_COUNT CONFIG_SLM_CMUX_SOCKET_CHANNELS
+#define CHANNEL_COUNT (BASE_CHANNEL_COUNT + SOCK_CHANNEL_COUNT)
 
 #define RECV_BUF_LEN SLM_AT_MAX_CMD_LEN
 /* The CMUX module reserves some spare buffer bytes. To achieve a maximum
@@ -45,7 +54,7 @@ static struct {
 		struct modem_pipe *pipe;
 		uint8_t address;
 		uint8_t receive_buf[RECV_BUF_LEN];
-	} dlcis[CHANNEL_COUNT];
+	} dlcis[BASE_CHANNEL_COUNT];
 	/* Index of the DLCI used for AT communication; defaults to 0. */
 	unsigned int at_channel;
 } cmux;
@@ -133,6 +142,359 @@ static void close_pipe(struct modem_pipe **pipe)
 	}
 }
 
+#if SOCK_CHANNEL_COUNT
+
+#define SOCK_BUF_LEN CONFIG_SLM_CMUX_SOCKET_BUF_SIZE
+#define SOCK_THREAD_STACK_SIZE KB(2)
+#define SOCK_THREAD_PRIORITY K_LOWEST_APPLICATION_THREAD_PRIO
+/* Delay before polling again after poll() failed [ms]. */
+#define SOCK_POLL_RETRY_DELAY 100
+
+/* CMUX channels carrying the data of a socket each, without AT encoding.
+ * The address of the first one follows the addresses of the base channels.
+ * The bound socket, the credits and the counters are shared by the AT command handler,
+ * the send work queue and the socket thread, so they are accessed atomically.
+ */
+static struct cmux_sock {
+	struct modem_cmux_dlci instance;
+	struct modem_pipe *pipe;
+	uint8_t address;
+	uint8_t receive_buf[SOCK_BUF_LEN];
+
+	/* Bound socket; INVALID_SOCKET if none. */
+	atomic_t fd;
+
+	/* Host to socket. The host may only send as many bytes as it has been granted credits,
+	 * so that the receive buffer of the channel never overflows.
+	 */
+	struct k_work send_work;
+	uint8_t send_buf[SOCK_BUF_LEN];
+	atomic_t credits;
+
+	/* Socket to host. Reception from the socket is paused until the host has taken the
+	 * previously received data, which makes the modem apply flow control to the peer.
+	 */
+	uint8_t recv_buf[SOCK_BUF_LEN];
+	size_t recv_len;
+	size_t recv_offset;
+
+	/* Throughput counters. */
+	atomic_t sent;
+	atomic_t received;
+	int64_t bind_time;
+} socks[SOCK_CHANNEL_COUNT];
+
+static struct k_work_q sock_work_q;
+static K_THREAD_STACK_DEFINE(sock_work_q_stack, SOCK_THREAD_STACK_SIZE);
+static struct k_thread sock_thread;
+static K_THREAD_STACK_DEFINE(sock_thread_stack, SOCK_THREAD_STACK_SIZE);
+/* Wakes up the socket thread when a socket is bound or unbound or the host has taken data,
+ * so that it can poll the sockets without a timeout.
+ */
+static int sock_wake_fd = INVALID_SOCKET;
+
+static void sock_thread_wake(void)
+{
+	if (eventfd_write(sock_wake_fd, 1)) {
+		LOG_ERR("Failed to wake up the socket thread: %d", -errno);
+	}
+}
+
+static void sock_credits_grant(struct cmux_sock *chan, size_t len)
+{
+	const atomic_val_t credits = atomic_add(&chan->credits, len) + len;
+
+	/* Grant credits in batches to limit the number of notifications. */
+	if (credits >= SOCK_BUF_LEN / 2 && atomic_cas(&chan->credits, credits, 0)) {
+		rsp_send("\r\n#XCMUXCREDIT: %u,%u\r\n", chan->address, (unsigned int)credits);
+	}
+}
+
+static void sock_send_work_fn(struct k_work *work)
+{
+	struct cmux_sock *const chan = CONTAINER_OF(work, struct cmux_sock, send_work);
+	int len;
+
+	while ((len = modem_pipe_receive(chan->pipe, chan->send_buf,
+					 sizeof(chan->send_buf))) > 0) {
+		const int fd = atomic_get(&chan->fd);
+		int offset = 0;
+
+		if (fd == INVALID_SOCKET) {
+			LOG_WRN("Discarding %u byte%s received on unbound DLCI %u.",
+				len, (len > 1) ? "s" : "", chan->address);
+			continue;
+		}
+
+		while (offset < len) {
+			const int ret = send(fd, chan->send_buf + offset, len - offset, 0);
+
+			if (ret < 0) {
+				LOG_ERR("send() failed on DLCI %u: %d, sent: %d",
+					chan->address, -errno, offset);
+				break;
+			}
+			offset += ret;
+		}
+		atomic_add(&chan->sent, offset);
+
+		/* The data has been taken out of the receive buffer in any case. */
+		sock_credits_grant(chan, len);
+	}
+}
+
+static void sock_pipe_event_handler(struct modem_pipe *pipe,
+				    enum modem_pipe_event event, void *user_data)
+{
+	struct cmux_sock *const chan = user_data;
+
+	switch (event) {
+	case MODEM_PIPE_EVENT_OPENED:
+	case MODEM_PIPE_EVENT_CLOSED:
+		LOG_INF("DLCI %u %s.", chan->address,
+			(event == MODEM_PIPE_EVENT_OPENED) ? "opened" : "closed");
+		break;
+	case MODEM_PIPE_EVENT_RECEIVE_READY:
+		/* Sending may block, so it is not done in the context of CMUX. */
+		k_work_submit_to_queue(&sock_work_q, &chan->send_work);
+		break;
+	case MODEM_PIPE_EVENT_TRANSMIT_IDLE:
+		sock_thread_wake();
+		break;
+	}
+}
+
+/* Returns true when all the data received from the socket has been passed to the host. */
+static bool sock_transmit(struct cmux_sock *chan)
+{
+	const int ret = modem_pipe_transmit(chan->pipe, chan->recv_buf + chan->recv_offset,
+					    chan->recv_len - chan->recv_offset);
+
+	if (ret < 0) {
+		LOG_ERR("Failed to transmit on DLCI %u, dropping %u bytes. (%d)",
+			chan->address, chan->recv_len - chan->recv_offset, ret);
+		chan->recv_offset = chan->recv_len;
+		return true;
+	}
+
+	chan->recv_offset += ret;
+	atomic_add(&chan->received, ret);
+
+	return chan->recv_offset == chan->recv_len;
+}
+
+static void sock_recv(struct cmux_sock *chan, int fd, short revents)
+{
+	int ret = 0;
+
+	if (revents & POLLIN) {
+		ret = recv(fd, chan->recv_buf, sizeof(chan->recv_buf), MSG_DONTWAIT);
+		if (ret > 0) {
+			chan->recv_len = ret;
+			chan->recv_offset = 0;
+			(void)sock_transmit(chan);
+			return;
+		}
+		if (ret < 0 && errno == EAGAIN) {
+			return;
+		}
+	} else if (!(revents & (POLLERR | POLLHUP | POLLNVAL))) {
+		return;
+	}
+
+	/* Like with AT#XRECV, a return value of 0 is treated as a shutdown by the peer. */
+	LOG_INF("Socket %d on DLCI %u closed. (%d, 0x%04x)",
+		fd, chan->address, (ret < 0) ? -errno : ret, revents);
+	/* Unless the socket has been unbound or rebound meanwhile */
+	if (atomic_cas(&chan->fd, fd, INVALID_SOCKET)) {
+		rsp_send("\r\n#XCMUXSOCK: %u\r\n", chan->address);
+	}
+}
+
+static void sock_thread_fn(void *, void *, void *)
+{
+	/* The bound sockets, followed by the wake-up event. */
+	struct pollfd fds[SOCK_CHANNEL_COUNT + 1];
+	struct pollfd *const wake_fd = &fds[SOCK_CHANNEL_COUNT];
+	eventfd_t value;
+	int ret;
+
+	wake_fd->fd = sock_wake_fd;
+	wake_fd->events = POLLIN;
+
+	while (true) {
+		for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+			struct cmux_sock *const chan = &socks[i];
+
+			fds[i].fd = atomic_get(&chan->fd);
+			fds[i].events = POLLIN;
+			fds[i].revents = 0;
+
+			if (fds[i].fd == INVALID_SOCKET) {
+				chan->recv_len = 0;
+				chan->recv_offset = 0;
+				continue;
+			}
+
+			if (chan->recv_offset != chan->recv_len && !sock_transmit(chan)) {
+				/* Do not receive more before the host has taken this data.
+				 * Negative file descriptors are ignored by poll().
+				 */
+				fds[i].fd = INVALID_SOCKET;
+			}
+		}
+		wake_fd->revents = 0;
+
+		ret = poll(fds, ARRAY_SIZE(fds), -1);
+		if (ret < 0) {
+			LOG_ERR("poll() failed: %d", -errno);
+			k_sleep(K_MSEC(SOCK_POLL_RETRY_DELAY));
+			continue;
+		}
+
+		if (wake_fd->revents & POLLIN) {
+			(void)eventfd_read(sock_wake_fd, &value);
+		}
+
+		for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+			/* Skip the sockets that have been unbound or rebound meanwhile. */
+			if (fds[i].fd != INVALID_SOCKET && fds[i].revents &&
+			    fds[i].fd == atomic_get(&socks[i].fd)) {
+				sock_recv(&socks[i], fds[i].fd, fds[i].revents);
+			}
+		}
+	}
+}
+
+static void sock_channels_init(void)
+{
+	for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+		struct cmux_sock *const chan = &socks[i];
+		const struct modem_cmux_dlci_config dlci_config = {
+			.dlci_address = BASE_CHANNEL_COUNT + 1 + i,
+			.receive_buf = chan->receive_buf,
+			.receive_buf_size = sizeof(chan->receive_buf)
+		};
+
+		chan->pipe = modem_cmux_dlci_init(&cmux.instance, &chan->instance, &dlci_config);
+		chan->address = dlci_config.dlci_address;
+		atomic_set(&chan->fd, INVALID_SOCKET);
+		k_work_init(&chan->send_work, sock_send_work_fn);
+
+		modem_pipe_attach(chan->pipe, sock_pipe_event_handler, chan);
+	}
+
+	sock_wake_fd = eventfd(0, EFD_NONBLOCK);
+	if (sock_wake_fd < 0) {
+		LOG_ERR("Failed to create the socket thread event: %d", -errno);
+		sock_wake_fd = INVALID_SOCKET;
+		return;
+	}
+
+	k_work_queue_start(&sock_work_q, sock_work_q_stack,
+			   K_THREAD_STACK_SIZEOF(sock_work_q_stack),
+			   SOCK_THREAD_PRIORITY, NULL);
+	k_thread_create(&sock_thread, sock_thread_stack,
+			K_THREAD_STACK_SIZEOF(sock_thread_stack),
+			sock_thread_fn, NULL, NULL, NULL,
+			SOCK_THREAD_PRIORITY, 0, K_NO_WAIT);
+}
+
+static uint32_t sock_rate(uint32_t bytes, int64_t elapsed_ms)
+{
+	return (elapsed_ms > 0) ? (uint64_t)bytes * MSEC_PER_SEC / elapsed_ms : 0;
+}
+
+SLM_AT_CMD_CUSTOM(xcmuxsock, "AT#XCMUXSOCK", handle_at_cmux_sock);
+static int handle_at_cmux_sock(enum at_cmd_type cmd_type, const struct at_param_list *param_list,
+			       uint32_t param_count)
+{
+	struct cmux_sock *chan;
+	unsigned int dlci;
+	int handle;
+	int ret;
+
+	if (cmd_type == AT_CMD_TYPE_READ_COMMAND) {
+		for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+			chan = &socks[i];
+			const int fd = atomic_get(&chan->fd);
+			const uint32_t sent = atomic_get(&chan->sent);
+			const uint32_t received = atomic_get(&chan->received);
+			const int64_t elapsed_ms = (fd != INVALID_SOCKET) ?
+						   k_uptime_get() - chan->bind_time : 0;
+
+			rsp_send("\r\n#XCMUXSOCK: %u,%d,%u,%u,%u,%u\r\n", chan->address, fd,
+				 sent, received, sock_rate(sent, elapsed_ms),
+				 sock_rate(received, elapsed_ms));
+		}
+		return 0;
+	}
+	if (cmd_type != AT_CMD_TYPE_SET_COMMAND || param_count < 2 || param_count > 3) {
+		return -EINVAL;
+	}
+
+	ret = at_params_unsigned_int_get(param_list, 1, &dlci);
+	if (ret || dlci <= BASE_CHANNEL_COUNT || dlci > CHANNEL_COUNT) {
+		return -EINVAL;
+	}
+	chan = &socks[dlci - BASE_CHANNEL_COUNT - 1];
+
+	if (param_count == 2) {
+		/* Unbind. Data not yet passed to the host is dropped. */
+		if (atomic_set(&chan->fd, INVALID_SOCKET) != INVALID_SOCKET) {
+			sock_thread_wake();
+		}
+		return 0;
+	}
+
+	ret = at_params_int_get(param_list, 2, &handle);
+	if (ret || !slm_at_socket_is_stream(handle)) {
+		return -EINVAL;
+	}
+	if (sock_wake_fd == INVALID_SOCKET) {
+		/* The socket thread is not running. */
+		return -ENOTSUP;
+	}
+	if (atomic_get(&chan->fd) != INVALID_SOCKET) {
+		return -EBUSY;
+	}
+	for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+		if (atomic_get(&socks[i].fd) == handle) {
+			return -EBUSY;
+		}
+	}
+
+	atomic_set(&chan->credits, 0);
+	atomic_set(&chan->sent, 0);
+	atomic_set(&chan->received, 0);
+	chan->bind_time = k_uptime_get();
+	if (!atomic_cas(&chan->fd, INVALID_SOCKET, handle)) {
+		return -EBUSY;
+	}
+	sock_thread_wake();
+
+	/* The whole receive buffer is initially available to the host. */
+	rsp_send("\r\n#XCMUXCREDIT: %u,%u\r\n", chan->address, SOCK_BUF_LEN);
+
+	return 0;
+}
+
+void slm_cmux_sock_unbind(int fd)
+{
+	if (fd == INVALID_SOCKET) {
+		return;
+	}
+
+	for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+		if (atomic_cas(&socks[i].fd, fd, INVALID_SOCKET)) {
+			LOG_INF("Socket %d unbound from DLCI %u.", fd, socks[i].address);
+			sock_thread_wake();
+		}
+	}
+}
+
+#endif /* SOCK_CHANNEL_COUNT */
+
 static int cmux_stop(void)
 {
 	if (cmux.uart_pipe && cmux.uart_pipe->state == MODEM_PIPE_STATE_OPEN) {
@@ -150,6 +512,11 @@ static int cmux_stop(void)
 	for (size_t i = 0; i != ARRAY_SIZE(cmux.dlcis); ++i) {
 		close_pipe(&cmux.dlcis[i].pipe);
 	}
+#if SOCK_CHANNEL_COUNT
+	for (size_t i = 0; i != ARRAY_SIZE(socks); ++i) {
+		close_pipe(&socks[i].pipe);
+	}
+#endif
 
 	return 0;
 }
@@ -174,13 +541,16 @@ void slm_cmux_init(void)
 	for (size_t i = 0; i != ARRAY_SIZE(cmux.dlcis); ++i) {
 		init_dlci(i, sizeof(cmux.dlcis[i].receive_buf), cmux.dlcis[i].receive_buf);
 	}
+#if SOCK_CHANNEL_COUNT
+	sock_channels_init();
+#endif
 }
 
 #if defined(CONFIG_SLM_PPP)
 
 static struct cmux_dlci *cmux_ppp_dlci(void)
 {
-	BUILD_ASSERT(ARRAY_SIZE(cmux.dlcis) == 2);
+	BUILD_ASSERT(BASE_CHANNEL_COUNT == 2);
 	/* The DLCI that is not the AT channel's is PPP's. */
 	return &cmux.dlcis[!cmux.at_channel];
 }
@@ -280,7 +650,7 @@ static int handle_at_cmux(enum at_cmd_type cmd_type, const struct at_param_list
 
 	if (param_count == 2) {
 		ret = at_params_unsigned_int_get(param_list, 1, &at_dlci);
-		if (ret || at_dlci < 1 || at_dlci > ARRAY_SIZE(cmux.dlcis)) {
+		if (ret || at_dlci < 1 || at_dlci > BASE_CHANNEL_COUNT) {
 			return -EINVAL;
 		}
 		const unsigned int at_channel = at_dlci - 1;
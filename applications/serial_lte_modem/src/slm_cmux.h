@@ -17,4 +17,9 @@ struct modem_pipe *slm_cmux_reserve_ppp_channel(void);
 void slm_cmux_release_ppp_channel(void);
 #endif /* CONFIG_SLM_PPP */
 
+#if CONFIG_SLM_CMUX_SOCKET_CHANNELS
+/* Unbinds a socket from its CMUX channel, if any. To be called before closing the socket. */
+void slm_cmux_sock_unbind(int fd);
+#endif
+
 #endif
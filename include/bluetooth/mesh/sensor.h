@@ -747,6 +747,50 @@ int bt_mesh_sensor_value_from_micro(
 	int64_t val,
 	struct bt_mesh_sensor_value *sensor_val);
 
+/** @brief Convert an array of integers in micro units to
+ *         @ref bt_mesh_sensor_value instances of the same format.
+ *
+ *  Works like @ref bt_mesh_sensor_value_from_micro for every value in the
+ *  array, but looks up the format conversion only once. This is useful for
+ *  filling in the values of sensor series columns.
+ *
+ *  Values that cannot be represented by the format are clamped as with
+ *  @ref bt_mesh_sensor_value_from_micro, and the conversion continues with
+ *  the next value.
+ *
+ *  @param[in]  format      Format to use when encoding the sensor values.
+ *  @param[in]  vals        The integers to convert.
+ *  @param[in]  count       Number of values to convert.
+ *  @param[out] sensor_vals Array of at least @c count resulting values.
+ *
+ *  @retval 0       All values were converted.
+ *  @retval -ERANGE One or more values were clamped.
+ *  @return Other (negative) error code if a value could not be converted.
+ *          The remaining values are not modified.
+ */
+int bt_mesh_sensor_values_from_micro(
+	const struct bt_mesh_sensor_format *format,
+	const int64_t *vals, size_t count,
+	struct bt_mesh_sensor_value *sensor_vals);
+
+/** @brief Convert an array of @ref bt_mesh_sensor_value instances to integers
+ *         in micro units.
+ *
+ *  Works like @ref bt_mesh_sensor_value_to_micro for every value in the
+ *  array. The entries of @c vals for values with a status for which
+ *  @ref bt_mesh_sensor_value_status_is_numeric returns false are not
+ *  modified.
+ *
+ *  @param[in]  sensor_vals The values to convert.
+ *  @param[in]  count       Number of values to convert.
+ *  @param[out] vals        Array of at least @c count resulting integers.
+ *
+ *  @return The number of values with a numeric status.
+ */
+size_t bt_mesh_sensor_values_to_micro(
+	const struct bt_mesh_sensor_value *sensor_vals, size_t count,
+	int64_t *vals);
+
 /** @brief Convert a @ref bt_mesh_sensor_value instance to a
  *         @c sensor_value (include/zephyr/drivers/sensor.h).
  *
@@ -64,6 +64,10 @@ struct dfu_target {
 	int (*done)(bool successful);
 	int (*schedule_update)(int img_num);
 	int (*reset)();
+	/** Optional, NULL if the target cannot lend its write buffer. */
+	int (*buf_get)(void **buf, size_t *len);
+	/** Required if buf_get is set. */
+	int (*buf_commit)(size_t len);
 };
 
 /**
@@ -138,6 +142,36 @@ int dfu_target_offset_get(size_t *offset);
  **/
 int dfu_target_write(const void *const buf, size_t len);
 
+/**
+ * @brief Get a buffer to place the next firmware data in.
+ *
+ * Targets that buffer the data before writing it to flash can lend the free
+ * space of that buffer, so that the data can be received directly into it.
+ * The data must then be committed with @ref dfu_target_buf_commit instead of
+ * being passed to @ref dfu_target_write, before any other data is written.
+ *
+ * @param[out] buf Returns the buffer.
+ * @param[out] len Returns the size of the buffer.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if no target has been initialized.
+ * @retval -ENOTSUP if the current target cannot lend its buffer.
+ */
+int dfu_target_buf_get(void **buf, size_t *len);
+
+/**
+ * @brief Commit firmware data placed in the buffer from
+ *	  @ref dfu_target_buf_get.
+ *
+ * @param[in] len Number of bytes placed at the start of the buffer.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if no target has been initialized.
+ * @retval -ENOTSUP if the current target cannot lend its buffer.
+ * @return Negative errno from the target otherwise.
+ */
+int dfu_target_buf_commit(size_t len);
+
 /**
  * @brief Release the resources that were needed for the current DFU
  *	  target.
@@ -109,6 +109,26 @@ int dfu_target_full_modem_offset_get(size_t *offset);
  */
 int dfu_target_full_modem_write(const void *const buf, size_t len);
 
+/**
+ * @brief Get a buffer to place the next firmware data in.
+ *
+ * @param[out] buf Returns the free space of the flash write buffer.
+ * @param[out] len Returns the size of the free space.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_full_modem_buf_get(void **buf, size_t *len);
+
+/**
+ * @brief Commit firmware data placed in the buffer from
+ *	  dfu_target_full_modem_buf_get().
+ *
+ * @param[in] len Number of bytes placed in the buffer.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_full_modem_buf_commit(size_t len);
+
 /**
  * @brief Release resources and finalize firmware upgrade if successful.
 
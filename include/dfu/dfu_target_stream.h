@@ -79,6 +79,40 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init);
  */
 int dfu_target_stream_offset_get(size_t *offset);
 
+/**
+ * @brief Get the free space of the stream flash buffer.
+ *
+ * Firmware data can be placed directly in the returned buffer, for instance
+ * by receiving it from a socket, to avoid copying it. The data must then be
+ * committed with @ref dfu_target_stream_buf_commit, before any other write is
+ * done. Data placed in the buffer must not be passed to
+ * @ref dfu_target_stream_write.
+ *
+ * @param[out] buf Returns the start of the free space.
+ * @param[out] len Returns the size of the free space.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if the stream has not been initialized.
+ */
+int dfu_target_stream_buf_get(uint8_t **buf, size_t *len);
+
+/**
+ * @brief Commit firmware data placed in the stream flash buffer.
+ *
+ * Accounts for @p len bytes placed at the start of the buffer returned by
+ * @ref dfu_target_stream_buf_get, and writes the buffer to flash once it is
+ * full.
+ *
+ * @param[in] len Number of bytes placed in the buffer.
+ *
+ * @retval 0 on success.
+ * @retval -EACCES if the stream has not been initialized.
+ * @retval -ENOMEM if @p len exceeds the size returned by
+ *	   @ref dfu_target_stream_buf_get.
+ * @return Negative errno from stream_flash_buffered_write otherwise.
+ */
+int dfu_target_stream_buf_commit(size_t len);
+
 /**
  * @brief Write a chunk of firmware data.
  *
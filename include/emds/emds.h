@@ -14,6 +14,7 @@
 #ifndef EMDS_H__
 #define EMDS_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <sys/types.h>
 #include <zephyr/sys/util.h>
@@ -23,6 +24,24 @@
 extern "C" {
 #endif
 
+/**
+ * @struct emds_entry_state
+ *
+ * Store state of an entry, used to skip unchanged entries when
+ * @kconfig{CONFIG_EMDS_INCREMENTAL_STORE} is enabled. Managed by the library.
+ */
+struct emds_entry_state {
+	/** Hash of the entry data when it was last stored or loaded. */
+	uint32_t hash;
+	/** Whether the flash holds a valid copy of the entry data. */
+	bool stored;
+	/** Number of times @ref emds_load has restored, or may have partially
+	 *  overwritten, the entry data. Owners of the data can compare it with a
+	 *  previous value to detect that state derived from the data is stale.
+	 */
+	uint32_t load_count;
+};
+
 /**
  * @struct emds_entry
  *
@@ -35,6 +54,8 @@ struct emds_entry {
 	uint8_t *data;
 	/** Length of data that will be stored. */
 	size_t len;
+	/** Store state of the entry. Managed by the library. */
+	struct emds_entry_state *state;
 };
 
 /**
@@ -46,6 +67,8 @@ struct emds_entry {
 struct emds_dynamic_entry {
 	struct emds_entry entry;
 	sys_snode_t node;
+	/** Store state of the entry. Managed by the library. */
+	struct emds_entry_state state;
 };
 
 /**
@@ -60,10 +83,12 @@ struct emds_dynamic_entry {
  * This creates a variable _name prepended by emds_.
  */
 #define EMDS_STATIC_ENTRY_DEFINE(_name, _id, _data, _len)                      \
+	static struct emds_entry_state emds_##_name##_state;                   \
 	static const STRUCT_SECTION_ITERABLE(emds_entry, emds_##_name) = {     \
 		.id = _id,                                                     \
 		.data = (uint8_t *)_data,                                      \
 		.len = _len,                                                   \
+		.state = &emds_##_name##_state,                                \
 	}
 
 /**
@@ -130,6 +155,10 @@ int emds_entry_add(struct emds_dynamic_entry *entry);
  * with MPSL, make sure to uninitialize the MPSL before this function is called.
  * Otherwise, an assertion may be triggered by the exit of the function.
  *
+ * With @kconfig{CONFIG_EMDS_INCREMENTAL_STORE} enabled, entries whose data is
+ * unchanged since they were last stored or loaded are skipped, as the copy in
+ * flash is still valid.
+ *
  * @retval 0 Success
  * @retval -ERRNO errno code if error
  */
@@ -168,6 +197,11 @@ int emds_clear(void);
  * added. After this has been called emergency data storage should be ready to
  * store.
  *
+ * With @kconfig{CONFIG_EMDS_INCREMENTAL_STORE} enabled, the current entries are
+ * kept in flash unless the flash storage has to be cleared, so that unchanged
+ * entries do not have to be written again on the next store. A subsequent
+ * @ref emds_load then returns the most recently stored data of each entry.
+ *
  * @retval 0 Success
  * @retval -ERRNO errno code if error
  */
@@ -180,10 +214,30 @@ int emds_prepare(void);
  * registered in the entries. This value is dependent on the chip used, and
  * should be checked against the chip datasheet.
  *
+ * This is the worst case time of @ref emds_store, and is the time budget that
+ * the backup power has to cover. With @kconfig{CONFIG_EMDS_INCREMENTAL_STORE}
+ * enabled, it includes the time of hashing the entries to detect changes.
+ *
  * @return Time needed to store all data (in microseconds).
  */
 uint32_t emds_store_time_get(void);
 
+/**
+ * @brief Estimate the time needed to store the data that has changed.
+ *
+ * Estimate how much time it would take to store the registered data right
+ * now. With @kconfig{CONFIG_EMDS_INCREMENTAL_STORE} enabled, only the entries
+ * that changed since they were last stored or loaded are written, and this
+ * can be considerably lower than @ref emds_store_time_get. Otherwise, this is
+ * equal to @ref emds_store_time_get.
+ *
+ * @note The entry data is hashed to detect changes, so this function should
+ *       not be called in time critical contexts.
+ *
+ * @return Time needed to store the changed data (in microseconds).
+ */
+uint32_t emds_store_time_dirty_get(void);
+
 /**
  * @brief Calculate the size needed to store the registered data.
  *
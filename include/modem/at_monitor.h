@@ -46,6 +46,12 @@ struct at_monitor_entry {
 		uint8_t paused : 1; /* Monitor is paused. */
 		uint8_t direct : 1; /* Dispatch in ISR. */
 	} flags;
+	/** Next monitor in the same dispatch list. Set by the library. */
+	struct at_monitor_entry *next;
+#if defined(CONFIG_AT_MONITOR_STATS) || defined(__DOXYGEN__)
+	/** Number of notifications dispatched to this monitor. */
+	uint32_t dispatch_count;
+#endif
 };
 
 /** Wildcard. Match any notifications. */
@@ -117,6 +123,26 @@ static inline void at_monitor_resume(struct at_monitor_entry *mon)
 	mon->flags.paused = false;
 }
 
+/**
+ * @brief Get the number of notifications dispatched to a monitor.
+ *
+ * Requires CONFIG_AT_MONITOR_STATS.
+ *
+ * @param mon The monitor.
+ *
+ * @return The number of times the monitor handler has been called.
+ */
+static inline uint32_t at_monitor_dispatch_count_get(const struct at_monitor_entry *mon)
+{
+#if defined(CONFIG_AT_MONITOR_STATS)
+	return mon->dispatch_count;
+#else
+	ARG_UNUSED(mon);
+
+	return 0;
+#endif
+}
+
 /** @} */
 
 #ifdef __cplusplus
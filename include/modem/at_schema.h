@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef AT_SCHEMA_H__
+#define AT_SCHEMA_H__
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/types.h>
+#include <zephyr/toolchain.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file at_schema.h
+ *
+ * @defgroup at_schema AT response schema parser
+ * @ingroup at_cmd_parser
+ * @{
+ * @brief Parse AT responses directly into a structure.
+ *
+ * A schema describes the parameters of an AT response or notification: the type
+ * of each parameter and where in a structure to store it. The response is parsed
+ * in a single pass, without allocating memory. String parameters are not copied,
+ * they are returned as views into the response.
+ */
+
+/** @brief Parameter types of a schema. */
+enum at_schema_type {
+	/** Parameter is skipped, whatever its type. */
+	AT_SCHEMA_SKIP,
+	/** Decimal number, stored in an int32_t. */
+	AT_SCHEMA_INT,
+	/** Decimal number, stored in an int64_t. Values out of range are saturated. */
+	AT_SCHEMA_INT64,
+	/** Hexadecimal number, usually quoted, stored in a uint32_t. */
+	AT_SCHEMA_HEX,
+	/** Quoted or unquoted string, stored in a struct at_str_view. */
+	AT_SCHEMA_STR,
+};
+
+/** @brief String parameter, pointing into the parsed response. */
+struct at_str_view {
+	/** First character of the string, without the quotes. */
+	const char *ptr;
+	/** Number of characters. The string is not null-terminated. */
+	size_t len;
+};
+
+/** @brief Parameter of a schema. */
+struct at_schema_field {
+	/** Parameter type. */
+	uint16_t type;
+	/** Offset of the parameter value in the output structure. */
+	uint16_t offset;
+};
+
+/** @brief Schema of an AT response. */
+struct at_schema {
+	/** Response prefix, for example "+CEREG", or NULL if there is none. */
+	const char *prefix;
+	/** Parameters, in the order in which they appear in the response. */
+	const struct at_schema_field *fields;
+	/** Number of parameters. At most 32. */
+	size_t field_count;
+};
+
+/**
+ * @brief Schema parameter stored in @p _member of @p _struct.
+ *
+ * @param _type   Parameter type, without the AT_SCHEMA_ prefix, for example INT.
+ * @param _struct Output structure type.
+ * @param _member Member of the output structure.
+ */
+#define AT_SCHEMA_FIELD(_type, _struct, _member)				\
+	{									\
+		.type = AT_SCHEMA_##_type,					\
+		.offset = offsetof(_struct, _member),				\
+	}
+
+/** @brief Schema parameter that is not stored. */
+#define AT_SCHEMA_FIELD_SKIP { .type = AT_SCHEMA_SKIP }
+
+/**
+ * @brief Define a schema.
+ *
+ * @param _name   Name of the schema.
+ * @param _prefix Response prefix, for example "+CEREG", or NULL if there is none.
+ * @param ...     Parameters, defined with @ref AT_SCHEMA_FIELD and @ref AT_SCHEMA_FIELD_SKIP.
+ */
+#define AT_SCHEMA_DEFINE(_name, _prefix, ...)					\
+	static const struct at_schema_field _name##_fields[] = { __VA_ARGS__ };\
+	BUILD_ASSERT(ARRAY_SIZE(_name##_fields) <= 32,				\
+		     "A schema can have at most 32 parameters");		\
+	static const struct at_schema _name = {					\
+		.prefix = _prefix,						\
+		.fields = _name##_fields,					\
+		.field_count = ARRAY_SIZE(_name##_fields),			\
+	}
+
+/**
+ * @brief Parse an AT response using a schema.
+ *
+ * The response must start with the prefix of the schema, followed by a colon.
+ * Parsing stops at the end of the line. Parameters that are not in the schema are
+ * ignored. Values of parameters that are empty or missing in the response are not
+ * written to @p out, and their bit in @p present is cleared.
+ *
+ * To parse a list of repeated parameters, for example neighbor cells, a schema
+ * without a prefix can be applied repeatedly, starting from the string returned
+ * in @p next, as long as it points to a separator.
+ *
+ * @param schema  Schema of the response.
+ * @param str     Response to parse, a null-terminated string.
+ * @param out     Structure where the parameter values are stored.
+ * @param present Bit n is set if parameter n of the schema was found and stored.
+ *                Can be NULL.
+ * @param next    Where parsing stopped: the separator after the last parameter of the
+ *                schema, or the end of the line. Can be NULL.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ * @retval -ENOMSG  The response does not start with the prefix of the schema.
+ * @retval -EBADMSG A parameter value does not match its type in the schema.
+ */
+int at_schema_parse(const struct at_schema *schema, const char *str, void *out,
+		    uint32_t *present, const char **next);
+
+/**
+ * @brief Copy a string parameter to a buffer, as a null-terminated string.
+ *
+ * @param view     String parameter.
+ * @param buf      Buffer where the string is copied.
+ * @param buf_size Size of the buffer, including the null terminator.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENODATA The parameter was not found in the response.
+ * @retval -E2BIG   The string does not fit in the buffer.
+ */
+static inline int at_str_view_copy(const struct at_str_view *view, char *buf, size_t buf_size)
+{
+	if (view->ptr == NULL) {
+		return -ENODATA;
+	}
+
+	if (view->len >= buf_size) {
+		return -E2BIG;
+	}
+
+	memcpy(buf, view->ptr, view->len);
+	buf[view->len] = '\0';
+
+	return 0;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AT_SCHEMA_H__ */
@@ -85,12 +85,20 @@ enum location_event_id {
 	 * GNSS is requesting A-GNSS data.
 	 *
 	 * Application should obtain the data and send it to location_agnss_data_process().
+	 *
+	 * If @kconfig{CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH} is set, this event is also
+	 * sent when no location request is running, after the RRC connection has been
+	 * established for other traffic.
 	 */
 	LOCATION_EVT_GNSS_ASSISTANCE_REQUEST,
 	/**
 	 * GNSS is requesting P-GPS data.
 	 *
 	 * Application should obtain the data and send it to location_pgps_data_process().
+	 *
+	 * If @kconfig{CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH} is set, this event is also
+	 * sent when no location request is running, after the RRC connection has been
+	 * established for other traffic.
 	 */
 	LOCATION_EVT_GNSS_PREDICTION_REQUEST,
 	/**
@@ -601,6 +609,21 @@ struct location_config {
 	enum location_req_mode mode;
 };
 
+/** GNSS assistance data statistics. */
+struct location_gnss_assistance_stats {
+	/** Number of GNSS location requests for which all assistance data was valid. */
+	uint32_t fresh_starts;
+	/** Number of GNSS location requests for which some assistance data had expired. */
+	uint32_t stale_starts;
+	/**
+	 * Number of times assistance data was requested while LTE was active for other traffic.
+	 * Checks that did not lead to a request, for example due to the minimum A-GNSS request
+	 * interval, are not counted.
+	 * See @kconfig{CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH}.
+	 */
+	uint32_t prefetches;
+};
+
 /**
  * @brief Event handler prototype.
  *
@@ -760,6 +783,20 @@ int location_agnss_data_process(const char *buf, size_t buf_len);
  */
 int location_pgps_data_process(const char *buf, size_t buf_len);
 
+/**
+ * @brief Get GNSS assistance data statistics.
+ *
+ * @details The statistics show how often GNSS location requests found the assistance data
+ * valid and how often it had to be fetched first.
+ *
+ * @param[out] stats Statistics.
+ *
+ * @return 0 on success, or negative error code on failure.
+ * @retval -EINVAL Given statistics pointer is NULL.
+ * @retval -ENOTSUP GNSS method or GNSS assistance is not enabled.
+ */
+int location_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats);
+
 /**
  * @brief Pass cloud location result to the library.
  *
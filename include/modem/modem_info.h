@@ -403,6 +403,39 @@ int modem_info_get_operator(char *buf, size_t buf_size);
  */
 int modem_info_get_snr(int *val);
 
+#if defined(CONFIG_MODEM_INFO_CACHE) || defined(__DOXYGEN__)
+
+/** @brief Statistics of the modem information cache. */
+struct modem_info_cache_stats {
+	/** Number of requests answered from the cache. */
+	uint32_t hits;
+	/** Number of requests for which an AT command was sent to the modem. */
+	uint32_t misses;
+	/** Number of times cached responses were invalidated by the modem. */
+	uint32_t invalidations;
+};
+
+/**
+ * @brief Invalidate all cached modem information.
+ *
+ * The next request of each information type is sent to the modem.
+ * Use this after changing a modem setting with an AT command that the
+ * library does not monitor, for example @c AT+CGDCONT.
+ */
+void modem_info_cache_invalidate(void);
+
+/**
+ * @brief Obtain the statistics of the modem information cache.
+ *
+ * @param stats Pointer to the target structure.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If @p stats is NULL.
+ */
+int modem_info_cache_stats_get(struct modem_info_cache_stats *stats);
+
+#endif /* CONFIG_MODEM_INFO_CACHE || __DOXYGEN__ */
+
 /** @} */
 
 #ifdef __cplusplus
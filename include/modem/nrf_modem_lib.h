@@ -249,6 +249,44 @@ struct nrf_modem_lib_diag_stats {
 int nrf_modem_lib_diag_stats_get(struct nrf_modem_lib_diag_stats *stats);
 #endif
 
+#if defined(CONFIG_NRF_MODEM_LIB_WAKEUP_STATS) || defined(__DOXYGEN__)
+/** @brief Statistics of the threads sleeping in calls to the Modem library. */
+struct nrf_modem_lib_wakeup_stats {
+	/** Number of events from the modem. */
+	uint32_t events;
+	/** Number of times a thread was woken up by an event on the context it sleeps on. */
+	uint32_t wakeups;
+	/** Number of times a thread was woken up by an event on another context, because
+	 *  either the thread or the event is not bound to a context.
+	 */
+	uint32_t spurious_wakeups;
+	/** Number of sleeping threads that were not woken up by an event, but were checked
+	 *  because their context shares a wait queue with the context of the event.
+	 */
+	uint32_t collisions;
+	/** Number of times a thread did not sleep, because an event arrived since it last
+	 *  checked its state.
+	 */
+	uint32_t sleeps_skipped;
+	/** Number of sleeps that ended with a timeout. */
+	uint32_t timeouts;
+	/** Largest number of threads sleeping at the same time. */
+	uint32_t max_waiting;
+};
+
+/**
+ * @brief Retrieve the wake-up statistics of the threads sleeping in the Modem library.
+ *
+ * @return int Zero on success, non-zero otherwise.
+ */
+int nrf_modem_lib_wakeup_stats_get(struct nrf_modem_lib_wakeup_stats *stats);
+
+/**
+ * @brief Reset the wake-up statistics.
+ */
+void nrf_modem_lib_wakeup_stats_reset(void);
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
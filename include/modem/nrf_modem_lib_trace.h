@@ -116,6 +116,44 @@ int nrf_modem_lib_trace_clear(void);
 uint32_t nrf_modem_lib_trace_backend_bitrate_get(void);
 #endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE) || defined(__DOXYGEN__) */
 
+#if defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RAM_COMPRESS) || defined(__DOXYGEN__)
+/** @brief Statistics of the compressed RAM trace backend. */
+struct nrf_modem_lib_trace_compress_stats {
+	/** Number of trace bytes received from the modem and compressed. */
+	uint32_t raw_bytes;
+	/** Number of bytes written to the RAM buffer, including the block headers. */
+	uint32_t stored_bytes;
+	/** Number of compressed blocks written to the RAM buffer. */
+	uint32_t blocks;
+	/** Number of trace bytes dropped with the oldest blocks when the buffer was full. */
+	uint32_t dropped_bytes;
+	/** Number of trace bytes dropped because the trace was frozen. */
+	uint32_t frozen_bytes;
+};
+
+/** @brief Freeze the trace stored in the RAM buffer.
+ *
+ * The trace data received so far is kept, and new trace data is dropped until the
+ * trace is cleared with @ref nrf_modem_lib_trace_clear. This can be called when a failure
+ * is detected, to keep the trace that led to it.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EPERM If the trace backend is not initialized.
+ */
+int nrf_modem_lib_trace_freeze(void);
+
+/** @brief Get the statistics of the compressed RAM trace backend.
+ *
+ * The compression ratio is @c raw_bytes divided by @c stored_bytes.
+ *
+ * @param[out] stats Statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If @p stats is @c NULL.
+ */
+int nrf_modem_lib_trace_compress_stats_get(struct nrf_modem_lib_trace_compress_stats *stats);
+#endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RAM_COMPRESS) || defined(__DOXYGEN__) */
+
 /** @} */
 
 #ifdef __cplusplus
@@ -28,6 +28,13 @@
 extern "C" {
 #endif
 
+/** Maximum number of CoAP block requests in flight. */
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+#define DOWNLOAD_CLIENT_COAP_WINDOW_MAX CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE
+#else
+#define DOWNLOAD_CLIENT_COAP_WINDOW_MAX 1
+#endif
+
 /**
  * @brief Download client event IDs.
  */
@@ -80,6 +87,8 @@ enum download_client_evt_id {
 struct download_fragment {
 	const void *buf;
 	size_t len;
+	/** The fragment is in a buffer from @ref download_client_cfg.buf_lend. */
+	bool lent;
 };
 
 /**
@@ -97,6 +106,21 @@ struct download_client_evt {
 	};
 };
 
+/**
+ * @brief Callback lending a buffer to receive HTTP payload into.
+ *
+ * The buffer must remain valid until it has been returned in a
+ * DOWNLOAD_CLIENT_EVT_FRAGMENT event, or until the download is stopped.
+ * The buffer is requested again for every fragment.
+ *
+ * @param[out] buf	The lent buffer.
+ * @param[out] len	Size of the lent buffer.
+ *
+ * @return Zero if a buffer is lent, otherwise a negative error code
+ *	   to receive the payload into the client's own buffer.
+ */
+typedef int (*download_client_buf_lend_t)(void **buf, size_t *len);
+
 /**
  * @brief Download client configuration options.
  */
@@ -126,6 +150,10 @@ struct download_client_cfg {
 	size_t frag_size_override;
 	/** Set hostname for TLS Server Name Indication extension */
 	bool set_tls_hostname;
+	/** Optional callback lending a buffer to receive the HTTP payload
+	 *  directly into. Fragments are then delivered in the lent buffer.
+	 */
+	download_client_buf_lend_t buf_lend;
 };
 
 /**
@@ -190,14 +218,66 @@ struct download_client {
 		bool connection_close;
 		/** Is using ranged query. */
 		bool ranged;
+		/** Offset of the next byte to request when pipelining. */
+		size_t request_next;
+		/** Payload bytes left in the current response. */
+		size_t body_left;
+		/** Bytes of the next pipelined response that follow
+		 *  the current fragment in the buffer.
+		 */
+		size_t carry;
+		/** Number of pipelined requests not yet fully received. */
+		uint8_t pipelined;
+		/** The server sent a shorter range than requested, so the
+		 *  responses still in flight do not follow the received data.
+		 */
+		bool pipeline_stale;
+		/** Number of requests to keep in flight. */
+		uint8_t window;
+		/** Time when a request was sent with no other requests in flight. */
+		uint32_t rtt_start;
+		/** Time when the header of the current response was received. */
+		uint32_t header_time;
+		/** Measured round-trip time, in milliseconds. */
+		uint32_t rtt;
+		/** Buffer lent by the application, NULL if none. */
+		uint8_t *lent_buf;
+		/** Size of the lent buffer. */
+		size_t lent_len;
+		/** Payload bytes received into the lent buffer. */
+		size_t lent_used;
 	} http;
 
 	struct {
 		/** CoAP block context. */
 		struct coap_block_context block_ctx;
 
-		/** CoAP pending object. */
-		struct coap_pending pending;
+		/** CoAP pending objects, one for each block of the window. */
+		struct coap_pending pending[DOWNLOAD_CLIENT_COAP_WINDOW_MAX];
+		/** Time when each request was first sent. */
+		uint32_t sent[DOWNLOAD_CLIENT_COAP_WINDOW_MAX];
+		/** Payload length of each received block. */
+		uint16_t len[DOWNLOAD_CLIENT_COAP_WINDOW_MAX];
+		/** Blocks of the window that were received, bit 0 is the first block. */
+		uint8_t received;
+		/** Requests that were retransmitted. */
+		uint8_t retransmitted;
+		/** Requests to send again. */
+		uint8_t resend;
+		/** Number of blocks in the window. */
+		uint8_t window;
+		/** Number of blocks that were delivered but are still in the buffer. */
+		uint8_t shift;
+		/** One plus the index of the last block of the file, zero if not received. */
+		uint8_t last;
+		/** Block size to use once the window is empty. */
+		uint8_t next_block_size;
+		/** Number of blocks received without retransmission. */
+		uint8_t good;
+		/** Smoothed round-trip time, in milliseconds. */
+		uint32_t srtt;
+		/** Round-trip time variation, in milliseconds. */
+		uint32_t rttvar;
 	} coap;
 
 	/** Internal thread ID. */
@@ -35,6 +35,8 @@ enum mqtt_state {
 enum mqtt_helper_error {
 	/** The received payload is larger than the payload buffer. */
 	MQTT_HELPER_ERROR_MSG_SIZE,
+	/** A queued message could not be sent while connected, and was dropped. */
+	MQTT_HELPER_ERROR_PUBLISH_DROPPED,
 };
 
 struct mqtt_helper_buf {
@@ -90,6 +92,36 @@ struct mqtt_helper_conn_params {
 	struct mqtt_helper_buf password;
 };
 
+/** @brief Statistics of the outgoing message queue. */
+struct mqtt_helper_queue_stats {
+	/** Number of messages accepted into the queue. */
+	uint32_t queued;
+	/** Number of messages rejected because the queue was full, or dropped because they
+	 *  could not be sent.
+	 */
+	uint32_t dropped;
+	/** Number of PUBLISH packets sent, including retransmissions. */
+	uint32_t sent;
+	/** Number of QoS 1 messages sent again after a reconnection. */
+	uint32_t resent;
+	/** Number of QoS 1 messages acknowledged by the broker. */
+	uint32_t acked;
+	/** Number of messages in the queue, including those waiting for a PUBACK. */
+	uint16_t depth;
+	/** Largest number of messages in the queue. */
+	uint16_t depth_max;
+	/** Number of QoS 1 messages waiting for a PUBACK. */
+	uint16_t inflight;
+	/** Average time from mqtt_helper_publish() to the PUBACK, or to the sending of
+	 *  QoS 0 messages, in milliseconds. Exponential moving average.
+	 */
+	uint32_t latency_avg_ms;
+	/** Longest time from mqtt_helper_publish() to the PUBACK, or to the sending of
+	 *  QoS 0 messages, in milliseconds.
+	 */
+	uint32_t latency_max_ms;
+};
+
 /** @brief Initialize the MQTT helper.
  *
  *  @retval 0 if successful.
@@ -124,13 +156,31 @@ int mqtt_helper_disconnect(void);
 int mqtt_helper_subscribe(struct mqtt_subscription_list *sub_list);
 
 /** @brief Publish an MQTT message.
+ *
+ *  If CONFIG_MQTT_HELPER_PUBLISH_QUEUE is enabled, the topic and payload are copied into
+ *  the outgoing message queue, and the message is sent when the QoS 1 in-flight window
+ *  allows it. The message can then also be published while disconnected, and it is sent
+ *  once connected. QoS 2 messages cannot be queued.
  *
  *  @retval 0 if successful.
  *  @retval -EOPNOTSUPP if operation is not supported in the current state.
+ *  @retval -ENOMEM if the message does not fit in the outgoing message queue.
+ *  @retval -ENOTSUP if the message is QoS 2 and the outgoing message queue is enabled.
  *  @return Otherwise a negative error code.
  */
 int mqtt_helper_publish(const struct mqtt_publish_param *param);
 
+/** @brief Get the statistics of the outgoing message queue.
+ *
+ *  Requires CONFIG_MQTT_HELPER_PUBLISH_QUEUE.
+ *
+ *  @param[out] stats Statistics.
+ *
+ *  @retval 0 if successful.
+ *  @retval -ENOTSUP if the outgoing message queue is not enabled.
+ */
+int mqtt_helper_queue_stats_get(struct mqtt_helper_queue_stats *stats);
+
 /** @brief Deinitialize library. Must be called when all MQTT operations are done to
  *	   release resources and allow for a new client. The client must be in a disconnected state.
  *
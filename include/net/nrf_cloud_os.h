@@ -37,6 +37,67 @@ struct nrf_cloud_os_mem_hooks {
  */
 void nrf_cloud_os_mem_hooks_init(struct nrf_cloud_os_mem_hooks *hooks);
 
+/** @brief Memory usage of the nRF Cloud library */
+struct nrf_cloud_mem_stats {
+	/** Bytes in use. With CONFIG_NRF_CLOUD_MEM_POOL, this includes the heap overhead. */
+	size_t used;
+	/** Largest number of bytes in use at the same time. */
+	size_t peak;
+	/** Free bytes in the pool. Only with CONFIG_NRF_CLOUD_MEM_POOL. */
+	size_t free;
+	/** Largest block that can currently be allocated from the pool.
+	 *  Compared to @ref free, this shows the fragmentation of the pool.
+	 *  Only with CONFIG_NRF_CLOUD_MEM_POOL.
+	 */
+	size_t largest_free;
+	/** Number of allocations. Only with CONFIG_NRF_CLOUD_MEM_STATS. */
+	uint32_t allocs;
+	/** Number of failed allocations. Only with CONFIG_NRF_CLOUD_MEM_STATS. */
+	uint32_t failures;
+};
+
+/** @brief Memory usage of one allocation call site */
+struct nrf_cloud_mem_site_stats {
+	/** Source file of the allocation call, or NULL for the entry that accounts
+	 *  for the call sites that did not fit in the table.
+	 */
+	const char *file;
+	/** Line of the allocation call in @ref file. */
+	uint32_t line;
+	/** Number of allocations. */
+	uint32_t allocs;
+	/** Number of failed allocations. */
+	uint32_t failures;
+	/** Bytes in use. */
+	size_t used;
+	/** Largest number of bytes in use at the same time. */
+	size_t peak;
+};
+
+/**
+ * @brief Get the memory usage of the nRF Cloud library.
+ *
+ * @param[out] stats Memory usage.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOTSUP If CONFIG_NRF_CLOUD_MEM_POOL is not enabled.
+ */
+int nrf_cloud_mem_stats_get(struct nrf_cloud_mem_stats *stats);
+
+/**
+ * @brief Get the memory usage of one allocation call site.
+ *
+ * Requires CONFIG_NRF_CLOUD_MEM_STATS.
+ *
+ * @param[in]  index Index of the call site, from 0.
+ * @param[out] stats Memory usage of the call site.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOENT If no call site has this index.
+ * @retval -ENOTSUP If CONFIG_NRF_CLOUD_MEM_STATS is not enabled.
+ */
+int nrf_cloud_mem_site_stats_get(size_t index, struct nrf_cloud_mem_site_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
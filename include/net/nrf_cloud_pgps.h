@@ -228,7 +228,8 @@ int nrf_cloud_pgps_notify_prediction(void);
  *
  * @return 0..NumPredictions-1 if successful; -ETIMEUNKNOWN if current date and time
  * not known; -ETIMEDOUT if all predictions stored are expired;
- * -EINVAL if prediction for the current time is invalid.
+ * -ENODATA if no predictions are stored, or the stored prediction for the
+ * current time is corrupted; -EINVAL if prediction for the current time is invalid.
  */
 int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction);
 
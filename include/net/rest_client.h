@@ -60,7 +60,10 @@ struct rest_client_req_context {
 	 */
 	int connect_socket;
 
-	/** Defines whether the connection should remain after API call. Default: false. */
+	/** Defines whether the connection should remain after API call. Default: false.
+	 *  If false and CONFIG_REST_CLIENT_CONN_REUSE is enabled, the library may keep
+	 *  the connection open internally for the next request to the same server.
+	 */
 	bool keep_alive;
 
 	/** Security tag. Default: @ref REST_CLIENT_SEC_TAG_NO_SEC. */
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include <modem/at_schema.h>
+#include "at_utils.h"
+
+static inline bool is_param_end(char chr)
+{
+	return (chr == AT_PARAM_SEPARATOR) || is_lfcr(chr) || is_terminated(chr);
+}
+
+static const char *skip_space(const char *str)
+{
+	while (*str == ' ') {
+		str++;
+	}
+
+	return str;
+}
+
+/* Find the value of the parameter at @p str, and return where the parameter ends. */
+static const char *param_get(const char *str, struct at_str_view *val, bool *quoted)
+{
+	str = skip_space(str);
+
+	*quoted = is_dblquote(*str);
+
+	if (*quoted) {
+		val->ptr = ++str;
+
+		while (!is_dblquote(*str) && !is_terminated(*str)) {
+			str++;
+		}
+
+		val->len = str - val->ptr;
+
+		if (is_dblquote(*str)) {
+			str++;
+		}
+	} else if (is_array_start(*str)) {
+		val->ptr = str;
+
+		while (!is_array_stop(*str) && !is_terminated(*str)) {
+			str++;
+		}
+
+		if (is_array_stop(*str)) {
+			str++;
+		}
+
+		val->len = str - val->ptr;
+	} else {
+		val->ptr = str;
+
+		while (!is_param_end(*str)) {
+			str++;
+		}
+
+		val->len = str - val->ptr;
+
+		while (val->len && val->ptr[val->len - 1] == ' ') {
+			val->len--;
+		}
+	}
+
+	return skip_space(str);
+}
+
+static int param_store(const struct at_schema_field *field, const struct at_str_view *val,
+		       bool quoted, void *out)
+{
+	void *dst = (uint8_t *)out + field->offset;
+	const char *end = val->ptr + val->len;
+	char *next;
+
+	switch (field->type) {
+	case AT_SCHEMA_INT:
+	case AT_SCHEMA_INT64: {
+		long long num;
+
+		if (quoted || !is_number(*val->ptr)) {
+			return -EBADMSG;
+		}
+
+		errno = 0;
+		num = strtoll(val->ptr, &next, 10);
+		if (next != end) {
+			return -EBADMSG;
+		}
+
+		if (field->type == AT_SCHEMA_INT64) {
+			/* Saturated on overflow, as by the AT command parser */
+			*(int64_t *)dst = num;
+		} else if (errno != ERANGE && num >= INT32_MIN && num <= INT32_MAX) {
+			*(int32_t *)dst = num;
+		} else {
+			return -EBADMSG;
+		}
+
+		break;
+	}
+	case AT_SCHEMA_HEX: {
+		unsigned long long num;
+
+		if (!isxdigit((int)*val->ptr)) {
+			return -EBADMSG;
+		}
+
+		num = strtoull(val->ptr, &next, 16);
+		if (next != end || num > UINT32_MAX) {
+			return -EBADMSG;
+		}
+
+		*(uint32_t *)dst = num;
+		break;
+	}
+	case AT_SCHEMA_STR:
+		*(struct at_str_view *)dst = *val;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int at_schema_parse(const struct at_schema *schema, const char *str, void *out,
+		    uint32_t *present, const char **next)
+{
+	struct at_str_view val;
+	uint32_t found = 0;
+	bool quoted;
+	int err;
+
+	if (schema == NULL || schema->field_count > 32 || str == NULL || out == NULL) {
+		return -EINVAL;
+	}
+
+	while (is_lfcr(*str)) {
+		str++;
+	}
+
+	if (schema->prefix) {
+		size_t len = strlen(schema->prefix);
+
+		if (strncmp(str, schema->prefix, len) != 0 || str[len] != AT_RSP_SEPARATOR) {
+			return -ENOMSG;
+		}
+
+		str += len + 1;
+	} else if (*str == AT_PARAM_SEPARATOR) {
+		str++;
+	}
+
+	for (size_t i = 0; i < schema->field_count; i++) {
+		const struct at_schema_field *field = &schema->fields[i];
+
+		if (i > 0) {
+			if (*str != AT_PARAM_SEPARATOR) {
+				/* End of line, the remaining parameters are missing */
+				break;
+			}
+
+			str++;
+		}
+
+		str = param_get(str, &val, &quoted);
+		if (!is_param_end(*str)) {
+			return -EBADMSG;
+		}
+
+		if (field->type == AT_SCHEMA_SKIP) {
+			continue;
+		}
+
+		/* An empty quoted string is still a string */
+		if (val.len == 0 && !(quoted && field->type == AT_SCHEMA_STR)) {
+			continue;
+		}
+
+		err = param_store(field, &val, quoted, out);
+		if (err) {
+			return err;
+		}
+
+		found |= BIT(i);
+	}
+
+	if (present) {
+		*present = found;
+	}
+
+	if (next) {
+		*next = str;
+	}
+
+	return 0;
+}
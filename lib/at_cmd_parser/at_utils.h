@@ -273,7 +273,7 @@ static inline bool is_command(const char *str)
  * @retval true  If the string is a CLAC response
  * @retval false Otherwise
  */
-static bool is_clac(const char *str)
+static inline bool is_clac(const char *str)
 {
 	/* skip leading <CR><LF>, if any, as check not from index 0 */
 	while (is_lfcr(*str)) {
@@ -15,9 +15,30 @@
 
 LOG_MODULE_REGISTER(at_monitor, CONFIG_AT_MONITOR_LOG_LEVEL);
 
+/* Monitors whose filter starts like an AT notification, with '+' or '%', and is at least
+ * KEY_LEN characters long are indexed by the first KEY_LEN characters of the filter.
+ * Such a filter can only match a notification at a position where the notification has
+ * a '+' or a '%'. When that is only the first character, which is the case for nearly all
+ * notifications, looking up the notification in the index gives the same monitors as
+ * matching every filter with strstr(). Otherwise, all monitors are matched.
+ */
+#define KEY_LEN 4
+#define BUCKETS 16
+
 struct at_notif_fifo {
 	void *fifo_reserved;
-	char data[]; /* Null-terminated AT notification string */
+	const char *data; /* Null-terminated AT notification string */
+	size_t mon_count;
+	struct at_monitor_entry *mon[]; /* Monitors to dispatch to, followed by the data */
+};
+
+struct match_iter {
+	const char *notif;
+	struct at_monitor_entry *indexed;
+	struct at_monitor_entry *other;
+	bool scan;
+	int scan_idx;
+	int scan_count;
 };
 
 static void at_monitor_task(struct k_work *work);
@@ -26,6 +47,9 @@ static K_FIFO_DEFINE(at_monitor_fifo);
 static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
 static K_WORK_DEFINE(at_monitor_work, at_monitor_task);
 
+static struct at_monitor_entry *buckets[BUCKETS];
+static struct at_monitor_entry *unindexed;
+
 static bool is_paused(const struct at_monitor_entry *mon)
 {
 	return mon->flags.paused;
@@ -41,25 +65,145 @@ static bool has_match(const struct at_monitor_entry *mon, const char *notif)
 	return (mon->filter == ANY || strstr(notif, mon->filter));
 }
 
+static bool is_key(const char *str)
+{
+	return (str[0] == '+' || str[0] == '%') && strnlen(str, KEY_LEN) == KEY_LEN;
+}
+
+static size_t key_hash(const char *str)
+{
+	uint32_t hash = 0;
+
+	for (size_t i = 0; i < KEY_LEN; i++) {
+		hash = hash * 31 + (uint8_t)str[i];
+	}
+
+	return hash % BUCKETS;
+}
+
+/* Link the monitors into the index. Each list keeps the order of definition. */
+static void index_build(void)
+{
+	struct at_monitor_entry **tails[BUCKETS];
+	struct at_monitor_entry **unindexed_tail = &unindexed;
+
+	for (size_t i = 0; i < BUCKETS; i++) {
+		buckets[i] = NULL;
+		tails[i] = &buckets[i];
+	}
+
+	unindexed = NULL;
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		e->next = NULL;
+
+		if (e->filter != ANY && is_key(e->filter)) {
+			size_t bucket = key_hash(e->filter);
+
+			*tails[bucket] = e;
+			tails[bucket] = &e->next;
+		} else {
+			*unindexed_tail = e;
+			unindexed_tail = &e->next;
+		}
+	}
+}
+
+static void match_iter_init(struct match_iter *it, const char *notif)
+{
+	it->notif = notif;
+	it->indexed = NULL;
+	it->other = NULL;
+	it->scan = false;
+
+	if (notif[0] != '\0' && strpbrk(notif + 1, "+%")) {
+		it->scan = true;
+		it->scan_idx = 0;
+		STRUCT_SECTION_COUNT(at_monitor_entry, &it->scan_count);
+		return;
+	}
+
+	if (is_key(notif)) {
+		it->indexed = buckets[key_hash(notif)];
+	}
+
+	it->other = unindexed;
+}
+
+/* Get the next monitor matching the notification, in the order of definition. */
+static struct at_monitor_entry *match_next(struct match_iter *it)
+{
+	struct at_monitor_entry *e;
+
+	if (it->scan) {
+		while (it->scan_idx < it->scan_count) {
+			STRUCT_SECTION_GET(at_monitor_entry, it->scan_idx++, &e);
+			if (has_match(e, it->notif)) {
+				return e;
+			}
+		}
+
+		return NULL;
+	}
+
+	while (it->indexed || it->other) {
+		if (!it->other || (it->indexed && it->indexed < it->other)) {
+			e = it->indexed;
+			it->indexed = e->next;
+			if (strncmp(it->notif, e->filter, strlen(e->filter)) == 0) {
+				return e;
+			}
+		} else {
+			e = it->other;
+			it->other = e->next;
+			if (has_match(e, it->notif)) {
+				return e;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static void dispatch_count_inc(struct at_monitor_entry *mon)
+{
+#if defined(CONFIG_AT_MONITOR_STATS)
+	mon->dispatch_count++;
+#endif
+}
+
 /* Dispatch AT notifications immediately, or schedules a workqueue task to do that.
  * Keep this function public so that it can be called by tests.
  * This function is called from an ISR.
  */
 void at_monitor_dispatch(const char *notif)
 {
-	bool monitored;
 	struct at_notif_fifo *at_notif;
-	size_t sz_needed;
+	struct at_monitor_entry *e;
+	struct match_iter it;
+	bool monitored;
+	size_t queued;
+	size_t len;
+	char *data;
 
 	__ASSERT_NO_MSG(notif != NULL);
 
 	monitored = false;
-	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!is_paused(e) && has_match(e, notif)) {
-			if (is_direct(e)) {
+	queued = 0;
+	match_iter_init(&it, notif);
+	while ((e = match_next(&it))) {
+		if (is_direct(e)) {
+			if (!is_paused(e)) {
 				LOG_DBG("Dispatching to %p (ISR)", e->handler);
+				dispatch_count_inc(e);
 				e->handler(notif);
-			} else {
+			}
+		} else {
+			/* Paused monitors are kept too, they may be resumed before the
+			 * workqueue task runs.
+			 */
+			queued++;
+			if (!is_paused(e)) {
 				/* Copy and schedule work-queue task */
 				monitored = true;
 			}
@@ -71,16 +215,30 @@ void at_monitor_dispatch(const char *notif)
 		return;
 	}
 
-	sz_needed = sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char);
+	/* One copy of the notification is shared by all the monitors it is dispatched to */
+	len = strlen(notif) + sizeof(char);
 
-	at_notif = k_heap_alloc(&at_monitor_heap, sz_needed, K_NO_WAIT);
+	at_notif = k_heap_alloc(&at_monitor_heap,
+				sizeof(struct at_notif_fifo) + queued * sizeof(e) + len,
+				K_NO_WAIT);
 	if (!at_notif) {
 		LOG_WRN("No heap space for incoming notification: %s", notif);
 		__ASSERT(at_notif, "No heap space for incoming notification: %s", notif);
 		return;
 	}
 
-	strcpy(at_notif->data, notif);
+	/* Keep the matching monitors, so that the workqueue task does not match them again */
+	at_notif->mon_count = 0;
+	match_iter_init(&it, notif);
+	while ((e = match_next(&it)) && at_notif->mon_count < queued) {
+		if (!is_direct(e)) {
+			at_notif->mon[at_notif->mon_count++] = e;
+		}
+	}
+
+	data = (char *)&at_notif->mon[queued];
+	memcpy(data, notif, len);
+	at_notif->data = data;
 
 	k_fifo_put(&at_monitor_fifo, at_notif);
 	k_work_submit(&at_monitor_work);
@@ -89,13 +247,18 @@ void at_monitor_dispatch(const char *notif)
 static void at_monitor_task(struct k_work *work)
 {
 	struct at_notif_fifo *at_notif;
+	struct at_monitor_entry *e;
 
 	while ((at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT))) {
-		/* Match notification with all monitors */
 		LOG_DBG("AT notif: %.*s", strlen(at_notif->data) - strlen("\r\n"), at_notif->data);
-		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data)) {
+		for (size_t i = 0; i < at_notif->mon_count; i++) {
+			e = at_notif->mon[i];
+			/* Check the state of the monitor when dispatching, as it may have been
+			 * paused or resumed since the notification was received.
+			 */
+			if (!is_paused(e)) {
 				LOG_DBG("Dispatching to %p", e->handler);
+				dispatch_count_inc(e);
 				e->handler(at_notif->data);
 			}
 		}
@@ -107,6 +270,8 @@ static int at_monitor_sys_init(void)
 {
 	int err;
 
+	index_build();
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
@@ -17,6 +17,9 @@
 
 #include "location_core.h"
 #include "location_utils.h"
+#if defined(CONFIG_LOCATION_METHOD_GNSS)
+#include "method_gnss.h"
+#endif
 
 LOG_MODULE_REGISTER(location, CONFIG_LOCATION_LOG_LEVEL);
 
@@ -391,6 +394,21 @@ int location_pgps_data_process(const char *buf, size_t buf_len)
 	return -ENOTSUP;
 }
 
+int location_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats)
+{
+#if defined(CONFIG_LOCATION_METHOD_GNSS) && \
+	(defined(CONFIG_NRF_CLOUD_AGNSS) || defined(CONFIG_NRF_CLOUD_PGPS))
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	method_gnss_assistance_stats_get(stats);
+
+	return 0;
+#endif
+	return -ENOTSUP;
+}
+
 void location_cloud_location_ext_result_set(
 	enum location_ext_result result,
 	struct location_data *location)
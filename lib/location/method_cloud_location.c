@@ -40,6 +40,18 @@ static bool running;
 static K_SEM_DEFINE(wifi_scan_ready, 0, 1);
 #endif
 
+#if defined(CONFIG_LOCATION_METHOD_WIFI_CELLULAR_GCI_SKIP)
+static void method_cloud_location_wifi_scan_done(uint16_t ap_count)
+{
+	/* Cellular scan is not stopped if there are not enough access points for a location,
+	 * see scan_wifi_results_get()
+	 */
+	if (ap_count > 1) {
+		scan_cellular_gci_search_stop();
+	}
+}
+#endif
+
 static void method_cloud_location_positioning_work_fn(struct k_work *work)
 {
 	struct method_cloud_location_start_work_args *work_data =
@@ -54,7 +66,15 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 	k_sem_reset(&wifi_scan_ready);
 
 	if (wifi_config != NULL) {
-		scan_wifi_execute(wifi_config->timeout, &wifi_scan_ready);
+		scan_wifi_done_cb_t done_cb = NULL;
+
+#if defined(CONFIG_LOCATION_METHOD_WIFI_CELLULAR_GCI_SKIP)
+		/* Wi-Fi scan runs while cellular scan is ongoing in this thread */
+		if (cell_config != NULL) {
+			done_cb = method_cloud_location_wifi_scan_done;
+		}
+#endif
+		scan_wifi_execute(wifi_config->timeout, &wifi_scan_ready, done_cb);
 	}
 #endif
 
@@ -113,6 +113,17 @@ static K_SEM_DEFINE(entered_rrc_idle, 1, 1);
 
 #if defined(CONFIG_NRF_CLOUD_AGNSS) || defined(CONFIG_NRF_CLOUD_PGPS)
 static struct nrf_modem_gnss_agnss_data_frame agnss_request;
+
+/* Assistance data statistics, see struct location_gnss_assistance_stats. */
+static atomic_t stats_fresh_starts;
+static atomic_t stats_stale_starts;
+static atomic_t stats_prefetches;
+#endif
+
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+static struct k_work method_gnss_prefetch_work;
+/* Assistance data is only prefetched after GNSS has been used once. */
+static bool gnss_used;
 #endif
 
 #if defined(CONFIG_NRF_CLOUD_PGPS)
@@ -233,6 +244,15 @@ void method_gnss_lte_ind_handler(const struct lte_lc_evt *const evt)
 		if (evt->rrc_mode == LTE_LC_RRC_MODE_CONNECTED) {
 			/* Prevent GNSS from starting while RRC is in connected mode. */
 			k_sem_reset(&entered_rrc_idle);
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+			/* Use the RRC connection to fetch assistance data, so that the modem
+			 * does not need to connect later only to download it.
+			 */
+			if (gnss_used && !running) {
+				k_work_submit_to_queue(location_core_work_queue_get(),
+						       &method_gnss_prefetch_work);
+			}
+#endif
 		} else if (evt->rrc_mode == LTE_LC_RRC_MODE_IDLE) {
 			/* Allow GNSS operation once RRC is in idle mode. */
 			k_sem_give(&entered_rrc_idle);
@@ -503,9 +523,13 @@ static const char *get_system_string(uint8_t system_id)
  * has valid (and more accurate) ephemerides available. With longer prediction sets, the number of
  * satellite ephemerides in the later prediction periods decreases due to accumulated errors,
  * so having almanacs may be beneficial.
+ *
+ * Returns true if A-GNSS data or P-GPS predictions were requested.
  */
-static void method_gnss_assistance_request(void)
+static bool method_gnss_assistance_request(void)
 {
+	bool requested = false;
+
 #if defined(CONFIG_NRF_CLOUD_PGPS)
 	/* GPS ephemerides come from P-GPS. */
 	pgps_agnss_request.system[0].sv_mask_ephe = agnss_request.system[0].sv_mask_ephe;
@@ -599,6 +623,7 @@ static void method_gnss_assistance_request(void)
 #else
 		method_gnss_nrf_cloud_agnss_request();
 #endif
+		requested = true;
 	}
 #endif /* CONFIG_NRF_CLOUD_AGNSS */
 
@@ -612,9 +637,13 @@ static void method_gnss_assistance_request(void)
 
 		if (err) {
 			LOG_ERR("Failed to request prediction, error: %d", err);
+		} else {
+			requested = true;
 		}
 	}
 #endif /* CONFIG_NRF_CLOUD_PGPS */
+
+	return requested;
 }
 #endif /* defined(CONFIG_NRF_CLOUD_AGNSS) || defined(CONFIG_NRF_CLOUD_PGPS) */
 
@@ -1139,7 +1168,7 @@ static void method_gnss_agnss_expiry_process(const struct nrf_modem_gnss_agnss_e
 }
 
 /* Queries assistance data need from GNSS. */
-static void method_gnss_assistance_data_need_get(void)
+static int method_gnss_assistance_data_need_get(void)
 {
 	int err;
 	struct nrf_modem_gnss_agnss_expiry agnss_expiry;
@@ -1147,13 +1176,64 @@ static void method_gnss_assistance_data_need_get(void)
 	err = nrf_modem_gnss_agnss_expiry_get(&agnss_expiry);
 	if (err) {
 		LOG_ERR("nrf_modem_gnss_agnss_expiry_get() failed, error: %d", err);
-		return;
+		return err;
 	}
 
 	method_gnss_agnss_expiry_process(&agnss_expiry);
+
+	return 0;
+}
+
+/* Checks whether the assistance data need stored into 'agnss_request' contains anything. QZSS is
+ * not checked, because GNSS reports unused QZSS satellites always as expired.
+ */
+static bool method_gnss_assistance_data_needed(void)
+{
+	return agnss_request.data_flags != 0 ||
+	       agnss_request.system[0].sv_mask_ephe != 0 ||
+	       agnss_request.system[0].sv_mask_alm != 0;
 }
+
+void method_gnss_assistance_stats_get(struct location_gnss_assistance_stats *stats)
+{
+	stats->fresh_starts = atomic_get(&stats_fresh_starts);
+	stats->stale_starts = atomic_get(&stats_stale_starts);
+	stats->prefetches = atomic_get(&stats_prefetches);
+}
+#endif
+
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+static void method_gnss_prefetch_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (running) {
+		/* Assistance data is handled by the ongoing location request. */
+		return;
+	}
+
+#if defined(CONFIG_NRF_CLOUD_PGPS)
+	method_gnss_pgps_init();
 #endif
 
+	if (method_gnss_assistance_data_need_get() != 0) {
+		return;
+	}
+
+	if (!method_gnss_assistance_data_needed()) {
+		LOG_DBG("Assistance data valid, nothing to prefetch");
+		return;
+	}
+
+	LOG_DBG("Prefetching assistance data");
+
+	/* Requests may be skipped, for example, due to the minimum A-GNSS request interval */
+	if (method_gnss_assistance_request()) {
+		atomic_inc(&stats_prefetches);
+	}
+}
+#endif /* CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH */
+
 static void method_gnss_prepare_work_fn(struct k_work *work)
 {
 #if defined(CONFIG_NRF_CLOUD_AGNSS) || defined(CONFIG_NRF_CLOUD_PGPS)
@@ -1164,7 +1244,13 @@ static void method_gnss_prepare_work_fn(struct k_work *work)
 	method_gnss_pgps_init();
 #endif
 
-	method_gnss_assistance_data_need_get();
+	if (method_gnss_assistance_data_need_get() == 0) {
+		if (method_gnss_assistance_data_needed()) {
+			atomic_inc(&stats_stale_starts);
+		} else {
+			atomic_inc(&stats_fresh_starts);
+		}
+	}
 
 	/* Request assistance data if needed. */
 	method_gnss_assistance_request();
@@ -1274,6 +1360,9 @@ int method_gnss_location_get(const struct location_request_info *request)
 	}
 
 	running = true;
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	gnss_used = true;
+#endif
 
 	k_work_submit_to_queue(location_core_work_queue_get(), &method_gnss_prepare_work);
 
@@ -1301,6 +1390,9 @@ int method_gnss_init(void)
 	k_work_init(&method_gnss_pvt_work, method_gnss_pvt_work_fn);
 	k_work_init(&method_gnss_prepare_work, method_gnss_prepare_work_fn);
 	k_work_init(&method_gnss_start_work, method_gnss_start_work_fn);
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	k_work_init(&method_gnss_prefetch_work, method_gnss_prefetch_work_fn);
+#endif
 
 #if defined(CONFIG_NRF_CLOUD_PGPS)
 #if defined(CONFIG_LOCATION_SERVICE_EXTERNAL)
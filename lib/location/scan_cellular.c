@@ -38,6 +38,10 @@ static struct lte_lc_cells_info scan_cellular_info = {
 
 static volatile bool running;
 static volatile bool timeout_occurred;
+/* GCI searches have been started, that is, the normal neighbor search is done. */
+static volatile bool gci_search_started;
+/* GCI searches are not needed anymore. */
+static volatile bool gci_search_stopped;
 /* Indicates when individual ncellmeas operation is completed. This is internal to this file. */
 static struct k_sem scan_cellular_sem_ncellmeas_evt;
 
@@ -50,6 +54,12 @@ K_WORK_DELAYABLE_DEFINE(scan_cellular_timeout_work, scan_cellular_timeout_work_f
 /** Semaphore for waiting for RRC idle mode. */
 static K_SEM_DEFINE(entered_rrc_idle, 1, 1);
 
+/**
+ * Semaphore given when RRC idle mode is entered, or the wait for it is to be stopped.
+ * Unlike resetting entered_rrc_idle, giving it also stops a wait that starts later.
+ */
+static K_SEM_DEFINE(rrc_idle_wait_done, 0, 1);
+
 /**
  * Handler for backup timeout, which ensures we won't be waiting for LTE_LC_EVT_NEIGHBOR_CELL_MEAS
  * event forever after lte_lc_neighbor_cell_measurement_cancel() in case it would never be sent.
@@ -132,6 +142,7 @@ void scan_cellular_lte_ind_handler(const struct lte_lc_evt *const evt)
 		} else if (evt->rrc_mode == LTE_LC_RRC_MODE_IDLE) {
 			/* Allow GCI search operation once RRC is in idle mode. */
 			k_sem_give(&entered_rrc_idle);
+			k_sem_give(&rrc_idle_wait_done);
 		}
 		break;
 	default:
@@ -150,6 +161,8 @@ void scan_cellular_execute(int32_t timeout, uint8_t cell_count)
 
 	running = true;
 	timeout_occurred = false;
+	gci_search_started = false;
+	gci_search_stopped = false;
 	scan_cellular_info.current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 	scan_cellular_info.ncells_count = 0;
 	scan_cellular_info.gci_cells_count = 0;
@@ -188,6 +201,16 @@ void scan_cellular_execute(int32_t timeout, uint8_t cell_count)
 		goto end;
 	}
 
+	gci_search_started = true;
+	k_sem_reset(&rrc_idle_wait_done);
+	if (!running) {
+		goto end;
+	}
+	if (gci_search_stopped) {
+		LOG_DBG("GCI searches are not needed");
+		goto end;
+	}
+
 	/* GCI searches are not done when in RRC connected mode. We are waiting for
 	 * device to enter RRC idle mode unless it's there already.
 	 */
@@ -195,17 +218,18 @@ void scan_cellular_execute(int32_t timeout, uint8_t cell_count)
 		"Waiting for the RRC connection release..." :
 		"RRC already in idle mode");
 
-	if (k_sem_take(&entered_rrc_idle, K_SECONDS(SCAN_CELLULAR_RRC_IDLE_WAIT_TIME)) != 0) {
-		/* If semaphore is reset while waiting, the position request was canceled */
-		if (!running) {
-			goto end;
-		}
+	if (k_sem_count_get(&entered_rrc_idle) == 0 &&
+	    k_sem_take(&rrc_idle_wait_done, K_SECONDS(SCAN_CELLULAR_RRC_IDLE_WAIT_TIME)) != 0) {
 		/* The wait for RRC idle timed out */
 		LOG_WRN("RRC connection was not released in %d seconds.",
 			SCAN_CELLULAR_RRC_IDLE_WAIT_TIME);
 		goto end;
 	}
-	k_sem_give(&entered_rrc_idle);
+
+	/* The position request may have been canceled or GCI searches stopped while waiting */
+	if (!running || gci_search_stopped) {
+		goto end;
+	}
 
 	/*****
 	 * 2nd: GCI history search to get GCI cells we can quickly search and measure.
@@ -238,6 +262,11 @@ void scan_cellular_execute(int32_t timeout, uint8_t cell_count)
 		goto end;
 	}
 
+	if (gci_search_stopped) {
+		LOG_DBG("GCI searches stopped after 2nd neighbor measurement");
+		goto end;
+	}
+
 	/* If we received already enough GCI cells including current cell */
 	if (scan_cellular_info.gci_cells_count + 1 >= cell_count) {
 		goto end;
@@ -265,13 +294,37 @@ void scan_cellular_execute(int32_t timeout, uint8_t cell_count)
 
 end:
 	k_work_cancel_delayable(&scan_cellular_timeout_work);
+	k_work_cancel_delayable(&scan_cellular_timeout_backup_work);
 	running = false;
 }
 
-int scan_cellular_cancel(void)
+void scan_cellular_gci_search_stop(void)
 {
-	int rrc_idling;
+	if (!running || gci_search_stopped) {
+		return;
+	}
+
+	gci_search_stopped = true;
 
+	if (!gci_search_started) {
+		/* The normal neighbor search is still ongoing, GCI searches won't be started */
+		return;
+	}
+
+	LOG_DBG("Stopping GCI searches");
+
+	/* Stop waiting for RRC idle mode, like in scan_cellular_cancel() */
+	if (!k_sem_count_get(&entered_rrc_idle)) {
+		k_sem_give(&rrc_idle_wait_done);
+	} else {
+		/* Cell measurements found so far are sent in the NCELLMEAS notification */
+		(void)lte_lc_neighbor_cell_measurement_cancel();
+		k_work_schedule(&scan_cellular_timeout_backup_work, K_MSEC(2000));
+	}
+}
+
+int scan_cellular_cancel(void)
+{
 	if (running) {
 		/* Cancel/stopping might trigger a NCELLMEAS notification */
 		(void)lte_lc_neighbor_cell_measurement_cancel();
@@ -282,15 +335,11 @@ int scan_cellular_cancel(void)
 
 	running = false;
 
-	/* If we are currently in RRC connected mode, reset the semaphore to unblock
-	 * scan_cellular_execute() and allow the ongoing location request to terminate.
-	 * Otherwise, don't reset the semaphore in order not to lose information about the current
-	 * RRC state.
+	/* Stop waiting for RRC idle mode to unblock scan_cellular_execute() and allow the ongoing
+	 * location request to terminate. The semaphore for the RRC state is not touched in order
+	 * not to lose information about the current RRC state.
 	 */
-	rrc_idling = k_sem_count_get(&entered_rrc_idle);
-	if (!rrc_idling) {
-		k_sem_reset(&entered_rrc_idle);
-	}
+	k_sem_give(&rrc_idle_wait_done);
 
 	return 0;
 }
@@ -10,8 +10,12 @@
 #include <modem/location.h>
 #include <net/wifi_location_common.h>
 
+/** Called when a Wi-Fi scan is done, with the number of access points found. */
+typedef void (*scan_wifi_done_cb_t)(uint16_t ap_count);
+
 int scan_wifi_init(void);
-void scan_wifi_execute(int32_t timeout, struct k_sem *wifi_scan_ready);
+void scan_wifi_execute(int32_t timeout, struct k_sem *wifi_scan_ready,
+		       scan_wifi_done_cb_t done_cb);
 struct wifi_scan_info *scan_wifi_results_get(void);
 int scan_wifi_cancel(void);
 #if defined(CONFIG_LOCATION_DATA_DETAILS)
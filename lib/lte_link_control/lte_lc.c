@@ -17,6 +17,7 @@
 #include <modem/lte_lc_trace.h>
 #include <modem/at_cmd_parser.h>
 #include <modem/at_params.h>
+#include <modem/at_schema.h>
 #include <modem/at_monitor.h>
 #include <modem/nrf_modem_lib.h>
 #include <zephyr/logging/log.h>
@@ -626,42 +627,60 @@ static void at_handler_mdmev(const char *response)
 static int enable_notifications(void)
 {
 	int err;
+	int xt3412_idx = -1;
+	int xmodemsleep_idx = -1;
+	struct at_batch batch;
+
+	/* The subscriptions are sent as one batch. If CONFIG_LTE_LC_AT_CMD_CACHE is enabled, the
+	 * ones that are still active since the previous call are skipped.
+	 */
+	at_batch_init(&batch);
 
 	/* +CEREG notifications, level 5 */
-	err = nrf_modem_at_printf(AT_CEREG_5);
-	if (err) {
-		LOG_ERR("Failed to subscribe to CEREG notifications, error: %d", err);
-		return -EFAULT;
-	}
+	err = at_batch_add(&batch, AT_BATCH_FLAG_IDEMPOTENT, AT_CEREG_5);
 
-	if (IS_ENABLED(CONFIG_LTE_LC_TAU_PRE_WARNING_NOTIFICATIONS)) {
-		err = nrf_modem_at_printf(AT_XT3412_SUB,
+	if (err >= 0 && IS_ENABLED(CONFIG_LTE_LC_TAU_PRE_WARNING_NOTIFICATIONS)) {
+		xt3412_idx = at_batch_add(&batch, AT_BATCH_FLAG_IDEMPOTENT | AT_BATCH_FLAG_OPTIONAL,
+					  AT_XT3412_SUB,
 					  CONFIG_LTE_LC_TAU_PRE_WARNING_TIME_MS,
 					  CONFIG_LTE_LC_TAU_PRE_WARNING_THRESHOLD_MS);
-		if (err) {
-			LOG_WRN("Enabling TAU pre-warning notifications failed, error: %d", err);
-			LOG_WRN("TAU pre-warning notifications require nRF9160 modem >= v1.3.0");
-		}
+		err = xt3412_idx;
 	}
 
-	if (IS_ENABLED(CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS)) {
+	if (err >= 0 && IS_ENABLED(CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS)) {
 		/* %XMODEMSLEEP notifications subscribe */
-		err = nrf_modem_at_printf(AT_XMODEMSLEEP_SUB,
-					  CONFIG_LTE_LC_MODEM_SLEEP_PRE_WARNING_TIME_MS,
-					  CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS_THRESHOLD_MS);
-		if (err) {
-			LOG_WRN("Enabling modem sleep notifications failed, error: %d", err);
-			LOG_WRN("Modem sleep notifications require nRF9160 modem >= v1.3.0");
-		}
+		xmodemsleep_idx = at_batch_add(
+			&batch, AT_BATCH_FLAG_IDEMPOTENT | AT_BATCH_FLAG_OPTIONAL,
+			AT_XMODEMSLEEP_SUB,
+			CONFIG_LTE_LC_MODEM_SLEEP_PRE_WARNING_TIME_MS,
+			CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS_THRESHOLD_MS);
+		err = xmodemsleep_idx;
+	}
+
+	if (err >= 0) {
+		/* +CSCON notifications */
+		err = at_batch_add(&batch, AT_BATCH_FLAG_IDEMPOTENT, cscon);
 	}
 
-	/* +CSCON notifications */
-	err = nrf_modem_at_printf(cscon);
+	if (err < 0) {
+		LOG_ERR("Failed to create notification subscriptions, error: %d", err);
+		return -EFAULT;
+	}
+
+	err = at_batch_submit(&batch);
 	if (err) {
-		LOG_WRN("Failed to enable RRC notifications (+CSCON), error %d", err);
+		LOG_ERR("Failed to subscribe to notifications, error: %d", err);
 		return -EFAULT;
 	}
 
+	if (xt3412_idx >= 0 && batch.err[xt3412_idx]) {
+		LOG_WRN("TAU pre-warning notifications require nRF9160 modem >= v1.3.0");
+	}
+
+	if (xmodemsleep_idx >= 0 && batch.err[xmodemsleep_idx]) {
+		LOG_WRN("Modem sleep notifications require nRF9160 modem >= v1.3.0");
+	}
+
 	return 0;
 }
 
@@ -693,6 +712,9 @@ static int fallback_system_mode_set(void)
 		return -EINVAL;
 	}
 
+	/* Not skipped with CONFIG_LTE_LC_AT_CMD_CACHE, because other libraries and applications,
+	 * for example the LwM2M carrier library, also set the system mode.
+	 */
 	err = nrf_modem_at_printf("AT%%XSYSTEMMODE=%s,%c",
 				  system_mode_params[fallback_sys_mode],
 				  system_mode_preference[lte_lc_sys_mode_pref]);
@@ -817,7 +839,7 @@ exit:
 
 static int feaconf_write(enum feaconf_feat feat, bool state)
 {
-	return nrf_modem_at_printf("AT%%FEACONF=%d,%d,%u", FEACONF_OPER_WRITE, feat, state);
+	return at_cmd_idempotent_printf("AT%%FEACONF=%d,%d,%u", FEACONF_OPER_WRITE, feat, state);
 }
 
 /* Public API */
@@ -948,18 +970,20 @@ int lte_lc_psm_req(bool enable)
 	if (enable) {
 		if (strlen(requested_psm_param_rptau) == 8 &&
 		    strlen(requested_psm_param_rat) == 8) {
-			err = nrf_modem_at_printf("AT+CPSMS=1,,,\"%s\",\"%s\"",
-						  requested_psm_param_rptau,
-						  requested_psm_param_rat);
+			err = at_cmd_idempotent_printf("AT+CPSMS=1,,,\"%s\",\"%s\"",
+						       requested_psm_param_rptau,
+						       requested_psm_param_rat);
 		} else if (strlen(requested_psm_param_rptau) == 8) {
-			err = nrf_modem_at_printf("AT+CPSMS=1,,,\"%s\"", requested_psm_param_rptau);
+			err = at_cmd_idempotent_printf("AT+CPSMS=1,,,\"%s\"",
+						       requested_psm_param_rptau);
 		} else if (strlen(requested_psm_param_rat) == 8) {
-			err = nrf_modem_at_printf("AT+CPSMS=1,,,,\"%s\"", requested_psm_param_rat);
+			err = at_cmd_idempotent_printf("AT+CPSMS=1,,,,\"%s\"",
+						       requested_psm_param_rat);
 		} else {
-			err = nrf_modem_at_printf("AT+CPSMS=1");
+			err = at_cmd_idempotent_printf("AT+CPSMS=1");
 		}
 	} else {
-		err = nrf_modem_at_printf(psm_disable);
+		err = at_cmd_idempotent_printf(psm_disable);
 	}
 
 	if (err) {
@@ -970,29 +994,42 @@ int lte_lc_psm_req(bool enable)
 	return 0;
 }
 
+/* PSM timers in a %XMONITOR response */
+struct xmonitor_psm {
+	struct at_str_view active_time;
+	struct at_str_view tau_ext;
+	struct at_str_view tau_legacy;
+};
+
+/* %XMONITOR: <reg_status>,[<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,<cell_id>,
+ * <phys_cell_id>,<EARFCN>,<rsrp>,<snr>,<NW-provided_eDRX_value>,<Active-Time>,
+ * <Periodic-TAUext>,<Periodic-TAU>]
+ * We need to parse the three last parameters, Active-Time, Periodic-TAU-ext and
+ * Periodic-TAU.
+ */
+AT_SCHEMA_DEFINE(xmonitor_psm_schema, "%XMONITOR",
+	AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP, AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD(STR, struct xmonitor_psm, active_time),
+	AT_SCHEMA_FIELD(STR, struct xmonitor_psm, tau_ext),
+	AT_SCHEMA_FIELD(STR, struct xmonitor_psm, tau_legacy));
+
 int lte_lc_psm_get(int *tau, int *active_time)
 {
 	int err;
 	struct lte_lc_psm_cfg psm_cfg;
-	char active_time_str[9] = {0};
-	char tau_ext_str[9] = {0};
-	char tau_legacy_str[9] = {0};
+	struct xmonitor_psm timers = { 0 };
+	char active_time_str[9];
+	char tau_ext_str[9];
+	char tau_legacy_str[9];
 	static char response[160] = { 0 };
-	const char ch = ',';
-	char *comma_ptr;
 
 	if ((tau == NULL) || (active_time == NULL)) {
 		return -EINVAL;
 	}
 
-	/* Format of XMONITOR AT command response:
-	 * %XMONITOR: <reg_status>,[<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,<cell_id>,
-	 * <phys_cell_id>,<EARFCN>,<rsrp>,<snr>,<NW-provided_eDRX_value>,<Active-Time>,
-	 * <Periodic-TAUext>,<Periodic-TAU>]
-	 * We need to parse the three last parameters, Active-Time, Periodic-TAU-ext and
-	 * Periodic-TAU.
-	 */
-
 	response[0] = '\0';
 
 	err = nrf_modem_at_cmd(response, sizeof(response), "AT%%XMONITOR");
@@ -1001,8 +1038,13 @@ int lte_lc_psm_get(int *tau, int *active_time)
 		return -EFAULT;
 	}
 
-	comma_ptr = strchr(response, ch);
-	if (!comma_ptr) {
+	err = at_schema_parse(&xmonitor_psm_schema, response, &timers, NULL, NULL);
+	if (err) {
+		LOG_ERR("AT command parsing failed, error: %d", err);
+		return -EBADMSG;
+	}
+
+	if (!timers.active_time.ptr && !timers.tau_ext.ptr && !timers.tau_legacy.ptr) {
 		/* Not an AT error, thus must be that just a <reg_status> received:
 		 * optional part is included in a response only when <reg_status> is 1 or 5.
 		 */
@@ -1010,42 +1052,9 @@ int lte_lc_psm_get(int *tau, int *active_time)
 		return -EBADMSG;
 	}
 
-	/* Skip over first 13 fields in AT cmd response by counting delimiters (commas). */
-	for (int i = 0; i < 12; i++) {
-		if (comma_ptr) {
-			comma_ptr = strchr(comma_ptr + 1, ch);
-		} else {
-			LOG_ERR("AT command parsing failed");
-			return -EBADMSG;
-		}
-	}
-
-	/* The last three fields of AT response looks something like this:
-	 * ,"00011110","00000111","01001001"
-	 * comma_ptr now points the comma before Active-Time. Discard the comma and the quote mark,
-	 * hence + 2, and copy Active-Time into active_time_str. Find the next comma and repeat for
-	 * Periodic-TAU-ext and so forth.
-	 */
-
-	if (comma_ptr) {
-		strncpy(active_time_str, comma_ptr + 2, 8);
-	} else {
-		LOG_ERR("AT command parsing failed");
-		return -EBADMSG;
-	}
-
-	comma_ptr = strchr(comma_ptr + 1, ch);
-	if (comma_ptr) {
-		strncpy(tau_ext_str, comma_ptr + 2, 8);
-	} else {
-		LOG_ERR("AT command parsing failed");
-		return -EBADMSG;
-	}
-
-	comma_ptr = strchr(comma_ptr + 1, ch);
-	if (comma_ptr) {
-		strncpy(tau_legacy_str, comma_ptr + 2, 8);
-	} else {
+	if (at_str_view_copy(&timers.active_time, active_time_str, sizeof(active_time_str)) ||
+	    at_str_view_copy(&timers.tau_ext, tau_ext_str, sizeof(tau_ext_str)) ||
+	    at_str_view_copy(&timers.tau_legacy, tau_legacy_str, sizeof(tau_legacy_str))) {
 		LOG_ERR("AT command parsing failed");
 		return -EBADMSG;
 	}
@@ -1296,6 +1305,9 @@ int lte_lc_system_mode_set(enum lte_lc_system_mode mode,
 		return -EINVAL;
 	}
 
+	/* Not skipped with CONFIG_LTE_LC_AT_CMD_CACHE, because other libraries and applications,
+	 * for example the LwM2M carrier library, also set the system mode.
+	 */
 	err = nrf_modem_at_printf("AT%%XSYSTEMMODE=%s,%c",
 				  system_mode_params[mode],
 				  system_mode_preference[preference]);
@@ -1904,6 +1916,9 @@ int lte_lc_reduced_mobility_set(enum lte_lc_reduced_mobility_mode mode)
 
 int lte_lc_factory_reset(enum lte_lc_factory_reset_type type)
 {
+	/* The reset reverts settings that may have been recorded as already set. */
+	at_batch_cache_clear();
+
 	return nrf_modem_at_printf("AT%%XFACTORYRESET=%d", type) ? -EFAULT : 0;
 }
 
@@ -10,10 +10,13 @@
 #include <zephyr/net/socket.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <zephyr/device.h>
+#include <nrf_modem_at.h>
 #include <modem/lte_lc.h>
 #include <modem/at_cmd_parser.h>
 #include <modem/at_params.h>
+#include <modem/at_schema.h>
 #include <zephyr/logging/log.h>
 
 #include "lte_lc_helpers.h"
@@ -130,31 +133,6 @@ void event_handler_list_dispatch(const struct lte_lc_evt *const evt)
 	k_mutex_unlock(&list_mtx);
 }
 
-
-/* Converts integer on string format to integer type.
- * Returns zero on success, otherwise negative error on failure.
- */
-static int string_param_to_int(struct at_param_list *resp_list,
-			       size_t idx, int *output, int base)
-{
-	int err;
-	char str_buf[16];
-	size_t len = sizeof(str_buf);
-
-	err = at_params_string_get(resp_list, idx, str_buf, &len);
-	if (err) {
-		return err;
-	}
-
-	str_buf[len] = '\0';
-
-	if (string_to_int(str_buf, base, output)) {
-		return -ENODATA;
-	}
-
-	return 0;
-}
-
 /* Get Paging Time Window multiplier for the LTE mode.
  * Multiplier is 1.28 s for LTE-M, and 2.56 s for NB-IoT, derived from
  * Figure 10.5.5.32/3GPP TS 24.008.
@@ -243,39 +221,6 @@ bool response_is_valid(const char *response, size_t response_len,
 	return true;
 }
 
-/* Get network registration status from CEREG response list.
- * Returns the (positive) registration value if it's found, otherwise a negative
- * error code.
- */
-static int get_nw_reg_status(struct at_param_list *list, bool is_notif)
-{
-	int err, reg_status;
-	size_t reg_status_index = is_notif ? AT_CEREG_REG_STATUS_INDEX :
-					     AT_CEREG_READ_REG_STATUS_INDEX;
-
-	err = at_params_int_get(list, reg_status_index, &reg_status);
-	if (err) {
-		return err;
-	}
-
-	/* Check if the parsed value maps to a valid registration status */
-	switch (reg_status) {
-	case LTE_LC_NW_REG_NOT_REGISTERED:
-	case LTE_LC_NW_REG_REGISTERED_HOME:
-	case LTE_LC_NW_REG_SEARCHING:
-	case LTE_LC_NW_REG_REGISTRATION_DENIED:
-	case LTE_LC_NW_REG_UNKNOWN:
-	case LTE_LC_NW_REG_REGISTERED_ROAMING:
-	case LTE_LC_NW_REG_UICC_FAIL:
-		break;
-	default:
-		LOG_ERR("Invalid network registration status: %d", reg_status);
-		return -EINVAL;
-	}
-
-	return reg_status;
-}
-
 int string_to_int(const char *str_buf, int base, int *output)
 {
 	int temp;
@@ -701,6 +646,43 @@ clean_exit:
 	return err;
 }
 
+/* Parameters of a +CEREG notification or AT+CEREG? response. The values of
+ * parameters that are not in the response are left untouched.
+ */
+struct cereg_params {
+	int32_t status;
+	uint32_t tac;
+	uint32_t cell_id;
+	int32_t act;
+	struct at_str_view active_time;
+	struct at_str_view tau_ext;
+};
+
+/* +CEREG: <stat>[,[<tac>],[<ci>],[<AcT>][,<cause_type>],[<reject_cause>][,[<Active-Time>],
+ * [<Periodic-TAU-ext>]]]]
+ */
+AT_SCHEMA_DEFINE(cereg_notif_schema, AT_CEREG_RESPONSE_PREFIX,
+	AT_SCHEMA_FIELD(INT, struct cereg_params, status),
+	AT_SCHEMA_FIELD(HEX, struct cereg_params, tac),
+	AT_SCHEMA_FIELD(HEX, struct cereg_params, cell_id),
+	AT_SCHEMA_FIELD(INT, struct cereg_params, act),
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD(STR, struct cereg_params, active_time),
+	AT_SCHEMA_FIELD(STR, struct cereg_params, tau_ext));
+
+/* Same as the notification, preceded by <n> */
+AT_SCHEMA_DEFINE(cereg_read_schema, AT_CEREG_RESPONSE_PREFIX,
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD(INT, struct cereg_params, status),
+	AT_SCHEMA_FIELD(HEX, struct cereg_params, tac),
+	AT_SCHEMA_FIELD(HEX, struct cereg_params, cell_id),
+	AT_SCHEMA_FIELD(INT, struct cereg_params, act),
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD(STR, struct cereg_params, active_time),
+	AT_SCHEMA_FIELD(STR, struct cereg_params, tau_ext));
+
 int parse_cereg(const char *at_response,
 		bool is_notif,
 		enum lte_lc_nw_reg_status *reg_status,
@@ -708,130 +690,72 @@ int parse_cereg(const char *at_response,
 		enum lte_lc_lte_mode *lte_mode,
 		struct lte_lc_psm_cfg *psm_cfg)
 {
-	int err, status;
-	struct at_param_list resp_list;
-	char str_buf[10];
-	char  response_prefix[sizeof(AT_CEREG_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	size_t len = sizeof(str_buf) - 1;
-
-	err = at_params_list_init(&resp_list, AT_CEREG_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse CEREG response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
-	if (err) {
-		LOG_ERR("Could not parse AT+CEREG response, error: %d", err);
-		goto clean_exit;
-	}
-
-	/* Check if AT command response starts with +CEREG */
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
-	}
+	int err;
+	struct cereg_params params = {
+		.status = -1,
+		.tac = LTE_LC_CELL_TAC_INVALID,
+		.cell_id = LTE_LC_CELL_EUTRAN_ID_INVALID,
+		.act = LTE_LC_LTE_MODE_NONE,
+	};
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_CEREG_RESPONSE_PREFIX)) {
+	/* Parse CEREG response directly into the parameters */
+	err = at_schema_parse(is_notif ? &cereg_notif_schema : &cereg_read_schema,
+			      at_response, &params, NULL, NULL);
+	if (err == -ENOMSG) {
 		/* The unsolicited response is not a CEREG response, ignore it.
 		 */
 		LOG_DBG("Not a valid CEREG response");
-		goto clean_exit;
+		return 0;
+	} else if (err) {
+		LOG_ERR("Could not parse AT+CEREG response, error: %d", err);
+		return err;
 	}
 
-	/* Get network registration status */
-	status = get_nw_reg_status(&resp_list, is_notif);
-	if (status < 0) {
-		LOG_ERR("Could not get registration status, error: %d", status);
-		err = status;
-		goto clean_exit;
+	/* Check if the parsed value maps to a valid registration status */
+	switch (params.status) {
+	case LTE_LC_NW_REG_NOT_REGISTERED:
+	case LTE_LC_NW_REG_REGISTERED_HOME:
+	case LTE_LC_NW_REG_SEARCHING:
+	case LTE_LC_NW_REG_REGISTRATION_DENIED:
+	case LTE_LC_NW_REG_UNKNOWN:
+	case LTE_LC_NW_REG_REGISTERED_ROAMING:
+	case LTE_LC_NW_REG_UICC_FAIL:
+		break;
+	default:
+		LOG_ERR("Invalid network registration status: %d", params.status);
+		return -EINVAL;
 	}
 
 	if (reg_status) {
-		*reg_status = status;
+		*reg_status = params.status;
 
 		LOG_DBG("Network registration status: %d", *reg_status);
 	}
 
-
-	if (cell && (status != LTE_LC_NW_REG_UICC_FAIL) &&
-	    (at_params_valid_count_get(&resp_list) > AT_CEREG_CELL_ID_INDEX)) {
-		/* Parse tracking area code */
-		err = at_params_string_get(
-				&resp_list,
-				is_notif ? AT_CEREG_TAC_INDEX :
-					   AT_CEREG_READ_TAC_INDEX,
-				str_buf, &len);
-		if (err) {
-			LOG_DBG("Could not get tracking area code, error: %d", err);
-			cell->tac = LTE_LC_CELL_TAC_INVALID;
-		} else {
-			str_buf[len] = '\0';
-			cell->tac = strtoul(str_buf, NULL, 16);
-		}
-
-		/* Parse cell ID */
-		len = sizeof(str_buf) - 1;
-
-		err = at_params_string_get(&resp_list,
-				is_notif ? AT_CEREG_CELL_ID_INDEX :
-					   AT_CEREG_READ_CELL_ID_INDEX,
-				str_buf, &len);
-		if (err) {
-			LOG_DBG("Could not get cell ID, error: %d", err);
-			cell->id = LTE_LC_CELL_EUTRAN_ID_INVALID;
-		} else {
-			str_buf[len] = '\0';
-			cell->id = strtoul(str_buf, NULL, 16);
-		}
+	if (cell && (params.status != LTE_LC_NW_REG_UICC_FAIL)) {
+		cell->tac = params.tac;
+		cell->id = params.cell_id;
 	} else if (cell) {
 		cell->tac = LTE_LC_CELL_TAC_INVALID;
 		cell->id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 	}
 
 	if (lte_mode) {
-		int mode;
+		/* It's expected in some situations that LTE mode is not available. */
+		*lte_mode = params.act;
 
-		/* Get currently active LTE mode. */
-		err = at_params_int_get(&resp_list,
-				is_notif ? AT_CEREG_ACT_INDEX :
-					   AT_CEREG_READ_ACT_INDEX,
-				&mode);
-		if (err) {
-			LOG_DBG("LTE mode not found, error code: %d", err);
-			*lte_mode = LTE_LC_LTE_MODE_NONE;
-
-			/* This is not an error that should be returned, as it's
-			 * expected in some situations that LTE mode is not
-			 * available.
-			 */
-			err = 0;
-		} else {
-			*lte_mode = mode;
-
-			LOG_DBG("LTE mode: %d", *lte_mode);
-		}
+		LOG_DBG("LTE mode: %d", *lte_mode);
 	}
 
 	/* Check PSM parameters only if we are connected */
-	if ((*reg_status != LTE_LC_NW_REG_REGISTERED_HOME) &&
-	    (*reg_status != LTE_LC_NW_REG_REGISTERED_ROAMING)) {
-		goto clean_exit;
+	if ((params.status != LTE_LC_NW_REG_REGISTERED_HOME) &&
+	    (params.status != LTE_LC_NW_REG_REGISTERED_ROAMING)) {
+		return 0;
 	}
 
 	if (psm_cfg != NULL) {
-		char active_time_str[9] = {0};
-		char tau_ext_str[9] = {0};
-		int str_len = 8;
+		char active_time_str[9];
+		char tau_ext_str[9];
 		int err_active_time;
 		int err_tau;
 
@@ -839,11 +763,8 @@ int parse_cereg(const char *at_response,
 		psm_cfg->tau = -1;
 
 		/* Get active time */
-		err_active_time = at_params_string_get(
-				&resp_list,
-				is_notif ? AT_CEREG_ACTIVE_TIME_INDEX :
-					   AT_CEREG_READ_ACTIVE_TIME_INDEX,
-				active_time_str, &str_len);
+		err_active_time = at_str_view_copy(&params.active_time, active_time_str,
+						   sizeof(active_time_str));
 		if (err_active_time) {
 			LOG_DBG("Active time not found, error: %d", err_active_time);
 		} else {
@@ -851,11 +772,7 @@ int parse_cereg(const char *at_response,
 		}
 
 		/* Get Periodic-TAU-ext */
-		err_tau = at_params_string_get(
-				&resp_list,
-				is_notif ? AT_CEREG_TAU_INDEX :
-					   AT_CEREG_READ_TAU_INDEX,
-				tau_ext_str, &str_len);
+		err_tau = at_str_view_copy(&params.tau_ext, tau_ext_str, sizeof(tau_ext_str));
 		if (err_tau) {
 			LOG_DBG("TAU not found, error: %d", err_tau);
 		} else {
@@ -875,13 +792,9 @@ int parse_cereg(const char *at_response,
 		/* The notification does not always contain PSM parameters,
 		 * so this is not considered an error
 		 */
-		err = 0;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_xt3412(const char *at_response, uint64_t *time)
@@ -944,282 +857,257 @@ uint32_t neighborcell_count_get(const char *at_response)
 	return ncell_count;
 }
 
-/* Parse NCELLMEAS notification and put information into struct lte_lc_cells_info.
- *
- * Returns 0 on successful cell measurements and population of struct.
- *	     The current cell information is valid if the current cell ID is
- *	     not set to LTE_LC_CELL_EUTRAN_ID_INVALID.
- *	     The ncells_count indicates how many neighbor cells were parsed
- *	     into the neighbor_cells array.
- * Returns 1 on measurement failure
- * Returns -E2BIG if not all cells were parsed due to memory limitations
- * Returns otherwise a negative error code.
+/* Parameters of a cell in a %NCELLMEAS notification. The status is only used by
+ * the first schema of a notification.
  */
-int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
-{
-	int err, status, tmp, len;
-	struct at_param_list resp_list;
-	char  response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	char tmp_str[7];
-	bool incomplete = false;
-	/* Count the actual number of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
-	 * 3 is added to account for the parameters that do not have a trailng
-	 * comma.
-	 */
-	size_t param_count = get_char_frequency(at_response, ',') + 3;
-
-	cells->ncells_count = 0;
-	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
-
-	err = at_params_list_init(&resp_list, param_count);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
-	if (err && err != -E2BIG) {
-		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		incomplete = true;
-	}
+struct ncellmeas_cell_params {
+	int32_t status;
+	uint32_t id;
+	struct at_str_view plmn;
+	uint32_t tac;
+	int32_t timing_advance;
+	int64_t timing_advance_meas_time;
+	int32_t earfcn;
+	int32_t phys_cell_id;
+	int32_t rsrp;
+	int32_t rsrq;
+	int64_t measurement_time;
+	int32_t serving;
+	int32_t neighbor_count;
+};
 
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
-	}
+/* Parameters of a neighbor cell in a %NCELLMEAS notification */
+struct ncellmeas_ncell_params {
+	int32_t earfcn;
+	int32_t phys_cell_id;
+	int32_t rsrp;
+	int32_t rsrq;
+	int32_t time_diff;
+};
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
-		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
-		LOG_DBG("Not a valid NCELLMEAS response");
-		goto clean_exit;
-	}
+/* %NCELLMEAS: <status>[,<cell_id>,<plmn>,<tac>,<timing_advance>,<current_earfcn>,
+ * <current_phys_cell_id>,<current_rsrp>,<current_rsrq>,<measurement_time>,...]
+ */
+AT_SCHEMA_DEFINE(ncellmeas_schema, AT_NCELLMEAS_RESPONSE_PREFIX,
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, status),
+	AT_SCHEMA_FIELD(HEX, struct ncellmeas_cell_params, id),
+	AT_SCHEMA_FIELD(STR, struct ncellmeas_cell_params, plmn),
+	AT_SCHEMA_FIELD(HEX, struct ncellmeas_cell_params, tac),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, timing_advance),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, earfcn),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, phys_cell_id),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, rsrp),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, rsrq),
+	AT_SCHEMA_FIELD(INT64, struct ncellmeas_cell_params, measurement_time));
+
+/* [,<n_earfcn>,<n_phys_cell_id>,<n_rsrp>,<n_rsrq>,<time_diff>], once for each neighbor cell */
+AT_SCHEMA_DEFINE(ncellmeas_ncell_schema, NULL,
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_ncell_params, earfcn),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_ncell_params, phys_cell_id),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_ncell_params, rsrp),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_ncell_params, rsrq),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_ncell_params, time_diff));
+
+/* [,<timing_advance_measurement_time>], after the neighbor cells */
+AT_SCHEMA_DEFINE(ncellmeas_ta_meas_time_schema, NULL,
+	AT_SCHEMA_FIELD(INT64, struct ncellmeas_cell_params, timing_advance_meas_time));
+
+/* %NCELLMEAS: <status>, followed by the cells of a GCI search */
+AT_SCHEMA_DEFINE(ncellmeas_gci_status_schema, AT_NCELLMEAS_RESPONSE_PREFIX,
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, status));
+
+/* ,<cell_id>,<plmn>,<tac>,<ta>,<ta_meas_time>,<earfcn>,<phys_cell_id>,<rsrp>,<rsrq>,
+ * <meas_time>,<serving>,<neighbor_count>, once for each cell of a GCI search
+ */
+AT_SCHEMA_DEFINE(ncellmeas_gci_cell_schema, NULL,
+	AT_SCHEMA_FIELD(HEX, struct ncellmeas_cell_params, id),
+	AT_SCHEMA_FIELD(STR, struct ncellmeas_cell_params, plmn),
+	AT_SCHEMA_FIELD(HEX, struct ncellmeas_cell_params, tac),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, timing_advance),
+	AT_SCHEMA_FIELD(INT64, struct ncellmeas_cell_params, timing_advance_meas_time),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, earfcn),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, phys_cell_id),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, rsrp),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, rsrq),
+	AT_SCHEMA_FIELD(INT64, struct ncellmeas_cell_params, measurement_time),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, serving),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas_cell_params, neighbor_count));
+
+/* Parse the next group of parameters of a %NCELLMEAS notification, all of which are
+ * mandatory.
+ */
+static int ncellmeas_group_parse(const struct at_schema *schema, const char *str, void *out,
+				 const char **next)
+{
+	uint32_t present;
+	int err;
 
-	/* Status code. */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_STATUS_INDEX, &status);
+	err = at_schema_parse(schema, str, out, &present, next);
 	if (err) {
-		goto clean_exit;
-	}
-
-	if (status != AT_NCELLMEAS_STATUS_VALUE_SUCCESS) {
-		err = 1;
-		goto clean_exit;
+		return err;
 	}
 
-	/* Current cell ID. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_CELL_ID_INDEX, &tmp, 16);
-	if (err) {
-		goto clean_exit;
+	if (present != BIT_MASK(schema->field_count)) {
+		return -EINVAL;
 	}
 
-	if (tmp > LTE_LC_CELL_EUTRAN_ID_MAX) {
-		tmp = LTE_LC_CELL_EUTRAN_ID_INVALID;
-	}
-	cells->current_cell.id = tmp;
+	return 0;
+}
 
-	/* PLMN */
-	len = sizeof(tmp_str);
+static int ncellmeas_cell_get(const struct ncellmeas_cell_params *params,
+			      struct lte_lc_cell *cell)
+{
+	char plmn[7];
+	int err;
 
-	err = at_params_string_get(&resp_list, AT_NCELLMEAS_PLMN_INDEX,
-				   tmp_str, &len);
-	if (err) {
-		goto clean_exit;
+	err = at_str_view_copy(&params->plmn, plmn, sizeof(plmn));
+	if (err || params->plmn.len <= 3) {
+		return -EINVAL;
 	}
 
-	tmp_str[len] = '\0';
-
 	/* Read MNC and store as integer. The MNC starts as the fourth character
 	 * in the string, following three characters long MCC.
 	 */
-	err = string_to_int(&tmp_str[3], 10, &cells->current_cell.mnc);
+	err = string_to_int(&plmn[3], 10, &cell->mnc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Null-terminated MCC, read and store it. */
-	tmp_str[3] = '\0';
-
-	err = string_to_int(tmp_str, 10, &cells->current_cell.mcc);
-	if (err) {
-		goto clean_exit;
-	}
+	plmn[3] = '\0';
 
-	/* Tracking area code. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_TAC_INDEX, &tmp, 16);
+	err = string_to_int(plmn, 10, &cell->mcc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	cells->current_cell.tac = tmp;
-
-	/* Timing advance */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_TIMING_ADV_INDEX,
-				&tmp);
-	if (err) {
-		goto clean_exit;
+	if (params->id > LTE_LC_CELL_EUTRAN_ID_MAX) {
+		cell->id = LTE_LC_CELL_EUTRAN_ID_INVALID;
+	} else {
+		cell->id = params->id;
 	}
 
-	cells->current_cell.timing_advance = tmp;
+	cell->tac = params->tac;
+	cell->timing_advance = params->timing_advance;
+	cell->timing_advance_meas_time = params->timing_advance_meas_time;
+	cell->earfcn = params->earfcn;
+	cell->phys_cell_id = params->phys_cell_id;
+	cell->rsrp = params->rsrp;
+	cell->rsrq = params->rsrq;
+	cell->measurement_time = params->measurement_time;
 
-	/* EARFCN */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_EARFCN_INDEX,
-				&cells->current_cell.earfcn);
-	if (err) {
-		goto clean_exit;
-	}
+	return 0;
+}
 
-	/* Physical cell ID. */
-	err = at_params_short_get(&resp_list, AT_NCELLMEAS_PHYS_CELL_ID_INDEX,
-				&cells->current_cell.phys_cell_id);
-	if (err) {
-		goto clean_exit;
-	}
+static void ncellmeas_ncell_get(const struct ncellmeas_ncell_params *params,
+				struct lte_lc_ncell *ncell)
+{
+	ncell->earfcn = params->earfcn;
+	ncell->phys_cell_id = params->phys_cell_id;
+	ncell->rsrp = params->rsrp;
+	ncell->rsrq = params->rsrq;
+	ncell->time_diff = params->time_diff;
+}
 
-	/* RSRP */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRP_INDEX, &tmp);
-	if (err) {
-		goto clean_exit;
-	}
+/* Parse NCELLMEAS notification and put information into struct lte_lc_cells_info.
+ *
+ * Returns 0 on successful cell measurements and population of struct.
+ *	     The current cell information is valid if the current cell ID is
+ *	     not set to LTE_LC_CELL_EUTRAN_ID_INVALID.
+ *	     The ncells_count indicates how many neighbor cells were parsed
+ *	     into the neighbor_cells array.
+ * Returns 1 on measurement failure
+ * Returns otherwise a negative error code.
+ */
+int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
+{
+	struct ncellmeas_cell_params params = {0};
+	struct ncellmeas_ncell_params ncell;
+	uint32_t ncells_count;
+	uint32_t present = 0;
+	const char *next;
+	int err;
 
-	cells->current_cell.rsrp = tmp;
+	cells->ncells_count = 0;
+	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 
-	/* RSRQ */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRQ_INDEX, &tmp);
-	if (err) {
-		goto clean_exit;
+	err = at_schema_parse(&ncellmeas_schema, at_response, &params, &present, &next);
+	if (err == -ENOMSG) {
+		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
+		LOG_DBG("Not a valid NCELLMEAS response");
+		return 0;
+	} else if (err) {
+		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
+		return err;
 	}
 
-	cells->current_cell.rsrq = tmp;
-
-	/* Measurement time. */
-	err = at_params_int64_get(&resp_list, AT_NCELLMEAS_MEASUREMENT_TIME_INDEX,
-				  &cells->current_cell.measurement_time);
-	if (err) {
-		goto clean_exit;
+	if (!(present & BIT(0))) {
+		return -EINVAL;
 	}
 
-	/* Neighbor cell count. */
-	cells->ncells_count = neighborcell_count_get(at_response);
-
-	/* Starting from modem firmware v1.3.1, timing advance measurement time
-	 * information is added as the last parameter in the response.
-	 */
-	size_t ta_meas_time_index = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-			cells->ncells_count * AT_NCELLMEAS_N_PARAMS_COUNT;
-
-	if (at_params_valid_count_get(&resp_list) > ta_meas_time_index) {
-		err = at_params_int64_get(&resp_list, ta_meas_time_index,
-					  &cells->current_cell.timing_advance_meas_time);
-		if (err) {
-			goto clean_exit;
-		}
-	} else {
-		cells->current_cell.timing_advance_meas_time = 0;
+	if (params.status != AT_NCELLMEAS_STATUS_VALUE_SUCCESS) {
+		return 1;
 	}
 
-	if ((cells->ncells_count == 0) || (cells->neighbor_cells == NULL)) {
-		goto clean_exit;
+	if (present != BIT_MASK(ncellmeas_schema.field_count)) {
+		return -EINVAL;
 	}
 
-	/* Neighboring cells. */
-	for (size_t i = 0; i < cells->ncells_count; i++) {
-		size_t start_idx = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-				   i * AT_NCELLMEAS_N_PARAMS_COUNT;
-
-		/* EARFCN */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_EARFCN_INDEX,
-					&cells->neighbor_cells[i].earfcn);
-		if (err) {
-			goto clean_exit;
-		}
-
-		/* Physical cell ID. */
-		err = at_params_short_get(&resp_list,
-					  start_idx + AT_NCELLMEAS_N_PHYS_CELL_ID_INDEX,
-					  &cells->neighbor_cells[i].phys_cell_id);
-		if (err) {
-			goto clean_exit;
-		}
+	/* The neighbor cells follow the current cell, in groups of
+	 * AT_NCELLMEAS_N_PARAMS_COUNT parameters.
+	 */
+	ncells_count = neighborcell_count_get(at_response);
 
-		/* RSRP */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRP_INDEX,
-					&tmp);
+	for (size_t i = 0; i < ncells_count; i++) {
+		err = ncellmeas_group_parse(&ncellmeas_ncell_schema, next, &ncell, &next);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 
-		cells->neighbor_cells[i].rsrp = tmp;
-
-		/* RSRQ */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRQ_INDEX,
-					&tmp);
-		if (err) {
-			goto clean_exit;
+		if (cells->neighbor_cells) {
+			ncellmeas_ncell_get(&ncell, &cells->neighbor_cells[i]);
 		}
+	}
 
-		cells->neighbor_cells[i].rsrq = tmp;
-
-		/* Time difference. */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_TIME_DIFF_INDEX,
-					&cells->neighbor_cells[i].time_diff);
+	/* Starting from modem firmware v1.3.1, timing advance measurement time
+	 * information is added as the last parameter in the response.
+	 */
+	if (*next == ',') {
+		err = ncellmeas_group_parse(&ncellmeas_ta_meas_time_schema, next, &params, NULL);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 	}
 
-	if (incomplete) {
-		err = -E2BIG;
+	err = ncellmeas_cell_get(&params, &cells->current_cell);
+	if (err) {
+		cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
+		return err;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
+	if (cells->neighbor_cells) {
+		cells->ncells_count = ncells_count;
+	}
 
-	return err;
+	return 0;
 }
 
 int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 	const char *at_response, struct lte_lc_cells_info *cells)
 {
-	struct at_param_list resp_list;
-	struct lte_lc_ncell *ncells = NULL;
-	int err, status, tmp_int, len;
-	int16_t tmp_short;
-	char response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	char tmp_str[7];
+	struct ncellmeas_cell_params cell_params = {0};
+	struct ncellmeas_ncell_params ncell;
+	uint32_t present = 0;
 	bool incomplete = false;
-	int curr_index;
-	size_t i = 0, j = 0, k = 0;
-
-	/* Count the actual number of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
-	 * 3 is added to account for the parameters that do not have a trailing
-	 * comma.
-	 */
-	size_t param_count = get_char_frequency(at_response, ',') + 3;
+	const char *next;
+	int err;
 
 	/* Fill the defaults */
 	cells->gci_cells_count = 0;
 	cells->ncells_count = 0;
 	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 
-	for (i = 0; i < params->gci_count; i++) {
+	for (size_t i = 0; i < params->gci_count; i++) {
 		cells->gci_cells[i].id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 		cells->gci_cells[i].timing_advance = LTE_LC_CELL_TIMING_ADVANCE_INVALID;
 	}
@@ -1241,287 +1129,92 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 	 *		<meas_time>,<serving>,<neighbor_count>
 	 *	[,<n_earfcn1>,<n_phys_cell_id1>,<n_rsrp1>,<n_rsrq1>,<time_diff1>]
 	 *	[,<n_earfcn2>,<n_phys_cell_id2>,<n_rsrp2>,<n_rsrq2>,<time_diff2>]...]...
+	 *
+	 * The status is parsed first, then the cell and neighbor cell schemas are applied
+	 * in turn, each starting where the previous one stopped.
 	 */
 
-	err = at_params_list_init(&resp_list, param_count);
-	if (err) {
-		LOG_ERR("Could not init AT params list for cell_list, error: %d", err);
-		goto clean_exit;
-	}
-
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
-	if (err && err != -E2BIG) {
-		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		/* Returns -E2BIG if the buffers set by CONFIG_LTE_NEIGHBOR_CELLS_MAX
-		 * are too small for the modem response. The associated data is still valid,
-		 * but not complete.
-		 */
-		incomplete = true;
-		LOG_WRN("E2BIG was returned, continue. param_count %d, err %d, str %s",
-			param_count, err, at_response);
-	}
-
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
-	}
-
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
+	err = at_schema_parse(&ncellmeas_gci_status_schema, at_response, &cell_params,
+			      &present, &next);
+	if (err == -ENOMSG) {
 		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
 		LOG_ERR("Not a valid NCELLMEAS response");
-		goto clean_exit;
-	}
-
-	/* Status code. */
-	curr_index = AT_NCELLMEAS_STATUS_INDEX;
-	err = at_params_int_get(&resp_list, curr_index, &status);
-	if (err) {
+		return 0;
+	} else if (err || !(present & BIT(0))) {
 		LOG_DBG("Cannot parse NCELLMEAS status");
-		goto clean_exit;
+		return err ? err : -EINVAL;
 	}
 
-	if (status == AT_NCELLMEAS_STATUS_VALUE_FAIL) {
-		err = 1;
-		LOG_DBG("NCELLMEAS status %d", status);
-		goto clean_exit;
-	} else if (status == AT_NCELLMEAS_STATUS_VALUE_INCOMPLETE) {
+	if (cell_params.status == AT_NCELLMEAS_STATUS_VALUE_FAIL) {
+		LOG_DBG("NCELLMEAS status %d", cell_params.status);
+		return 1;
+	} else if (cell_params.status == AT_NCELLMEAS_STATUS_VALUE_INCOMPLETE) {
 		LOG_WRN("NCELLMEAS measurements interrupted; results incomplete");
 	}
 
 	/* Go through the cells. */
-	for (i = 0; curr_index < (param_count - (AT_NCELLMEAS_GCI_CELL_PARAMS_COUNT + 1)) &&
-			i < params->gci_count; i++) {
+	for (size_t i = 0; *next == ',' && i < params->gci_count; i++) {
 		struct lte_lc_cell parsed_cell;
-		bool is_serving_cell;
-		uint8_t parsed_ncells_count;
 
-		/* <cell_id>  */
-		curr_index++;
-		err = string_param_to_int(&resp_list, curr_index, &tmp_int, 16);
+		err = ncellmeas_group_parse(&ncellmeas_gci_cell_schema, next, &cell_params, &next);
 		if (err) {
-			LOG_ERR("Could not parse cell_id, index %d, i %d error: %d",
-				curr_index, i, err);
-			goto clean_exit;
-		}
-
-		if (tmp_int > LTE_LC_CELL_EUTRAN_ID_MAX) {
-			LOG_WRN("cell_id = %d which is > LTE_LC_CELL_EUTRAN_ID_MAX; "
-				"marking invalid", tmp_int);
-			tmp_int = LTE_LC_CELL_EUTRAN_ID_INVALID;
+			LOG_ERR("Could not parse cell %zu, error: %d", i, err);
+			return err;
 		}
-		parsed_cell.id = tmp_int;
 
-		/* <plmn> */
-		len = sizeof(tmp_str);
-
-		curr_index++;
-		err = at_params_string_get(&resp_list, curr_index, tmp_str, &len);
-		if (err) {
-			LOG_ERR("Could not parse plmn, error: %d", err);
-			goto clean_exit;
-		}
-		/* A successful call to `at_params_string_get` guarantees `len` to be set to
-		 * a value lower than the totalt size of `tmp_str`.
-		 */
-		tmp_str[len] = '\0';
-
-		/* Read MNC and store as integer. The MNC starts as the fourth character
-		 * in the string, following three characters long MCC.
-		 */
-		err = string_to_int(&tmp_str[3], 10, &parsed_cell.mnc);
-		if (err) {
-			LOG_ERR("string_to_int, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* Null-terminated MCC, read and store it. */
-		tmp_str[3] = '\0';
-
-		err = string_to_int(tmp_str, 10, &parsed_cell.mcc);
-		if (err) {
-			LOG_ERR("string_to_int, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <tac> */
-		curr_index++;
-		err = string_param_to_int(&resp_list, curr_index, &tmp_int, 16);
-		if (err) {
-			LOG_ERR("Could not parse tracking_area_code in i %d, error: %d", i, err);
-			goto clean_exit;
-		}
-		parsed_cell.tac = tmp_int;
-
-		/* <ta> */
-		curr_index++;
-		err = at_params_int_get(&resp_list, curr_index, &tmp_int);
-		if (err) {
-			LOG_ERR("Could not parse timing_advance, error: %d", err);
-			goto clean_exit;
-		}
-		parsed_cell.timing_advance = tmp_int;
-
-		/* <ta_meas_time> */
-		curr_index++;
-		err = at_params_int64_get(&resp_list, curr_index,
-					  &parsed_cell.timing_advance_meas_time);
-		if (err) {
-			LOG_ERR("Could not parse timing_advance_meas_time, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <earfcn> */
-		curr_index++;
-		err = at_params_int_get(&resp_list, curr_index, &parsed_cell.earfcn);
+		err = ncellmeas_cell_get(&cell_params, &parsed_cell);
 		if (err) {
-			LOG_ERR("Could not parse earfcn, error: %d", err);
-			goto clean_exit;
+			LOG_ERR("Could not parse plmn of cell %zu, error: %d", i, err);
+			return err;
 		}
 
-		/* <phys_cell_id> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.phys_cell_id);
-		if (err) {
-			LOG_ERR("Could not parse phys_cell_id, error: %d", err);
-			goto clean_exit;
+		if (parsed_cell.id == LTE_LC_CELL_EUTRAN_ID_INVALID) {
+			LOG_WRN("cell_id = 0x%08x which is > LTE_LC_CELL_EUTRAN_ID_MAX; "
+				"marking invalid", cell_params.id);
 		}
 
-		/* <rsrp> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.rsrp);
-		if (err) {
-			LOG_ERR("Could not parse rsrp, error: %d", err);
-			goto clean_exit;
-		}
-
-		/* <rsrq> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.rsrq);
-		if (err) {
-			LOG_ERR("Could not parse rsrq, error: %d", err);
-			goto clean_exit;
+		if (!cell_params.serving) {
+			cells->gci_cells[cells->gci_cells_count] = parsed_cell;
+			cells->gci_cells_count++; /* Increase count for non-serving GCI cell */
+			continue;
 		}
 
-		/* <meas_time> */
-		curr_index++;
-		err = at_params_int64_get(&resp_list, curr_index, &parsed_cell.measurement_time);
-		if (err) {
-			LOG_ERR("Could not parse meas_time, error: %d", err);
-			goto clean_exit;
-		}
+		/* This the current/serving cell.
+		 * In practice the <neighbor_count> is always 0 for other than
+		 * the serving cell, i.e. no neigbour cell list is available.
+		 * Thus, handle neighbor cells only for the serving cell.
+		 */
+		cells->current_cell = parsed_cell;
 
-		/* <serving> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &tmp_short);
-		if (err) {
-			LOG_ERR("Could not parse serving, error: %d", err);
-			goto clean_exit;
+		if (cell_params.neighbor_count > CONFIG_LTE_NEIGHBOR_CELLS_MAX) {
+			incomplete = true;
+			LOG_WRN("Cutting response, because received neigbor cell"
+				" count is bigger than configured max: %d",
+				CONFIG_LTE_NEIGHBOR_CELLS_MAX);
 		}
-		is_serving_cell = tmp_short;
 
-		/* <neighbor_count> */
-		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &tmp_short);
-		if (err) {
-			LOG_ERR("Could not parse neighbor_count, error: %d", err);
-			goto clean_exit;
+		if (cell_params.neighbor_count > 0 && cells->neighbor_cells == NULL) {
+			/* Allocate room for the parsed neighbor info. */
+			cells->neighbor_cells = k_calloc(MIN(cell_params.neighbor_count,
+							     CONFIG_LTE_NEIGHBOR_CELLS_MAX),
+							 sizeof(struct lte_lc_ncell));
+			if (cells->neighbor_cells == NULL) {
+				LOG_WRN("Failed to allocate memory for the ncells (continue)");
+			}
 		}
-		parsed_ncells_count = tmp_short;
-
-		if (is_serving_cell) {
-			int to_be_parsed_ncell_count = 0;
 
-			/* This the current/serving cell.
-			 * In practice the <neighbor_count> is always 0 for other than
-			 * the serving cell, i.e. no neigbour cell list is available.
-			 * Thus, handle neighbor cells only for the serving cell.
-			 */
-			cells->current_cell = parsed_cell;
-			if (parsed_ncells_count != 0) {
-				/* Allocate room for the parsed neighbor info. */
-				if (parsed_ncells_count > CONFIG_LTE_NEIGHBOR_CELLS_MAX) {
-					to_be_parsed_ncell_count = CONFIG_LTE_NEIGHBOR_CELLS_MAX;
-					incomplete = true;
-					LOG_WRN("Cutting response, because received neigbor cell"
-						" count is bigger than configured max: %d",
-							CONFIG_LTE_NEIGHBOR_CELLS_MAX);
-
-				} else {
-					to_be_parsed_ncell_count = parsed_ncells_count;
-				}
-				ncells = k_calloc(
-						to_be_parsed_ncell_count,
-						sizeof(struct lte_lc_ncell));
-				if (ncells == NULL) {
-					LOG_WRN("Failed to allocate memory for the ncells"
-						" (continue)");
-					continue;
-				}
-				cells->neighbor_cells = ncells;
-				cells->ncells_count = to_be_parsed_ncell_count;
+		/* Parse neighbors. The ones that do not fit are skipped. */
+		for (int j = 0; j < cell_params.neighbor_count; j++) {
+			err = ncellmeas_group_parse(&ncellmeas_ncell_schema, next, &ncell, &next);
+			if (err) {
+				LOG_ERR("Could not parse neighbor cell %d, error: %d", j, err);
+				return err;
 			}
 
-			/* Parse neighbors */
-			for (j = 0; j < to_be_parsed_ncell_count; j++) {
-				/* <n_earfcn[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list,
-							curr_index,
-							&cells->neighbor_cells[j].earfcn);
-				if (err) {
-					LOG_ERR("Could not parse n_earfcn, error: %d", err);
-					goto clean_exit;
-				}
-
-				/* <n_phys_cell_id[j]> */
-				curr_index++;
-				err = at_params_short_get(&resp_list,
-							  curr_index,
-							  &cells->neighbor_cells[j].phys_cell_id);
-				if (err) {
-					LOG_ERR("Could not parse n_phys_cell_id, error: %d", err);
-					goto clean_exit;
-				}
-
-				/* <n_rsrp[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list, curr_index, &tmp_int);
-				if (err) {
-					LOG_ERR("Could not parse n_rsrp, error: %d", err);
-					goto clean_exit;
-				}
-				cells->neighbor_cells[j].rsrp = tmp_int;
-
-				/* <n_rsrq[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list, curr_index, &tmp_int);
-				if (err) {
-					LOG_ERR("Could not parse n_rsrq, error: %d", err);
-					goto clean_exit;
-				}
-				cells->neighbor_cells[j].rsrq = tmp_int;
-
-				/* <time_diff[j]> */
-				curr_index++;
-				err = at_params_int_get(&resp_list,
-							curr_index,
-							&cells->neighbor_cells[j].time_diff);
-				if (err) {
-					LOG_ERR("Could not parse time_diff, error: %d", err);
-					goto clean_exit;
-				}
+			if (cells->neighbor_cells && j < CONFIG_LTE_NEIGHBOR_CELLS_MAX) {
+				ncellmeas_ncell_get(&ncell, &cells->neighbor_cells[j]);
+				cells->ncells_count++;
 			}
-		} else {
-			cells->gci_cells[k] = parsed_cell;
-			cells->gci_cells_count++; /* Increase count for non-serving GCI cell */
-			k++;
 		}
 	}
 
@@ -1530,9 +1223,6 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 		LOG_ERR("Buffer is too small; results incomplete: %d", err);
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
 	return err;
 }
 
@@ -1753,3 +1443,179 @@ int parse_periodic_search_pattern(const char *const pattern_str,
 
 	return 0;
 }
+
+#if defined(CONFIG_LTE_LC_AT_CMD_CACHE)
+#define AT_CMD_CACHE_ENTRIES	10
+#define AT_CMD_CACHE_CMD_LEN	48
+
+/* Last successful idempotent commands, one per command name. Commands that do not fit an
+ * entry are not cached, and are always sent.
+ */
+static char at_cmd_cache[AT_CMD_CACHE_ENTRIES][AT_CMD_CACHE_CMD_LEN];
+#endif
+
+/* Serializes the cache lookup, the command and the cache update of idempotent commands. */
+static K_MUTEX_DEFINE(at_batch_mtx);
+
+#if defined(CONFIG_LTE_LC_AT_CMD_CACHE)
+static char *at_cmd_cache_entry_get(const char *cmd)
+{
+	char *free_entry = NULL;
+	/* Commands are compared by name, including the '=' sign. */
+	size_t name_len = strcspn(cmd, "=") + 1;
+
+	if (strlen(cmd) >= AT_CMD_CACHE_CMD_LEN) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < AT_CMD_CACHE_ENTRIES; i++) {
+		if (at_cmd_cache[i][0] == '\0') {
+			if (free_entry == NULL) {
+				free_entry = at_cmd_cache[i];
+			}
+		} else if (strncmp(at_cmd_cache[i], cmd, name_len) == 0) {
+			return at_cmd_cache[i];
+		}
+	}
+
+	return free_entry;
+}
+#endif /* CONFIG_LTE_LC_AT_CMD_CACHE */
+
+void at_batch_init(struct at_batch *batch)
+{
+	batch->buf_len = 0;
+	batch->count = 0;
+	batch->skipped = 0;
+}
+
+static int at_batch_vadd(struct at_batch *batch, uint8_t flags, const char *fmt, va_list args)
+{
+	int len;
+
+	if (batch->count == AT_BATCH_CMD_COUNT_MAX) {
+		return -ENOMEM;
+	}
+
+	len = vsnprintf(&batch->buf[batch->buf_len], sizeof(batch->buf) - batch->buf_len,
+			fmt, args);
+
+	if (len < 0 || (size_t)len >= sizeof(batch->buf) - batch->buf_len) {
+		return -ENOMEM;
+	}
+
+	batch->buf_len += len + 1;
+	batch->flags[batch->count] = flags;
+	batch->err[batch->count] = 0;
+
+	return batch->count++;
+}
+
+int at_batch_add(struct at_batch *batch, uint8_t flags, const char *fmt, ...)
+{
+	int ret;
+	va_list args;
+
+	va_start(args, fmt);
+	ret = at_batch_vadd(batch, flags, fmt, args);
+	va_end(args);
+
+	return ret;
+}
+
+/* Send a formatted command, with at_batch_mtx locked. Returns the error of the command. */
+static int at_batch_cmd_send(const char *cmd, uint8_t flags, uint8_t *skipped)
+{
+	int err;
+#if defined(CONFIG_LTE_LC_AT_CMD_CACHE)
+	/* All commands update the cache, so that it follows the state set by lte_lc. */
+	char *entry = at_cmd_cache_entry_get(cmd);
+
+	if ((flags & AT_BATCH_FLAG_IDEMPOTENT) && entry != NULL && strcmp(entry, cmd) == 0) {
+		LOG_DBG("%s skipped, already set", cmd);
+		(*skipped)++;
+		return 0;
+	}
+#endif
+
+	/* The command is already formatted, any '%' in it must not be interpreted. */
+	err = nrf_modem_at_printf("%s", cmd);
+	if (err) {
+#if defined(CONFIG_LTE_LC_AT_CMD_CACHE)
+		if (entry != NULL) {
+			/* The state of the modem is unknown after a failure. */
+			entry[0] = '\0';
+		}
+#endif
+		if (flags & AT_BATCH_FLAG_OPTIONAL) {
+			LOG_WRN("%s failed, error: %d", cmd, err);
+		} else {
+			LOG_ERR("%s failed, error: %d", cmd, err);
+		}
+		return err;
+	}
+
+#if defined(CONFIG_LTE_LC_AT_CMD_CACHE)
+	if (entry != NULL) {
+		strcpy(entry, cmd);
+	}
+#endif
+
+	return 0;
+}
+
+int at_batch_submit(struct at_batch *batch)
+{
+	int err = 0;
+	const char *cmd = batch->buf;
+
+	k_mutex_lock(&at_batch_mtx, K_FOREVER);
+
+	for (size_t i = 0; i < batch->count; cmd += strlen(cmd) + 1, i++) {
+		if (err) {
+			batch->err[i] = -ECANCELED;
+			continue;
+		}
+
+		batch->err[i] = at_batch_cmd_send(cmd, batch->flags[i], &batch->skipped);
+		if (batch->err[i] && !(batch->flags[i] & AT_BATCH_FLAG_OPTIONAL)) {
+			err = batch->err[i];
+		}
+	}
+
+	k_mutex_unlock(&at_batch_mtx);
+
+	return err;
+}
+
+int at_cmd_idempotent_printf(const char *fmt, ...)
+{
+	int err;
+	int len;
+	va_list args;
+	uint8_t skipped = 0;
+	char cmd[AT_CMD_IDEMPOTENT_LEN];
+
+	va_start(args, fmt);
+	len = vsnprintf(cmd, sizeof(cmd), fmt, args);
+	va_end(args);
+
+	if (len < 0 || (size_t)len >= sizeof(cmd)) {
+		return -ENOMEM;
+	}
+
+	k_mutex_lock(&at_batch_mtx, K_FOREVER);
+	err = at_batch_cmd_send(cmd, AT_BATCH_FLAG_IDEMPOTENT, &skipped);
+	k_mutex_unlock(&at_batch_mtx);
+
+	return err;
+}
+
+void at_batch_cache_clear(void)
+{
+#if defined(CONFIG_LTE_LC_AT_CMD_CACHE)
+	k_mutex_lock(&at_batch_mtx, K_FOREVER);
+	memset(at_cmd_cache, 0, sizeof(at_cmd_cache));
+	k_mutex_unlock(&at_batch_mtx);
+#endif
+}
@@ -25,19 +25,6 @@
 #define AT_CEREG_5				"AT+CEREG=5"
 #define AT_CEREG_READ				"AT+CEREG?"
 #define AT_CEREG_RESPONSE_PREFIX		"+CEREG"
-#define AT_CEREG_PARAMS_COUNT_MAX		11
-#define AT_CEREG_REG_STATUS_INDEX		1
-#define AT_CEREG_READ_REG_STATUS_INDEX		2
-#define AT_CEREG_TAC_INDEX			2
-#define AT_CEREG_READ_TAC_INDEX			3
-#define AT_CEREG_CELL_ID_INDEX			3
-#define AT_CEREG_READ_CELL_ID_INDEX		4
-#define AT_CEREG_ACT_INDEX			4
-#define AT_CEREG_READ_ACT_INDEX			5
-#define AT_CEREG_ACTIVE_TIME_INDEX		7
-#define AT_CEREG_READ_ACTIVE_TIME_INDEX		8
-#define AT_CEREG_TAU_INDEX			8
-#define AT_CEREG_READ_TAU_INDEX			9
 #define AT_CEREG_RESPONSE_MAX_LEN		80
 #define AT_XSYSTEMMODE_READ			"AT%XSYSTEMMODE?"
 #define AT_XSYSTEMMODE_RESPONSE_PREFIX		"%XSYSTEMMODE"
@@ -156,6 +143,30 @@
 #define AT_MDMEV_CE_LEVEL_2			"PRACH CE-LEVEL 2\r\n"
 #define AT_MDMEV_CE_LEVEL_3			"PRACH CE-LEVEL 3\r\n"
 
+/* Configuration command batches */
+#define AT_BATCH_BUF_SIZE			256
+#define AT_BATCH_CMD_COUNT_MAX			8
+/* The command only sets modem state. Skip it if the same state is known to be set already. */
+#define AT_BATCH_FLAG_IDEMPOTENT		BIT(0)
+/* A failure of the command does not stop the rest of the batch. */
+#define AT_BATCH_FLAG_OPTIONAL			BIT(1)
+/* Maximum length of a command sent with at_cmd_idempotent_printf(), including the terminator. */
+#define AT_CMD_IDEMPOTENT_LEN			64
+
+/* A batch of configuration AT commands that are sent to the modem back to back.
+ * The commands are formatted when they are added, so that they can be sent without any
+ * processing in between. The result of each command is stored in err.
+ */
+struct at_batch {
+	char buf[AT_BATCH_BUF_SIZE];
+	size_t buf_len;
+	uint8_t count;
+	uint8_t flags[AT_BATCH_CMD_COUNT_MAX];
+	int err[AT_BATCH_CMD_COUNT_MAX];
+	/* Number of commands that were skipped, because the modem state already matched. */
+	uint8_t skipped;
+};
+
 /* @brief Helper function to check if a response is what was expected.
  *
  * @param response Pointer to response prefix
@@ -410,3 +421,53 @@ char *periodic_search_pattern_get(char *const buf, size_t buf_size,
  */
 int parse_periodic_search_pattern(const char *const pattern_str,
 				  struct lte_lc_periodic_search_pattern *pattern);
+
+/* @brief Initialize an empty configuration command batch.
+ *
+ * @param batch Pointer to the batch.
+ */
+void at_batch_init(struct at_batch *batch);
+
+/* @brief Format an AT command and add it to a configuration command batch.
+ *
+ * @param batch Pointer to the batch.
+ * @param flags AT_BATCH_FLAG_* flags of the command.
+ * @param fmt Command format string, as for nrf_modem_at_printf().
+ *
+ * @return Index of the command in the batch on success, negative errno code otherwise.
+ * @retval -ENOMEM if the batch is full.
+ */
+int at_batch_add(struct at_batch *batch, uint8_t flags, const char *fmt, ...);
+
+/* @brief Send the commands of a configuration command batch to the modem in order.
+ *
+ * If CONFIG_LTE_LC_AT_CMD_CACHE is enabled, commands with AT_BATCH_FLAG_IDEMPOTENT are skipped
+ * when the last successful command with the same name (the part before '=') was identical.
+ * Sending stops at the first failed command without AT_BATCH_FLAG_OPTIONAL, and the commands
+ * after it get the error -ECANCELED.
+ *
+ * @param batch Pointer to the batch.
+ *
+ * @return Zero on success, otherwise the error of the first failed command without
+ *	   AT_BATCH_FLAG_OPTIONAL, as returned by nrf_modem_at_printf().
+ */
+int at_batch_submit(struct at_batch *batch);
+
+/* @brief Send a single AT command that only sets modem state.
+ *
+ * The command is sent like a command of a batch with AT_BATCH_FLAG_IDEMPOTENT, but it is
+ * formatted into a buffer of AT_CMD_IDEMPOTENT_LEN bytes on the stack instead of a batch.
+ *
+ * @param fmt Command format string, as for nrf_modem_at_printf().
+ *
+ * @return Zero on success, otherwise the error returned by nrf_modem_at_printf(),
+ *	   or -ENOMEM if the command is longer than AT_CMD_IDEMPOTENT_LEN - 1 characters.
+ */
+int at_cmd_idempotent_printf(const char *fmt, ...);
+
+/* @brief Forget the modem state recorded from successful idempotent commands.
+ *
+ * Must be called when the modem may have lost the state, for example when it is
+ * initialized or powered off.
+ */
+void at_batch_cache_clear(void);
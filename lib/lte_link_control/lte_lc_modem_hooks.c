@@ -9,6 +9,8 @@
 #include <modem/nrf_modem_lib.h>
 #include <zephyr/logging/log.h>
 
+#include "lte_lc_helpers.h"
+
 LOG_MODULE_DECLARE(lte_lc, CONFIG_LTE_LINK_CONTROL_LOG_LEVEL);
 
 NRF_MODEM_LIB_ON_INIT(lte_lc_init_hook, on_modem_init, NULL);
@@ -18,6 +20,10 @@ static void on_modem_init(int err, void *ctx)
 {
 	extern const enum lte_lc_system_mode lte_lc_sys_mode;
 	extern const enum lte_lc_system_mode_preference lte_lc_sys_mode_pref;
+	struct at_batch batch;
+
+	/* The modem starts from its stored settings, nothing is known to be set yet. */
+	at_batch_cache_clear();
 
 	if (err) {
 		LOG_ERR("Modem library init error: %d, lte_lc not initialized", err);
@@ -82,40 +88,34 @@ static void on_modem_init(int err, void *ctx)
 		return;
 	}
 
+	/* The remaining settings are sent back to back as one batch. */
+	at_batch_init(&batch);
+
 #if defined(CONFIG_LTE_LOCK_BANDS)
 	/* Set LTE band lock (volatile setting).
 	 * Has to be done every time before activating the modem.
 	 */
-	err = nrf_modem_at_printf("AT%%XBANDLOCK=2,\""CONFIG_LTE_LOCK_BAND_MASK "\"");
-	if (err) {
-		LOG_ERR("Failed to lock LTE bands, err %d", err);
-		return;
-	}
+	(void)at_batch_add(&batch, 0, "AT%%XBANDLOCK=2,\""CONFIG_LTE_LOCK_BAND_MASK "\"");
 #endif
 
 #if defined(CONFIG_LTE_LOCK_PLMN)
 	/* Manually select Operator (volatile setting).
 	 * Has to be done every time before activating the modem.
 	 */
-	err = nrf_modem_at_printf("AT+COPS=1,2,\"" CONFIG_LTE_LOCK_PLMN_STRING "\"");
-	if (err) {
-		LOG_ERR("Failed to lock PLMN, err %d", err);
-		return;
-	}
+	(void)at_batch_add(&batch, 0, "AT+COPS=1,2,\"" CONFIG_LTE_LOCK_PLMN_STRING "\"");
 #elif defined(CONFIG_LTE_UNLOCK_PLMN)
 	/* Automatically select Operator (volatile setting).
 	 */
-	err = nrf_modem_at_printf("AT+COPS=0");
-	if (err) {
-		LOG_ERR("Failed to unlock PLMN, err %d", err);
-		return;
-	}
+	(void)at_batch_add(&batch, 0, "AT+COPS=0");
 #endif
 
 	/* Configure Release Assistance Indication (RAI). */
-	err = nrf_modem_at_printf("AT%%RAI=%d", IS_ENABLED(CONFIG_LTE_RAI_REQ) ? 1 : 0);
+	(void)at_batch_add(&batch, AT_BATCH_FLAG_IDEMPOTENT, "AT%%RAI=%d",
+			   IS_ENABLED(CONFIG_LTE_RAI_REQ) ? 1 : 0);
+
+	err = at_batch_submit(&batch);
 	if (err) {
-		LOG_ERR("Failed to configure RAI, err %d", err);
+		LOG_ERR("Failed to configure band lock, PLMN selection or RAI, err %d", err);
 		return;
 	}
 }
@@ -138,6 +138,11 @@ static void lte_lc_on_modem_cfun(int mode, void *ctx)
 {
 	ARG_UNUSED(ctx);
 
+	/* The modem forgets notification subscriptions when it is powered off. */
+	if (mode == LTE_LC_FUNC_MODE_POWER_OFF) {
+		at_batch_cache_clear();
+	}
+
 	STRUCT_SECTION_FOREACH(lte_lc_cfun_cb, e) {
 		LOG_DBG("CFUN monitor callback: %p", e->callback);
 		e->callback(mode, e->context);
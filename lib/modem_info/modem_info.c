@@ -7,6 +7,7 @@
 #include <nrf_modem_at.h>
 #include <modem/at_monitor.h>
 #include <modem/at_cmd_parser.h>
+#include <modem/nrf_modem_lib.h>
 #include <ctype.h>
 #include <zephyr/device.h>
 #include <errno.h>
@@ -367,6 +368,221 @@ AT_MONITOR(modem_info_cesq_mon, "%CESQ", modem_info_rsrp_subscribe_handler, PAUS
 static rsrp_cb_t modem_info_rsrp_cb;
 static struct at_param_list m_param_list;
 
+#if defined(CONFIG_MODEM_INFO_CACHE)
+/* Cached AT responses. Entries are grouped by what invalidates them. */
+enum cache_id {
+	/* Kept until the modem library is reinitialized */
+	CACHE_FW_VERSION,
+	CACHE_IMEI,
+	CACHE_SUPPORTED_BAND,
+	/* Kept until the functional mode changes or a %XSIM notification */
+	CACHE_UICC_STATE,
+	CACHE_ICCID,
+	CACHE_IMSI,
+	/* Kept until a +CEREG or +CGEV notification, or the network max age */
+	CACHE_CURRENT_MODE,
+	CACHE_SYSTEMMODE,
+	CACHE_NETWORK_STATUS,
+	CACHE_CURRENT_OP,
+	CACHE_PDP_CONTEXT,
+	CACHE_CURRENT_BAND,
+	/* Kept until a notification or the measurement max age */
+	CACHE_CESQ,
+	CACHE_VBAT,
+	CACHE_TEMP,
+	CACHE_COUNT,
+};
+
+#define CACHE_MASK_ALL		BIT_MASK(CACHE_COUNT)
+#define CACHE_MASK_STATIC	(BIT(CACHE_FW_VERSION) | BIT(CACHE_IMEI) | BIT(CACHE_SUPPORTED_BAND))
+#define CACHE_MASK_SIM		(BIT(CACHE_UICC_STATE) | BIT(CACHE_ICCID) | BIT(CACHE_IMSI))
+#define CACHE_MASK_NETWORK	(BIT(CACHE_CURRENT_MODE) | BIT(CACHE_SYSTEMMODE) |	\
+				 BIT(CACHE_NETWORK_STATUS) | BIT(CACHE_CURRENT_OP) |	\
+				 BIT(CACHE_PDP_CONTEXT) | BIT(CACHE_CURRENT_BAND))
+#define CACHE_MASK_MEASUREMENT	(BIT(CACHE_CESQ) | BIT(CACHE_VBAT) | BIT(CACHE_TEMP))
+
+BUILD_ASSERT(CACHE_COUNT <= ATOMIC_BITS, "Cache entries must fit in an atomic_t");
+
+struct cache_entry {
+	const char *cmd;
+	int64_t timestamp;
+	char rsp[CONFIG_MODEM_INFO_BUFFER_SIZE];
+};
+
+static struct cache_entry cache[CACHE_COUNT] = {
+	[CACHE_FW_VERSION]	= { .cmd = AT_CMD_FW_VERSION },
+	[CACHE_IMEI]		= { .cmd = AT_CMD_IMEI },
+	[CACHE_SUPPORTED_BAND]	= { .cmd = AT_CMD_SUPPORTED_BAND },
+	[CACHE_UICC_STATE]	= { .cmd = AT_CMD_UICC_STATE },
+	[CACHE_ICCID]		= { .cmd = AT_CMD_ICCID },
+	[CACHE_IMSI]		= { .cmd = AT_CMD_IMSI },
+	[CACHE_CURRENT_MODE]	= { .cmd = AT_CMD_CURRENT_MODE },
+	[CACHE_SYSTEMMODE]	= { .cmd = AT_CMD_SYSTEMMODE },
+	[CACHE_NETWORK_STATUS]	= { .cmd = AT_CMD_NETWORK_STATUS },
+	[CACHE_CURRENT_OP]	= { .cmd = AT_CMD_CURRENT_OP },
+	[CACHE_PDP_CONTEXT]	= { .cmd = AT_CMD_PDP_CONTEXT },
+	[CACHE_CURRENT_BAND]	= { .cmd = AT_CMD_CURRENT_BAND },
+	[CACHE_CESQ]		= { .cmd = AT_CMD_CESQ },
+	[CACHE_VBAT]		= { .cmd = AT_CMD_VBAT },
+	[CACHE_TEMP]		= { .cmd = AT_CMD_TEMP },
+};
+
+/* Valid entries, one bit per entry. Cleared from notification handlers in ISR context. */
+static atomic_t cache_valid;
+/* Incremented on every invalidation, so that a response that was requested
+ * before an invalidation is not stored after it.
+ */
+static atomic_t cache_generation;
+static atomic_t cache_invalidations;
+static uint32_t cache_hits;
+static uint32_t cache_misses;
+static K_MUTEX_DEFINE(cache_lock);
+
+AT_MONITOR_ISR(modem_info_cache_cereg_mon, "+CEREG", cache_on_notif_network);
+AT_MONITOR_ISR(modem_info_cache_cgev_mon, "+CGEV", cache_on_notif_network);
+AT_MONITOR_ISR(modem_info_cache_xsim_mon, "%XSIM", cache_on_notif_sim);
+AT_MONITOR_ISR(modem_info_cache_cesq_mon, "%CESQ", cache_on_notif_cesq);
+AT_MONITOR_ISR(modem_info_cache_xmodemsleep_mon, "%XMODEMSLEEP", cache_on_notif_modem_sleep);
+
+NRF_MODEM_LIB_ON_INIT(modem_info_cache_init_hook, cache_on_modem_init, NULL);
+NRF_MODEM_LIB_ON_CFUN(modem_info_cache_cfun_hook, cache_on_modem_cfun, NULL);
+
+static void cache_invalidate(atomic_val_t mask)
+{
+	atomic_inc(&cache_generation);
+
+	if (atomic_and(&cache_valid, ~mask) & mask) {
+		atomic_inc(&cache_invalidations);
+	}
+}
+
+static void cache_on_notif_network(const char *notif)
+{
+	cache_invalidate(CACHE_MASK_NETWORK);
+}
+
+static void cache_on_notif_sim(const char *notif)
+{
+	cache_invalidate(CACHE_MASK_SIM);
+}
+
+static void cache_on_notif_cesq(const char *notif)
+{
+	cache_invalidate(BIT(CACHE_CESQ));
+}
+
+static void cache_on_notif_modem_sleep(const char *notif)
+{
+	/* Measurements from before sleep do not describe the conditions after it */
+	cache_invalidate(CACHE_MASK_MEASUREMENT);
+}
+
+static void cache_on_modem_init(int ret, void *ctx)
+{
+	cache_invalidate(CACHE_MASK_ALL);
+}
+
+static void cache_on_modem_cfun(int mode, void *ctx)
+{
+	cache_invalidate(CACHE_MASK_ALL & ~CACHE_MASK_STATIC);
+}
+
+static int cache_find(const char *cmd)
+{
+	for (int i = 0; i < CACHE_COUNT; i++) {
+		if (strcmp(cache[i].cmd, cmd) == 0) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static bool cache_is_fresh(int id)
+{
+	int64_t max_age;
+
+	if (!atomic_test_bit(&cache_valid, id)) {
+		return false;
+	}
+
+	if (BIT(id) & CACHE_MASK_NETWORK) {
+		max_age = CONFIG_MODEM_INFO_CACHE_NETWORK_MAX_AGE;
+	} else if (BIT(id) & CACHE_MASK_MEASUREMENT) {
+		max_age = CONFIG_MODEM_INFO_CACHE_MEASUREMENT_MAX_AGE;
+	} else {
+		return true;
+	}
+
+	return k_uptime_get() - cache[id].timestamp < max_age;
+}
+
+void modem_info_cache_invalidate(void)
+{
+	atomic_inc(&cache_generation);
+	atomic_clear(&cache_valid);
+}
+
+int modem_info_cache_stats_get(struct modem_info_cache_stats *stats)
+{
+	if (stats == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	stats->hits = cache_hits;
+	stats->misses = cache_misses;
+	k_mutex_unlock(&cache_lock);
+
+	stats->invalidations = atomic_get(&cache_invalidations);
+
+	return 0;
+}
+#endif /* CONFIG_MODEM_INFO_CACHE */
+
+/* Send @p cmd and store the response in @p buf, of CONFIG_MODEM_INFO_BUFFER_SIZE bytes. */
+static int modem_info_at_cmd(const char *cmd, char *buf)
+{
+#if defined(CONFIG_MODEM_INFO_CACHE)
+	atomic_val_t generation;
+	int id;
+	int err;
+
+	id = cache_find(cmd);
+	if (id < 0) {
+		return nrf_modem_at_cmd(buf, CONFIG_MODEM_INFO_BUFFER_SIZE, cmd);
+	}
+
+	/* The lock is held while the command is sent, so that concurrent
+	 * requests for the same information result in a single command.
+	 */
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache_is_fresh(id)) {
+		memcpy(buf, cache[id].rsp, CONFIG_MODEM_INFO_BUFFER_SIZE);
+		cache_hits++;
+		k_mutex_unlock(&cache_lock);
+		return 0;
+	}
+
+	cache_misses++;
+	generation = atomic_get(&cache_generation);
+
+	err = nrf_modem_at_cmd(buf, CONFIG_MODEM_INFO_BUFFER_SIZE, cmd);
+	if (err == 0 && atomic_get(&cache_generation) == generation) {
+		memcpy(cache[id].rsp, buf, CONFIG_MODEM_INFO_BUFFER_SIZE);
+		cache[id].timestamp = k_uptime_get();
+		atomic_set_bit(&cache_valid, id);
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+#else
+	return nrf_modem_at_cmd(buf, CONFIG_MODEM_INFO_BUFFER_SIZE, cmd);
+#endif
+}
+
 static void flip_iccid_string(char *buf)
 {
 	uint8_t current_char;
@@ -466,7 +682,7 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return -EINVAL;
 	}
 
-	err = nrf_modem_at_cmd(recv_buf, CONFIG_MODEM_INFO_BUFFER_SIZE, modem_data[info]->cmd);
+	err = modem_info_at_cmd(modem_data[info]->cmd, recv_buf);
 	if (err != 0) {
 		return -EIO;
 	}
@@ -630,7 +846,7 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 
 	buf[0] = '\0';
 
-	err = nrf_modem_at_cmd(recv_buf, CONFIG_MODEM_INFO_BUFFER_SIZE, modem_data[info]->cmd);
+	err = modem_info_at_cmd(modem_data[info]->cmd, recv_buf);
 	if (err != 0) {
 		return -EIO;
 	}
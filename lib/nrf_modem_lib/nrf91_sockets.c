@@ -49,6 +49,7 @@
 /* Offloading context related to nRF socket. */
 static struct nrf_sock_ctx {
 	int nrf_fd; /* nRF socket descriptior. */
+	int type; /* Socket type. */
 	struct k_mutex *lock; /* Mutex associated with the socket. */
 	struct k_poll_signal poll; /* poll() signal. */
 } offload_ctx[NRF_MODEM_MAX_SOCKET_COUNT];
@@ -62,7 +63,7 @@ static bool offload_disabled;
 /* TLS offloading disabled only. */
 static bool tls_offload_disabled;
 
-static struct nrf_sock_ctx *allocate_ctx(int nrf_fd)
+static struct nrf_sock_ctx *allocate_ctx(int nrf_fd, int type)
 {
 	struct nrf_sock_ctx *ctx = NULL;
 
@@ -72,6 +73,7 @@ static struct nrf_sock_ctx *allocate_ctx(int nrf_fd)
 		if (offload_ctx[i].nrf_fd == -1) {
 			ctx = &offload_ctx[i];
 			ctx->nrf_fd = nrf_fd;
+			ctx->type = type;
 			break;
 		}
 	}
@@ -391,7 +393,7 @@ static int nrf91_socket_offload_accept(void *obj, struct sockaddr *addr,
 		goto error;
 	}
 
-	ctx = allocate_ctx(new_sd);
+	ctx = allocate_ctx(new_sd, SOCK_STREAM);
 	if (ctx == NULL) {
 		errno = ENOMEM;
 		goto error;
@@ -590,28 +592,23 @@ static int nrf91_socket_offload_getsockopt(void *obj, int level, int optname,
 	return retval;
 }
 
-static ssize_t nrf91_socket_offload_recvfrom(void *obj, void *buf, size_t len,
-					     int flags, struct sockaddr *from,
-					     socklen_t *fromlen)
+/* Receive from the modem, the caller must have released the socket lock. */
+static ssize_t recvfrom_unlocked(int sd, void *buf, size_t len, int flags,
+				 struct sockaddr *from, socklen_t *fromlen)
 {
-	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
 	ssize_t retval;
 
-	if (ctx->lock) {
-		(void) k_mutex_unlock(ctx->lock);
-	}
-
 	if (from == NULL || fromlen == NULL) {
-		retval = nrf_recvfrom(ctx->nrf_fd, buf, len, flags, NULL, NULL);
+		retval = nrf_recvfrom(sd, buf, len, flags, NULL, NULL);
 	} else {
 		/* Allocate space for maximum of IPv4 and IPv6 family type. */
 		struct nrf_sockaddr_in6 cliaddr_storage = {0};
 		nrf_socklen_t sock_len = sizeof(struct nrf_sockaddr_in6);
 		struct nrf_sockaddr *cliaddr = (struct nrf_sockaddr *)&cliaddr_storage;
 
-		retval = nrf_recvfrom(ctx->nrf_fd, buf, len, flags, cliaddr, &sock_len);
+		retval = nrf_recvfrom(sd, buf, len, flags, cliaddr, &sock_len);
 		if (retval < 0) {
-			goto exit;
+			return retval;
 		}
 
 		if (cliaddr->sa_family == NRF_AF_INET &&
@@ -625,7 +622,22 @@ static ssize_t nrf91_socket_offload_recvfrom(void *obj, void *buf, size_t len,
 		}
 	}
 
-exit:
+	return retval;
+}
+
+static ssize_t nrf91_socket_offload_recvfrom(void *obj, void *buf, size_t len,
+					     int flags, struct sockaddr *from,
+					     socklen_t *fromlen)
+{
+	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
+	ssize_t retval;
+
+	if (ctx->lock) {
+		(void) k_mutex_unlock(ctx->lock);
+	}
+
+	retval = recvfrom_unlocked(ctx->nrf_fd, buf, len, flags, from, fromlen);
+
 	/* Context might have been freed during this call.
 	 * Check again before accessing.
 	 */
@@ -636,6 +648,23 @@ exit:
 	return retval;
 }
 
+/* Convert an IPv4 or IPv6 destination address. */
+static int z_to_nrf_addr(const struct sockaddr *z_in, struct nrf_sockaddr_in6 *nrf_out,
+			 nrf_socklen_t *nrf_len)
+{
+	if (z_in->sa_family == AF_INET) {
+		z_to_nrf_ipv4(z_in, (struct nrf_sockaddr_in *)nrf_out);
+		*nrf_len = sizeof(struct nrf_sockaddr_in);
+	} else if (z_in->sa_family == AF_INET6) {
+		z_to_nrf_ipv6(z_in, nrf_out);
+		*nrf_len = sizeof(struct nrf_sockaddr_in6);
+	} else {
+		return -EAFNOSUPPORT;
+	}
+
+	return 0;
+}
+
 static ssize_t nrf91_socket_offload_sendto(void *obj, const void *buf,
 					   size_t len, int flags,
 					   const struct sockaddr *to,
@@ -643,30 +672,21 @@ static ssize_t nrf91_socket_offload_sendto(void *obj, const void *buf,
 {
 	int sd = OBJ_TO_SD(obj);
 	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
+	struct nrf_sockaddr_in6 nrf_to;
+	nrf_socklen_t nrf_tolen = 0;
 	ssize_t retval;
 
+	if (to != NULL && z_to_nrf_addr(to, &nrf_to, &nrf_tolen)) {
+		errno = EAFNOSUPPORT;
+		return -1;
+	}
+
 	if (ctx->lock) {
 		(void)k_mutex_unlock(ctx->lock);
 	}
 
-	if (to == NULL) {
-		retval = nrf_sendto(sd, buf, len, flags, NULL, 0);
-	} else if (to->sa_family == AF_INET) {
-		struct nrf_sockaddr_in ipv4;
-		nrf_socklen_t sock_len = sizeof(struct nrf_sockaddr_in);
-
-		z_to_nrf_ipv4(to, &ipv4);
-		retval = nrf_sendto(sd, buf, len, flags, (struct nrf_sockaddr *)&ipv4, sock_len);
-	} else if (to->sa_family == AF_INET6) {
-		struct nrf_sockaddr_in6 ipv6;
-		nrf_socklen_t sock_len = sizeof(struct nrf_sockaddr_in6);
-
-		z_to_nrf_ipv6(to, &ipv6);
-		retval = nrf_sendto(sd, buf, len, flags, (struct nrf_sockaddr *)&ipv6, sock_len);
-	} else {
-		errno = EAFNOSUPPORT;
-		retval = -1;
-	}
+	retval = nrf_sendto(sd, buf, len, flags,
+			    to ? (struct nrf_sockaddr *)&nrf_to : NULL, nrf_tolen);
 
 	/* Context might have been freed during this call.
 	 * Check again before accessing.
@@ -678,81 +698,265 @@ static ssize_t nrf91_socket_offload_sendto(void *obj, const void *buf,
 	return retval;
 }
 
+/* Buffers used by sendmsg() to assemble a message which is scattered over
+ * several I/O vectors, when it must be passed to the modem in one call.
+ * Each sender takes its own buffer, so sockets don't wait on each other.
+ */
+K_MEM_SLAB_DEFINE_STATIC(msg_buf_slab, CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE,
+			 CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_COUNT, 4);
+
+/* Buffer used by recvmsg() to receive a datagram which is scattered over several
+ * I/O vectors. It is separate from the sendmsg() buffers, which are held while
+ * sending blocks, and it is only held while a datagram that is already available
+ * is copied out. One byte more than the I/O vectors is received, to detect
+ * datagrams that don't fit.
+ */
+#define RECVMSG_BUF_SIZE ROUND_UP(CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE + 1, 4)
+
+K_MEM_SLAB_DEFINE_STATIC(recvmsg_buf_slab, RECVMSG_BUF_SIZE, 1, 4);
+
+static ssize_t send_all(int sd, const uint8_t *buf, size_t len, int flags,
+			const struct nrf_sockaddr *to, nrf_socklen_t tolen)
+{
+	size_t offset = 0;
+	ssize_t ret;
+
+	while (offset < len) {
+		ret = nrf_sendto(sd, buf + offset, len - offset, flags, to, tolen);
+		if (ret < 0) {
+			return ret;
+		}
+		offset += ret;
+	}
+
+	return offset;
+}
+
 static ssize_t nrf91_socket_offload_sendmsg(void *obj, const struct msghdr *msg,
 					    int flags)
 {
+	int sd = OBJ_TO_SD(obj);
+	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
+	struct nrf_sockaddr_in6 nrf_to;
+	struct nrf_sockaddr *nrf_to_ptr = NULL;
+	nrf_socklen_t nrf_tolen = 0;
+	size_t chunks = 0;
 	ssize_t len = 0;
 	ssize_t ret;
-	ssize_t offset;
-	int i;
-	static K_MUTEX_DEFINE(sendmsg_lock);
-	static uint8_t buf[CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE];
+	uint8_t *buf;
 
 	if (msg == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	/* Try to reduce number of `sendto` calls - copy data if they fit into
-	 * a single buffer
-	 */
+	if (msg->msg_name != NULL) {
+		if (z_to_nrf_addr(msg->msg_name, &nrf_to, &nrf_tolen)) {
+			errno = EAFNOSUPPORT;
+			return -1;
+		}
+		nrf_to_ptr = (struct nrf_sockaddr *)&nrf_to;
+	}
 
-	for (i = 0; i < msg->msg_iovlen; i++) {
-		len += msg->msg_iov[i].iov_len;
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
+		if (msg->msg_iov[i].iov_len > 0) {
+			len += msg->msg_iov[i].iov_len;
+			chunks++;
+		}
 	}
 
-	if (len <= sizeof(buf)) {
-		/* Protect `buf` access with a mutex. */
-		k_mutex_lock(&sendmsg_lock, K_FOREVER);
-		len = 0;
+	if (ctx->lock) {
+		(void)k_mutex_unlock(ctx->lock);
+	}
+
+	if (chunks > 1 && len <= CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE) {
+		/* Reduce the number of `sendto` calls, copy the data into a single buffer */
+		(void)k_mem_slab_alloc(&msg_buf_slab, (void **)&buf, K_FOREVER);
 
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			memcpy(buf + len, msg->msg_iov[i].iov_base,
-			       msg->msg_iov[i].iov_len);
+		len = 0;
+		for (size_t i = 0; i < msg->msg_iovlen; i++) {
+			memcpy(buf + len, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
 			len += msg->msg_iov[i].iov_len;
 		}
 
-		offset = 0;
-		ret = 0;
-		while ((offset < len) && (ret >= 0)) {
-			ret = nrf91_socket_offload_sendto(obj,
-				(buf + offset), (len - offset), flags,
-				msg->msg_name, msg->msg_namelen);
-			if (ret > 0) {
-				offset += ret;
-			}
+		ret = send_all(sd, buf, len, flags, nrf_to_ptr, nrf_tolen);
+
+		k_mem_slab_free(&msg_buf_slab, (void *)buf);
+		goto exit;
+	}
+
+	/* A single buffer is sent as it is, and buffers that don't fit into the
+	 * intermediate buffer are sent separately.
+	 */
+	len = 0;
+	ret = 0;
+
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
+		if (msg->msg_iov[i].iov_len == 0) {
+			continue;
 		}
 
-		k_mutex_unlock(&sendmsg_lock);
-		return ret;
+		ret = send_all(sd, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len, flags,
+			       nrf_to_ptr, nrf_tolen);
+		if (ret < 0) {
+			goto exit;
+		}
+		len += ret;
 	}
 
-	/* If the data won't fit into intermediate buffer, send the buffers
-	 * separately
+	ret = len;
+
+exit:
+	/* Context might have been freed during this call.
+	 * Check again before accessing.
 	 */
+	if (ctx->lock) {
+		(void) k_mutex_lock(ctx->lock, K_FOREVER);
+	}
 
-	len = 0;
+	return ret;
+}
+
+/* Receive a byte stream directly into the I/O vectors. Once some data has been
+ * received, the following vectors only take the data that is already available.
+ */
+static ssize_t recv_stream_scatter(int sd, struct msghdr *msg, int flags)
+{
+	ssize_t len = 0;
+	ssize_t ret;
 
-	for (i = 0; i < msg->msg_iovlen; i++) {
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
 		if (msg->msg_iov[i].iov_len == 0) {
 			continue;
 		}
 
-		offset = 0;
-		while (offset < msg->msg_iov[i].iov_len) {
-			ret = nrf91_socket_offload_sendto(obj,
-				(((uint8_t *) msg->msg_iov[i].iov_base) + offset),
-				(msg->msg_iov[i].iov_len - offset), flags,
-				msg->msg_name, msg->msg_namelen);
+		ret = nrf_recvfrom(sd, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len, flags,
+				   NULL, NULL);
+		if (ret < 0) {
+			/* Report the data already received, if any */
+			return len > 0 ? len : ret;
+		}
+
+		len += ret;
+
+		if ((size_t)ret < msg->msg_iov[i].iov_len) {
+			break;
+		}
+
+		if (!(flags & NRF_MSG_WAITALL)) {
+			flags |= NRF_MSG_DONTWAIT;
+		}
+	}
+
+	return len;
+}
+
+/* Receive a datagram into an intermediate buffer and scatter it over the I/O vectors.
+ * The buffer is taken only once a datagram is available, and the datagram is
+ * received without blocking. If another thread took the datagram in the meantime,
+ * wait for the next one.
+ */
+static ssize_t recv_dgram_scatter(int sd, struct msghdr *msg, int flags)
+{
+	size_t len = 0;
+	size_t size;
+	size_t offset = 0;
+	ssize_t ret;
+	uint8_t *buf;
+	uint8_t byte;
+
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
+		len += msg->msg_iov[i].iov_len;
+	}
+
+	/* A datagram can't be larger than the shared memory it is received in */
+	size = MIN(len + 1, CONFIG_NRF_MODEM_LIB_SHMEM_RX_SIZE);
+
+	while (true) {
+		if (!(flags & NRF_MSG_DONTWAIT)) {
+			ret = nrf_recvfrom(sd, &byte, sizeof(byte), flags | NRF_MSG_PEEK,
+					   NULL, NULL);
 			if (ret < 0) {
 				return ret;
 			}
-			offset += ret;
-			len += ret;
 		}
+
+		if (size <= RECVMSG_BUF_SIZE) {
+			(void)k_mem_slab_alloc(&recvmsg_buf_slab, (void **)&buf, K_FOREVER);
+		} else {
+			buf = k_malloc(size);
+			if (buf == NULL) {
+				errno = ENOMEM;
+				return -1;
+			}
+		}
+
+		ret = recvfrom_unlocked(sd, buf, size, flags | NRF_MSG_DONTWAIT, msg->msg_name,
+					&msg->msg_namelen);
+
+		if (ret > (ssize_t)len) {
+			msg->msg_flags |= MSG_TRUNC;
+			ret = len;
+		}
+
+		for (size_t i = 0; ret > 0 && offset < (size_t)ret; i++) {
+			size_t chunk = MIN(msg->msg_iov[i].iov_len, ret - offset);
+
+			memcpy(msg->msg_iov[i].iov_base, buf + offset, chunk);
+			offset += chunk;
+		}
+
+		if (size <= RECVMSG_BUF_SIZE) {
+			k_mem_slab_free(&recvmsg_buf_slab, (void *)buf);
+		} else {
+			k_free(buf);
+		}
+
+		if (ret < 0 && errno == EAGAIN && !(flags & NRF_MSG_DONTWAIT)) {
+			continue;
+		}
+
+		return ret;
 	}
+}
 
-	return len;
+static ssize_t nrf91_socket_offload_recvmsg(void *obj, struct msghdr *msg, int flags)
+{
+	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
+	ssize_t retval;
+
+	if (msg == NULL || (msg->msg_iovlen > 0 && msg->msg_iov == NULL)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	msg->msg_flags = 0;
+
+	if (ctx->lock) {
+		(void) k_mutex_unlock(ctx->lock);
+	}
+
+	if (msg->msg_iovlen == 0) {
+		retval = 0;
+	} else if (msg->msg_iovlen == 1) {
+		/* Received directly into the caller's buffer */
+		retval = recvfrom_unlocked(ctx->nrf_fd, msg->msg_iov[0].iov_base,
+					   msg->msg_iov[0].iov_len, flags,
+					   msg->msg_name, &msg->msg_namelen);
+	} else if (ctx->type == SOCK_STREAM && !(flags & NRF_MSG_PEEK)) {
+		retval = recv_stream_scatter(ctx->nrf_fd, msg, flags);
+	} else {
+		retval = recv_dgram_scatter(ctx->nrf_fd, msg, flags);
+	}
+
+	/* Context might have been freed during this call.
+	 * Check again before accessing.
+	 */
+	if (ctx->lock) {
+		(void) k_mutex_lock(ctx->lock, K_FOREVER);
+	}
+
+	return retval;
 }
 
 static void nrf91_socket_offload_freeaddrinfo(struct zsock_addrinfo *root)
@@ -1043,6 +1247,7 @@ static const struct socket_op_vtable nrf91_socket_fd_op_vtable = {
 	.sendto = nrf91_socket_offload_sendto,
 	.sendmsg = nrf91_socket_offload_sendmsg,
 	.recvfrom = nrf91_socket_offload_recvfrom,
+	.recvmsg = nrf91_socket_offload_recvmsg,
 	.getsockopt = nrf91_socket_offload_getsockopt,
 	.setsockopt = nrf91_socket_offload_setsockopt,
 };
@@ -1111,7 +1316,7 @@ static int nrf91_socket_create(int family, int type, int proto)
 		return -1;
 	}
 
-	ctx = allocate_ctx(sd);
+	ctx = allocate_ctx(sd, type);
 	if (ctx == NULL) {
 		errno = ENOMEM;
 		nrf_close(sd);
@@ -9,15 +9,17 @@
 #include <zephyr/kernel.h>
 #include <nrf_modem.h>
 #include <nrf_modem_os.h>
-#include <nrf.h>
-#include <nrfx_ipc.h>
 #include <nrf_errno.h>
 #include <errno.h>
 #include <pm_config.h>
+#include <modem/nrf_modem_lib.h>
 #include <zephyr/logging/log.h>
 
 #define UNUSED_FLAGS 0
-#define THREAD_MONITOR_ENTRIES 10
+#define THREAD_MONITOR_BITS 4
+#define THREAD_MONITOR_ENTRIES BIT(THREAD_MONITOR_BITS)
+#define WAIT_QUEUE_BITS 3
+#define WAIT_QUEUES BIT(WAIT_QUEUE_BITS)
 
 LOG_MODULE_REGISTER(nrf_modem, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
@@ -37,32 +39,66 @@ static uint8_t library_heap_buf[CONFIG_NRF_MODEM_LIB_HEAP_SIZE];
 
 /* An array of thread ID and RPC counter pairs, used to avoid race conditions.
  * It allows to identify whether it is safe to put the thread to sleep or not.
+ * Entries are looked up by open addressing, starting from the hash of the thread ID.
  */
 static struct thread_monitor_entry {
 	k_tid_t id; /* Thread ID. */
 	int cnt; /* Last RPC event count. */
 } thread_event_monitor[THREAD_MONITOR_ENTRIES];
 
-/* A list of threads that are sleeping and should be woken up on next event. */
-static sys_slist_t sleeping_threads;
+/* Sleeping threads, woken up on the next event for their context. Each context is mapped to
+ * one of the wait queues, so that an event only walks the threads that may be waiting on it.
+ * Threads sleeping on context 0 are woken up by any event, and have a queue of their own.
+ */
+static sys_slist_t wait_queues[WAIT_QUEUES];
+static sys_slist_t wait_queue_any;
 
 /* RPC event counter, incremented on each RPC event. */
 static atomic_t rpc_event_cnt;
 
+#if defined(CONFIG_NRF_MODEM_LIB_WAKEUP_STATS)
+static struct nrf_modem_lib_wakeup_stats wakeup_stats;
+static uint32_t waiting;
+
+#define WAKEUP_STATS_INC(field) (wakeup_stats.field++)
+#else
+#define WAKEUP_STATS_INC(field)
+#endif /* CONFIG_NRF_MODEM_LIB_WAKEUP_STATS */
+
+/* Fibonacci hashing, the upper bits of the product are the best distributed. */
+static inline uint32_t hash_index(uint32_t key, uint8_t bits)
+{
+	return (key * 2654435769u) >> (32 - bits);
+}
+
+static sys_slist_t *wait_queue_get(uint32_t context)
+{
+	if (context == 0) {
+		return &wait_queue_any;
+	}
+
+	return &wait_queues[hash_index(context, WAIT_QUEUE_BITS)];
+}
+
 /* Get thread monitor structure assigned to a specific thread id, with a RPC
  * counter value at which nrf_modem_lib last checked the 'readiness' of a thread
  */
 static struct thread_monitor_entry *thread_monitor_entry_get(k_tid_t id)
 {
-	struct thread_monitor_entry *entry = thread_event_monitor;
-	struct thread_monitor_entry *new_entry = thread_event_monitor;
+	const uint32_t start = hash_index((uint32_t)(uintptr_t)id, THREAD_MONITOR_BITS);
+	struct thread_monitor_entry *entry;
+	struct thread_monitor_entry *new_entry = &thread_event_monitor[start];
 	int entry_age, oldest_entry_age = 0;
 
-	for ( ; PART_OF_ARRAY(thread_event_monitor, entry); entry++) {
+	for (size_t i = 0; i < THREAD_MONITOR_ENTRIES; i++) {
+		entry = &thread_event_monitor[(start + i) & (THREAD_MONITOR_ENTRIES - 1)];
+
 		if (entry->id == id) {
 			return entry;
 		} else if (entry->id == 0) {
-			/* Uninitialized field. */
+			/* Uninitialized field. Entries are never removed,
+			 * so the thread is not further in the array.
+			 */
 			new_entry = entry;
 			break;
 		}
@@ -110,7 +146,7 @@ static void sleeping_thread_init(struct sleeping_thread *thread, uint32_t contex
 	thread->context = context;
 }
 
-/* Add thread to the sleeping threads list. Will return information whether
+/* Add thread to the wait queue of its context. Will return information whether
  * the thread was allowed to sleep or not.
  */
 static bool sleeping_thread_add(struct sleeping_thread *thread)
@@ -124,7 +160,13 @@ static bool sleeping_thread_add(struct sleeping_thread *thread)
 
 	if (can_thread_sleep(entry)) {
 		allow_to_sleep = true;
-		sys_slist_append(&sleeping_threads, &thread->node);
+		sys_slist_append(wait_queue_get(thread->context), &thread->node);
+#if defined(CONFIG_NRF_MODEM_LIB_WAKEUP_STATS)
+		waiting++;
+		wakeup_stats.max_waiting = MAX(wakeup_stats.max_waiting, waiting);
+#endif
+	} else {
+		WAKEUP_STATS_INC(sleeps_skipped);
 	}
 
 	irq_unlock(key);
@@ -132,14 +174,20 @@ static bool sleeping_thread_add(struct sleeping_thread *thread)
 	return allow_to_sleep;
 }
 
-/* Remove a thread form the sleeping threads list. */
-static void sleeping_thread_remove(struct sleeping_thread *thread)
+/* Remove a thread form the wait queue of its context. */
+static void sleeping_thread_remove(struct sleeping_thread *thread, bool timed_out)
 {
 	struct thread_monitor_entry *entry;
 
 	uint32_t key = irq_lock();
 
-	sys_slist_find_and_remove(&sleeping_threads, &thread->node);
+	sys_slist_find_and_remove(wait_queue_get(thread->context), &thread->node);
+#if defined(CONFIG_NRF_MODEM_LIB_WAKEUP_STATS)
+	waiting--;
+	if (timed_out) {
+		wakeup_stats.timeouts++;
+	}
+#endif
 
 	entry = thread_monitor_entry_get(k_current_get());
 	thread_monitor_entry_update(entry);
@@ -147,6 +195,39 @@ static void sleeping_thread_remove(struct sleeping_thread *thread)
 	irq_unlock(key);
 }
 
+/* Wake the threads of a wait queue that are waiting on the context. */
+static void wait_queue_wake(sys_slist_t *queue, uint32_t context)
+{
+	struct sleeping_thread *thread;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(queue, thread, node) {
+		/* Wake sleeping thread if context of the thread matches, is 0 or the notify
+		 * context is 0.
+		 */
+		if (thread->context == context) {
+			WAKEUP_STATS_INC(wakeups);
+		} else if ((context == 0) || (thread->context == 0)) {
+			WAKEUP_STATS_INC(spurious_wakeups);
+		} else {
+			/* Another context in the same queue */
+			WAKEUP_STATS_INC(collisions);
+			continue;
+		}
+
+		k_sem_give(&thread->sem);
+	}
+}
+
+/* Wake all sleeping threads. */
+static void wait_queues_wake_all(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(wait_queues); i++) {
+		wait_queue_wake(&wait_queues[i], 0);
+	}
+
+	wait_queue_wake(&wait_queue_any, 0);
+}
+
 void nrf_modem_os_busywait(int32_t usec)
 {
 	k_busy_wait(usec);
@@ -156,6 +237,7 @@ int32_t nrf_modem_os_timedwait(uint32_t context, int32_t *timeout)
 {
 	struct sleeping_thread thread;
 	int64_t start, remaining;
+	bool timed_out;
 
 	if (!nrf_modem_is_initialized()) {
 		return -NRF_ESHUTDOWN;
@@ -190,9 +272,9 @@ int32_t nrf_modem_os_timedwait(uint32_t context, int32_t *timeout)
 #pragma GCC diagnostic pop
 #endif /* __GNUC__ */
 
-	(void)k_sem_take(&thread.sem, SYS_TIMEOUT_MS(*timeout));
+	timed_out = (k_sem_take(&thread.sem, SYS_TIMEOUT_MS(*timeout)) == -EAGAIN);
 
-	sleeping_thread_remove(&thread);
+	sleeping_thread_remove(&thread, timed_out);
 
 	if (!nrf_modem_is_initialized()) {
 		return -NRF_ESHUTDOWN;
@@ -344,16 +426,15 @@ void nrf_modem_os_event_notify(uint32_t context)
 {
 	atomic_inc(&rpc_event_cnt);
 
-	struct sleeping_thread *thread;
+	WAKEUP_STATS_INC(events);
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&sleeping_threads, thread, node) {
-		/* Wake sleeping thread if context of the thread matches, is 0 or the notify
-		 * context is 0.
-		 */
-		if ((thread->context == context) || (context == 0) || (thread->context == 0)) {
-			k_sem_give(&thread->sem);
-		}
+	if (context == 0) {
+		wait_queues_wake_all();
+		return;
 	}
+
+	wait_queue_wake(wait_queue_get(context), context);
+	wait_queue_wake(&wait_queue_any, context);
 }
 
 void *nrf_modem_os_alloc(size_t bytes)
@@ -471,11 +552,15 @@ void nrf_modem_os_logdump(int level, const char *str, const void *data, size_t l
 /* On application initialization */
 static int on_init(void)
 {
-	/* The list of sleeping threads should only be initialized once at the application
-	 * initialization. This is because we want to keep the list intact regardless of modem
+	/* The lists of sleeping threads should only be initialized once at the application
+	 * initialization. This is because we want to keep the lists intact regardless of modem
 	 * reinitialization to wake sleeping threads on modem initialization.
 	 */
-	sys_slist_init(&sleeping_threads);
+	for (size_t i = 0; i < ARRAY_SIZE(wait_queues); i++) {
+		sys_slist_init(&wait_queues[i]);
+	}
+
+	sys_slist_init(&wait_queue_any);
 	atomic_clear(&rpc_event_cnt);
 
 	return 0;
@@ -494,12 +579,35 @@ void nrf_modem_os_init(void)
 
 void nrf_modem_os_shutdown(void)
 {
-	struct sleeping_thread *thread;
-
 	/* Wake up all sleeping threads. */
-	SYS_SLIST_FOR_EACH_CONTAINER(&sleeping_threads, thread, node) {
-		k_sem_give(&thread->sem);
+	wait_queues_wake_all();
+}
+
+#if defined(CONFIG_NRF_MODEM_LIB_WAKEUP_STATS)
+int nrf_modem_lib_wakeup_stats_get(struct nrf_modem_lib_wakeup_stats *stats)
+{
+	uint32_t key;
+
+	if (!stats) {
+		return -EFAULT;
 	}
+
+	key = irq_lock();
+	*stats = wakeup_stats;
+	irq_unlock(key);
+
+	return 0;
+}
+
+void nrf_modem_lib_wakeup_stats_reset(void)
+{
+	uint32_t key = irq_lock();
+
+	memset(&wakeup_stats, 0, sizeof(wakeup_stats));
+	wakeup_stats.max_waiting = waiting;
+
+	irq_unlock(key);
 }
+#endif /* CONFIG_NRF_MODEM_LIB_WAKEUP_STATS */
 
 SYS_INIT(on_init, POST_KERNEL, 0);
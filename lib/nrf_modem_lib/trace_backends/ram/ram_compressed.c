@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <sys/errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/logging/log.h>
+#include <modem/trace_backend.h>
+#include <modem/nrf_modem_lib_trace.h>
+
+LOG_MODULE_REGISTER(modem_trace_backend, CONFIG_MODEM_TRACE_BACKEND_LOG_LEVEL);
+
+#define BLOCK_SIZE CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RAM_BLOCK_SIZE
+
+/* Changed along with the layout of the data kept over a reboot. */
+#define RAM_TRACE_MAGIC 0xdeadbe2f
+
+/* Blocks are compressed in the LZ4 block format, so that they can also be
+ * decompressed with standard tools.
+ */
+#define LZ_HASH_BITS 10
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5
+#define LZ_MATCH_LIMIT 12
+#define LZ_BOUND(len) ((len) + (len) / 255 + 16)
+
+/* Header of a block in the RAM buffer. A block that did not compress is stored
+ * as it is, with the same stored and raw length.
+ */
+struct block_hdr {
+	uint16_t raw_len;
+	uint16_t stored_len;
+};
+
+BUILD_ASSERT(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RAM_LENGTH >=
+	     2 * (sizeof(struct block_hdr) + BLOCK_SIZE),
+	     "RAM buffer must hold at least two blocks");
+
+/* Let's put this in noinit, so it can be read out after a crash/reboot.
+ * This includes the trace data that is not compressed yet, the block that is
+ * partially read and the frozen state, which are all covered by the magic.
+ */
+static __noinit uint8_t _ring_buffer_data_ram_trace_buf[
+	CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RAM_LENGTH
+];
+
+__noinit struct ring_buf ram_trace_buf;
+__noinit uint32_t ram_trace_buf_magic;
+/* Number of trace bytes in the RAM buffer, after decompression. */
+static __noinit uint32_t ram_trace_raw_size;
+
+/* Trace data waiting to be compressed. */
+static __noinit uint8_t raw_block[BLOCK_SIZE];
+static __noinit uint32_t raw_len;
+
+/* Decompressed block, being read. Its unread bytes are part of the raw size. */
+static __noinit uint8_t read_block[BLOCK_SIZE];
+static __noinit uint32_t read_len;
+static __noinit uint32_t read_offset;
+
+static __noinit bool frozen;
+
+static K_MUTEX_DEFINE(ram_trace_lock);
+
+static trace_backend_processed_cb trace_processed_callback;
+
+/* Compressed block, being written or read. */
+static uint8_t stored_block[LZ_BOUND(BLOCK_SIZE)];
+
+static uint16_t lz_hash_table[BIT(LZ_HASH_BITS)];
+
+static struct nrf_modem_lib_trace_compress_stats stats;
+
+static bool is_initialized(void)
+{
+	return ram_trace_buf_magic == RAM_TRACE_MAGIC;
+}
+
+/* Check the state kept over a reboot, in case the magic survived but the state did not. */
+static bool is_consistent(void)
+{
+	return ram_trace_buf.buffer == _ring_buffer_data_ram_trace_buf &&
+	       ram_trace_buf.size == ARRAY_SIZE(_ring_buffer_data_ram_trace_buf) &&
+	       raw_len <= BLOCK_SIZE &&
+	       read_len <= BLOCK_SIZE &&
+	       read_offset <= read_len &&
+	       ram_trace_raw_size >= read_len - read_offset;
+}
+
+static uint32_t lz_hash(const uint8_t *ptr)
+{
+	uint32_t seq;
+
+	memcpy(&seq, ptr, sizeof(seq));
+
+	return (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+static uint8_t *lz_length_put(uint8_t *op, size_t len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+
+	*op++ = len;
+
+	return op;
+}
+
+static uint8_t *lz_sequence_put(uint8_t *op, const uint8_t *literals, size_t lit_len,
+				size_t offset, size_t match_len)
+{
+	uint8_t *token = op++;
+
+	*token = MIN(lit_len, 15) << 4;
+	if (lit_len >= 15) {
+		op = lz_length_put(op, lit_len - 15);
+	}
+
+	memcpy(op, literals, lit_len);
+	op += lit_len;
+
+	if (offset == 0) {
+		/* Last sequence, literals only */
+		return op;
+	}
+
+	*op++ = offset & 0xff;
+	*op++ = offset >> 8;
+
+	match_len -= LZ_MIN_MATCH;
+	*token |= MIN(match_len, 15);
+	if (match_len >= 15) {
+		op = lz_length_put(op, match_len - 15);
+	}
+
+	return op;
+}
+
+/* Compress @p len bytes from @p src into @p dst, which must hold LZ_BOUND(len) bytes. */
+static size_t lz_compress(const uint8_t *src, size_t len, uint8_t *dst)
+{
+	const uint8_t *const end = src + len;
+	const uint8_t *ip = src;
+	const uint8_t *anchor = src;
+	uint8_t *op = dst;
+
+	while (len > LZ_MATCH_LIMIT && ip < end - LZ_MATCH_LIMIT) {
+		uint32_t hash = lz_hash(ip);
+		const uint8_t *ref = src + lz_hash_table[hash];
+		const uint8_t *match_end;
+
+		lz_hash_table[hash] = ip - src;
+
+		/* The table is not cleared between blocks, stale entries are filtered here */
+		if (ref >= ip || memcmp(ref, ip, LZ_MIN_MATCH) != 0) {
+			ip++;
+			continue;
+		}
+
+		match_end = ip + LZ_MIN_MATCH;
+		ref += LZ_MIN_MATCH;
+		while (match_end < end - LZ_LAST_LITERALS && *match_end == *ref) {
+			match_end++;
+			ref++;
+		}
+
+		op = lz_sequence_put(op, anchor, ip - anchor, match_end - ref,
+				     match_end - ip);
+
+		ip = match_end;
+		anchor = ip;
+	}
+
+	op = lz_sequence_put(op, anchor, end - anchor, 0, 0);
+
+	return op - dst;
+}
+
+static int lz_length_get(const uint8_t **ip, const uint8_t *end, size_t *len)
+{
+	uint8_t byte;
+
+	do {
+		if (*ip >= end) {
+			return -EBADMSG;
+		}
+
+		byte = *(*ip)++;
+		*len += byte;
+	} while (byte == 255);
+
+	return 0;
+}
+
+static int lz_decompress(const uint8_t *src, size_t len, uint8_t *dst, size_t dst_size)
+{
+	const uint8_t *const end = src + len;
+	const uint8_t *ip = src;
+	uint8_t *op = dst;
+
+	while (ip < end) {
+		uint8_t token = *ip++;
+		size_t lit_len = token >> 4;
+		size_t match_len = token & 0x0f;
+		size_t offset;
+
+		if (lit_len == 15 && lz_length_get(&ip, end, &lit_len)) {
+			return -EBADMSG;
+		}
+
+		if (lit_len > (size_t)(end - ip) || lit_len > (size_t)(dst + dst_size - op)) {
+			return -EBADMSG;
+		}
+
+		memcpy(op, ip, lit_len);
+		op += lit_len;
+		ip += lit_len;
+
+		if (ip == end) {
+			break;
+		}
+
+		if (end - ip < 2) {
+			return -EBADMSG;
+		}
+
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (match_len == 15 && lz_length_get(&ip, end, &match_len)) {
+			return -EBADMSG;
+		}
+
+		match_len += LZ_MIN_MATCH;
+
+		if (offset == 0 || offset > (size_t)(op - dst) ||
+		    match_len > (size_t)(dst + dst_size - op)) {
+			return -EBADMSG;
+		}
+
+		/* The match can overlap the output, copy byte by byte */
+		for (const uint8_t *ref = op - offset; match_len > 0; match_len--) {
+			*op++ = *ref++;
+		}
+	}
+
+	return op - dst;
+}
+
+/* Compress the pending trace data and store it, dropping the oldest blocks if needed. */
+static void block_store(void)
+{
+	struct block_hdr hdr = {
+		.raw_len = raw_len,
+	};
+	const uint8_t *payload = stored_block;
+
+	if (raw_len == 0) {
+		return;
+	}
+
+	hdr.stored_len = lz_compress(raw_block, raw_len, stored_block);
+	if (hdr.stored_len >= raw_len) {
+		hdr.stored_len = raw_len;
+		payload = raw_block;
+	}
+
+	while (ring_buf_space_get(&ram_trace_buf) < sizeof(hdr) + hdr.stored_len) {
+		struct block_hdr oldest;
+
+		(void)ring_buf_get(&ram_trace_buf, (uint8_t *)&oldest, sizeof(oldest));
+		(void)ring_buf_get(&ram_trace_buf, NULL, oldest.stored_len);
+
+		ram_trace_raw_size -= oldest.raw_len;
+		stats.dropped_bytes += oldest.raw_len;
+	}
+
+	(void)ring_buf_put(&ram_trace_buf, (uint8_t *)&hdr, sizeof(hdr));
+	(void)ring_buf_put(&ram_trace_buf, payload, hdr.stored_len);
+
+	ram_trace_raw_size += hdr.raw_len;
+	stats.stored_bytes += sizeof(hdr) + hdr.stored_len;
+	stats.blocks++;
+
+	raw_len = 0;
+}
+
+/* Decompress the oldest block into the read buffer. */
+static int block_load(void)
+{
+	struct block_hdr hdr;
+	int ret;
+
+	if (ring_buf_get(&ram_trace_buf, (uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+	    hdr.raw_len > BLOCK_SIZE || hdr.stored_len > sizeof(stored_block) ||
+	    ring_buf_get(&ram_trace_buf, stored_block, hdr.stored_len) != hdr.stored_len) {
+		return -EBADMSG;
+	}
+
+	if (hdr.stored_len == hdr.raw_len) {
+		memcpy(read_block, stored_block, hdr.raw_len);
+		ret = hdr.raw_len;
+	} else {
+		ret = lz_decompress(stored_block, hdr.stored_len, read_block, sizeof(read_block));
+	}
+
+	if (ret != hdr.raw_len) {
+		return -EBADMSG;
+	}
+
+	read_len = ret;
+	read_offset = 0;
+
+	return 0;
+}
+
+static void ram_trace_reset(void)
+{
+	ring_buf_reset(&ram_trace_buf);
+	ram_trace_raw_size = 0;
+	raw_len = 0;
+	read_len = 0;
+	read_offset = 0;
+	frozen = false;
+}
+
+int trace_backend_init(trace_backend_processed_cb trace_processed_cb)
+{
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+
+	if (!is_initialized() || !is_consistent()) {
+		ram_trace_buf.buffer = _ring_buffer_data_ram_trace_buf;
+		ram_trace_buf.size = ARRAY_SIZE(_ring_buffer_data_ram_trace_buf);
+		ram_trace_reset();
+		ram_trace_buf_magic = RAM_TRACE_MAGIC;
+	}
+	trace_processed_callback = trace_processed_cb;
+
+	k_mutex_unlock(&ram_trace_lock);
+
+	return 0;
+}
+
+int trace_backend_deinit(void)
+{
+	/* Store the pending trace data, it is the last before the modem was shut down */
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+	block_store();
+	k_mutex_unlock(&ram_trace_lock);
+
+	return 0;
+}
+
+size_t trace_backend_data_size(void)
+{
+	size_t size;
+
+	if (!is_initialized()) {
+		return -EPERM;
+	}
+
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+	size = ram_trace_raw_size + raw_len;
+	k_mutex_unlock(&ram_trace_lock);
+
+	return size;
+}
+
+int trace_backend_read(void *buf, size_t len)
+{
+	size_t read = 0;
+	int err;
+
+	if (!is_initialized()) {
+		return -EPERM;
+	}
+
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+
+	/* Include the trace data that is not compressed yet */
+	block_store();
+
+	while (read < len) {
+		size_t chunk;
+
+		if (read_offset == read_len) {
+			if (ring_buf_is_empty(&ram_trace_buf)) {
+				break;
+			}
+
+			err = block_load();
+			if (err) {
+				LOG_ERR("Corrupted trace data, clearing");
+				ram_trace_reset();
+				k_mutex_unlock(&ram_trace_lock);
+				return err;
+			}
+		}
+
+		chunk = MIN(len - read, read_len - read_offset);
+		memcpy((uint8_t *)buf + read, read_block + read_offset, chunk);
+		read_offset += chunk;
+		read += chunk;
+		ram_trace_raw_size -= chunk;
+	}
+
+	k_mutex_unlock(&ram_trace_lock);
+
+	return read;
+}
+
+int trace_backend_write(const void *data, size_t len)
+{
+	if (!is_initialized()) {
+		return -EPERM;
+	}
+
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+
+	if (frozen) {
+		stats.frozen_bytes += len;
+	} else {
+		len = MIN(len, BLOCK_SIZE - raw_len);
+		memcpy(raw_block + raw_len, data, len);
+		raw_len += len;
+		stats.raw_bytes += len;
+
+		if (raw_len == BLOCK_SIZE) {
+			block_store();
+		}
+	}
+
+	k_mutex_unlock(&ram_trace_lock);
+
+	trace_processed_callback(len);
+
+	return len;
+}
+
+int trace_backend_clear(void)
+{
+	if (!is_initialized()) {
+		return -EPERM;
+	}
+
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+	ram_trace_reset();
+	k_mutex_unlock(&ram_trace_lock);
+
+	return 0;
+}
+
+int nrf_modem_lib_trace_freeze(void)
+{
+	if (!is_initialized()) {
+		return -EPERM;
+	}
+
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+	block_store();
+	frozen = true;
+	k_mutex_unlock(&ram_trace_lock);
+
+	LOG_INF("Trace frozen, %u bytes stored", ram_trace_raw_size);
+
+	return 0;
+}
+
+int nrf_modem_lib_trace_compress_stats_get(struct nrf_modem_lib_trace_compress_stats *out)
+{
+	if (!out) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&ram_trace_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&ram_trace_lock);
+
+	return 0;
+}
+
+struct nrf_modem_lib_trace_backend trace_backend = {
+	.init = trace_backend_init,
+	.deinit = trace_backend_deinit,
+	.write = trace_backend_write,
+	.data_size = trace_backend_data_size,
+	.read = trace_backend_read,
+	.clear = trace_backend_clear,
+};
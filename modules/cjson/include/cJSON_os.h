@@ -15,8 +15,7 @@
 void cJSON_Init(void);
 
 /**
- * @brief Free a string created and returned by cJSON.
- * @return returns the return value of the free implementation.
+ * @brief Free a string created and returned by cJSON, with the current cJSON hooks.
  * @param ptr IN -- pointer to string to free
  */
 void cJSON_FreeString(char *ptr);
@@ -28,5 +28,6 @@ void cJSON_Init(void)
 
 void cJSON_FreeString(char *ptr)
 {
-	free_fn_hook(ptr);
+	/* The string may come from hooks other than the OS ones */
+	cJSON_free(ptr);
 }
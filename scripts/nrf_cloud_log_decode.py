@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+
+"""
+Decode dictionary-based logs sent to nRF Cloud by the nRF Cloud logging backend.
+
+Each binary message starts with a header (struct nrf_cloud_bin_hdr) followed by
+the dictionary-based log messages of one upload. The input files may contain one
+or more such binary messages back to back. Binary messages are split by walking the
+length fields of the log messages they contain, since log data may itself contain
+the header bytes. The log messages are decoded with the Zephyr dictionary log
+parser, using the log_dictionary.json file of the build.
+"""
+
+import argparse
+import datetime
+import os
+import struct
+import sys
+
+NRF_CLOUD_BINARY_MAGIC = 0x4346526e
+NRF_CLOUD_DICT_LOG_FMT = 0x0001
+
+# struct nrf_cloud_bin_hdr: magic, format, pad, ts, sequence
+BIN_HDR = struct.Struct("<IHHqI")
+BIN_HDR_START = struct.pack("<IH", NRF_CLOUD_BINARY_MAGIC, NRF_CLOUD_DICT_LOG_FMT)
+
+# Zephyr dictionary log message types
+MSG_TYPE_NORMAL = 0
+MSG_TYPE_DROPPED = 1
+
+
+def argument_parser():
+    parser = argparse.ArgumentParser(
+        description="Decode nRF Cloud dictionary-based log messages",
+        allow_abbrev=False
+    )
+    parser.add_argument(
+        "dbfile",
+        help="Dictionary logging database file (log_dictionary.json)"
+    )
+    parser.add_argument(
+        "logfiles",
+        nargs="+",
+        help="Files containing binary log messages downloaded from nRF Cloud"
+    )
+    parser.add_argument(
+        "--zephyr-base",
+        default=os.environ.get("ZEPHYR_BASE"),
+        help="Zephyr repository, to locate the dictionary log parser "
+             "(default: $ZEPHYR_BASE)"
+    )
+    parser.add_argument(
+        "--debug",
+        action="store_true",
+        help="Print debug information from the log parser"
+    )
+    return parser
+
+
+class LogMsgFormat:
+    """Sizes of the dictionary log message fields, as built for the target."""
+
+    def __init__(self, database):
+        endian = "<" if database.is_tgt_little_endian() else ">"
+        source = "Q" if database.is_tgt_64bit() else "I"
+        timestamp = "Q" if database.has_kconfig("CONFIG_LOG_TIMESTAMP_64BIT") else "I"
+
+        # type, domain and level, package length, data length, source, timestamp
+        self.normal = struct.Struct(endian + "BBHH" + source + timestamp)
+        # type, number of dropped messages
+        self.dropped = struct.Struct(endian + "BH")
+
+    def msg_len(self, data, offset):
+        """Return the length of the log message at offset in data."""
+        if data[offset] == MSG_TYPE_NORMAL:
+            if offset + self.normal.size > len(data):
+                raise ValueError(f"Truncated log message at offset {offset}")
+            _, _, pkg_len, data_len, _, _ = self.normal.unpack_from(data, offset)
+            return self.normal.size + pkg_len + data_len
+        if data[offset] == MSG_TYPE_DROPPED:
+            return self.dropped.size
+        raise ValueError(f"Unknown log message type {data[offset]} at offset {offset}")
+
+
+def split_messages(data, msg_format):
+    """Yield (ts, sequence, payload) for each binary message in data."""
+    start = 0
+    while start < len(data):
+        if data[start:start + len(BIN_HDR_START)] != BIN_HDR_START:
+            raise ValueError(f"No nRF Cloud dictionary log header at offset {start}")
+        _, _, _, ts, sequence = BIN_HDR.unpack_from(data, start)
+
+        end = start + BIN_HDR.size
+        while end < len(data) and data[end:end + len(BIN_HDR_START)] != BIN_HDR_START:
+            end += msg_format.msg_len(data, end)
+        if end > len(data):
+            raise ValueError(f"Truncated log message in binary message at offset {start}")
+
+        yield ts, sequence, data[start + BIN_HDR.size:end]
+        start = end
+
+
+def load_parser(zephyr_base, dbfile):
+    if not zephyr_base:
+        sys.exit("Zephyr repository not found; set ZEPHYR_BASE or use --zephyr-base")
+
+    sys.path.insert(0, os.path.join(zephyr_base, "scripts", "logging", "dictionary"))
+
+    import dictionary_parser
+    from dictionary_parser.log_database import LogDatabase
+
+    database = LogDatabase.read_json_database(dbfile)
+    if database is None:
+        sys.exit(f"Cannot open database file {dbfile}")
+
+    log_parser = dictionary_parser.get_parser(database)
+    if log_parser is None:
+        sys.exit("Unsupported log database version")
+
+    return database, log_parser
+
+
+def main():
+    args = argument_parser().parse_args()
+    database, log_parser = load_parser(args.zephyr_base, args.dbfile)
+    msg_format = LogMsgFormat(database)
+
+    for logfile in args.logfiles:
+        with open(logfile, "rb") as f:
+            data = f.read()
+
+        try:
+            messages = list(split_messages(data, msg_format))
+        except ValueError as e:
+            sys.exit(f"{logfile}: {e}")
+
+        for ts, sequence, payload in messages:
+            if ts > 0:
+                when = datetime.datetime.fromtimestamp(ts / 1000, datetime.timezone.utc)
+                print(f"--- {when.isoformat()}, sequence {sequence}, {len(payload)} bytes")
+            else:
+                print(f"--- sequence {sequence}, {len(payload)} bytes")
+
+            if not log_parser.parse_log_data(payload, debug=args.debug):
+                print("Error parsing log data", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
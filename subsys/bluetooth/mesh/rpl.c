@@ -22,6 +22,141 @@ static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
 EMDS_STATIC_ENTRY_DEFINE(rpl_store, CONFIG_BT_MESH_RPL_INDEX, replay_list, sizeof(replay_list));
 
+#if defined(CONFIG_BT_MESH_RPL_HASH_INDEX)
+/* Open-addressed hash index over the replay list, keyed on the source address.
+ * The index lives in RAM only and is rebuilt from the replay list whenever it
+ * is invalidated, so the layout of the EMDS entry is unaffected. The table has
+ * at least twice as many buckets as the replay list to keep probe sequences
+ * short when the replay list is full.
+ */
+#define RPL_INDEX_BITS (LOG2CEIL(CONFIG_BT_MESH_CRPL) + 1)
+#define RPL_INDEX_SIZE BIT(RPL_INDEX_BITS)
+#define RPL_INDEX_EMPTY UINT16_MAX
+
+BUILD_ASSERT(CONFIG_BT_MESH_CRPL < RPL_INDEX_EMPTY, "RPL too large for the hash index");
+
+static uint16_t rpl_index[RPL_INDEX_SIZE];
+/* Number of occupied entries at the start of replay_list. */
+static uint16_t rpl_count;
+/* The index is built lazily, as the replay list may be restored from EMDS
+ * after this module has been initialized.
+ */
+static bool rpl_index_valid;
+/* EMDS load count of the replay list when the index was built. A restore
+ * overwrites the replay list, so the index is rebuilt after it.
+ */
+static uint32_t rpl_index_load_count;
+
+static uint32_t rpl_hash(uint16_t src)
+{
+	/* Fibonacci hashing, using the upper bits of the product. */
+	return ((uint32_t)src * 2654435769U) >> (32 - RPL_INDEX_BITS);
+}
+
+/* Returns the bucket that either holds the given source address, or the empty
+ * bucket where it should be inserted.
+ */
+static uint16_t *rpl_index_bucket(uint16_t src)
+{
+	uint32_t i = rpl_hash(src);
+
+	while (rpl_index[i] != RPL_INDEX_EMPTY && replay_list[rpl_index[i]].src != src) {
+		i = (i + 1) & (RPL_INDEX_SIZE - 1);
+	}
+
+	return &rpl_index[i];
+}
+
+static void rpl_index_rebuild(void)
+{
+	(void)memset(rpl_index, 0xff, sizeof(rpl_index));
+
+	/* The replay list is always kept compact, so the first empty slot
+	 * marks the end of the occupied entries.
+	 */
+	for (rpl_count = 0; rpl_count < ARRAY_SIZE(replay_list); rpl_count++) {
+		if (!replay_list[rpl_count].src) {
+			break;
+		}
+
+		*rpl_index_bucket(replay_list[rpl_count].src) = rpl_count;
+	}
+
+	rpl_index_load_count = emds_rpl_store_state.load_count;
+	rpl_index_valid = true;
+}
+
+static bool rpl_index_is_valid(void)
+{
+	return rpl_index_valid && rpl_index_load_count == emds_rpl_store_state.load_count;
+}
+
+static struct bt_mesh_rpl *rpl_lookup(uint16_t src)
+{
+	uint16_t *bucket;
+
+	if (!rpl_index_is_valid()) {
+		rpl_index_rebuild();
+	}
+
+	bucket = rpl_index_bucket(src);
+	if (*bucket != RPL_INDEX_EMPTY) {
+		return &replay_list[*bucket];
+	}
+
+	if (rpl_count < ARRAY_SIZE(replay_list)) {
+		return &replay_list[rpl_count];
+	}
+
+	return NULL;
+}
+
+static void rpl_index_update(struct bt_mesh_rpl *rpl, uint16_t src)
+{
+	size_t slot = rpl - replay_list;
+
+	if (!rpl_index_is_valid() || rpl->src == src) {
+		return;
+	}
+
+	if (!rpl->src && slot == rpl_count) {
+		*rpl_index_bucket(src) = slot;
+		rpl_count++;
+		return;
+	}
+
+	/* The slot was handed out for another source address, e.g. by two
+	 * interleaved segmented messages. This is rare, so just rebuild the
+	 * index on the next lookup.
+	 */
+	rpl_index_valid = false;
+}
+#else
+/* Returns the slot holding the given source address, the first empty slot if
+ * the address is not in the list, or NULL if the list is full.
+ */
+static struct bt_mesh_rpl *rpl_lookup(uint16_t src)
+{
+	for (int i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		struct bt_mesh_rpl *rpl = &replay_list[i];
+
+		if (!rpl->src || rpl->src == src) {
+			return rpl;
+		}
+	}
+
+	return NULL;
+}
+
+static void rpl_index_update(struct bt_mesh_rpl *rpl, uint16_t src)
+{
+}
+
+static void rpl_index_rebuild(void)
+{
+}
+#endif /* CONFIG_BT_MESH_RPL_HASH_INDEX */
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
@@ -32,6 +167,8 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		rpl->seg = 0;
 	}
 
+	rpl_index_update(rpl, rx->ctx.addr);
+
 	rpl->src = rx->ctx.addr;
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
@@ -45,7 +182,7 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -57,48 +194,46 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
-
-		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
+	rpl = rpl_lookup(rx->ctx.addr);
+	if (!rpl) {
+		LOG_ERR("RPL is full!");
+		return true;
+	}
 
-			return false;
+	/* Empty slot */
+	if (!rpl->src) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		return false;
+	}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+	/* Existing slot for given address */
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
 
-				return false;
-			} else {
-				return true;
-			}
+	if ((!rx->old_iv && rpl->old_iv) ||
+	    rpl->seq < rx->seq) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
+
+		return false;
 	}
 
-	LOG_ERR("RPL is full!");
 	return true;
 }
 
 void bt_mesh_rpl_clear(void)
 {
 	(void)memset(replay_list, 0, sizeof(replay_list));
+	rpl_index_rebuild();
 }
 
 void bt_mesh_rpl_reset(void)
@@ -130,6 +265,11 @@ void bt_mesh_rpl_reset(void)
 	}
 
 	(void) memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+
+	/* Entries have moved, so the index must be rebuilt. This only happens
+	 * once per IV Index update, and costs one pass over the replay list.
+	 */
+	rpl_index_rebuild();
 }
 
 void bt_mesh_rpl_pending_store(uint16_t addr)
@@ -955,6 +955,54 @@ int bt_mesh_sensor_value_from_micro(
 	return format->cb->from_float(format, val / 1000000.0f, sensor_val);
 }
 
+int bt_mesh_sensor_values_from_micro(
+	const struct bt_mesh_sensor_format *format,
+	const int64_t *vals, size_t count,
+	struct bt_mesh_sensor_value *sensor_vals)
+{
+	int (*const from_micro)(const struct bt_mesh_sensor_format *format,
+				int64_t val,
+				struct bt_mesh_sensor_value *sensor_val) =
+		format->cb->from_micro;
+	int ret = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		int err;
+
+		if (from_micro) {
+			err = from_micro(format, vals[i], &sensor_vals[i]);
+		} else {
+			err = format->cb->from_float(format, vals[i] / 1000000.0f,
+						     &sensor_vals[i]);
+		}
+
+		if (err == -ERANGE) {
+			ret = err;
+		} else if (err) {
+			return err;
+		}
+	}
+
+	return ret;
+}
+
+size_t bt_mesh_sensor_values_to_micro(
+	const struct bt_mesh_sensor_value *sensor_vals, size_t count,
+	int64_t *vals)
+{
+	enum bt_mesh_sensor_value_status status;
+	size_t numeric = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		status = bt_mesh_sensor_value_to_micro(&sensor_vals[i], &vals[i]);
+		if (bt_mesh_sensor_value_status_is_numeric(status)) {
+			numeric++;
+		}
+	}
+
+	return numeric;
+}
+
 enum bt_mesh_sensor_value_status
 bt_mesh_sensor_value_to_sensor_value(
 	const struct bt_mesh_sensor_value *sensor_val,
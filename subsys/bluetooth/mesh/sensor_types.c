@@ -14,8 +14,8 @@
 
 /* Constants: */
 
-/* logf(1.1f) */
-#define LOG_1_1 (0.095310203f)
+/* sqrtf(1.1f) */
+#define SQRT_1_1 (1.04880885f)
 
 /* Various shorthand macros to improve readability and maintainability of this
  * file:
@@ -96,14 +96,25 @@ UNIT(unitless) = { "Unitless" };
 
 #define SCALAR_IS_DIV(_scalar) ((_scalar) > -1.0 && (_scalar) < 1.0)
 
+#define SCALAR_VALUE(_scalar)                                                  \
+	((int64_t)((SCALAR_IS_DIV(_scalar) ? (1.0 / (_scalar)) : (_scalar)) + 0.5))
+
+/* Multiplier from the encoded value to micro units, or 0 if the multiplier
+ * isn't an integer.
+ */
+#define SCALAR_MICRO(_scalar)                                                  \
+	(!SCALAR_IS_DIV(_scalar) ? SCALAR_VALUE(_scalar) * 1000000LL :         \
+	 (1000000LL % SCALAR_VALUE(_scalar)) ? 0 :                             \
+	 1000000LL / SCALAR_VALUE(_scalar))
+
 #define SCALAR_REPR_RANGED(_scalar, _flags, _min, _max)                              \
 	{                                                                      \
 		.flags = ((_flags) | (SCALAR_IS_DIV(_scalar) ? DIVIDE : 0)),   \
 		.min = _min,                                                   \
 		.max = _max,                                                   \
-		.value = (int64_t)((SCALAR_IS_DIV(_scalar) ? (1.0 / (_scalar)) : \
-							   (_scalar)) +        \
-				 0.5),                                         \
+		.value = SCALAR_VALUE(_scalar),                                \
+		.micro = SCALAR_MICRO(_scalar),                                \
+		.ratio = (float)(_scalar),                                     \
 	}
 
 #define SCALAR_REPR(_scalar, _flags) SCALAR_REPR_RANGED(_scalar, _flags, 0, 0)
@@ -219,6 +230,10 @@ struct scalar_repr {
 	int32_t min;
 	uint32_t max; /**< Highest encoded value */
 	int64_t value;
+	/** Encoded value to micro units multiplier, or 0 if not an integer. */
+	int64_t micro;
+	/** Encoded value to float multiplier. */
+	float ratio;
 };
 
 static uint32_t scalar_type_max(const struct bt_mesh_sensor_format *format)
@@ -424,7 +439,8 @@ static int scalar_decode(const struct bt_mesh_sensor_format *format,
 		return 0;
 	}
 
-	int64_t million = MUL_SCALAR(raw * 1000000LL, repr);
+	int64_t million = repr->micro ? raw * repr->micro :
+					MUL_SCALAR(raw * 1000000LL, repr);
 
 	val->val1 = million / 1000000LL;
 	val->val2 = million % 1000000LL;
@@ -547,11 +563,6 @@ static inline int64_t mul_scalar(int64_t val, const struct scalar_repr *repr)
 		DIV_ROUND_CLOSEST(val, repr->value) : val * repr->value;
 }
 
-static inline float mul_scalar_f(float val, const struct scalar_repr *repr)
-{
-	return repr->flags & DIVIDE ? val / repr->value : val * repr->value;
-}
-
 static inline int64_t div_scalar(int64_t val, const struct scalar_repr *repr)
 {
 	return repr->flags & DIVIDE ?
@@ -751,7 +762,7 @@ scalar_to_float(const struct bt_mesh_sensor_value *sensor_val, float *val)
 	if (val && bt_mesh_sensor_value_status_is_numeric(status)) {
 		const struct scalar_repr *repr = sensor_val->format->user_data;
 
-		*val = mul_scalar_f(raw, repr);
+		*val = raw * repr->ratio;
 	}
 
 	return status;
@@ -789,7 +800,8 @@ scalar_to_micro(const struct bt_mesh_sensor_value *sensor_val, int64_t *val)
 	if (val && bt_mesh_sensor_value_status_is_numeric(status)) {
 		const struct scalar_repr *repr = sensor_val->format->user_data;
 
-		*val = mul_scalar(raw * 1000000LL, repr);
+		*val = repr->micro ? raw * repr->micro :
+				     mul_scalar(raw * 1000000LL, repr);
 	}
 
 	return status;
@@ -800,8 +812,19 @@ static int scalar_from_micro(const struct bt_mesh_sensor_format *format,
 			     struct bt_mesh_sensor_value *sensor_val)
 {
 	const struct scalar_repr *repr = format->user_data;
-	int64_t raw = div_scalar(val / 1000000, repr) +
+	int64_t raw;
+
+	if ((repr->flags & DIVIDE) && repr->micro) {
+		/* Avoid the 64-bit division for values that fit in 32 bits. */
+		if (IN_RANGE(val, INT32_MIN / 2, INT32_MAX / 2)) {
+			raw = DIV_ROUND_CLOSEST((int32_t)val, (int32_t)repr->micro);
+		} else {
+			raw = DIV_ROUND_CLOSEST(val, repr->micro);
+		}
+	} else {
+		raw = div_scalar(val / 1000000, repr) +
 		      DIV_ROUND_CLOSEST(div_scalar(val % 1000000, repr), 1000000LL);
+	}
 
 	return scalar_from_raw(format, raw, sensor_val);
 }
@@ -1037,13 +1060,99 @@ static uint8_t exp_1_1_ceil_abs_diff(uint8_t a, uint8_t b)
 	return MAX(max - d, 1);
 }
 
+/* Decoded values of the exp_1_1 format, 1.1^(raw - 64), for raw in [0, 253]. */
+static const float exp_1_1_lookup[] = {
+	0.0f, 2.46752087e-03f, 2.71427296e-03f, 2.98570026e-03f, 3.28427028e-03f,
+	3.61269731e-03f, 3.97396704e-03f, 4.37136374e-03f, 4.80850012e-03f, 5.28935013e-03f,
+	5.81828514e-03f, 6.40011366e-03f, 7.04012502e-03f, 7.74413753e-03f, 8.51855128e-03f,
+	9.37040641e-03f, 1.03074470e-02f, 1.13381918e-02f, 1.24720109e-02f, 1.37192120e-02f,
+	1.50911332e-02f, 1.66002465e-02f, 1.82602712e-02f, 2.00862983e-02f, 2.20949282e-02f,
+	2.43044210e-02f, 2.67348631e-02f, 2.94083494e-02f, 3.23491843e-02f, 3.55841027e-02f,
+	3.91425130e-02f, 4.30567643e-02f, 4.73624407e-02f, 5.20986848e-02f, 5.73085533e-02f,
+	6.30394086e-02f, 6.93433495e-02f, 7.62776844e-02f, 8.39054529e-02f, 9.22959982e-02f,
+	1.01525598e-01f, 1.11678158e-01f, 1.22845974e-01f, 1.35130571e-01f, 1.48643628e-01f,
+	1.63507991e-01f, 1.79858790e-01f, 1.97844669e-01f, 2.17629136e-01f, 2.39392049e-01f,
+	2.63331254e-01f, 2.89664380e-01f, 3.18630818e-01f, 3.50493899e-01f, 3.85543289e-01f,
+	4.24097618e-01f, 4.66507380e-01f, 5.13158118e-01f, 5.64473930e-01f, 6.20921323e-01f,
+	6.83013455e-01f, 7.51314801e-01f, 8.26446281e-01f, 9.09090909e-01f, 1.00000000e+00f,
+	1.10000000e+00f, 1.21000000e+00f, 1.33100000e+00f, 1.46410000e+00f, 1.61051000e+00f,
+	1.77156100e+00f, 1.94871710e+00f, 2.14358881e+00f, 2.35794769e+00f, 2.59374246e+00f,
+	2.85311671e+00f, 3.13842838e+00f, 3.45227121e+00f, 3.79749834e+00f, 4.17724817e+00f,
+	4.59497299e+00f, 5.05447028e+00f, 5.55991731e+00f, 6.11590904e+00f, 6.72749995e+00f,
+	7.40024994e+00f, 8.14027494e+00f, 8.95430243e+00f, 9.84973268e+00f, 1.08347059e+01f,
+	1.19181765e+01f, 1.31099942e+01f, 1.44209936e+01f, 1.58630930e+01f, 1.74494023e+01f,
+	1.91943425e+01f, 2.11137767e+01f, 2.32251544e+01f, 2.55476699e+01f, 2.81024368e+01f,
+	3.09126805e+01f, 3.40039486e+01f, 3.74043434e+01f, 4.11447778e+01f, 4.52592556e+01f,
+	4.97851811e+01f, 5.47636992e+01f, 6.02400692e+01f, 6.62640761e+01f, 7.28904837e+01f,
+	8.01795321e+01f, 8.81974853e+01f, 9.70172338e+01f, 1.06718957e+02f, 1.17390853e+02f,
+	1.29129938e+02f, 1.42042932e+02f, 1.56247225e+02f, 1.71871948e+02f, 1.89059142e+02f,
+	2.07965057e+02f, 2.28761562e+02f, 2.51637719e+02f, 2.76801490e+02f, 3.04481640e+02f,
+	3.34929803e+02f, 3.68422784e+02f, 4.05265062e+02f, 4.45791568e+02f, 4.90370725e+02f,
+	5.39407798e+02f, 5.93348578e+02f, 6.52683435e+02f, 7.17951779e+02f, 7.89746957e+02f,
+	8.68721652e+02f, 9.55593818e+02f, 1.05115320e+03f, 1.15626852e+03f, 1.27189537e+03f,
+	1.39908491e+03f, 1.53899340e+03f, 1.69289274e+03f, 1.86218201e+03f, 2.04840021e+03f,
+	2.25324024e+03f, 2.47856426e+03f, 2.72642069e+03f, 2.99906275e+03f, 3.29896903e+03f,
+	3.62886593e+03f, 3.99175253e+03f, 4.39092778e+03f, 4.83002056e+03f, 5.31302261e+03f,
+	5.84432487e+03f, 6.42875736e+03f, 7.07163310e+03f, 7.77879641e+03f, 8.55667605e+03f,
+	9.41234365e+03f, 1.03535780e+04f, 1.13889358e+04f, 1.25278294e+04f, 1.37806123e+04f,
+	1.51586736e+04f, 1.66745409e+04f, 1.83419950e+04f, 2.01761945e+04f, 2.21938140e+04f,
+	2.44131954e+04f, 2.68545149e+04f, 2.95399664e+04f, 3.24939630e+04f, 3.57433594e+04f,
+	3.93176953e+04f, 4.32494648e+04f, 4.75744113e+04f, 5.23318524e+04f, 5.75650377e+04f,
+	6.33215414e+04f, 6.96536956e+04f, 7.66190651e+04f, 8.42809717e+04f, 9.27090688e+04f,
+	1.01979976e+05f, 1.12177973e+05f, 1.23395771e+05f, 1.35735348e+05f, 1.49308882e+05f,
+	1.64239771e+05f, 1.80663748e+05f, 1.98730123e+05f, 2.18603135e+05f, 2.40463448e+05f,
+	2.64509793e+05f, 2.90960772e+05f, 3.20056850e+05f, 3.52062535e+05f, 3.87268788e+05f,
+	4.25995667e+05f, 4.68595233e+05f, 5.15454757e+05f, 5.67000233e+05f, 6.23700256e+05f,
+	6.86070281e+05f, 7.54677309e+05f, 8.30145040e+05f, 9.13159544e+05f, 1.00447550e+06f,
+	1.10492305e+06f, 1.21541535e+06f, 1.33695689e+06f, 1.47065258e+06f, 1.61771784e+06f,
+	1.77948962e+06f, 1.95743858e+06f, 2.15318244e+06f, 2.36850068e+06f, 2.60535075e+06f,
+	2.86588583e+06f, 3.15247441e+06f, 3.46772185e+06f, 3.81449404e+06f, 4.19594344e+06f,
+	4.61553778e+06f, 5.07709156e+06f, 5.58480072e+06f, 6.14328079e+06f, 6.75760887e+06f,
+	7.43336975e+06f, 8.17670673e+06f, 8.99437740e+06f, 9.89381514e+06f, 1.08831967e+07f,
+	1.19715163e+07f, 1.31686680e+07f, 1.44855348e+07f, 1.59340882e+07f, 1.75274971e+07f,
+	1.92802468e+07f, 2.12082714e+07f, 2.33290986e+07f, 2.56620084e+07f, 2.82282093e+07f,
+	3.10510302e+07f, 3.41561332e+07f, 3.75717465e+07f, 4.13289212e+07f, 4.54618133e+07f,
+	5.00079946e+07f, 5.50087941e+07f, 6.05096735e+07f, 6.65606409e+07f,
+};
+
 static float exp_1_1_decode_float(uint8_t raw)
 {
-	if (raw == 0x00) {
-		return 0.0f;
+	return exp_1_1_lookup[raw];
+}
+
+/** Finds the encoded value closest to @c val on the logarithmic scale, which is
+ *  64 + round(log_1.1(val)). Returns 0 if @c val is below the range of
+ *  the format, and 0xfe if it is above.
+ */
+static uint8_t exp_1_1_encode_float(float val)
+{
+	/* The boundary between two encoded values is their geometric mean, so
+	 * scale the value by sqrt(1.1) and look for the highest entry that is
+	 * less than or equal to it.
+	 */
+	float scaled = val * SQRT_1_1;
+	uint8_t lo = 1;
+	uint8_t hi = ARRAY_SIZE(exp_1_1_lookup) - 1;
+
+	if (!(scaled >= exp_1_1_lookup[lo])) {
+		return 0x00;
+	}
+
+	if (scaled >= exp_1_1_lookup[hi] * 1.1f) {
+		return 0xfe;
+	}
+
+	while (lo < hi) {
+		uint8_t mid = lo + (hi - lo + 1) / 2;
+
+		if (exp_1_1_lookup[mid] <= scaled) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
 	}
 
-	return powf(1.1f, raw - 64);
+	return lo;
 }
 
 static int exp_1_1_compare(const struct bt_mesh_sensor_value *op1,
@@ -1132,7 +1241,7 @@ static int exp_1_1_from_float(const struct bt_mesh_sensor_format *format,
 		return 0;
 	}
 
-	float result = 64.0f + roundf(logf(val)/LOG_1_1);
+	uint8_t result = exp_1_1_encode_float(val);
 
 	*(sensor_val->raw) = CLAMP(result, 0x01, 0xfd);
 
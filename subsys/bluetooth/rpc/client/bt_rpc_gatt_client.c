@@ -754,6 +754,139 @@ void bt_gatt_notify_params_enc(struct nrf_rpc_cbor_ctx *encoder,
 	}
 }
 
+static bool notify_params_batchable(const struct bt_gatt_notify_params *params)
+{
+	/* Only notifications without completion callback and UUID lookup are
+	 * sent in batches, as they need no per-notification state on the host.
+	 */
+	return params->attr && !params->func && !params->uuid;
+}
+
+static int notify_batch_send(struct bt_conn *conn, const struct bt_gatt_notify_params *params,
+			     size_t count)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	int result;
+	size_t scratchpad_size = 0;
+	size_t buffer_size_max = 15;
+
+	__ASSERT_NO_MSG(count <= BT_RPC_GATT_NOTIFY_BATCH_COUNT_MAX);
+
+	for (size_t i = 0; i < count; i++) {
+		buffer_size_max += 10 + params[i].len;
+		scratchpad_size += SCRATCHPAD_ALIGN(sizeof(uint8_t) * params[i].len);
+	}
+
+	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
+	ser_encode_uint(&ctx, scratchpad_size);
+
+	bt_rpc_encode_bt_conn(&ctx, conn);
+	ser_encode_uint(&ctx, count);
+
+	for (size_t i = 0; i < count; i++) {
+		bt_rpc_encode_gatt_attr(&ctx, params[i].attr);
+		ser_encode_buffer(&ctx, params[i].data, sizeof(uint8_t) * params[i].len);
+	}
+
+	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_NOTIFY_BATCH_RPC_CMD,
+		&ctx, ser_rsp_decode_i32, &result);
+
+	return result;
+}
+
+#if defined(CONFIG_BT_RPC_GATT_NOTIFY_BATCH)
+static struct {
+	struct bt_conn *conn;
+	struct bt_gatt_notify_params params[CONFIG_BT_RPC_GATT_NOTIFY_BATCH_MAX];
+	uint8_t data[CONFIG_BT_RPC_GATT_NOTIFY_BATCH_BUF_SIZE];
+	size_t count;
+	size_t data_len;
+} notify_batch;
+
+static K_MUTEX_DEFINE(notify_batch_lock);
+
+static void notify_batch_flush(void)
+{
+	int err;
+
+	k_mutex_lock(&notify_batch_lock, K_FOREVER);
+
+	if (notify_batch.count) {
+		err = notify_batch_send(notify_batch.conn, notify_batch.params,
+					notify_batch.count);
+		if (err) {
+			LOG_WRN("Batched notification failed: %d", err);
+		}
+
+		if (notify_batch.conn) {
+			bt_conn_unref(notify_batch.conn);
+		}
+
+		notify_batch.conn = NULL;
+		notify_batch.count = 0;
+		notify_batch.data_len = 0;
+	}
+
+	k_mutex_unlock(&notify_batch_lock);
+}
+
+static void notify_batch_work_handler(struct k_work *work)
+{
+	notify_batch_flush();
+}
+
+static K_WORK_DEFINE(notify_batch_work, notify_batch_work_handler);
+
+static int notify_batch_add(struct bt_conn *conn, const struct bt_gatt_notify_params *params)
+{
+	struct bt_gatt_notify_params *entry;
+
+	if (params->len > sizeof(notify_batch.data)) {
+		return -ENOMEM;
+	}
+
+	k_mutex_lock(&notify_batch_lock, K_FOREVER);
+
+	if (notify_batch.count &&
+	    (conn != notify_batch.conn ||
+	     notify_batch.count == ARRAY_SIZE(notify_batch.params) ||
+	     notify_batch.data_len + params->len > sizeof(notify_batch.data))) {
+		notify_batch_flush();
+	}
+
+	if (!notify_batch.count && conn) {
+		notify_batch.conn = bt_conn_ref(conn);
+	}
+
+	entry = &notify_batch.params[notify_batch.count++];
+	entry->attr = params->attr;
+	entry->data = &notify_batch.data[notify_batch.data_len];
+	entry->len = params->len;
+
+	/* The caller may reuse its buffer once this function returns, so the data is copied
+	 * until the batch is encoded.
+	 */
+	memcpy(&notify_batch.data[notify_batch.data_len], params->data, params->len);
+	notify_batch.data_len += params->len;
+
+	k_mutex_unlock(&notify_batch_lock);
+
+	/* Notifications queued until the work item runs are sent in one transfer. */
+	k_work_submit(&notify_batch_work);
+
+	return 0;
+}
+#else
+static void notify_batch_flush(void)
+{
+}
+
+static int notify_batch_add(struct bt_conn *conn, const struct bt_gatt_notify_params *params)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_BT_RPC_GATT_NOTIFY_BATCH */
+
 int bt_gatt_notify_cb(struct bt_conn *conn,
 		      struct bt_gatt_notify_params *params)
 {
@@ -762,6 +895,14 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 	size_t scratchpad_size = 0;
 	size_t buffer_size_max = 8;
 
+	if (IS_ENABLED(CONFIG_BT_RPC_GATT_NOTIFY_BATCH) && notify_params_batchable(params) &&
+	    !notify_batch_add(conn, params)) {
+		return 0;
+	}
+
+	/* Keep the order of notifications sent in batches and one by one. */
+	notify_batch_flush();
+
 	buffer_size_max += bt_gatt_notify_params_buf_size(params);
 
 	scratchpad_size += bt_gatt_notify_params_sp_size(params);
@@ -788,6 +929,30 @@ int bt_gatt_notify_multiple(struct bt_conn *conn, uint16_t num_params,
 	__ASSERT(num_params, "invalid parameters\n");
 	__ASSERT(params->attr, "invalid parameters\n");
 
+	for (i = 0; i < num_params; i++) {
+		if (!notify_params_batchable(&params[i])) {
+			break;
+		}
+	}
+
+	/* Send the notifications in as few transfers as possible. The host stops
+	 * at the first failed notification, and so does this function.
+	 */
+	if (i == num_params) {
+		notify_batch_flush();
+
+		for (i = 0; i < num_params; i += BT_RPC_GATT_NOTIFY_BATCH_COUNT_MAX) {
+			ret = notify_batch_send(conn, &params[i],
+						MIN(num_params - i,
+						    BT_RPC_GATT_NOTIFY_BATCH_COUNT_MAX));
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		return 0;
+	}
+
 	for (i = 0; i < num_params; i++) {
 		ret = bt_gatt_notify_cb(conn, &params[i]);
 		if (ret < 0) {
@@ -843,6 +1008,8 @@ int bt_gatt_indicate(struct bt_conn *conn, struct bt_gatt_indicate_params *param
 	size_t buffer_size_max = 13;
 	uintptr_t params_addr = (uintptr_t)params;
 
+	notify_batch_flush();
+
 	buffer_size_max += bt_gatt_indicate_params_buf_size(params);
 	scratchpad_size += bt_gatt_indicate_params_sp_size(params);
 
@@ -144,6 +144,10 @@ enum bt_rpc_cmd_from_cli_to_host {
 	/* internal.h API */
 	BT_ADDR_LE_IS_BONDED_CMD,
 	BT_HCI_CMD_SEND_SYNC_RPC_CMD,
+	/* Commands added later are appended, so that the IDs of the commands above
+	 * stay the same for the client and the host built from different versions.
+	 */
+	BT_GATT_NOTIFY_BATCH_RPC_CMD,
 };
 
 /** @brief Host commands IDs used in bluetooth API serialization.
@@ -21,14 +21,41 @@ LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
 
 static struct bt_gatt_svc_cache {
 	const struct bt_gatt_service *services[CONFIG_BT_RPC_GATT_SRV_MAX];
+	/* Service indexes sorted by the address of the service attributes. */
+	uint8_t sorted[CONFIG_BT_RPC_GATT_SRV_MAX];
 	size_t count;
 } svc_cache = {
 	.count = 0,
 };
 
+BUILD_ASSERT(CONFIG_BT_RPC_GATT_SRV_MAX <= UINT8_MAX + 1);
+
+/* Returns the number of services in the sorted index whose attributes start at
+ * or before the given address.
+ */
+static size_t sorted_upper_bound(const struct bt_gatt_attr *attr)
+{
+	size_t low = 0;
+	size_t high = svc_cache.count;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		const struct bt_gatt_service *svc = svc_cache.services[svc_cache.sorted[mid]];
+
+		if ((uintptr_t)svc->attrs <= (uintptr_t)attr) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
 int bt_rpc_gatt_add_service(const struct bt_gatt_service *svc, uint32_t *svc_index)
 {
 	uint32_t index;
+	size_t pos;
 
 	if (svc_cache.count >= CONFIG_BT_RPC_GATT_SRV_MAX) {
 		LOG_ERR("Too many GATT services used by BT_RPC. %s",
@@ -39,6 +66,11 @@ int bt_rpc_gatt_add_service(const struct bt_gatt_service *svc, uint32_t *svc_ind
 	index = svc_cache.count;
 	svc_cache.services[index] = svc;
 
+	pos = sorted_upper_bound(svc->attrs);
+	memmove(&svc_cache.sorted[pos + 1], &svc_cache.sorted[pos],
+		sizeof(svc_cache.sorted[0]) * (svc_cache.count - pos));
+	svc_cache.sorted[pos] = index;
+
 	svc_cache.count++;
 
 	*svc_index = index;
@@ -50,25 +82,25 @@ int bt_rpc_gatt_attr_to_index(const struct bt_gatt_attr *attr, uint32_t *index)
 {
 	const struct bt_gatt_service *service;
 	uint32_t attr_index;
-	uint32_t service_index = 0;
+	uint32_t service_index;
+	size_t pos;
 
 	if (!attr) {
 		return -EINVAL;
 	}
 
-	do {
-		if (service_index >= svc_cache.count) {
-			return -EINVAL;
-		}
+	/* The attribute can only belong to the last service starting before it. */
+	pos = sorted_upper_bound(attr);
+	if (pos == 0) {
+		return -EINVAL;
+	}
 
-		service = svc_cache.services[service_index];
+	service_index = svc_cache.sorted[pos - 1];
+	service = svc_cache.services[service_index];
 
-		if ((attr >= service->attrs) && (attr < &service->attrs[service->attr_count])) {
-			break;
-		}
-
-		service_index++;
-	} while (true);
+	if (attr >= &service->attrs[service->attr_count]) {
+		return -EINVAL;
+	}
 
 	attr_index = attr - service->attrs;
 
@@ -101,21 +133,43 @@ const struct bt_gatt_service *bt_rpc_gatt_get_service_by_index(uint16_t svc_inde
 
 int bt_rpc_gatt_service_to_index(const struct bt_gatt_service *svc, uint16_t *svc_index)
 {
-	int err = -EFAULT;
+	size_t pos;
 
 	if (!svc_index || !svc) {
 		return -EINVAL;
 	}
 
-	for (size_t i = 0; i < svc_cache.count; i++) {
-		if (svc == svc_cache.services[i]) {
-			*svc_index = i;
-			err = 0;
+	/* Check all services whose attributes start at the same address. */
+	for (pos = sorted_upper_bound(svc->attrs); pos > 0; pos--) {
+		const struct bt_gatt_service *service = svc_cache.services[svc_cache.sorted[pos - 1]];
+
+		if (service->attrs != svc->attrs) {
 			break;
 		}
+
+		if (service == svc) {
+			*svc_index = svc_cache.sorted[pos - 1];
+			return 0;
+		}
 	}
 
-	return err;
+	return -EFAULT;
+}
+
+static void sorted_remove(size_t index)
+{
+	size_t j = 0;
+
+	/* Drop the removed service, and shift the indexes of the services that
+	 * followed it in the service pool.
+	 */
+	for (size_t i = 0; i <= svc_cache.count; i++) {
+		if (svc_cache.sorted[i] == index) {
+			continue;
+		}
+
+		svc_cache.sorted[j++] = svc_cache.sorted[i] - (svc_cache.sorted[i] > index ? 1 : 0);
+	}
 }
 
 int bt_rpc_gatt_remove_service(const struct bt_gatt_service *svc)
@@ -134,6 +188,7 @@ int bt_rpc_gatt_remove_service(const struct bt_gatt_service *svc)
 			}
 
 			svc_cache.count--;
+			sorted_remove(i);
 
 			break;
 		}
@@ -219,3 +274,26 @@ void bt_rpc_gatt_foreach_attr_type(uint16_t start_handle, uint16_t end_handle,
 		}
 	}
 }
+
+int bt_rpc_gatt_notify_batch_send(struct bt_conn *conn,
+				  const struct bt_rpc_gatt_notify_batch_entry *entries,
+				  size_t count,
+				  int (*notify)(struct bt_conn *conn,
+						const struct bt_gatt_attr *attr,
+						const void *data, uint16_t len))
+{
+	int err;
+
+	for (size_t i = 0; i < count; i++) {
+		if (!entries[i].attr) {
+			return -EINVAL;
+		}
+
+		err = notify(conn, entries[i].attr, entries[i].data, entries[i].len);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
@@ -30,6 +30,19 @@
 #define BT_RPC_GATT_ATTR_SPECIAL_CPF 8
 #define BT_RPC_GATT_ATTR_SPECIAL_USER 9
 
+/* Maximum number of notifications in one BT_GATT_NOTIFY_BATCH_RPC_CMD command. */
+#define BT_RPC_GATT_NOTIFY_BATCH_COUNT_MAX 16
+
+/**@brief Notification decoded from a batch of notifications. */
+struct bt_rpc_gatt_notify_batch_entry {
+	/** Characteristic value attribute. */
+	const struct bt_gatt_attr *attr;
+	/** Notification data. */
+	const void *data;
+	/** Notification data length. */
+	uint16_t len;
+};
+
 /**@brief Helper structure for indication parameter serialization. */
 struct bt_rpc_gatt_indication_params {
 	/** Pointer to the structure holding indication parameters on the client side. */
@@ -135,4 +148,25 @@ void bt_rpc_encode_gatt_attr(struct nrf_rpc_cbor_ctx *ctx, const struct bt_gatt_
  */
 const struct bt_gatt_attr *bt_rpc_decode_gatt_attr(struct nrf_rpc_cbor_ctx *ctx);
 
+/**@brief Send a batch of notifications.
+ *
+ * The notifications are sent in order, and sending stops at the first
+ * notification that fails.
+ *
+ * @param[in] conn Connection object, or NULL to notify all connections.
+ * @param[in] entries Notifications to send.
+ * @param[in] count Number of notifications.
+ * @param[in] notify Function that sends a single notification.
+ *
+ * @retval 0 If all notifications were sent.
+ * @retval -EINVAL If a notification has no attribute.
+ *           Otherwise, the error of the first failed notification is returned.
+ */
+int bt_rpc_gatt_notify_batch_send(struct bt_conn *conn,
+				  const struct bt_rpc_gatt_notify_batch_entry *entries,
+				  size_t count,
+				  int (*notify)(struct bt_conn *conn,
+						const struct bt_gatt_attr *attr,
+						const void *data, uint16_t len));
+
 #endif /* BT_RPC_GATT_COMMON_H_ */
@@ -828,6 +828,49 @@ decoding_error:
 NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_gatt_notify_cb, BT_GATT_NOTIFY_CB_RPC_CMD,
 	bt_gatt_notify_cb_rpc_handler, NULL);
 
+static void bt_gatt_notify_batch_rpc_handler(const struct nrf_rpc_group *group,
+					     struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	struct bt_conn *conn;
+	struct bt_rpc_gatt_notify_batch_entry entries[BT_RPC_GATT_NOTIFY_BATCH_COUNT_MAX];
+	uint32_t count;
+	int result;
+	struct ser_scratchpad scratchpad;
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, ctx);
+
+	conn = bt_rpc_decode_bt_conn(ctx);
+	count = ser_decode_uint(ctx);
+
+	if (count > ARRAY_SIZE(entries)) {
+		ser_decoder_invalid(ctx, ZCBOR_ERR_UNKNOWN);
+		count = 0;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		size_t len;
+
+		entries[i].attr = bt_rpc_decode_gatt_attr(ctx);
+		entries[i].data = ser_decode_buffer_into_scratchpad(&scratchpad, &len);
+		entries[i].len = len;
+	}
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	result = bt_rpc_gatt_notify_batch_send(conn, entries, count, bt_gatt_notify);
+
+	ser_rsp_send_int(group, result);
+
+	return;
+decoding_error:
+	report_decoding_error(BT_GATT_NOTIFY_BATCH_RPC_CMD, handler_data);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_gatt_notify_batch, BT_GATT_NOTIFY_BATCH_RPC_CMD,
+	bt_gatt_notify_batch_rpc_handler, NULL);
+
 void bt_gatt_indicate_params_dec(struct ser_scratchpad *scratchpad,
 				 struct bt_gatt_indicate_params *data)
 {
@@ -8,7 +8,7 @@
 #include <zephyr/dfu/mcuboot.h>
 #include <dfu/dfu_target.h>
 
-#define DEF_DFU_TARGET(name) \
+#define DEF_DFU_TARGET(name, ...) \
 static const struct dfu_target dfu_target_ ## name  = { \
 	.init = dfu_target_ ## name ## _init, \
 	.offset_get = dfu_target_## name ##_offset_get, \
@@ -16,6 +16,7 @@ static const struct dfu_target dfu_target_ ## name  = { \
 	.done = dfu_target_ ## name ## _done, \
 	.schedule_update = dfu_target_ ## name ## _schedule_update, \
 	.reset = dfu_target_ ## name ## _reset, \
+	__VA_ARGS__ \
 }
 
 #ifdef CONFIG_DFU_TARGET_MODEM_DELTA
@@ -24,11 +25,13 @@ DEF_DFU_TARGET(modem_delta);
 #endif
 #ifdef CONFIG_DFU_TARGET_MCUBOOT
 #include "dfu/dfu_target_mcuboot.h"
-DEF_DFU_TARGET(mcuboot);
+DEF_DFU_TARGET(mcuboot, .buf_get = dfu_target_mcuboot_buf_get,
+	       .buf_commit = dfu_target_mcuboot_buf_commit);
 #endif
 #ifdef CONFIG_DFU_TARGET_FULL_MODEM
 #include "dfu/dfu_target_full_modem.h"
-DEF_DFU_TARGET(full_modem);
+DEF_DFU_TARGET(full_modem, .buf_get = dfu_target_full_modem_buf_get,
+	       .buf_commit = dfu_target_full_modem_buf_commit);
 #endif
 #ifdef CONFIG_DFU_TARGET_SMP
 #include "dfu/dfu_target_smp.h"
@@ -146,6 +149,32 @@ int dfu_target_write(const void *const buf, size_t len)
 	return current_target->write(buf, len);
 }
 
+int dfu_target_buf_get(void **buf, size_t *len)
+{
+	if (current_target == NULL) {
+		return -EACCES;
+	}
+
+	if (current_target->buf_get == NULL) {
+		return -ENOTSUP;
+	}
+
+	return current_target->buf_get(buf, len);
+}
+
+int dfu_target_buf_commit(size_t len)
+{
+	if (current_target == NULL) {
+		return -EACCES;
+	}
+
+	if (current_target->buf_commit == NULL) {
+		return -ENOTSUP;
+	}
+
+	return current_target->buf_commit(len);
+}
+
 int dfu_target_done(bool successful)
 {
 	int err;
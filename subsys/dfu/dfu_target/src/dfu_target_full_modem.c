@@ -121,6 +121,24 @@ int dfu_target_full_modem_write(const void *const buf, size_t len)
 	return dfu_target_stream_write(buf, len);
 }
 
+int dfu_target_full_modem_buf_get(void **buf, size_t *len)
+{
+	if (!configured) {
+		return -EPERM;
+	}
+
+	return dfu_target_stream_buf_get((uint8_t **)buf, len);
+}
+
+int dfu_target_full_modem_buf_commit(size_t len)
+{
+	if (!configured) {
+		return -EPERM;
+	}
+
+	return dfu_target_stream_buf_commit(len);
+}
+
 int dfu_target_full_modem_done(bool successful)
 {
 	if (!configured) {
@@ -174,6 +174,18 @@ int dfu_target_mcuboot_write(const void *const buf, size_t len)
 	return dfu_target_stream_write(buf, len);
 }
 
+int dfu_target_mcuboot_buf_get(void **buf, size_t *len)
+{
+	return dfu_target_stream_buf_get((uint8_t **)buf, len);
+}
+
+int dfu_target_mcuboot_buf_commit(size_t len)
+{
+	stream_buf_bytes = (stream_buf_bytes + len) % stream_buf_len;
+
+	return dfu_target_stream_buf_commit(len);
+}
+
 int dfu_target_mcuboot_done(bool successful)
 {
 	int err = 0;
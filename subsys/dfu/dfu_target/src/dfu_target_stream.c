@@ -25,24 +25,91 @@ static const char *current_id;
 
 static char current_name_key[32];
 
+/* Last checkpoint handed over to the work item, and when. */
+static size_t checkpoint_offset;
+static int64_t checkpoint_time;
+static atomic_t checkpoint_pending;
+
+static int store_offset(size_t offset)
+{
+	int err;
+
+	err = settings_save_one(current_name_key, &offset, sizeof(offset));
+
+	if (err) {
+		LOG_ERR("Problem storing offset (err %d)", err);
+		return err;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Store the information stored in the stream_flash instance so that it
  *        can be restored from flash in case of a power failure, reboot etc.
  */
 static int store_progress(void)
+{
+	return store_offset(stream_flash_bytes_written(&stream));
+}
+
+static void checkpoint_work_handler(struct k_work *work)
+{
+	/* Failing to store progress is not a critical error you'll just
+	 * be left to download a bit more if you fail and resume.
+	 */
+	if (store_offset(atomic_get(&checkpoint_pending)) != 0) {
+		LOG_WRN("Unable to store write progress");
+	}
+}
+
+static K_WORK_DEFINE(checkpoint_work, checkpoint_work_handler);
+
+static void checkpoint_cancel(void)
+{
+	struct k_work_sync sync;
+
+	(void)k_work_cancel_sync(&checkpoint_work, &sync);
+}
+
+/**
+ * @brief Schedule storing the write progress, if it has advanced enough.
+ *
+ * Only offsets at the start of a flash page are stored. When resuming from
+ * such an offset, the page is considered not erased and is erased again
+ * before it is written, so the data written after the checkpoint and before
+ * a power failure is not written twice without an erase.
+ */
+static void checkpoint_update(void)
 {
 	int err;
-	size_t bytes_written = stream_flash_bytes_written(&stream);
+	size_t offset;
+	struct flash_pages_info page;
 
-	err = settings_save_one(current_name_key, &bytes_written,
-				sizeof(bytes_written));
+	err = flash_get_page_info_by_offs(stream.fdev,
+					  stream.offset + stream_flash_bytes_written(&stream),
+					  &page);
+	if (err != 0) {
+		/* End of the flash device, stored when done */
+		return;
+	}
 
-	if (err) {
-		LOG_ERR("Problem storing offset (err %d)", err);
-		return err;
+	offset = ((size_t)page.start_offset > stream.offset) ?
+		 (size_t)page.start_offset - stream.offset : 0;
+
+	if (offset <= checkpoint_offset ||
+	    offset - checkpoint_offset < CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_BYTES) {
+		return;
 	}
 
-	return 0;
+	if (k_uptime_get() - checkpoint_time < CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_PERIOD_MS) {
+		return;
+	}
+
+	checkpoint_offset = offset;
+	checkpoint_time = k_uptime_get();
+	atomic_set(&checkpoint_pending, offset);
+	k_work_submit(&checkpoint_work);
 }
 
 /**
@@ -149,6 +216,9 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		LOG_ERR("settings_load failed (err %d)", err);
 		return err;
 	}
+
+	checkpoint_offset = stream_flash_bytes_written(&stream);
+	checkpoint_time = k_uptime_get();
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
 	return 0;
@@ -161,6 +231,49 @@ int dfu_target_stream_offset_get(size_t *out)
 	return 0;
 }
 
+int dfu_target_stream_buf_get(uint8_t **buf, size_t *len)
+{
+	if (current_id == NULL) {
+		return -EACCES;
+	}
+
+	*buf = stream.buf + stream.buf_bytes;
+	*len = MIN(stream.buf_len - stream.buf_bytes,
+		   stream.available - stream.bytes_written - stream.buf_bytes);
+
+	return 0;
+}
+
+int dfu_target_stream_buf_commit(size_t len)
+{
+	int err = 0;
+
+	if (current_id == NULL) {
+		return -EACCES;
+	}
+
+	if (len > stream.buf_len - stream.buf_bytes ||
+	    stream.bytes_written + stream.buf_bytes + len > stream.available) {
+		return -ENOMEM;
+	}
+
+	stream.buf_bytes += len;
+	if (stream.buf_bytes == stream.buf_len) {
+		/* Write the full buffer to flash */
+		err = stream_flash_buffered_write(&stream, NULL, 0, true);
+		if (err != 0) {
+			LOG_ERR("stream_flash_buffered_write error %d", err);
+			return err;
+		}
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	checkpoint_update();
+#endif
+
+	return err;
+}
+
 int dfu_target_stream_write(const uint8_t *buf, size_t len)
 {
 	int err = stream_flash_buffered_write(&stream, buf, len, false);
@@ -171,13 +284,7 @@ int dfu_target_stream_write(const uint8_t *buf, size_t len)
 	}
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
-	err = store_progress();
-	if (err != 0) {
-		/* Failing to store progress is not a critical error you'll just
-		 * be left to download a bit more if you fail and resume.
-		 */
-		LOG_WRN("Unable to store write progress: %d", err);
-	}
+	checkpoint_update();
 #endif
 
 	return err;
@@ -187,6 +294,10 @@ int dfu_target_stream_done(bool successful)
 {
 	int err = 0;
 
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	checkpoint_cancel();
+#endif
+
 	if (successful) {
 		err = stream_flash_buffered_write(&stream, NULL, 0, true);
 		if (err != 0) {
@@ -225,6 +336,9 @@ int dfu_target_stream_reset(void)
 	stream.bytes_written = 0;
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	checkpoint_cancel();
+	checkpoint_offset = 0;
+
 	err = settings_delete(current_name_key);
 	if (err != 0) {
 		LOG_ERR("settings_delete error %d", err);
@@ -9,6 +9,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/drivers/flash.h>
+#include <zephyr/sys/crc.h>
 #include "emds_flash.h"
 
 #include <zephyr/logging/log.h>
@@ -62,11 +63,96 @@ static int emds_fs_init(void)
 	emds_flash.sector_cnt = cnt;
 	emds_flash.offset = fa->fa_off;
 	emds_flash.flash_dev = fa->fa_dev;
+	emds_flash.keep_entries = IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE);
 
 	return emds_flash_init(&emds_flash);
 }
 
 
+static uint32_t entry_hash(const struct emds_entry *entry)
+{
+	return crc32_ieee(entry->data, entry->len);
+}
+
+static void entry_state_set(const struct emds_entry *entry, bool stored)
+{
+	if (!IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE) || !entry->state) {
+		return;
+	}
+
+	entry->state->stored = stored;
+	if (stored) {
+		entry->state->hash = entry_hash(entry);
+	}
+}
+
+static void entries_state_reset(void)
+{
+	struct emds_dynamic_entry *ch;
+
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		entry_state_set(entry, false);
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		entry_state_set(&ch->entry, false);
+	}
+}
+
+static bool entry_is_dirty(const struct emds_entry *entry, uint32_t hash)
+{
+	if (!IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE) || !entry->state) {
+		return true;
+	}
+
+	return !entry->state->stored || entry->state->hash != hash;
+}
+
+static ssize_t entry_store(const struct emds_entry *entry)
+{
+	uint32_t hash = 0;
+	ssize_t len;
+
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE)) {
+		hash = entry_hash(entry);
+	}
+
+	if (!entry_is_dirty(entry, hash)) {
+		/* The copy in flash is still valid. */
+		return entry->len;
+	}
+
+	len = emds_flash_write(&emds_flash, entry->id, entry->data, entry->len);
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE) && entry->state && len == entry->len) {
+		entry->state->hash = hash;
+		entry->state->stored = true;
+	}
+
+	return len;
+}
+
+static uint32_t entry_store_time(const struct emds_entry *entry)
+{
+	size_t block_size = emds_flash.flash_params->write_block_size;
+
+	return DIV_ROUND_UP(entry->len, block_size) * CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US +
+	       DIV_ROUND_UP(emds_flash.ate_size, block_size) *
+		       CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US +
+	       CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+}
+
+/* Time to hash the entry in emds_store(), which is done for every entry
+ * whether it has changed or not.
+ */
+static uint32_t entry_hash_time(const struct emds_entry *entry)
+{
+#if defined(CONFIG_EMDS_INCREMENTAL_STORE)
+	return DIV_ROUND_UP((uint64_t)entry->len * CONFIG_EMDS_HASH_TIME_ONE_KB_US, 1024);
+#else
+	return 0;
+#endif
+}
+
 static int emds_entries_size(uint32_t *size)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
@@ -130,6 +216,9 @@ int emds_entry_add(struct emds_dynamic_entry *entry)
 		}
 	}
 
+	entry->entry.state = &entry->state;
+	entry_state_set(&entry->entry, false);
+
 	sys_slist_append(&emds_dynamic_entries, &entry->node);
 
 	emds_ready = false;
@@ -152,8 +241,8 @@ int emds_store(void)
 	LOG_DBG("Emergency Data Storeage released");
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		ssize_t len = emds_flash_write(&emds_flash,
-					       ch->id, ch->data, ch->len);
+		ssize_t len = entry_store(ch);
+
 		if (len < 0) {
 			LOG_ERR("Write static entry: (%d) error (%d)",
 				ch->id, len);
@@ -166,8 +255,8 @@ int emds_store(void)
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		ssize_t len = emds_flash_write(&emds_flash,
-					       ch->entry.id, ch->entry.data, ch->entry.len);
+		ssize_t len = entry_store(&ch->entry);
+
 		if (len < 0) {
 			LOG_ERR("Write dynamic entry: (%d) error (%d).",
 				ch->entry.id, len);
@@ -212,6 +301,12 @@ int emds_load(void)
 			LOG_WRN("Read dynamic entry: (%d) did not match (%d:%d).",
 				ch->entry.id, ch->entry.len, len);
 		}
+
+		entry_state_set(&ch->entry, len == ch->entry.len);
+		/* Only a missing entry is known to leave the data untouched. */
+		if (len != -ENXIO) {
+			ch->entry.state->load_count++;
+		}
 	}
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
@@ -227,6 +322,11 @@ int emds_load(void)
 			LOG_WRN("Read static entry: (%d) entry did not match (%d:%d)",
 				ch->id, ch->len, len);
 		}
+
+		entry_state_set(ch, len == ch->len);
+		if (len != -ENXIO && ch->state) {
+			ch->state->load_count++;
+		}
 	}
 
 	return 0;
@@ -238,6 +338,8 @@ int emds_clear(void)
 		return -ECANCELED;
 	}
 
+	entries_state_reset();
+
 	return emds_flash_clear(&emds_flash);
 }
 
@@ -257,6 +359,11 @@ int emds_prepare(void)
 		return rc;
 	}
 
+	/* Without any entries kept in flash, everything has to be stored. */
+	if (!emds_flash.keep_entries || emds_flash_is_empty(&emds_flash)) {
+		entries_state_reset();
+	}
+
 	emds_ready = true;
 
 	return 0;
@@ -264,26 +371,41 @@ int emds_prepare(void)
 
 uint32_t emds_store_time_get(void)
 {
-	size_t block_size = emds_flash.flash_params->write_block_size;
 	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
+	struct emds_dynamic_entry *ch;
 
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		store_time_us += entry_hash_time(entry) + entry_store_time(entry);
+	}
 
-	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		store_time_us += DIV_ROUND_UP(ch->len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + DIV_ROUND_UP(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		store_time_us += entry_hash_time(&ch->entry) + entry_store_time(&ch->entry);
 	}
 
+	return store_time_us;
+}
+
+uint32_t emds_store_time_dirty_get(void)
+{
+	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
 	struct emds_dynamic_entry *ch;
 
+	if (!IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE)) {
+		return emds_store_time_get();
+	}
+
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		store_time_us += entry_hash_time(entry);
+		if (entry_is_dirty(entry, entry_hash(entry))) {
+			store_time_us += entry_store_time(entry);
+		}
+	}
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		store_time_us += DIV_ROUND_UP(ch->entry.len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + DIV_ROUND_UP(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+		store_time_us += entry_hash_time(&ch->entry);
+		if (entry_is_dirty(&ch->entry, entry_hash(&ch->entry))) {
+			store_time_us += entry_store_time(&ch->entry);
+		}
 	}
 
 	return store_time_us;
@@ -156,26 +156,35 @@ static void commit_changes(size_t len)
 }
 #endif
 
-static int flash_direct_write(const struct device *dev, off_t offset, const void *data, size_t len)
-{
-	uint32_t flash_addr = offset;
+/* A contiguous chunk of words to write to flash. */
+struct flash_burst {
+	off_t offset;
+	const void *data;
+	size_t len;
+};
 
+/* Writes all bursts back to back, so that the flash controller only has to be
+ * prepared once for each entry.
+ */
+static int flash_direct_write(const struct device *dev, const struct flash_burst *bursts,
+			      size_t count)
+{
 	ARG_UNUSED(dev);
 
-	if (!is_regular_addr_valid(flash_addr, len)) {
-		return -EINVAL;
-	}
+	for (size_t i = 0; i < count; i++) {
+		if (!is_regular_addr_valid(bursts[i].offset, bursts[i].len)) {
+			return -EINVAL;
+		}
 
-	if (!is_aligned_32(flash_addr)) {
-		return -EINVAL;
-	}
+		if (!is_aligned_32(bursts[i].offset)) {
+			return -EINVAL;
+		}
 
-	if (len % sizeof(uint32_t)) {
-		return -EINVAL;
+		if (bursts[i].len % sizeof(uint32_t)) {
+			return -EINVAL;
+		}
 	}
 
-	flash_addr += DT_REG_ADDR(SOC_NV_FLASH_NODE);
-
 	nvmc_wait_ready();
 
 	if (SUSPEND_POFWARN()) {
@@ -186,22 +195,31 @@ static int flash_direct_write(const struct device *dev, off_t offset, const void
 	nrf_rramc_config_t config = {.mode_write = true, .write_buff_size = WRITE_BUFFER_SIZE};
 
 	nrf_rramc_config_set(NRF_RRAMC, &config);
-	memcpy((void *)flash_addr, data, len);
 
-	barrier_dmem_fence_full(); /* Barrier following our last write. */
-	commit_changes(len);
+	for (size_t i = 0; i < count; i++) {
+		uint32_t flash_addr = bursts[i].offset + DT_REG_ADDR(SOC_NV_FLASH_NODE);
+
+		memcpy((void *)flash_addr, bursts[i].data, bursts[i].len);
+
+		barrier_dmem_fence_full(); /* Barrier following our last write. */
+		commit_changes(bursts[i].len);
+	}
 
 	config.mode_write = false;
 	nrf_rramc_config_set(NRF_RRAMC, &config);
 #else
-	uint32_t data_addr = (uint32_t)data;
+	for (size_t i = 0; i < count; i++) {
+		uint32_t flash_addr = bursts[i].offset + DT_REG_ADDR(SOC_NV_FLASH_NODE);
+		uint32_t data_addr = (uint32_t)bursts[i].data;
+		size_t len = bursts[i].len;
 
-	while (len >= sizeof(uint32_t)) {
-		nrfx_nvmc_word_write(flash_addr, UNALIGNED_GET((uint32_t *)data_addr));
+		while (len >= sizeof(uint32_t)) {
+			nrfx_nvmc_word_write(flash_addr, UNALIGNED_GET((uint32_t *)data_addr));
 
-		flash_addr += sizeof(uint32_t);
-		data_addr += sizeof(uint32_t);
-		len -= sizeof(uint32_t);
+			flash_addr += sizeof(uint32_t);
+			data_addr += sizeof(uint32_t);
+			len -= sizeof(uint32_t);
+		}
 	}
 #endif
 
@@ -222,69 +240,6 @@ static size_t align_size(struct emds_fs *fs, size_t len)
 	return (len + (write_block_size - 1U)) & ~(write_block_size - 1U);
 }
 
-static int ate_wrt(struct emds_fs *fs, const struct emds_ate *entry)
-{
-	size_t ate_size = align_size(fs, sizeof(struct emds_ate));
-
-	if (ate_size % fs->flash_params->write_block_size) {
-		return -EINVAL;
-	}
-
-	int rc = flash_direct_write(fs->flash_dev, fs->ate_wra, entry, sizeof(struct emds_ate));
-
-	if (rc) {
-		return rc;
-	}
-
-	fs->ate_wra -= ate_size;
-	return 0;
-}
-
-static int data_wrt(struct emds_fs *fs, const void *data, size_t len)
-{
-	const uint8_t *data8 = (const uint8_t *)data;
-	int rc;
-	off_t offset;
-	size_t blen;
-	size_t temp_len = len;
-	uint8_t buf[EMDS_FLASH_BLOCK_SIZE];
-
-	if (!temp_len) {
-		/* Nothing to write, avoid changing the flash protection */
-		return 0;
-	}
-
-	offset = fs->offset;
-	offset += fs->data_wra_offset & ADDR_OFFS_MASK;
-
-	blen = temp_len & ~(fs->flash_params->write_block_size - 1U);
-	/* Writes multiples of 4 bytes to flash */
-	if (blen > 0) {
-		rc = flash_direct_write(fs->flash_dev, offset, data8, blen);
-		if (rc) {
-			return rc;
-		}
-
-		temp_len -= blen;
-		offset += blen;
-		data8 += blen;
-	}
-
-	if (temp_len) {
-		(void)memcpy(buf, data8, temp_len);
-		(void)memset(buf + temp_len, fs->flash_params->erase_value,
-			     fs->flash_params->write_block_size - temp_len);
-		rc = flash_direct_write(fs->flash_dev, offset, buf,
-					fs->flash_params->write_block_size);
-		if (rc) {
-			return rc;
-		}
-	}
-
-	fs->data_wra_offset += align_size(fs, len);
-	return 0;
-}
-
 static int check_erased(struct emds_fs *fs, uint32_t addr, size_t len)
 {
 	size_t bytes_to_cmp;
@@ -317,22 +272,48 @@ static int entry_wrt(struct emds_fs *fs, uint16_t id, const void *data, size_t l
 {
 	int rc;
 	struct emds_ate entry;
+	struct flash_burst bursts[3];
+	size_t count = 0;
+	size_t blen;
+	off_t offset = fs->offset + (fs->data_wra_offset & ADDR_OFFS_MASK);
+	uint8_t buf[EMDS_FLASH_BLOCK_SIZE];
+
+	if (align_size(fs, sizeof(struct emds_ate)) % fs->flash_params->write_block_size) {
+		return -EINVAL;
+	}
 
 	entry.id = id;
 	entry.offset = fs->data_wra_offset;
 	entry.len = (uint16_t)len;
 	entry.crc8_data = crc8_ccitt(0xff, data, len);
 	entry.crc8 = crc8_ccitt(0xff, &entry, offsetof(struct emds_ate, crc8));
-	rc = data_wrt(fs, data, len);
-	if (rc) {
-		return rc;
+
+	/* Write multiples of the write block size directly from the data */
+	blen = len & ~(fs->flash_params->write_block_size - 1U);
+	if (blen > 0) {
+		bursts[count++] = (struct flash_burst){ offset, data, blen };
 	}
 
-	rc = ate_wrt(fs, &entry);
+	/* Pad the remaining bytes to a full write block */
+	if (len > blen) {
+		(void)memcpy(buf, (const uint8_t *)data + blen, len - blen);
+		(void)memset(buf + (len - blen), fs->flash_params->erase_value,
+			     fs->flash_params->write_block_size - (len - blen));
+		bursts[count++] = (struct flash_burst){
+			offset + blen, buf, fs->flash_params->write_block_size
+		};
+	}
+
+	bursts[count++] = (struct flash_burst){ fs->ate_wra, &entry, sizeof(struct emds_ate) };
+
+	rc = flash_direct_write(fs->flash_dev, bursts, count);
 	if (rc) {
 		return rc;
 	}
 
+	fs->data_wra_offset += align_size(fs, len);
+	fs->ate_wra -= fs->ate_size;
+
 	return 0;
 }
 
@@ -588,10 +569,12 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 		return -ENOMEM;
 	}
 
-	int rc = old_entries_invalidate(fs);
+	if (!fs->keep_entries) {
+		int rc = old_entries_invalidate(fs);
 
-	if (rc) {
-		return rc;
+		if (rc) {
+			return rc;
+		}
 	}
 
 	if (fs->force_erase || (byte_size > emds_flash_free_space_get(fs))) {
@@ -603,6 +586,11 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 	return 0;
 }
 
+bool emds_flash_is_empty(struct emds_fs *fs)
+{
+	return fs->ate_wra == fs->offset + fs->sector_cnt * fs->sector_size - fs->ate_size;
+}
+
 ssize_t emds_flash_free_space_get(struct emds_fs *fs)
 {
 	ssize_t space = fs->ate_wra - (fs->data_wra_offset + fs->offset);
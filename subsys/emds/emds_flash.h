@@ -31,6 +31,8 @@ extern "C" {
  * @param flash_dev Pointer to flash device runtime structure
  * @param flash_params Pointer to flash memory parameters structure
  * @param force_erase Force erase flag
+ * @param keep_entries Keep the stored entries valid on prepare, unless the flash area has to be
+ * cleared
  */
 struct emds_fs {
 	off_t offset;
@@ -45,6 +47,7 @@ struct emds_fs {
 	const struct device *flash_dev;
 	const struct flash_parameters *flash_params;
 	bool force_erase;
+	bool keep_entries;
 };
 
 /**
@@ -106,8 +109,9 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
  * entries from flash. It will invalidate all prior entries, and potentially clear the flash
  * area.
  *
- * @note Calling this function will make any subsequent read attempts fail. Be sure to
- * restore all necessary entries before using this function.
+ * @note Calling this function will make any subsequent read attempts fail, unless
+ * @c keep_entries is set and the flash area was not cleared. Be sure to restore all necessary
+ * entries before using this function.
  *
  * @note Should only be called once.
  *
@@ -127,6 +131,15 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size);
  */
 ssize_t emds_flash_free_space_get(struct emds_fs *fs);
 
+/**
+ * @brief Check if the EMDS file system holds any entries.
+ *
+ * @param fs Pointer to file system
+ *
+ * @retval true if no entries have been written since the flash area was cleared
+ */
+bool emds_flash_is_empty(struct emds_fs *fs);
+
 
 #ifdef __cplusplus
 }
@@ -14,6 +14,8 @@ int url_parse_proto(const char *url, int *proto, int *type);
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
 int http_parse(struct download_client *client, size_t len);
+int http_parse_lent(struct download_client *client, size_t len);
+bool http_buf_lend(struct download_client *client);
 int http_get_request_send(struct download_client *client);
 
 int coap_block_init(struct download_client *client, size_t from);
@@ -23,5 +25,7 @@ int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
 
 int socket_send(const struct download_client *client, size_t len, int timeout);
+int socket_send_buf(const struct download_client *client, const char *buf, size_t len,
+		    int timeout);
 
 #endif /* DOWNLOAD_CLIENT_INTERNAL_H */
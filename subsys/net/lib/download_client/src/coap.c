@@ -9,7 +9,9 @@
 #include <net/download_client.h>
 #include <zephyr/logging/log.h>
 #include <string.h>
+#include <limits.h>
 #include <zephyr/sys/__assert.h>
+#include "download_client_internal.h"
 
 LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
@@ -17,29 +19,178 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 #define FILENAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE
 #define COAP_PATH_ELEM_DELIM "/"
 
+/* Room for the CoAP header and options of a response */
+#define COAP_RESPONSE_HDR_MAX 32
+
+/* Retransmission timeout bounds, as in RFC 6298 */
+#define RTO_MIN_MS 1000
+#define RTO_MAX_MS 60000
+
+/* Smallest block size used when adapting the block size */
+#define BLOCK_SIZE_MIN COAP_BLOCK_128
+/* Blocks received without retransmission before doubling the block size */
+#define BLOCK_SIZE_GROW_AFTER 16
+
 /* declaration of strtok_r appears to be missing in some cases,
  * even though it's defined in the minimal libc, so we forward declare it
  */
 extern char *strtok_r(char *str, const char *sep, char **state);
 
-int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len, int timeout);
+static size_t block_bytes(const struct download_client *client)
+{
+	return coap_block_size_to_bytes(client->coap.block_ctx.block_size);
+}
+
+static bool is_pending(const struct download_client *client, int i)
+{
+	return client->coap.pending[i].timeout > 0;
+}
 
-static int coap_get_current_from_response_pkt(const struct coap_packet *cpkt)
+static bool window_is_empty(const struct download_client *client)
 {
-	int block = 0;
+	if (client->coap.received) {
+		return false;
+	}
 
-	block = coap_get_option_int(cpkt, COAP_OPTION_BLOCK2);
-	if (block < 0) {
-		return block;
+	for (int i = 0; i < client->coap.window; i++) {
+		if (is_pending(client, i)) {
+			return false;
+		}
 	}
 
-	return GET_BLOCK_NUM(block) << (GET_BLOCK_SIZE(block) + 4);
+	return true;
 }
 
-static bool has_pending(struct download_client *client)
+/* Responses are received after the blocks of the window, and requests are
+ * built there, so that the blocks stay in place until they are delivered.
+ */
+static size_t dgram_offset(const struct download_client *client)
 {
-	return client->coap.pending.timeout > 0;
+	if (client->coap.window == 1) {
+		return 0;
+	}
+
+	return client->coap.window * block_bytes(client);
+}
+
+/* The window only changes size when it is empty */
+static uint8_t window_size(const struct download_client *client)
+{
+	size_t blocks = (sizeof(client->buf) - COAP_RESPONSE_HDR_MAX) / block_bytes(client);
+
+	/* Until the file size is known, it is not known how many blocks to request.
+	 * A download resumed in the middle of a block only requests that block.
+	 */
+	if (client->file_size == 0 || client->coap.block_ctx.current % block_bytes(client)) {
+		return 1;
+	}
+
+	/* One block of room is left for receiving the responses */
+	if (blocks < 3) {
+		return 1;
+	}
+
+	return MIN(blocks - 1, DOWNLOAD_CLIENT_COAP_WINDOW_MAX);
+}
+
+/* Remove the blocks that were delivered, and move the others to the start of the buffer */
+static void window_shift(struct download_client *client)
+{
+	uint8_t n = client->coap.shift;
+
+	if (n == 0) {
+		return;
+	}
+
+	memmove(client->buf, client->buf + n * block_bytes(client),
+		(client->coap.window - n) * block_bytes(client));
+
+	for (int i = 0; i < client->coap.window - n; i++) {
+		client->coap.pending[i] = client->coap.pending[i + n];
+		client->coap.sent[i] = client->coap.sent[i + n];
+		client->coap.len[i] = client->coap.len[i + n];
+	}
+
+	for (int i = client->coap.window - n; i < client->coap.window; i++) {
+		coap_pending_clear(&client->coap.pending[i]);
+	}
+
+	client->coap.received >>= n;
+	client->coap.retransmitted >>= n;
+	client->coap.resend >>= n;
+	client->coap.last = (client->coap.last > n) ? client->coap.last - n : 0;
+	client->coap.shift = 0;
+}
+
+static void window_resize(struct download_client *client)
+{
+	enum coap_block_size next = client->coap.next_block_size;
+
+	/* A larger block must start at a multiple of its size */
+	if (next < client->coap.block_ctx.block_size ||
+	    client->coap.block_ctx.current % coap_block_size_to_bytes(next) == 0) {
+		if (next != client->coap.block_ctx.block_size) {
+			LOG_DBG("CoAP block size %d", coap_block_size_to_bytes(next));
+		}
+		client->coap.block_ctx.block_size = next;
+	}
+
+	client->coap.window = window_size(client);
+}
+
+static void rtt_update(struct download_client *client, uint32_t rtt)
+{
+	uint32_t delta;
+
+	if (!client->coap.srtt) {
+		client->coap.srtt = MAX(rtt, 1);
+		client->coap.rttvar = rtt / 2;
+		return;
+	}
+
+	delta = (client->coap.srtt > rtt) ? client->coap.srtt - rtt : rtt - client->coap.srtt;
+	client->coap.rttvar = (3 * client->coap.rttvar + delta) / 4;
+	client->coap.srtt = MAX((7 * client->coap.srtt + rtt) / 8, 1);
+}
+
+static uint32_t rto_get(const struct download_client *client)
+{
+	return CLAMP(client->coap.srtt + 4 * client->coap.rttvar, RTO_MIN_MS, RTO_MAX_MS);
+}
+
+static void block_lost(struct download_client *client)
+{
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_ADAPTIVE)) {
+		return;
+	}
+
+	client->coap.good = 0;
+
+	if (client->coap.block_ctx.block_size > BLOCK_SIZE_MIN &&
+	    client->coap.next_block_size == client->coap.block_ctx.block_size) {
+		client->coap.next_block_size--;
+	}
+}
+
+static void block_received(struct download_client *client, int i)
+{
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_ADAPTIVE)) {
+		return;
+	}
+
+	if (client->coap.retransmitted & BIT(i)) {
+		/* The round-trip time is ambiguous (Karn's algorithm) */
+		return;
+	}
+
+	rtt_update(client, k_uptime_get_32() - client->coap.sent[i]);
+
+	if (++client->coap.good >= BLOCK_SIZE_GROW_AFTER) {
+		client->coap.good = 0;
+		if (client->coap.next_block_size < CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE) {
+			client->coap.next_block_size++;
+		}
+	}
 }
 
 int coap_block_init(struct download_client *client, size_t from)
@@ -47,21 +198,48 @@ int coap_block_init(struct download_client *client, size_t from)
 	coap_block_transfer_init(&client->coap.block_ctx,
 				 CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE, 0);
 	client->coap.block_ctx.current = from;
-	coap_pending_clear(&client->coap.pending);
+
+	for (int i = 0; i < ARRAY_SIZE(client->coap.pending); i++) {
+		coap_pending_clear(&client->coap.pending[i]);
+	}
+
+	client->coap.received = 0;
+	client->coap.retransmitted = 0;
+	client->coap.resend = 0;
+	client->coap.window = 1;
+	client->coap.shift = 0;
+	client->coap.last = 0;
+	client->coap.next_block_size = CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE;
+	client->coap.good = 0;
+	client->coap.srtt = 0;
+	client->coap.rttvar = 0;
+
 	return 0;
 }
 
 int coap_get_recv_timeout(struct download_client *dl)
 {
-	int timeout;
-
-	__ASSERT(has_pending(dl), "Must have coap pending");
+	int timeout = INT_MAX;
+	int remaining;
+	bool pending = false;
 
 	/* Retransmission is cycled in case recv() times out. In case sending request
 	 * blocks, the time that is used for sending request must be substracted next time
 	 * recv() is called.
 	 */
-	timeout = dl->coap.pending.t0 + dl->coap.pending.timeout - k_uptime_get_32();
+	for (int i = 0; i < dl->coap.window; i++) {
+		if (!is_pending(dl, i)) {
+			continue;
+		}
+
+		pending = true;
+		remaining = dl->coap.pending[i].t0 + dl->coap.pending[i].timeout -
+			    k_uptime_get_32();
+		timeout = MIN(timeout, remaining);
+	}
+
+	__ASSERT(pending, "Must have coap pending");
+
 	if (timeout < 0) {
 		/* All time is spent when sending request and time this
 		 * method is called, there is no time left for receiving;
@@ -74,59 +252,128 @@ int coap_get_recv_timeout(struct download_client *dl)
 	return timeout;
 }
 
+static int retransmission_schedule(struct download_client *dl, int i)
+{
+	if (!coap_pending_cycle(&dl->coap.pending[i])) {
+		LOG_ERR("CoAP max-retransmissions exceeded");
+		return -1;
+	}
+
+	dl->coap.resend |= BIT(i);
+	dl->coap.retransmitted |= BIT(i);
+
+	return 0;
+}
+
 int coap_initiate_retransmission(struct download_client *dl)
 {
-	if (dl->coap.pending.timeout == 0) {
+	int earliest = -1;
+	int remaining;
+	int min_remaining = INT_MAX;
+	bool expired = false;
+
+	for (int i = 0; i < dl->coap.window; i++) {
+		if (!is_pending(dl, i)) {
+			continue;
+		}
+
+		remaining = dl->coap.pending[i].t0 + dl->coap.pending[i].timeout -
+			    k_uptime_get_32();
+		if (remaining < min_remaining) {
+			min_remaining = remaining;
+			earliest = i;
+		}
+
+		if (remaining <= 0) {
+			expired = true;
+			if (retransmission_schedule(dl, i)) {
+				return -1;
+			}
+		}
+	}
+
+	if (earliest < 0) {
 		return -EINVAL;
 	}
 
-	if (!coap_pending_cycle(&dl->coap.pending)) {
-		LOG_ERR("CoAP max-retransmissions exceeded");
+	/* recv() may return just before the timeout expires */
+	if (!expired && retransmission_schedule(dl, earliest)) {
 		return -1;
 	}
 
+	block_lost(dl);
+
 	return 0;
 }
 
+/* Returns the index of the pending request with the ID of the response, or -1 */
+static int pending_find(const struct download_client *client, uint16_t id)
+{
+	for (int i = 0; i < client->coap.window; i++) {
+		if (is_pending(client, i) && client->coap.pending[i].id == id) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 static int coap_block_update(struct download_client *client, struct coap_packet *pkt,
-			     size_t *blk_off, bool *more)
+			     int i, size_t *blk_off, bool *more)
 {
-	int err, new_current;
+	int block2, size2;
+	enum coap_block_size szx;
+	size_t block_start;
+	size_t expected;
 
-	*blk_off = client->coap.block_ctx.current %
-		   coap_block_size_to_bytes(client->coap.block_ctx.block_size);
+	*blk_off = client->coap.block_ctx.current % block_bytes(client);
 	if (*blk_off) {
 		LOG_DBG("%d bytes of current block already downloaded",
 			*blk_off);
 	}
 
-	new_current = coap_get_current_from_response_pkt(pkt);
-	if (new_current < 0) {
-		LOG_ERR("Failed to get current from CoAP packet, err %d", new_current);
-		return new_current;
+	block2 = coap_get_option_int(pkt, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		LOG_ERR("Failed to get current from CoAP packet, err %d", block2);
+		return block2;
 	}
 
-	if (new_current < client->coap.block_ctx.current) {
-		LOG_WRN("Block out of order %d, expected %d", new_current,
-			client->coap.block_ctx.current);
-		return -1;
-	} else if (new_current > client->coap.block_ctx.current) {
-		LOG_WRN("Block out of order %d, expected %d", new_current,
-			client->coap.block_ctx.current);
-		return -1;
-	}
+	szx = GET_BLOCK_SIZE(block2);
+	block_start = GET_BLOCK_NUM(block2) << (szx + 4);
+	expected = client->coap.block_ctx.current - *blk_off + i * block_bytes(client);
 
-	err = coap_update_from_block(pkt, &client->coap.block_ctx);
-	if (err) {
-		return err;
+	if (i == 0 && szx < client->coap.block_ctx.block_size &&
+	    block_start == ROUND_DOWN(client->coap.block_ctx.current,
+				      coap_block_size_to_bytes(szx))) {
+		/* The server uses smaller blocks, continue with its block size.
+		 * The other requests of the window are for larger blocks.
+		 */
+		LOG_DBG("Server block size %d", coap_block_size_to_bytes(szx));
+
+		for (int j = 1; j < client->coap.window; j++) {
+			coap_pending_clear(&client->coap.pending[j]);
+		}
+
+		client->coap.block_ctx.block_size = szx;
+		client->coap.next_block_size = szx;
+		client->coap.received = 0;
+		client->coap.resend = 0;
+		client->coap.last = 0;
+		client->coap.window = 1;
+		*blk_off = client->coap.block_ctx.current % block_bytes(client);
+	} else if (block_start != expected || szx != client->coap.block_ctx.block_size) {
+		LOG_WRN("Block out of order %zu, expected %zu", block_start, expected);
+		return -1;
 	}
 
-	if (client->file_size == 0 && client->coap.block_ctx.total_size > 0) {
-		LOG_DBG("Total size: %d", client->coap.block_ctx.total_size);
-		client->file_size = client->coap.block_ctx.total_size;
+	size2 = coap_get_option_int(pkt, COAP_OPTION_SIZE2);
+	if (client->file_size == 0 && size2 > 0) {
+		LOG_DBG("Total size: %d", size2);
+		client->coap.block_ctx.total_size = size2;
+		client->file_size = size2;
 	}
 
-	*more = coap_next_block(pkt, &client->coap.block_ctx);
+	*more = GET_MORE(block2);
 	if (!*more) {
 		LOG_DBG("Last block received");
 	}
@@ -137,7 +384,10 @@ static int coap_block_update(struct download_client *client, struct coap_packet
 int coap_parse(struct download_client *client, size_t len)
 {
 	int err;
+	int i;
 	size_t blk_off;
+	size_t delivered = 0;
+	uint8_t n = 0;
 	uint8_t response_code;
 	uint16_t payload_len;
 	const uint8_t *payload;
@@ -148,19 +398,23 @@ int coap_parse(struct download_client *client, size_t len)
 	 * and we can just request the same block again using retry mechanism
 	 */
 
-	err = coap_packet_parse(&response, client->buf, len, NULL, 0);
+	window_shift(client);
+
+	err = coap_packet_parse(&response, client->buf + client->offset, len, NULL, 0);
 	if (err) {
 		LOG_ERR("Failed to parse CoAP packet, err %d", err);
 		return -EBADMSG;
 	}
 
-
-	if (coap_header_get_id(&response) != client->coap.pending.id) {
-		LOG_ERR("Response is not pending");
-		return -EBADMSG;
+	i = pending_find(client, coap_header_get_id(&response));
+	if (i < 0) {
+		/* A late response to a request that was already answered */
+		LOG_WRN("Response is not pending");
+		return 1;
 	}
 
-	coap_pending_clear(&client->coap.pending);
+	coap_pending_clear(&client->coap.pending[i]);
+	client->coap.resend &= ~BIT(i);
 
 	if (coap_header_get_type(&response) != COAP_TYPE_ACK) {
 		LOG_ERR("Response must be of coap type ACK");
@@ -174,7 +428,7 @@ int coap_parse(struct download_client *client, size_t len)
 		return -EBADMSG;
 	}
 
-	err = coap_block_update(client, &response, &blk_off, &more);
+	err = coap_block_update(client, &response, i, &blk_off, &more);
 	if (err) {
 		return -EBADMSG;
 	}
@@ -185,28 +439,49 @@ int coap_parse(struct download_client *client, size_t len)
 		return -EBADMSG;
 	}
 
-	/* TODO: because our buffer is large enough for the whole datagram,
-	 * we don't scrictly need to copy the bytes at the beginning
-	 * of the buffer, we could simply send a fragment pointing to the
-	 * payload directly.
+	block_received(client, i);
+
+	/* Put the payload at the position of its block in the window. With a
+	 * single block, the response was received at the start of the buffer.
 	 */
 	LOG_DBG("CoAP response: %d, copying %d bytes",
 		coap_header_get_code(&response), payload_len - blk_off);
-	memcpy(client->buf + client->offset, payload + blk_off,
-	       payload_len - blk_off);
+	memmove(client->buf + i * block_bytes(client), payload + blk_off,
+		payload_len - blk_off);
 
-	client->offset += payload_len - blk_off;
-	client->progress += payload_len - blk_off;
+	client->coap.len[i] = payload_len - blk_off;
+	client->coap.received |= BIT(i);
 
 	if (!more) {
-		/* Mark the end, in case we did not know the total size */
-		client->file_size = client->progress;
+		client->coap.last = i + 1;
+	}
+
+	/* Deliver the blocks that are received in order */
+	while (n < client->coap.window && (client->coap.received & BIT(n))) {
+		delivered += client->coap.len[n];
+		n++;
+
+		if (client->coap.last == n) {
+			/* Mark the end, in case we did not know the total size */
+			client->file_size = client->progress + delivered;
+			break;
+		}
+	}
+
+	if (n == 0) {
+		/* Wait for the first block of the window */
+		return 1;
 	}
 
+	client->offset = delivered;
+	client->progress += delivered;
+	client->coap.block_ctx.current += delivered;
+	client->coap.shift = n;
+
 	return 0;
 }
 
-int coap_request_send(struct download_client *client)
+static int coap_block_request_send(struct download_client *client, int i, size_t off)
 {
 	int err;
 	uint16_t id;
@@ -214,14 +489,15 @@ int coap_request_send(struct download_client *client)
 	char *path_elem;
 	char *path_elem_saveptr;
 	struct coap_packet request;
+	struct coap_block_context block_ctx = client->coap.block_ctx;
 
-	if (has_pending(client)) {
-		id = client->coap.pending.id;
+	if (is_pending(client, i)) {
+		id = client->coap.pending[i].id;
 	} else {
 		id = coap_next_id();
 	}
 
-	err = coap_packet_init(&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, COAP_VER,
+	err = coap_packet_init(&request, client->buf + off, sizeof(client->buf) - off, COAP_VER,
 			       COAP_TYPE_CON, 8, coap_next_token(), COAP_METHOD_GET, id);
 	if (err) {
 		LOG_ERR("Failed to init CoAP message, err %d", err);
@@ -244,43 +520,96 @@ int coap_request_send(struct download_client *client)
 		}
 	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
 
-	err = coap_append_block2_option(&request, &client->coap.block_ctx);
+	block_ctx.current += i * block_bytes(client);
+
+	err = coap_append_block2_option(&request, &block_ctx);
 	if (err) {
 		LOG_ERR("Unable to add block2 option");
 		return err;
 	}
 
-	err = coap_append_size2_option(&request, &client->coap.block_ctx);
+	err = coap_append_size2_option(&request, &block_ctx);
 	if (err) {
 		LOG_ERR("Unable to add size2 option");
 		return err;
 	}
 
-	if (!has_pending(client)) {
+	if (!is_pending(client, i)) {
 		struct coap_transmission_parameters params = coap_get_transmission_parameters();
 
 		params.max_retransmission =
 			CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT;
-		err = coap_pending_init(&client->coap.pending, &request, &client->remote_addr,
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_ADAPTIVE) && client->coap.srtt) {
+			params.ack_timeout = rto_get(client);
+		}
+
+		err = coap_pending_init(&client->coap.pending[i], &request, &client->remote_addr,
 					&params);
 		if (err < 0) {
 			return -EINVAL;
 		}
 
-		coap_pending_cycle(&client->coap.pending);
+		coap_pending_cycle(&client->coap.pending[i]);
+		client->coap.sent[i] = k_uptime_get_32();
+		client->coap.retransmitted &= ~BIT(i);
 	}
 
-	LOG_DBG("CoAP next block: %d", client->coap.block_ctx.current);
+	LOG_DBG("CoAP next block: %d", block_ctx.current);
 
-	err = socket_send(client, request.offset, client->coap.pending.timeout);
+	err = socket_send_buf(client, client->buf + off, request.offset,
+			      client->coap.pending[i].timeout);
 	if (err) {
 		LOG_ERR("Failed to send CoAP request, errno %d", errno);
 		return err;
 	}
 
+	client->coap.resend &= ~BIT(i);
+
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
 		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
 	}
 
 	return 0;
 }
+
+int coap_request_send(struct download_client *client)
+{
+	int err;
+	size_t off;
+
+	window_shift(client);
+
+	if (window_is_empty(client)) {
+		window_resize(client);
+	}
+
+	off = dgram_offset(client);
+
+	for (int i = 0; i < client->coap.window; i++) {
+		if (is_pending(client, i)) {
+			if (!(client->coap.resend & BIT(i))) {
+				continue;
+			}
+		} else if (client->coap.received & BIT(i)) {
+			continue;
+		} else if (i > 0 &&
+			   (client->coap.next_block_size != client->coap.block_ctx.block_size ||
+			    client->coap.block_ctx.current + i * block_bytes(client) >=
+			    client->file_size)) {
+			/* Let the window empty before changing the block size,
+			 * and do not request past the end of the file.
+			 */
+			continue;
+		}
+
+		err = coap_block_request_send(client, i, off);
+		if (err) {
+			return err;
+		}
+	}
+
+	/* Receive the response after the blocks of the window */
+	client->offset = off;
+
+	return 0;
+}
@@ -31,6 +31,8 @@ LOG_MODULE_REGISTER(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 #define HOSTNAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE
 
+extern char *strnstr(const char *haystack, const char *needle, size_t haystack_sz);
+
 static int handle_disconnect(struct download_client *client);
 static int error_evt_send(const struct download_client *dl, int error);
 
@@ -326,6 +328,18 @@ static int client_socket_connect(struct download_client *dl, int type, uint16_t
 				/* Not fatal, so continue */
 			}
 		}
+
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_TLS_SESSION_CACHE)) {
+			int cache = TLS_SESSION_CACHE_ENABLED;
+
+			err = setsockopt(dl->fd, SOL_TLS, TLS_SESSION_CACHE, &cache,
+					 sizeof(cache));
+			if (err) {
+				err = -errno;
+				LOG_WRN("Failed to enable TLS_SESSION_CACHE: %d", err);
+				/* Not fatal, so continue */
+			}
+		}
 	}
 
 	if (IS_ENABLED(CONFIG_LOG)) {
@@ -465,7 +479,8 @@ cleanup:
 	return err;
 }
 
-int socket_send(const struct download_client *client, size_t len, int timeout)
+int socket_send_buf(const struct download_client *client, const char *buf, size_t len,
+		    int timeout)
 {
 	int err;
 	int sent;
@@ -477,7 +492,7 @@ int socket_send(const struct download_client *client, size_t len, int timeout)
 	}
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(client->fd, buf + off, len, 0);
 		if (sent < 0) {
 			return -errno;
 		}
@@ -489,6 +504,11 @@ int socket_send(const struct download_client *client, size_t len, int timeout)
 	return 0;
 }
 
+int socket_send(const struct download_client *client, size_t len, int timeout)
+{
+	return socket_send_buf(client, client->buf, len, timeout);
+}
+
 static int request_send(struct download_client *dl)
 {
 	if (dl->fd < 0) {
@@ -513,17 +533,38 @@ static int fragment_evt_send(struct download_client *client)
 	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
 
-	const struct download_client_evt evt = {
+	struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
 			.buf = client->buf,
 			.len = client->offset,
 		}
 	};
+	/* Any bytes of the next pipelined response follow the buffered
+	 * payload in the receive buffer, even if the fragment itself was
+	 * received into a lent buffer.
+	 */
+	const size_t carry_from = client->offset;
+	int err;
+
+	if (client->http.lent_buf) {
+		/* The payload was received into the lent buffer */
+		evt.fragment.buf = client->http.lent_buf;
+		evt.fragment.len = client->http.lent_used;
+		evt.fragment.lent = true;
+		client->http.lent_buf = NULL;
+	}
 
 	client->offset = 0;
 
-	return client->callback(&evt);
+	err = client->callback(&evt);
+
+	if (client->http.carry) {
+		/* Keep the start of the next pipelined response */
+		memmove(client->buf, client->buf + carry_from, client->http.carry);
+	}
+
+	return err;
 }
 
 static int error_evt_send(const struct download_client *dl, int error)
@@ -544,6 +585,19 @@ static int reconnect(struct download_client *dl)
 	int err;
 
 	LOG_INF("Reconnecting...");
+
+	/* Pipelined requests are lost with the connection */
+	dl->http.pipelined = 0;
+	dl->http.pipeline_stale = false;
+	dl->http.carry = 0;
+	dl->http.lent_buf = NULL;
+
+	if (IS_ENABLED(CONFIG_COAP) &&
+	    (dl->proto == IPPROTO_UDP || dl->proto == IPPROTO_DTLS_1_2)) {
+		/* Request the blocks of the window again on the new connection */
+		coap_block_init(dl, dl->progress);
+	}
+
 	if (dl->fd >= 0) {
 		err = close(dl->fd);
 		if (err) {
@@ -556,6 +610,30 @@ static int reconnect(struct download_client *dl)
 	return err;
 }
 
+/* Receive no further than the end of the HTTP header, so that the payload
+ * can be received directly into a lent buffer.
+ */
+static ssize_t socket_recv_header(struct download_client *dl)
+{
+	char *p = dl->buf + dl->offset;
+	char *start = dl->buf + MAX(dl->offset, 3) - 3;
+	char *end;
+	ssize_t len;
+
+	len = recv(dl->fd, p, sizeof(dl->buf) - dl->offset, MSG_PEEK);
+	if (len <= 0) {
+		return len;
+	}
+
+	/* The end of the header may start in the previous read */
+	end = strnstr(start, "\r\n\r\n", p + len - start);
+	if (end) {
+		len = end + strlen("\r\n\r\n") - p;
+	}
+
+	return recv(dl->fd, p, len, 0);
+}
+
 static ssize_t socket_recv(struct download_client *dl)
 {
 	int err, timeout = 0;
@@ -585,6 +663,18 @@ static ssize_t socket_recv(struct download_client *dl)
 		return -1;
 	}
 
+	if (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2) {
+		if (dl->offset == 0 && http_buf_lend(dl)) {
+			return recv(dl->fd, dl->http.lent_buf + dl->http.lent_used,
+				    MIN(dl->http.lent_len - dl->http.lent_used,
+					dl->http.body_left), 0);
+		}
+
+		if (dl->config.buf_lend && !dl->http.has_header) {
+			return socket_recv_header(dl);
+		}
+	}
+
 	return recv(dl->fd, dl->buf + dl->offset, sizeof(dl->buf) - dl->offset, 0);
 }
 
@@ -628,7 +718,8 @@ static int handle_socket_error(struct download_client *dl, ssize_t len)
 	 * and it has been accounted in our progress, we have
 	 * to hand it to the application before discarding it.
 	 */
-	if ((dl->offset > 0) && (dl->http.has_header)) {
+	if ((dl->http.lent_buf ? dl->http.lent_used : dl->offset) > 0 &&
+	    (dl->http.has_header)) {
 		rc = fragment_evt_send(dl);
 		if (rc) {
 			/* Restart and suspend */
@@ -637,6 +728,8 @@ static int handle_socket_error(struct download_client *dl, ssize_t len)
 		}
 	}
 
+	dl->http.lent_buf = NULL;
+
 	rc = ECONNRESET;
 
 	if (len == -1) {
@@ -691,8 +784,12 @@ static int handle_received(struct download_client *dl, ssize_t len)
 	LOG_DBG("Read %d bytes from socket", len);
 
 	if (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2) {
-		rc = http_parse(dl, len);
-		if (rc > 0 &&
+		if (dl->http.lent_buf) {
+			rc = http_parse_lent(dl, len);
+		} else {
+			rc = http_parse(dl, len);
+		}
+		if (rc == 1 &&
 		    (!dl->http.has_header || dl->offset < sizeof(dl->buf))) {
 			/* Wait for more data (full buffer).
 			 * Forward only full buffers to callback.
@@ -732,6 +829,9 @@ static int handle_received(struct download_client *dl, ssize_t len)
 		/* Restart and suspend */
 		LOG_INF("Fragment refused, download stopped.");
 		rc = -1;
+	} else if (rc == 2) {
+		/* The lent buffer is full, more payload follows */
+		return 1;
 	}
 
 	if (dl->progress == dl->file_size) {
@@ -860,7 +960,15 @@ void download_thread(void *client, void *a, void *b)
 			LOG_DBG("Receiving up to %d bytes at %p...", (sizeof(dl->buf) - dl->offset),
 				(void *)(dl->buf + dl->offset));
 
-			len = socket_recv(dl);
+			if (dl->http.carry) {
+				/* The start of the next pipelined response
+				 * is already in the buffer.
+				 */
+				len = dl->http.carry;
+				dl->http.carry = 0;
+			} else {
+				len = socket_recv(dl);
+			}
 
 			if ((len == 0) || (len == -1)) {
 				/* We just had an unexpected socket error or closure */
@@ -993,6 +1101,11 @@ int download_client_start(struct download_client *client, const char *file,
 	client->progress = from;
 	client->offset = 0;
 	client->http.has_header = false;
+	client->http.pipelined = 0;
+	client->http.pipeline_stale = false;
+	client->http.carry = 0;
+	client->http.window = 1;
+	client->http.lent_buf = NULL;
 	if (is_idle(client)) {
 		set_state(client, DOWNLOAD_CLIENT_CONNECTING);
 	} else {
@@ -18,6 +18,12 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 #define HOSTNAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE
 #define FILENAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)
+#define PIPELINE_DEPTH CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH
+#else
+#define PIPELINE_DEPTH 1
+#endif
+
 /* Request whole file; use with HTTP */
 #define HTTP_GET                                                               \
 	"GET /%s HTTP/1.1\r\n"                                                 \
@@ -43,6 +49,98 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 extern char *strnstr(const char *haystack, const char *needle, size_t haystack_sz);
 
+static size_t http_frag_size(const struct download_client *client)
+{
+	return client->config.frag_size_override != 0 ?
+		       client->config.frag_size_override :
+		       CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+/* Send range requests until the pipeline window is full. The requests are
+ * formatted in the buffer space following the buffered data of the next
+ * response, if any.
+ */
+static int http_pipeline_fill(struct download_client *client, const char *host,
+			      const char *file)
+{
+	char *req = client->buf + client->http.carry;
+	size_t req_size = sizeof(client->buf) - client->http.carry;
+	size_t off;
+	int err;
+	int len;
+
+	if (client->http.pipelined == 0) {
+		/* Nothing in flight, for instance after (re)connecting */
+		client->http.request_next = client->progress;
+		client->http.has_header = false;
+		client->http.rtt_start = k_uptime_get_32();
+	}
+
+	/* The file size is unknown until the first response has been
+	 * received, so request only one fragment until then.
+	 */
+	while (client->http.pipelined < MAX(client->http.window, 1) &&
+	       (client->file_size ? client->http.request_next < client->file_size :
+				    client->http.pipelined == 0)) {
+		off = client->http.request_next + http_frag_size(client) - 1;
+		if (client->file_size != 0) {
+			off = MIN(off, client->file_size - 1);
+		}
+
+		len = snprintf(req, req_size, HTTP_GET_RANGE, file, host,
+			       client->http.request_next, off);
+		if (len < 0 || len >= req_size) {
+			if (client->http.pipelined) {
+				/* Send the rest when the buffer has room */
+				break;
+			}
+
+			LOG_ERR("Cannot create GET request, buffer too small");
+			return -ENOMEM;
+		}
+
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+			LOG_HEXDUMP_DBG(req, len, "HTTP request");
+		}
+
+		err = socket_send_buf(client, req, len, 0);
+		if (err) {
+			LOG_ERR("Failed to send HTTP request, errno %d", errno);
+			return err;
+		}
+
+		client->http.ranged = true;
+		client->http.request_next = off + 1;
+		client->http.pipelined++;
+	}
+
+	return 0;
+}
+
+/* Called when the whole payload of a pipelined response has been received. */
+static void http_pipeline_response_done(struct download_client *client)
+{
+	uint32_t xfer = MAX(k_uptime_get_32() - client->http.header_time, 1);
+
+	client->http.pipelined--;
+	client->http.has_header = false;
+
+	if (client->http.pipeline_stale) {
+		/* Drop the responses in flight and request the rest again */
+		client->http.pipeline_stale = false;
+		client->http.connection_close = true;
+	}
+
+	/* Keep enough requests in flight to cover the round-trip time with the
+	 * time it takes to receive a fragment.
+	 */
+	client->http.window = CLAMP(1 + DIV_ROUND_UP(client->http.rtt, xfer), 1,
+				    PIPELINE_DEPTH);
+
+	LOG_DBG("RTT %u ms, fragment %u ms, window %u", client->http.rtt, xfer,
+		client->http.window);
+}
+
 int http_get_request_send(struct download_client *client)
 {
 	int err;
@@ -54,8 +152,6 @@ int http_get_request_send(struct download_client *client)
 	__ASSERT_NO_MSG(client->host);
 	__ASSERT_NO_MSG(client->file);
 
-	client->http.has_header = false;
-
 	err = url_parse_host(client->host, host, sizeof(host));
 	if (err) {
 		return err;
@@ -66,14 +162,15 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
-	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)) {
+		return http_pipeline_fill(client, host, file);
 	}
 
+	client->http.has_header = false;
+
+	/* Offset of last byte in range (Content-Range) */
+	off = client->progress + http_frag_size(client) - 1;
+
 	if (client->file_size != 0) {
 		/* Don't request bytes past the end of file */
 		off = MIN(off, client->file_size - 1);
@@ -115,6 +212,46 @@ int http_get_request_send(struct download_client *client)
 	return 0;
 }
 
+/* Parse "Content-Range: bytes <first>-<last>/<size>" of a ranged response.
+ * The size is zero if the server sent "*" instead.
+ */
+static int http_content_range_parse(const struct download_client *client, size_t hdr_len,
+				    size_t *first, size_t *last, size_t *size)
+{
+	char *p;
+	char *q;
+
+	p = strnstr(client->buf, "\r\ncontent-range", hdr_len);
+	if (!p) {
+		LOG_ERR("Server did not send \"Content-Range\" in response");
+		return -EBADMSG;
+	}
+
+	p = strnstr(p, "bytes", hdr_len - (p - client->buf));
+	if (!p) {
+		LOG_ERR("Unsupported range unit in response");
+		return -EBADMSG;
+	}
+	p += strlen("bytes");
+
+	*first = strtoul(p, &q, 10);
+	if (q == p || *q != '-') {
+		LOG_ERR("No range in response");
+		return -EBADMSG;
+	}
+	p = q + 1;
+
+	*last = strtoul(p, &q, 10);
+	if (q == p || *q != '/' || *last < *first) {
+		LOG_ERR("No range in response");
+		return -EBADMSG;
+	}
+
+	*size = strtoul(q + 1, NULL, 10);
+
+	return 0;
+}
+
 /* Returns:
  *  1 while the header is being received
  *  0 if the header has been fully received
@@ -125,6 +262,10 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	char *p;
 	char *q;
 	unsigned int http_status;
+	size_t first = 0;
+	size_t last = 0;
+	size_t size;
+	int err;
 
 	const unsigned int expected_status = (client->http.ranged || client->progress) ? 206 : 200;
 
@@ -184,39 +325,50 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 
 	/* The file size is returned via "Content-Length" in case of HTTP,
 	 * and via "Content-Range" in case of HTTPS with range requests.
+	 * Each ranged response carries its own range, which may be shorter than
+	 * the one requested.
 	 */
-	if (client->file_size == 0) {
-		if (client->http.ranged) {
-			p = strnstr(client->buf, "\r\ncontent-range", sizeof(client->buf));
-			if (!p) {
-				LOG_ERR("Server did not send "
-					"\"Content-Range\" in response");
-				return -EBADMSG;
-			}
-			p = strnstr(p, "/", sizeof(client->buf) - (p - client->buf));
-			if (!p) {
-				LOG_ERR("No file size in response");
-				return -EBADMSG;
-			}
-		} else { /* proto == PROTO_HTTP */
-			p = strnstr(client->buf, "\r\ncontent-length", sizeof(client->buf));
-			if (!p) {
-				LOG_WRN("Server did not send "
-					"\"Content-Length\" in response");
-					return -EBADMSG;
-			}
-			p = strstr(p, ":");
-			if (!p) {
+	if (client->http.ranged) {
+		err = http_content_range_parse(client, *hdr_len, &first, &last, &size);
+		if (err) {
+			return err;
+		}
+
+		if (first != client->progress) {
+			LOG_ERR("Unexpected range %u-%u in response, expected offset %u",
+				first, last, client->progress);
+			return -EBADMSG;
+		}
+
+		if (client->file_size == 0) {
+			if (size == 0) {
 				LOG_ERR("No file size in response");
 				return -EBADMSG;
 			}
-			/* Accumulate any eventual progress (starting offset)
-			 * when reading the file size from Content-Length
-			 */
-			client->file_size = client->progress;
+			client->file_size = size;
+			LOG_DBG("File size = %u", client->file_size);
 		}
 
-		client->file_size += atoi(p + 1);
+		if (last >= client->file_size) {
+			LOG_ERR("Range %u-%u past the end of file", first, last);
+			return -EBADMSG;
+		}
+	} else if (client->file_size == 0) { /* proto == PROTO_HTTP */
+		p = strnstr(client->buf, "\r\ncontent-length", sizeof(client->buf));
+		if (!p) {
+			LOG_WRN("Server did not send "
+				"\"Content-Length\" in response");
+				return -EBADMSG;
+		}
+		p = strstr(p, ":");
+		if (!p) {
+			LOG_ERR("No file size in response");
+			return -EBADMSG;
+		}
+		/* Accumulate any eventual progress (starting offset)
+		 * when reading the file size from Content-Length
+		 */
+		client->file_size = client->progress + atoi(p + 1);
 		LOG_DBG("File size = %u", client->file_size);
 	}
 
@@ -227,6 +379,30 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	}
 
 	client->http.has_header = true;
+	if (client->http.ranged) {
+		client->http.body_left = last - first + 1;
+
+		/* The following pipelined responses start where the requested
+		 * range ended, not where this one does.
+		 */
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE) &&
+		    client->http.pipelined > 1 &&
+		    client->http.body_left <
+			    MIN(client->file_size - client->progress, http_frag_size(client))) {
+			LOG_WRN("Short range %u-%u, will re-connect", first, last);
+			client->http.pipeline_stale = true;
+		}
+	} else {
+		client->http.body_left = client->file_size - client->progress;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)) {
+		client->http.header_time = k_uptime_get_32();
+		if (client->http.rtt_start) {
+			client->http.rtt = client->http.header_time - client->http.rtt_start;
+			client->http.rtt_start = 0;
+		}
+	}
 
 	return 0;
 }
@@ -240,6 +416,7 @@ int http_parse(struct download_client *client, size_t len)
 {
 	int rc;
 	size_t hdr_len;
+	size_t payload;
 
 	/* Accumulate buffer offset */
 	client->offset += len;
@@ -281,14 +458,36 @@ int http_parse(struct download_client *client, size_t len)
 	 * `offset` is less than `len` and it represents
 	 * the actual payload bytes.
 	 */
-	client->progress += MIN(client->offset, len);
+	payload = MIN(client->offset, len);
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)) {
+		if (payload > client->http.body_left) {
+			/* The rest belongs to the next response */
+			client->http.carry = payload - client->http.body_left;
+			client->offset -= client->http.carry;
+			payload = client->http.body_left;
+		}
+
+		client->progress += payload;
+		client->http.body_left -= payload;
+
+		if (client->http.body_left) {
+			return 1;
+		}
+
+		http_pipeline_response_done(client);
+
+		return 0;
+	}
+
+	client->progress += payload;
+	client->http.body_left -= MIN(payload, client->http.body_left);
 
 	/* Have we received a whole fragment or the whole file? */
 	if (client->progress != client->file_size) {
 		if (client->http.ranged) {
-			if (client->offset < (client->config.frag_size_override != 0 ?
-						      client->config.frag_size_override :
-						      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+			if (client->offset < http_frag_size(client) &&
+			    client->http.body_left) {
 				/* Ranged query: read until a full fragment */
 				return 1;
 			}
@@ -301,3 +500,53 @@ int http_parse(struct download_client *client, size_t len)
 	/* Either we have a full file, or we need to request a next fragment */
 	return 0;
 }
+
+/* Returns true if the rest of the current response can be received into a
+ * buffer lent by the application.
+ */
+bool http_buf_lend(struct download_client *client)
+{
+	void *buf;
+	size_t len;
+
+	if (client->http.lent_buf) {
+		return true;
+	}
+
+	if (!client->config.buf_lend || !client->http.has_header ||
+	    client->http.body_left == 0) {
+		return false;
+	}
+
+	if (client->config.buf_lend(&buf, &len) || len == 0) {
+		return false;
+	}
+
+	client->http.lent_buf = buf;
+	client->http.lent_len = len;
+	client->http.lent_used = 0;
+
+	return true;
+}
+
+/* Returns:
+ *  2 if the lent buffer is full and more payload follows
+ *  1 if more data is expected
+ *  0 if the whole response has been received
+ */
+int http_parse_lent(struct download_client *client, size_t len)
+{
+	client->http.lent_used += len;
+	client->progress += len;
+	client->http.body_left -= len;
+
+	if (client->http.body_left == 0) {
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)) {
+			http_pipeline_response_done(client);
+		}
+
+		return 0;
+	}
+
+	return (client->http.lent_used < client->http.lent_len) ? 1 : 2;
+}
@@ -118,6 +118,18 @@ static void dfu_target_callback_handler(enum dfu_target_evt_id evt)
 	}
 }
 
+#ifdef CONFIG_FOTA_DOWNLOAD_ZERO_COPY
+static int dfu_target_buf_lend(void **buf, size_t *len)
+{
+	if (atomic_test_bit(&flags, FLAG_FIRST_FRAGMENT)) {
+		/* The DFU target is chosen from the first fragment */
+		return -EAGAIN;
+	}
+
+	return dfu_target_buf_get(buf, len);
+}
+#endif
+
 static int download_client_callback(const struct download_client_evt *event)
 {
 	static size_t file_size;
@@ -218,8 +230,13 @@ static int download_client_callback(const struct download_client_evt *event)
 			}
 		}
 
-		err = dfu_target_write(event->fragment.buf,
-				       event->fragment.len);
+		if (IS_ENABLED(CONFIG_FOTA_DOWNLOAD_ZERO_COPY) && event->fragment.lent) {
+			/* The fragment is in the buffer from dfu_target_buf_get() */
+			err = dfu_target_buf_commit(event->fragment.len);
+		} else {
+			err = dfu_target_write(event->fragment.buf,
+					       event->fragment.len);
+		}
 		if (err && err == -EINVAL) {
 			LOG_INF("Image refused");
 			set_error_state(FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE);
@@ -431,6 +448,9 @@ int fota_download(const char *host, const char *file,
 	struct download_client_cfg config = {
 		.pdn_id = pdn_id,
 		.frag_size_override = fragment_size,
+#ifdef CONFIG_FOTA_DOWNLOAD_ZERO_COPY
+		.buf_lend = dfu_target_buf_lend,
+#endif
 	};
 
 	if (host == NULL || file == NULL || callback == NULL) {
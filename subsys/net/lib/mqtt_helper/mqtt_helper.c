@@ -17,6 +17,7 @@
 
 #include <net/mqtt_helper.h>
 #include <zephyr/net/mqtt.h>
+#include <zephyr/sys/slist.h>
 #include <zephyr/logging/log.h>
 
 #if defined(CONFIG_MQTT_HELPER_PROVISION_CERTIFICATES)
@@ -309,6 +310,211 @@ MQTT_HELPER_STATIC void on_publish(const struct mqtt_evt *mqtt_evt)
 	}
 }
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+/* Weight of the latest sample in the latency average, as a power of two */
+#define LATENCY_AVG_SHIFT 3
+
+struct pub_entry {
+	sys_snode_t node;
+	struct mqtt_publish_param param;
+	/* Time when the message was given to mqtt_helper_publish() */
+	uint32_t queued_at;
+	/* Sent and waiting for a PUBACK */
+	bool sent;
+	/* Topic, followed by the payload */
+	uint8_t data[];
+};
+
+K_HEAP_DEFINE(pub_heap, CONFIG_MQTT_HELPER_PUBLISH_QUEUE_HEAP_SIZE);
+static sys_slist_t pub_queue = SYS_SLIST_STATIC_INIT(&pub_queue);
+static K_MUTEX_DEFINE(pub_lock);
+static struct mqtt_helper_queue_stats pub_stats;
+
+static void pub_latency_record(const struct pub_entry *entry)
+{
+	uint32_t latency = k_uptime_get_32() - entry->queued_at;
+
+	if (pub_stats.latency_avg_ms == 0) {
+		pub_stats.latency_avg_ms = latency;
+	} else {
+		pub_stats.latency_avg_ms += (latency >> LATENCY_AVG_SHIFT) -
+					    (pub_stats.latency_avg_ms >> LATENCY_AVG_SHIFT);
+	}
+
+	pub_stats.latency_max_ms = MAX(pub_stats.latency_max_ms, latency);
+}
+
+static void pub_entry_free(struct pub_entry *entry)
+{
+	sys_slist_find_and_remove(&pub_queue, &entry->node);
+	k_heap_free(&pub_heap, entry);
+	pub_stats.depth--;
+}
+
+/* Send the queued messages in order, as long as the in-flight window allows it. */
+static void pub_queue_process(void)
+{
+	struct pub_entry *entry, *next;
+	int dropped = 0;
+	int err;
+
+	k_mutex_lock(&pub_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&pub_queue, entry, next, node) {
+		if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
+			break;
+		}
+
+		if (entry->sent) {
+			continue;
+		}
+
+		if (entry->param.message.topic.qos == MQTT_QOS_1_AT_LEAST_ONCE &&
+		    pub_stats.inflight >= CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX) {
+			break;
+		}
+
+		err = mqtt_publish(&mqtt_client, &entry->param);
+		if (err) {
+			LOG_WRN("Failed to publish queued message, error: %d", err);
+
+			/* A transport error disconnects the client, and the message is sent
+			 * again after the next CONNACK. If the client is still connected,
+			 * the message itself cannot be sent and would block the queue.
+			 */
+			if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
+				break;
+			}
+
+			pub_entry_free(entry);
+			pub_stats.dropped++;
+			dropped++;
+			continue;
+		}
+
+		pub_stats.sent++;
+
+		if (entry->param.message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+			pub_latency_record(entry);
+			pub_entry_free(entry);
+		} else {
+			entry->sent = true;
+			pub_stats.inflight++;
+		}
+	}
+
+	k_mutex_unlock(&pub_lock);
+
+	for (; dropped > 0; dropped--) {
+		if (current_cfg.cb.on_error) {
+			current_cfg.cb.on_error(MQTT_HELPER_ERROR_PUBLISH_DROPPED);
+		}
+	}
+}
+
+static int pub_queue_add(const struct mqtt_publish_param *param)
+{
+	size_t topic_len = param->message.topic.topic.size;
+	size_t payload_len = param->message.payload.len;
+	struct pub_entry *entry;
+
+	if (param->message.topic.qos > MQTT_QOS_1_AT_LEAST_ONCE) {
+		LOG_ERR("QoS 2 messages cannot be queued");
+		return -ENOTSUP;
+	}
+
+	entry = k_heap_alloc(&pub_heap, sizeof(*entry) + topic_len + payload_len, K_NO_WAIT);
+	if (!entry) {
+		LOG_WRN("No room for %zu bytes in the outgoing message queue",
+			topic_len + payload_len);
+
+		k_mutex_lock(&pub_lock, K_FOREVER);
+		pub_stats.dropped++;
+		k_mutex_unlock(&pub_lock);
+
+		return -ENOMEM;
+	}
+
+	entry->param = *param;
+	entry->queued_at = k_uptime_get_32();
+	entry->sent = false;
+
+	memcpy(entry->data, param->message.topic.topic.utf8, topic_len);
+	memcpy(entry->data + topic_len, param->message.payload.data, payload_len);
+	entry->param.message.topic.topic.utf8 = entry->data;
+	entry->param.message.payload.data = entry->data + topic_len;
+
+	k_mutex_lock(&pub_lock, K_FOREVER);
+	sys_slist_append(&pub_queue, &entry->node);
+	pub_stats.queued++;
+	pub_stats.depth++;
+	pub_stats.depth_max = MAX(pub_stats.depth_max, pub_stats.depth);
+	k_mutex_unlock(&pub_lock);
+
+	pub_queue_process();
+
+	return 0;
+}
+
+static void pub_queue_ack(uint16_t message_id)
+{
+	struct pub_entry *entry;
+
+	k_mutex_lock(&pub_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&pub_queue, entry, node) {
+		if (entry->sent && entry->param.message_id == message_id) {
+			pub_latency_record(entry);
+			pub_stats.acked++;
+			pub_stats.inflight--;
+			pub_entry_free(entry);
+			break;
+		}
+	}
+
+	k_mutex_unlock(&pub_lock);
+
+	pub_queue_process();
+}
+
+/* The messages that were not acknowledged on the previous connection are sent again first. */
+static void pub_queue_resume(void)
+{
+	struct pub_entry *entry;
+
+	k_mutex_lock(&pub_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&pub_queue, entry, node) {
+		if (entry->sent) {
+			entry->sent = false;
+			entry->param.dup_flag = 1;
+			pub_stats.resent++;
+		}
+	}
+
+	pub_stats.inflight = 0;
+
+	k_mutex_unlock(&pub_lock);
+
+	pub_queue_process();
+}
+
+static void pub_queue_clear(void)
+{
+	struct pub_entry *entry, *next;
+
+	k_mutex_lock(&pub_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&pub_queue, entry, next, node) {
+		pub_entry_free(entry);
+	}
+
+	memset(&pub_stats, 0, sizeof(pub_stats));
+
+	k_mutex_unlock(&pub_lock);
+}
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 MQTT_HELPER_STATIC void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 					 const struct mqtt_evt *mqtt_evt)
 {
@@ -334,6 +540,12 @@ MQTT_HELPER_STATIC void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			current_cfg.cb.on_connack(mqtt_evt->param.connack.return_code,
 						  mqtt_evt->param.connack.session_present_flag);
 		}
+
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+		if (mqtt_evt->param.connack.return_code == MQTT_CONNECTION_ACCEPTED) {
+			pub_queue_resume();
+		}
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
 		break;
 	case MQTT_EVT_DISCONNECT:
 		LOG_DBG("MQTT_EVT_DISCONNECT: result = %d", mqtt_evt->result);
@@ -359,6 +571,10 @@ MQTT_HELPER_STATIC void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			current_cfg.cb.on_puback(mqtt_evt->param.puback.message_id,
 						 mqtt_evt->result);
 		}
+
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+		pub_queue_ack(mqtt_evt->param.puback.message_id);
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
 		break;
 	case MQTT_EVT_SUBACK:
 		LOG_DBG("MQTT_EVT_SUBACK: id = %d result = %d",
@@ -675,6 +891,16 @@ int mqtt_helper_publish(const struct mqtt_publish_param *param)
 		param->message.topic.topic.size,
 		(char *)param->message.topic.topic.utf8);
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	if (mqtt_state_verify(MQTT_STATE_UNINIT)) {
+		LOG_ERR("Library is in the wrong state (%s)",
+			state_name_get(mqtt_state_get()));
+
+		return -EOPNOTSUPP;
+	}
+
+	return pub_queue_add(param);
+#else
 	if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
 		LOG_ERR("Library is in the wrong state (%s), %s required",
 			state_name_get(mqtt_state_get()),
@@ -684,6 +910,7 @@ int mqtt_helper_publish(const struct mqtt_publish_param *param)
 	}
 
 	return mqtt_publish(&mqtt_client, param);
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
 }
 
 int mqtt_helper_deinit(void)
@@ -696,6 +923,10 @@ int mqtt_helper_deinit(void)
 		return -EOPNOTSUPP;
 	}
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	pub_queue_clear();
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 	memset(&current_cfg, 0, sizeof(current_cfg));
 	memset(&mqtt_client, 0, sizeof(mqtt_client));
 
@@ -704,6 +935,21 @@ int mqtt_helper_deinit(void)
 	return 0;
 }
 
+int mqtt_helper_queue_stats_get(struct mqtt_helper_queue_stats *stats)
+{
+	__ASSERT_NO_MSG(stats != NULL);
+
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	k_mutex_lock(&pub_lock, K_FOREVER);
+	*stats = pub_stats;
+	k_mutex_unlock(&pub_lock);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+}
+
 MQTT_HELPER_STATIC void mqtt_helper_poll_loop(void)
 {
 	int ret;
@@ -344,6 +344,13 @@ int nrf_cloud_rest_error_decode(const char *const buf, enum nrf_cloud_error *con
 int nrf_cloud_pvt_data_encode(const struct nrf_cloud_gnss_pvt *const pvt,
 			      cJSON * const pvt_data_obj);
 
+/** @brief Encode a GNSS device message without building a cJSON object.
+ * The output is the same as the printed output of @ref nrf_cloud_gnss_msg_json_encode.
+ * If successful, user is responsible for calling @ref cJSON_free on output->ptr.
+ */
+int nrf_cloud_gnss_msg_encode(const struct nrf_cloud_gnss_data * const gnss,
+			      struct nrf_cloud_data *output);
+
 /** @brief Replace legacy c2d topic with wilcard topic string.
  * Return true, if the topic was modified; otherwise false.
  */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_JSON_WRITER_H__
+#define NRF_CLOUD_JSON_WRITER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Streaming JSON writer.
+ *
+ * Serializes JSON objects directly into a buffer, without building a cJSON
+ * tree first. The output is identical to the unformatted output of cJSON for
+ * the same sequence of added items.
+ *
+ * With a NULL buffer, the writer only computes the length of the output, so
+ * that a buffer of the exact size can be allocated for a second pass.
+ */
+struct nrf_cloud_json_writer {
+	/** Output buffer, or NULL to only compute the length. */
+	char *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Length of the output, may exceed the size of the buffer. */
+	size_t len;
+	/** No member has been added to the current object yet. */
+	bool first;
+};
+
+/** @brief Initialize a writer.
+ *
+ * @param[out] w Writer.
+ * @param[in] buf Output buffer, or NULL to only compute the output length.
+ * @param[in] size Size of the output buffer.
+ */
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *w, char *buf, size_t size);
+
+/** @brief Start an object.
+ *
+ * @param[in] w Writer.
+ * @param[in] key Key of the object in the current object, or NULL for the
+ *		  root object.
+ */
+void nrf_cloud_json_obj_start(struct nrf_cloud_json_writer *w, const char *key);
+
+/** @brief End the current object. */
+void nrf_cloud_json_obj_end(struct nrf_cloud_json_writer *w);
+
+/** @brief Add a string to the current object. */
+void nrf_cloud_json_str_add(struct nrf_cloud_json_writer *w, const char *key, const char *str);
+
+/** @brief Add a number to the current object. */
+void nrf_cloud_json_num_add(struct nrf_cloud_json_writer *w, const char *key, double num);
+
+/** @brief Add an integer to the current object.
+ *
+ * Faster than @ref nrf_cloud_json_num_add, with the same output for integers
+ * of less than 15 digits, like timestamps in milliseconds.
+ */
+void nrf_cloud_json_int_add(struct nrf_cloud_json_writer *w, const char *key, int64_t num);
+
+/** @brief Terminate the output.
+ *
+ * @param[in] w Writer.
+ *
+ * @retval 0 if the output and its null terminator fit in the buffer, or if
+ *	     no buffer was given.
+ * @retval -ENOMEM if the buffer is too small.
+ */
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_JSON_WRITER_H__ */
@@ -14,6 +14,14 @@ extern "C" {
 #include <zephyr/kernel.h>
 #include <net/nrf_cloud_os.h>
 
+#if defined(CONFIG_NRF_CLOUD_MEM_STATS)
+void *nrf_cloud_mem_calloc_at(size_t count, size_t size, const char *file, uint32_t line);
+void *nrf_cloud_mem_malloc_at(size_t size, const char *file, uint32_t line);
+
+/* The statistics are kept for the call site in the library */
+#define nrf_cloud_calloc(count, size) nrf_cloud_mem_calloc_at(count, size, __FILE__, __LINE__)
+#define nrf_cloud_malloc(size) nrf_cloud_mem_malloc_at(size, __FILE__, __LINE__)
+#else
 /** @brief Allocate zero-initialized memory of size count*size for
  * internal use in the module.
  *
@@ -31,8 +39,12 @@ void *nrf_cloud_calloc(size_t count, size_t size);
  * @retval A valid pointer on SUCCESS, else, NULL.
  */
 void *nrf_cloud_malloc(size_t size);
+#endif /* CONFIG_NRF_CLOUD_MEM_STATS */
 
 /** @brief Free any allocated memory for internal use in the module.
+ *
+ * With CONFIG_NRF_CLOUD_MEM_POOL, memory that is not from the pool is freed with
+ * cJSON_free(), as the module frees some strings printed by cJSON with this function.
  *
  * @param[in] memory Memory to be freed.
  */
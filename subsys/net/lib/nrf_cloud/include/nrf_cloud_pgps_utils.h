@@ -33,6 +33,7 @@ extern "C" {
 #define NUM_BLOCKS			NUM_PREDICTIONS
 #define BLOCK_SIZE			PGPS_PREDICTION_STORAGE_SIZE
 #define NO_BLOCK			-1
+#define NO_SLOT				0xFFU
 
 struct gps_location {
 	int32_t latitude;
@@ -40,6 +41,19 @@ struct gps_location {
 	int64_t gps_sec;
 };
 
+/* Location and CRC of each stored prediction, in time order. This lets the stored
+ * predictions be cataloged at boot without reading them from flash.
+ */
+struct npgps_stored_index {
+	/* Start of the prediction set, to match the index with the saved header */
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+	uint16_t count;
+	/* Flash block of each prediction, or NO_SLOT if not stored */
+	uint8_t slot[NUM_PREDICTIONS];
+	uint32_t crc[NUM_PREDICTIONS];
+} __packed;
+
 struct nrf_cloud_pgps_header;
 
 typedef int (*npgps_buffer_handler_t)(uint8_t *buf, size_t len);
@@ -54,6 +68,9 @@ void npgps_download_unlock(void);
 int npgps_save_header(struct nrf_cloud_pgps_header *header);
 const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
 const struct gps_location *npgps_get_saved_location(void);
+int npgps_save_index(struct npgps_stored_index *stored);
+struct npgps_stored_index *npgps_get_saved_index(void);
+int npgps_clear_index(void);
 int npgps_settings_init(void);
 
 /* time functions */
@@ -71,6 +88,7 @@ void npgps_free_block(int block);
 int npgps_get_block_extent(int block);
 void npgps_reset_block_pool(void);
 void npgps_mark_block_used(int block, bool used);
+bool npgps_block_used(int block);
 void npgps_print_blocks(void);
 int npgps_num_free(void);
 int npgps_find_first_free(int from_block);
@@ -9,6 +9,7 @@
 #include "nrf_cloud_fsm.h"
 #include <net/nrf_cloud_codec.h>
 #include "nrf_cloud_log_internal.h"
+#include "nrf_cloud_json_writer.h"
 #include <net/nrf_cloud_location.h>
 #include <net/nrf_cloud_alert.h>
 #include <net/nrf_cloud_log.h>
@@ -195,6 +196,38 @@ static int json_add_str_cs(cJSON *parent, const char *str, const char *item)
 	return cJSON_AddStringToObjectCS(parent, str, item) ? 0 : -ENOMEM;
 }
 
+typedef void (*json_write_fn)(struct nrf_cloud_json_writer *w, const void *data);
+
+/* Serialize a message with the streaming writer instead of a cJSON tree.
+ * A first pass computes the length, so that the output is allocated once,
+ * with the exact size. The output is freed like cJSON printed output.
+ */
+static int json_write_alloc(json_write_fn write, const void *data,
+			    struct nrf_cloud_data *output)
+{
+	struct nrf_cloud_json_writer w;
+	char *buffer;
+	size_t size;
+
+	nrf_cloud_json_writer_init(&w, NULL, 0);
+	write(&w, data);
+	size = w.len + 1;
+
+	buffer = cJSON_malloc(size);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	nrf_cloud_json_writer_init(&w, buffer, size);
+	write(&w, data);
+	(void)nrf_cloud_json_writer_finish(&w);
+
+	output->ptr = buffer;
+	output->len = w.len;
+
+	return 0;
+}
+
 cJSON *json_create_req_obj(const char *const app_id, const char *const msg_type)
 {
 	__ASSERT_NO_MSG(app_id != NULL);
@@ -408,49 +441,30 @@ static bool compare(const char *s1, const char *s2)
 	return !strncmp(s1, s2, strlen(s2));
 }
 
+static void sensor_data_write(struct nrf_cloud_json_writer *w, const void *data)
+{
+	const struct nrf_cloud_sensor_data *sensor = data;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	if (sensor->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
+		nrf_cloud_json_int_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, sensor->ts_ms);
+	}
+	nrf_cloud_json_obj_end(w);
+}
+
 int nrf_cloud_sensor_data_encode(const struct nrf_cloud_sensor_data *sensor,
 				 struct nrf_cloud_data *output)
 {
-	int ret;
-
 	__ASSERT_NO_MSG(sensor != NULL);
 	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
 	__ASSERT_NO_MSG(sensor->data.len != 0);
 	__ASSERT_NO_MSG(output != NULL);
 	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
 
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
-
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_MSG_TYPE_KEY,
-			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
-	if (sensor->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, sensor->ts_ms);
-	}
-
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
-
-	char *buffer;
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
-
-	if (buffer == NULL) {
-		return -ENOMEM;
-	}
-
-	output->ptr = buffer;
-	output->len = strlen(buffer);
-
-	return 0;
+	return json_write_alloc(sensor_data_write, sensor, output);
 }
 
 #ifdef CONFIG_NRF_CLOUD_GATEWAY
@@ -1929,7 +1943,7 @@ int nrf_cloud_fota_job_decode(struct nrf_cloud_fota_job_info *const job_info,
 
 		if (temp) {
 			LOG_DBG("JSON array: %s", temp);
-			cJSON_FreeString(temp);
+			cJSON_free(temp);
 		}
 	}
 
@@ -3057,89 +3071,119 @@ bool nrf_cloud_disconnection_request_decode(const char *const buf)
 	return ret;
 }
 
-int nrf_cloud_gnss_msg_json_encode(const struct nrf_cloud_gnss_data * const gnss,
-				   cJSON * const gnss_msg_obj)
-{
-	if (!gnss || !gnss_msg_obj) {
-		return -EINVAL;
-	}
-
-	int ret;
+struct gnss_msg_data {
+	int64_t ts_ms;
+	/* NMEA sentence, or NULL if the message contains PVT data */
+	const char *nmea;
+	struct nrf_cloud_gnss_pvt pvt;
+};
 
-	/* Add the app ID, message type, and timestamp */
-	if (json_add_str_cs(gnss_msg_obj,
-			    NRF_CLOUD_JSON_APPID_KEY,
-			    NRF_CLOUD_JSON_APPID_VAL_GNSS) ||
-	    json_add_str_cs(gnss_msg_obj,
-			    NRF_CLOUD_JSON_MSG_TYPE_KEY,
-			    NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA) ||
-	    ((gnss->ts_ms != NRF_CLOUD_NO_TIMESTAMP) &&
-	     json_add_num_cs(gnss_msg_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, gnss->ts_ms))) {
-		ret = -ENOMEM;
-		goto cleanup;
-	}
+/* Check the GNSS data and get the contents of the message, shared by the cJSON and the
+ * streaming encoders.
+ */
+static int gnss_msg_data_get(const struct nrf_cloud_gnss_data * const gnss,
+			     struct gnss_msg_data *msg)
+{
+	*msg = (struct gnss_msg_data) {
+		.ts_ms = gnss->ts_ms,
+	};
 
-	/* Add the specified GNSS data type */
 	switch (gnss->type) {
-	case NRF_CLOUD_GNSS_TYPE_MODEM_PVT:
 	case NRF_CLOUD_GNSS_TYPE_PVT:
-	{
-		cJSON * const data_obj =
-			cJSON_AddObjectToObject(gnss_msg_obj, NRF_CLOUD_JSON_DATA_KEY);
-
-		/* Add PVT to the data object */
-		if (gnss->type == NRF_CLOUD_GNSS_TYPE_PVT) {
-			ret = nrf_cloud_pvt_data_encode(&gnss->pvt, data_obj);
-		} else {
+		msg->pvt = gnss->pvt;
+		break;
+	case NRF_CLOUD_GNSS_TYPE_MODEM_PVT:
 #if defined(CONFIG_NRF_MODEM)
-			ret = nrf_cloud_modem_pvt_data_encode(gnss->mdm_pvt, data_obj);
-#else
-			ret = -ENOSYS;
-#endif
-		}
-
-		if (ret) {
-			goto cleanup;
+		if (!gnss->mdm_pvt) {
+			return -EINVAL;
 		}
 
+		msg->pvt = (struct nrf_cloud_gnss_pvt) {
+			.lon =		gnss->mdm_pvt->longitude,
+			.lat =		gnss->mdm_pvt->latitude,
+			.accuracy =	gnss->mdm_pvt->accuracy,
+			.alt =		gnss->mdm_pvt->altitude,
+			.has_alt =	1,
+			.speed =	gnss->mdm_pvt->speed,
+			.has_speed =	1,
+			.heading =	gnss->mdm_pvt->heading,
+			.has_heading =	1
+		};
 		break;
-	}
+#else
+		return -ENOSYS;
+#endif
 	case NRF_CLOUD_GNSS_TYPE_MODEM_NMEA:
 	case NRF_CLOUD_GNSS_TYPE_NMEA:
-	{
-		const char *nmea = NULL;
-
 		if (gnss->type == NRF_CLOUD_GNSS_TYPE_MODEM_NMEA) {
 #if defined(CONFIG_NRF_MODEM)
 			if (gnss->mdm_nmea) {
-				nmea = gnss->mdm_nmea->nmea_str;
+				msg->nmea = gnss->mdm_nmea->nmea_str;
 			}
 #endif
 		} else {
-			nmea = gnss->nmea.sentence;
+			msg->nmea = gnss->nmea.sentence;
 		}
 
-		if (nmea == NULL) {
-			ret = -EINVAL;
-			goto cleanup;
+		if (msg->nmea == NULL) {
+			return -EINVAL;
 		}
 
-		if (memchr(nmea, '\0', NRF_MODEM_GNSS_NMEA_MAX_LEN) == NULL) {
-			ret = -EFBIG;
-			goto cleanup;
+		if (memchr(msg->nmea, '\0', NRF_MODEM_GNSS_NMEA_MAX_LEN) == NULL) {
+			return -EFBIG;
 		}
+		break;
+	default:
+		return -EPROTO;
+	}
+
+	return 0;
+}
+
+int nrf_cloud_gnss_msg_json_encode(const struct nrf_cloud_gnss_data * const gnss,
+				   cJSON * const gnss_msg_obj)
+{
+	if (!gnss || !gnss_msg_obj) {
+		return -EINVAL;
+	}
 
+	int ret;
+	struct gnss_msg_data msg;
+
+	ret = gnss_msg_data_get(gnss, &msg);
+	if (ret) {
+		return ret;
+	}
+
+	/* Add the app ID, message type, and timestamp */
+	if (json_add_str_cs(gnss_msg_obj,
+			    NRF_CLOUD_JSON_APPID_KEY,
+			    NRF_CLOUD_JSON_APPID_VAL_GNSS) ||
+	    json_add_str_cs(gnss_msg_obj,
+			    NRF_CLOUD_JSON_MSG_TYPE_KEY,
+			    NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA) ||
+	    ((msg.ts_ms != NRF_CLOUD_NO_TIMESTAMP) &&
+	     json_add_num_cs(gnss_msg_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg.ts_ms))) {
+		ret = -ENOMEM;
+		goto cleanup;
+	}
+
+	if (msg.nmea) {
 		/* Add the NMEA sentence to the message */
-		if (cJSON_AddStringToObject(gnss_msg_obj, NRF_CLOUD_JSON_DATA_KEY, nmea) == NULL) {
+		if (cJSON_AddStringToObject(gnss_msg_obj, NRF_CLOUD_JSON_DATA_KEY,
+					    msg.nmea) == NULL) {
 			ret = -ENOMEM;
 			goto cleanup;
 		}
+	} else {
+		/* Add PVT to the data object */
+		cJSON * const data_obj =
+			cJSON_AddObjectToObject(gnss_msg_obj, NRF_CLOUD_JSON_DATA_KEY);
 
-		break;
-	}
-	default:
-		ret = -EPROTO;
-		goto cleanup;
+		ret = data_obj ? nrf_cloud_pvt_data_encode(&msg.pvt, data_obj) : -ENOMEM;
+		if (ret) {
+			goto cleanup;
+		}
 	}
 
 	return 0;
@@ -3154,59 +3198,98 @@ cleanup:
 	return ret;
 }
 
-int nrf_cloud_alert_encode(const struct nrf_cloud_alert_info *alert, struct nrf_cloud_data *output)
+static void gnss_msg_write(struct nrf_cloud_json_writer *w, const void *data)
 {
-#if defined(CONFIG_NRF_CLOUD_ALERT)
-	int ret;
+	const struct gnss_msg_data *msg = data;
+	const struct nrf_cloud_gnss_pvt *pvt = &msg->pvt;
 
-	__ASSERT_NO_MSG(alert != NULL);
-	__ASSERT_NO_MSG(output != NULL);
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_GNSS);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	if (msg->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
+		nrf_cloud_json_int_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg->ts_ms);
+	}
 
-	cJSON *root_obj = cJSON_CreateObject();
+	if (msg->nmea) {
+		nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_DATA_KEY, msg->nmea);
+		nrf_cloud_json_obj_end(w);
+		return;
+	}
 
-	if (root_obj == NULL) {
-		return -ENOMEM;
+	nrf_cloud_json_obj_start(w, NRF_CLOUD_JSON_DATA_KEY);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_GNSS_PVT_KEY_LON, pvt->lon);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_GNSS_PVT_KEY_LAT, pvt->lat);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_GNSS_PVT_KEY_ACCURACY, pvt->accuracy);
+	if (pvt->has_alt) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_GNSS_PVT_KEY_ALTITUDE, pvt->alt);
+	}
+	if (pvt->has_speed) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_GNSS_PVT_KEY_SPEED, pvt->speed);
+	}
+	if (pvt->has_heading) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_GNSS_PVT_KEY_HEADING, pvt->heading);
 	}
+	nrf_cloud_json_obj_end(w);
+	nrf_cloud_json_obj_end(w);
+}
+
+int nrf_cloud_gnss_msg_encode(const struct nrf_cloud_gnss_data * const gnss,
+			      struct nrf_cloud_data *output)
+{
+	int ret;
+	struct gnss_msg_data msg;
+
+	if (!gnss || !output) {
+		return -EINVAL;
+	}
+
+	ret = gnss_msg_data_get(gnss, &msg);
+	if (ret) {
+		return ret;
+	}
+
+	return json_write_alloc(gnss_msg_write, &msg, output);
+}
 
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_ALERT);
-	ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_ALERT_TYPE, alert->type);
+#if defined(CONFIG_NRF_CLOUD_ALERT)
+static void alert_write(struct nrf_cloud_json_writer *w, const void *data)
+{
+	const struct nrf_cloud_alert_info *alert = data;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_ALERT);
+	nrf_cloud_json_int_add(w, NRF_CLOUD_JSON_ALERT_TYPE, alert->type);
 	if (alert->value != NRF_CLOUD_ALERT_UNUSED_VALUE) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_ALERT_VALUE, alert->value);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_VALUE, alert->value);
 	}
 	if (alert->ts_ms > NRF_CLOUD_NO_TIMESTAMP) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, alert->ts_ms);
+		nrf_cloud_json_int_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, alert->ts_ms);
 	}
 	if ((alert->ts_ms <= NRF_CLOUD_NO_TIMESTAMP) ||
 	    IS_ENABLED(CONFIG_NRF_CLOUD_ALERT_SEQ_ALWAYS)) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_ALERT_SEQUENCE, alert->sequence);
+		nrf_cloud_json_int_add(w, NRF_CLOUD_JSON_ALERT_SEQUENCE, alert->sequence);
 	}
 	if (alert->description != NULL) {
-		ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_ALERT_DESCRIPTION,
-				       alert->description);
-	}
-
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
+		nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_ALERT_DESCRIPTION, alert->description);
 	}
+	nrf_cloud_json_obj_end(w);
+}
+#endif /* CONFIG_NRF_CLOUD_ALERT */
 
-	char *buffer;
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
-
-	if (buffer == NULL) {
-		return -ENOMEM;
-	}
+int nrf_cloud_alert_encode(const struct nrf_cloud_alert_info *alert, struct nrf_cloud_data *output)
+{
+#if defined(CONFIG_NRF_CLOUD_ALERT)
+	__ASSERT_NO_MSG(alert != NULL);
+	__ASSERT_NO_MSG(output != NULL);
 
-	output->ptr = buffer;
-	output->len = strlen(buffer);
+	return json_write_alloc(alert_write, alert, output);
 #else
 	ARG_UNUSED(alert);
 	output->ptr = NULL;
 	output->len = 0;
-#endif /* CONFIG_NRF_CLOUD_ALERT */
+
 	return 0;
+#endif /* CONFIG_NRF_CLOUD_ALERT */
 }
 
 static int agnss_types_array_json_encode(cJSON * const obj,
@@ -3743,50 +3826,44 @@ int nrf_cloud_ground_fix_url_encode(char *buf, size_t size, const char *base,
 	return 0;
 }
 
-static int encode_json_log(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
-			   struct nrf_cloud_data *output)
-{
-	int ret;
-	cJSON *root_obj = cJSON_CreateObject();
+struct log_msg_data {
+	const struct nrf_cloud_log_context *ctx;
+	const char *msg;
+};
 
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
+static void log_write(struct nrf_cloud_json_writer *w, const void *data)
+{
+	const struct log_msg_data *log = data;
+	const struct nrf_cloud_log_context *ctx = log->ctx;
 
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_LOG);
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_LOG);
 	if (ctx != NULL) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_DOMAIN, ctx->dom_id);
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_LEVEL, ctx->level);
+		nrf_cloud_json_int_add(w, NRF_CLOUD_JSON_LOG_KEY_DOMAIN, ctx->dom_id);
+		nrf_cloud_json_int_add(w, NRF_CLOUD_JSON_LOG_KEY_LEVEL, ctx->level);
 		if (ctx->src_name != NULL) {
-			ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_SOURCE,
-					       ctx->src_name);
+			nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_LOG_KEY_SOURCE, ctx->src_name);
 		}
 		if (ctx->ts > 0) {
-			ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, ctx->ts);
+			nrf_cloud_json_int_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, ctx->ts);
 		}
 		if (!ctx->ts || IS_ENABLED(CONFIG_NRF_CLOUD_LOG_SEQ_ALWAYS)) {
-			ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_SEQUENCE,
-					       ctx->sequence);
+			nrf_cloud_json_int_add(w, NRF_CLOUD_JSON_LOG_KEY_SEQUENCE, ctx->sequence);
 		}
 	}
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_LOG_KEY_MESSAGE, log->msg);
+	nrf_cloud_json_obj_end(w);
+}
 
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_MESSAGE, (const char *)buf);
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
-
-	char *buffer = cJSON_PrintUnformatted(root_obj);
-
-	cJSON_Delete(root_obj);
-
-	if (buffer == NULL) {
-		return -ENOMEM;
-	}
+static int encode_json_log(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
+			   struct nrf_cloud_data *output)
+{
+	const struct log_msg_data log = {
+		.ctx = ctx,
+		.msg = (const char *)buf,
+	};
 
-	output->ptr = buffer;
-	output->len = strlen(buffer);
-	return 0;
+	return json_write_alloc(log_write, &log, output);
 }
 
 int nrf_cloud_log_json_encode(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
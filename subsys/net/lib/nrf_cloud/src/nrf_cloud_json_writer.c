@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nrf_cloud_json_writer.h"
+
+static void put(struct nrf_cloud_json_writer *w, const char *s, size_t n)
+{
+	if (w->buf && w->len + n <= w->size) {
+		memcpy(w->buf + w->len, s, n);
+	}
+
+	w->len += n;
+}
+
+static void put_c(struct nrf_cloud_json_writer *w, char c)
+{
+	if (w->buf && w->len < w->size) {
+		w->buf[w->len] = c;
+	}
+
+	w->len++;
+}
+
+/* Same escaping as cJSON: quotes, backslashes and control characters. */
+static void put_str(struct nrf_cloud_json_writer *w, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+	const char *run = str;
+	char esc[6] = { '\\', 'u', '0', '0' };
+
+	put_c(w, '"');
+
+	for (; *str; str++) {
+		unsigned char c = *str;
+
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+
+		put(w, run, str - run);
+		run = str + 1;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			esc[1] = c;
+			break;
+		case '\b':
+			esc[1] = 'b';
+			break;
+		case '\f':
+			esc[1] = 'f';
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			esc[1] = 'u';
+			esc[4] = hex[c >> 4];
+			esc[5] = hex[c & 0xf];
+			put(w, esc, 6);
+			continue;
+		}
+
+		put(w, esc, 2);
+	}
+
+	put(w, run, str - run);
+	put_c(w, '"');
+}
+
+static void put_key(struct nrf_cloud_json_writer *w, const char *key)
+{
+	if (!w->first) {
+		put_c(w, ',');
+	}
+
+	w->first = false;
+
+	if (key) {
+		put_str(w, key);
+		put_c(w, ':');
+	}
+}
+
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *w, char *buf, size_t size)
+{
+	w->buf = buf;
+	w->size = buf ? size : 0;
+	w->len = 0;
+	w->first = true;
+}
+
+void nrf_cloud_json_obj_start(struct nrf_cloud_json_writer *w, const char *key)
+{
+	put_key(w, key);
+	put_c(w, '{');
+	w->first = true;
+}
+
+void nrf_cloud_json_obj_end(struct nrf_cloud_json_writer *w)
+{
+	put_c(w, '}');
+	w->first = false;
+}
+
+void nrf_cloud_json_str_add(struct nrf_cloud_json_writer *w, const char *key, const char *str)
+{
+	put_key(w, key);
+	put_str(w, str);
+}
+
+/* Same number format as cJSON, so that the output does not change. */
+void nrf_cloud_json_num_add(struct nrf_cloud_json_writer *w, const char *key, double num)
+{
+	char tmp[26];
+	double test;
+	int len;
+	int as_int;
+
+	put_key(w, key);
+
+	if (isnan(num) || isinf(num)) {
+		put(w, "null", 4);
+		return;
+	}
+
+	as_int = (num >= INT_MAX) ? INT_MAX : (num <= (double)INT_MIN) ? INT_MIN : (int)num;
+
+	if (num == (double)as_int) {
+		len = snprintf(tmp, sizeof(tmp), "%d", as_int);
+	} else {
+		len = snprintf(tmp, sizeof(tmp), "%1.15g", num);
+
+		/* Use more digits if the value does not survive the round-trip */
+		test = strtod(tmp, NULL);
+		if (fabs(test - num) > fmax(fabs(test), fabs(num)) * DBL_EPSILON) {
+			len = snprintf(tmp, sizeof(tmp), "%1.17g", num);
+		}
+	}
+
+	put(w, tmp, len);
+}
+
+void nrf_cloud_json_int_add(struct nrf_cloud_json_writer *w, const char *key, int64_t num)
+{
+	char tmp[21];
+	char *p = tmp + sizeof(tmp);
+	uint64_t u = (num < 0) ? -(uint64_t)num : (uint64_t)num;
+
+	put_key(w, key);
+
+	do {
+		*--p = '0' + (u % 10);
+		u /= 10;
+	} while (u);
+
+	if (num < 0) {
+		*--p = '-';
+	}
+
+	put(w, p, tmp + sizeof(tmp) - p);
+}
+
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *w)
+{
+	if (!w->buf) {
+		return 0;
+	}
+
+	if (w->len >= w->size) {
+		if (w->size) {
+			w->buf[w->size - 1] = '\0';
+		}
+
+		return -ENOMEM;
+	}
+
+	w->buf[w->len] = '\0';
+
+	return 0;
+}
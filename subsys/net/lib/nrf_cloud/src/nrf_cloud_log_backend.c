@@ -26,6 +26,7 @@
 LOG_MODULE_DECLARE(nrf_cloud_log, CONFIG_NRF_CLOUD_LOG_LOG_LEVEL);
 
 #define RING_BUF_SIZE CONFIG_NRF_CLOUD_LOG_RING_BUF_SIZE
+#define SEND_INTERVAL_SEC CONFIG_NRF_CLOUD_LOG_SEND_INTERVAL
 
 #define LOG_OUTPUT_RETRIES 5
 #define LOG_OUTPUT_RETRY_DELAY_MS 50
@@ -75,6 +76,7 @@ static uint8_t log_buf[CONFIG_NRF_CLOUD_LOG_BUF_SIZE + 1];
 static uint32_t log_format_current = CONFIG_LOG_BACKEND_NRF_CLOUD_OUTPUT_DEFAULT;
 static uint32_t log_output_flags = LOG_OUTPUT_FLAG_CRLF_NONE;
 static int num_msgs;
+static bool panic_mode;
 static struct nrf_cloud_rest_context *rest_ctx;
 static char device_id[NRF_CLOUD_CLIENT_ID_MAX_LEN];
 
@@ -125,6 +127,20 @@ RING_BUF_DECLARE(log_nrf_cloud_rb, RING_BUF_SIZE);
 
 static int send_ring_buffer(void);
 
+#if SEND_INTERVAL_SEC
+/* Interval uploads are made from a dedicated work queue, so that sending, which may
+ * block and retry, neither holds up the system workqueue nor the logging thread.
+ * The logging thread only waits while the buffered messages are copied out.
+ */
+static K_THREAD_STACK_DEFINE(send_stack, CONFIG_NRF_CLOUD_LOG_SEND_STACK_SIZE);
+static struct k_work_q send_workq;
+static uint8_t send_buf[RING_BUF_SIZE + 1];
+
+static void send_work_fn(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(send_work, send_work_fn);
+#endif
+
 static void logger_init(const struct log_backend *const backend)
 {
 	static bool initialized;
@@ -144,6 +160,15 @@ static void logger_init(const struct log_backend *const backend)
 
 	nrf_cloud_log_init();
 
+#if SEND_INTERVAL_SEC
+	const struct k_work_queue_config cfg = {
+		.name = "nrf_cloud_log",
+	};
+
+	k_work_queue_start(&send_workq, send_stack, K_THREAD_STACK_SIZEOF(send_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+#endif
+
 	LOG_DBG("Filtering lower level log sources");
 	for (i = 0; i < ARRAY_SIZE(filtered_modules); i++) {
 		sid = log_source_id_get(filtered_modules[i]);
@@ -272,6 +297,7 @@ static void logger_dropped(const struct log_backend *const backend, uint32_t cnt
 static void logger_panic(const struct log_backend *const backend)
 {
 	if (backend == &log_nrf_cloud_backend) {
+		panic_mode = true;
 		log_output_flush(&log_nrf_cloud_output);
 	}
 }
@@ -328,6 +354,14 @@ static void logger_notify(const struct log_backend *const backend, enum log_back
 		return;
 	}
 
+#if SEND_INTERVAL_SEC
+	/* Send everything buffered during the interval in a single upload.
+	 * Scheduling does nothing if an upload is already pending.
+	 */
+	if (num_msgs) {
+		k_work_schedule_for_queue(&send_workq, &send_work, K_SECONDS(SEND_INTERVAL_SEC));
+	}
+#else
 	/* Flush our transmission buffer */
 	send_ring_buffer();
 	if (CONFIG_NRF_CLOUD_LOG_LOG_LEVEL >= LOG_LEVEL_DBG) {
@@ -340,45 +374,20 @@ static void logger_notify(const struct log_backend *const backend, enum log_back
 	} else {
 		LOG_INF("Sent lines:%u, bytes:%u", stats.lines_sent, stats.bytes_sent);
 	}
+#endif
 }
 
-static int send_ring_buffer(void)
+/* Send buffered log messages. Text data must be NUL-terminated. */
+static int send_data(const uint8_t *data, size_t len, int msgs)
 {
-	int err = 0;
-	int ret = 0;
+	int err;
 	struct nrf_cloud_tx_data output = {
+		.data.ptr = data,
+		.data.len = len,
 		.qos = MQTT_QOS_0_AT_MOST_ONCE,
 		.topic_type = (log_format_current == LOG_OUTPUT_TEXT) ?
 			       NRF_CLOUD_TOPIC_BULK : NRF_CLOUD_TOPIC_BIN
 	};
-	uint32_t stored;
-	uint8_t *base64_buf = NULL;
-
-	/* The bulk topic requires the multiple JSON messages to be placed in
-	 * a JSON array. Close the array then send it.
-	 */
-	if ((num_msgs != 0) && (log_format_current == LOG_OUTPUT_TEXT)) {
-		ring_buf_put(&log_nrf_cloud_rb, "]", 1);
-	}
-
-	stored = ring_buf_size_get(&log_nrf_cloud_rb);
-	output.data.len = ring_buf_get_claim(&log_nrf_cloud_rb,
-					     (uint8_t **)&output.data.ptr,
-					     stored);
-	if (output.data.len != stored) {
-		LOG_WRN("Capacity:%u, free:%u, stored:%u, claimed:%u",
-			ring_buf_capacity_get(&log_nrf_cloud_rb),
-			ring_buf_space_get(&log_nrf_cloud_rb),
-			stored, output.data.len);
-		stored = output.data.len;
-	}
-	if (!output.data.len) {
-		goto cleanup;
-	}
-
-	uint8_t *p = (uint8_t *)output.data.ptr;
-
-	p[output.data.len] = '\0';
 
 	LOG_DBG("Ready to transmit %zd bytes...", output.data.len);
 	if (IS_ENABLED(CONFIG_NRF_CLOUD_MQTT)) {
@@ -390,7 +399,7 @@ static int send_ring_buffer(void)
 								 output.data.ptr, true, NULL);
 			if (err) {
 				LOG_ERR("Error sending message:%d", err);
-				if (p[0] == '\0') {
+				if (data[0] == '\0') {
 					LOG_ERR("Empty buffer!");
 				}
 				if (err != -EBUSY) {
@@ -406,10 +415,85 @@ static int send_ring_buffer(void)
 		err = -ENODEV;
 	}
 	if (!err) {
-		stats.lines_sent += num_msgs;
+		stats.lines_sent += msgs;
 		stats.bytes_sent += output.data.len;
 	}
 
+	return err;
+}
+
+#if SEND_INTERVAL_SEC
+static void send_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	size_t len;
+	int msgs;
+
+	/* If not connected, the messages stay buffered until the next interval */
+	if (logger_is_ready(&log_nrf_cloud_backend) != 0) {
+		return;
+	}
+
+	/* Take the buffered messages, so that new ones can be stored during the upload */
+	(void)k_sem_take(&ncl_active, K_FOREVER);
+	if ((num_msgs != 0) && (log_format_current == LOG_OUTPUT_TEXT)) {
+		/* Close the JSON array of the bulk topic */
+		ring_buf_put(&log_nrf_cloud_rb, "]", 1);
+	}
+	len = ring_buf_get(&log_nrf_cloud_rb, send_buf, sizeof(send_buf) - 1);
+	msgs = num_msgs;
+	ring_buf_reset(&log_nrf_cloud_rb);
+	num_msgs = 0;
+	k_sem_give(&ncl_active);
+
+	if (!len) {
+		return;
+	}
+
+	send_buf[len] = '\0';
+	if (send_data(send_buf, len, msgs)) {
+		LOG_ERR("Error sending %d buffered log messages", msgs);
+		return;
+	}
+
+	LOG_INF("Sent lines:%u, bytes:%u", stats.lines_sent, stats.bytes_sent);
+}
+#endif
+
+static int send_ring_buffer(void)
+{
+	int err = 0;
+	int ret = 0;
+	struct nrf_cloud_data output;
+	uint32_t stored;
+	uint8_t *base64_buf = NULL;
+
+	/* The bulk topic requires the multiple JSON messages to be placed in
+	 * a JSON array. Close the array then send it.
+	 */
+	if ((num_msgs != 0) && (log_format_current == LOG_OUTPUT_TEXT)) {
+		ring_buf_put(&log_nrf_cloud_rb, "]", 1);
+	}
+
+	stored = ring_buf_size_get(&log_nrf_cloud_rb);
+	output.len = ring_buf_get_claim(&log_nrf_cloud_rb, (uint8_t **)&output.ptr, stored);
+	if (output.len != stored) {
+		LOG_WRN("Capacity:%u, free:%u, stored:%u, claimed:%u",
+			ring_buf_capacity_get(&log_nrf_cloud_rb),
+			ring_buf_space_get(&log_nrf_cloud_rb),
+			stored, output.len);
+		stored = output.len;
+	}
+	if (!output.len) {
+		goto cleanup;
+	}
+
+	uint8_t *p = (uint8_t *)output.ptr;
+
+	p[output.len] = '\0';
+
+	err = send_data(output.ptr, output.len, num_msgs);
+
 cleanup:
 	if (err) {
 		LOG_ERR("Error %d ret %d processing ring buffer", err, ret);
@@ -442,7 +526,11 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 		return 0;
 	}
 
-	if (k_sem_take(&ncl_active, K_NO_WAIT) < 0) {
+	/* With interval uploads, the sender may be copying out the ring buffer;
+	 * wait for it, unless in panic mode. The upload itself is not waited for.
+	 */
+	if (k_sem_take(&ncl_active, (SEND_INTERVAL_SEC && !panic_mode && !k_is_in_isr()) ?
+				    K_FOREVER : K_NO_WAIT) < 0) {
 		printk("logger_out: BUSY\n");
 		return 0;
 	}
@@ -457,7 +545,7 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 			printk("buf %p..%p is not inside our log_buf %p..%p\n",
 				buf, &buf[size], log_buf,
 				&log_buf[CONFIG_NRF_CLOUD_LOG_BUF_SIZE]);
-			return orig_size;
+			goto end;
 		}
 
 		extra = 3;
@@ -527,6 +615,20 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 			break;
 		}
 
+#if SEND_INTERVAL_SEC
+		if (!panic_mode) {
+			/* Low on space; upload now rather than at the end of the interval,
+			 * and drop this message instead of waiting for the upload.
+			 */
+			k_work_reschedule_for_queue(&send_workq, &send_work, K_NO_WAIT);
+			stats.lines_dropped++;
+			if (log_format_current == LOG_OUTPUT_TEXT) {
+				cJSON_free((void *)data.ptr);
+			}
+			break;
+		}
+#endif
+
 		/* Low on space, so send everything. */
 		if (logger_is_ready(&log_nrf_cloud_backend) == 0) {
 			err = send_ring_buffer();
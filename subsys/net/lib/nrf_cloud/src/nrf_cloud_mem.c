@@ -4,18 +4,166 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <net/nrf_cloud.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/math_extras.h>
 #include <zephyr/logging/log.h>
+#include <cJSON.h>
 
 #include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_mem.h"
+
+#if defined(CONFIG_NRF_CLOUD_MEM_POOL)
+/* sys_heap internals, to find the largest free chunk without allocating */
+#include <heap.h>
+#endif
 
 LOG_MODULE_REGISTER(nrf_cloud_mem, CONFIG_NRF_CLOUD_LOG_LEVEL);
 
+#if defined(CONFIG_NRF_CLOUD_MEM_POOL)
+K_HEAP_DEFINE(nrf_cloud_pool, CONFIG_NRF_CLOUD_MEM_POOL_SIZE);
+
+static bool pool_owns(const void *ptr)
+{
+	return (const uint8_t *)ptr >= (const uint8_t *)nrf_cloud_pool.heap.init_mem &&
+	       (const uint8_t *)ptr < (const uint8_t *)nrf_cloud_pool.heap.init_mem +
+				      nrf_cloud_pool.heap.init_bytes;
+}
+
+static void *pool_malloc(size_t size)
+{
+	return k_heap_alloc(&nrf_cloud_pool, size, K_NO_WAIT);
+}
+
+static void *pool_calloc(size_t count, size_t size)
+{
+	size_t total;
+	void *ptr;
+
+	if (size_mul_overflow(count, size, &total)) {
+		return NULL;
+	}
+
+	ptr = pool_malloc(total);
+	if (ptr) {
+		memset(ptr, 0, total);
+	}
+
+	return ptr;
+}
+
+static void pool_free(void *ptr)
+{
+	k_heap_free(&nrf_cloud_pool, ptr);
+}
+
+static struct nrf_cloud_os_mem_hooks used_hooks = { .malloc_fn = pool_malloc,
+						    .calloc_fn = pool_calloc,
+						    .free_fn = pool_free };
+#else
 static struct nrf_cloud_os_mem_hooks used_hooks = { .malloc_fn = k_malloc,
 						    .calloc_fn = k_calloc,
 						    .free_fn = k_free };
+#endif /* CONFIG_NRF_CLOUD_MEM_POOL */
+
+#if defined(CONFIG_NRF_CLOUD_MEM_STATS)
+/* Prepended to each allocation, so that it can be accounted for when freed */
+struct mem_hdr {
+	uint32_t size;
+	uint32_t site;
+};
+
+static struct k_spinlock stats_lock;
+static struct nrf_cloud_mem_stats stats;
+/* The extra entry collects the call sites that do not fit in the table. */
+static struct nrf_cloud_mem_site_stats sites[CONFIG_NRF_CLOUD_MEM_STATS_SITES + 1];
+static size_t site_count;
+
+static struct nrf_cloud_mem_site_stats *site_get(const char *file, uint32_t line)
+{
+	for (size_t i = 0; i < site_count; i++) {
+		if (sites[i].line == line && strcmp(sites[i].file, file) == 0) {
+			return &sites[i];
+		}
+	}
+
+	if (site_count < CONFIG_NRF_CLOUD_MEM_STATS_SITES) {
+		sites[site_count].file = file;
+		sites[site_count].line = line;
+		return &sites[site_count++];
+	}
+
+	return &sites[CONFIG_NRF_CLOUD_MEM_STATS_SITES];
+}
+
+static void *tracked_alloc(size_t count, size_t size, bool zero, const char *file, uint32_t line)
+{
+	struct nrf_cloud_mem_site_stats *site;
+	struct mem_hdr *hdr = NULL;
+	k_spinlock_key_t key;
+	size_t total;
+
+	if (!size_mul_overflow(count, size, &total) &&
+	    total <= UINT32_MAX - sizeof(struct mem_hdr)) {
+		hdr = used_hooks.malloc_fn(sizeof(struct mem_hdr) + total);
+	}
+
+	key = k_spin_lock(&stats_lock);
+
+	site = site_get(file, line);
+
+	if (!hdr) {
+		site->failures++;
+		stats.failures++;
+		k_spin_unlock(&stats_lock, key);
+
+		return NULL;
+	}
+
+	hdr->size = total;
+	hdr->site = site - sites;
+
+	site->allocs++;
+	site->used += total;
+	site->peak = MAX(site->peak, site->used);
+
+	stats.allocs++;
+	stats.used += total;
+	stats.peak = MAX(stats.peak, stats.used);
+
+	k_spin_unlock(&stats_lock, key);
+
+	if (zero) {
+		memset(hdr + 1, 0, total);
+	}
+
+	return hdr + 1;
+}
+
+void *nrf_cloud_mem_calloc_at(size_t count, size_t size, const char *file, uint32_t line)
+{
+	return tracked_alloc(count, size, true, file, line);
+}
 
+void *nrf_cloud_mem_malloc_at(size_t size, const char *file, uint32_t line)
+{
+	return tracked_alloc(1, size, false, file, line);
+}
+
+static void tracked_free(void *ptr)
+{
+	struct mem_hdr *hdr = (struct mem_hdr *)ptr - 1;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&stats_lock);
+	sites[hdr->site].used -= hdr->size;
+	stats.used -= hdr->size;
+	k_spin_unlock(&stats_lock, key);
+
+	used_hooks.free_fn(hdr);
+}
+#else
 void *nrf_cloud_calloc(size_t count, size_t size)
 {
 	return used_hooks.calloc_fn(count, size);
@@ -25,12 +173,29 @@ void *nrf_cloud_malloc(size_t size)
 {
 	return used_hooks.malloc_fn(size);
 }
+#endif /* CONFIG_NRF_CLOUD_MEM_STATS */
 
 void nrf_cloud_free(void *ptr)
 {
-	if (ptr) {
-		used_hooks.free_fn(ptr);
+	if (!ptr) {
+		return;
+	}
+
+#if defined(CONFIG_NRF_CLOUD_MEM_POOL)
+	/* Some strings printed by cJSON are freed with this function. cJSON does not
+	 * allocate from the pool, so memory outside of it belongs to cJSON.
+	 */
+	if (!pool_owns(ptr)) {
+		cJSON_free(ptr);
+		return;
 	}
+#endif /* CONFIG_NRF_CLOUD_MEM_POOL */
+
+#if defined(CONFIG_NRF_CLOUD_MEM_STATS)
+	tracked_free(ptr);
+#else
+	used_hooks.free_fn(ptr);
+#endif /* CONFIG_NRF_CLOUD_MEM_STATS */
 }
 
 void nrf_cloud_os_mem_hooks_init(struct nrf_cloud_os_mem_hooks *hooks)
@@ -39,10 +204,113 @@ void nrf_cloud_os_mem_hooks_init(struct nrf_cloud_os_mem_hooks *hooks)
 
 	LOG_DBG("Overriding OS mem hooks");
 
-	used_hooks.malloc_fn = hooks->malloc_fn;
-	used_hooks.calloc_fn = hooks->calloc_fn;
-	used_hooks.free_fn = hooks->free_fn;
+	/* With the dedicated pool, the hooks only apply to cJSON */
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_MEM_POOL)) {
+		used_hooks.malloc_fn = hooks->malloc_fn;
+		used_hooks.calloc_fn = hooks->calloc_fn;
+		used_hooks.free_fn = hooks->free_fn;
+	}
 
 	/* Codec hooks need to be the same */
 	(void)nrf_cloud_codec_init(hooks);
 }
+
+#if defined(CONFIG_NRF_CLOUD_MEM_POOL)
+/* Walk the free list of the highest non-empty bucket, which holds the largest free
+ * chunks. The heap lock keeps the lists stable, and nothing is allocated.
+ */
+static size_t pool_largest_free(void)
+{
+	struct z_heap *h = nrf_cloud_pool.heap.heap;
+	chunksz_t largest = 0;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&nrf_cloud_pool.lock);
+
+	if (h->avail_buckets) {
+		int bucket = 31 - __builtin_clz(h->avail_buckets);
+		chunkid_t first = h->buckets[bucket].next;
+		chunkid_t c = first;
+
+		do {
+			largest = MAX(largest, chunk_size(h, c));
+			c = next_free_chunk(h, c);
+		} while (c != first);
+	}
+
+	k_spin_unlock(&nrf_cloud_pool.lock, key);
+
+	return largest ? chunksz_to_bytes(h, largest) : 0;
+}
+
+static int pool_stats_get(struct nrf_cloud_mem_stats *out)
+{
+	struct sys_memory_stats heap_stats;
+	int err;
+
+	err = sys_heap_runtime_stats_get(&nrf_cloud_pool.heap, &heap_stats);
+	if (err) {
+		return err;
+	}
+
+	out->used = heap_stats.allocated_bytes;
+	out->peak = heap_stats.max_allocated_bytes;
+	out->free = heap_stats.free_bytes;
+	out->largest_free = pool_largest_free();
+
+	return 0;
+}
+#else
+static int pool_stats_get(struct nrf_cloud_mem_stats *out)
+{
+	return 0;
+}
+#endif /* CONFIG_NRF_CLOUD_MEM_POOL */
+
+int nrf_cloud_mem_stats_get(struct nrf_cloud_mem_stats *out)
+{
+	__ASSERT_NO_MSG(out != NULL);
+
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_MEM_POOL)) {
+		return -ENOTSUP;
+	}
+
+	memset(out, 0, sizeof(*out));
+
+#if defined(CONFIG_NRF_CLOUD_MEM_STATS)
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*out = stats;
+	k_spin_unlock(&stats_lock, key);
+#endif /* CONFIG_NRF_CLOUD_MEM_STATS */
+
+	/* The pool usage includes the heap overhead, so it replaces the counted bytes */
+	return pool_stats_get(out);
+}
+
+int nrf_cloud_mem_site_stats_get(size_t index, struct nrf_cloud_mem_site_stats *out)
+{
+	__ASSERT_NO_MSG(out != NULL);
+
+#if defined(CONFIG_NRF_CLOUD_MEM_STATS)
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	int err = -ENOENT;
+
+	if (index < site_count) {
+		*out = sites[index];
+		err = 0;
+	} else if (index == CONFIG_NRF_CLOUD_MEM_STATS_SITES &&
+		   site_count == CONFIG_NRF_CLOUD_MEM_STATS_SITES) {
+		*out = sites[index];
+		err = 0;
+	}
+
+	k_spin_unlock(&stats_lock, key);
+
+	return err;
+#else
+	ARG_UNUSED(index);
+
+	return -ENOTSUP;
+#endif /* CONFIG_NRF_CLOUD_MEM_STATS */
+}
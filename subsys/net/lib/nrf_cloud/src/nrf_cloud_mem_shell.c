@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/shell/shell.h>
+#include <net/nrf_cloud_os.h>
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct nrf_cloud_mem_stats stats;
+	int err;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	err = nrf_cloud_mem_stats_get(&stats);
+	if (err) {
+		shell_error(sh, "Failed to get memory statistics, error: %d", err);
+		return -ENOEXEC;
+	}
+
+	shell_print(sh, "Used: %zu bytes, peak: %zu bytes", stats.used, stats.peak);
+
+	shell_print(sh, "Pool: %d bytes, free: %zu bytes, largest free block: %zu bytes",
+		    CONFIG_NRF_CLOUD_MEM_POOL_SIZE, stats.free, stats.largest_free);
+
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_MEM_STATS)) {
+		shell_print(sh, "Allocations: %u, failed: %u", stats.allocs, stats.failures);
+	}
+
+	return 0;
+}
+
+static int cmd_sites(const struct shell *sh, size_t argc, char **argv)
+{
+	struct nrf_cloud_mem_site_stats site;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_MEM_STATS)) {
+		shell_error(sh, "CONFIG_NRF_CLOUD_MEM_STATS is not enabled");
+		return -ENOEXEC;
+	}
+
+	shell_print(sh, "%8s %6s %8s %8s  %s", "Allocs", "Failed", "Used", "Peak", "Call site");
+
+	for (size_t i = 0; nrf_cloud_mem_site_stats_get(i, &site) == 0; i++) {
+		if (site.file) {
+			shell_print(sh, "%8u %6u %8zu %8zu  %s:%u", site.allocs, site.failures,
+				    site.used, site.peak, site.file, site.line);
+		} else {
+			shell_print(sh, "%8u %6u %8zu %8zu  %s", site.allocs, site.failures,
+				    site.used, site.peak, "other");
+		}
+	}
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_nrf_cloud_mem,
+	SHELL_CMD(stats, NULL, "Print the memory usage of the nRF Cloud library", cmd_stats),
+	SHELL_CMD(sites, NULL, "Print the memory usage of each allocation call site", cmd_sites),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(nrf_cloud_mem, &sub_nrf_cloud_mem, "nRF Cloud memory usage", NULL);
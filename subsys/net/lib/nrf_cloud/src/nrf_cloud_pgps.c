@@ -9,6 +9,7 @@
 #include <zephyr/device.h>
 #include <zephyr/storage/stream_flash.h>
 #include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
 
 #include <cJSON.h>
 #include <modem/modem_info.h>
@@ -88,6 +89,14 @@ struct pgps_index {
 	 * a pointer.
 	 */
 	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+
+	/* CRC of each prediction, as stored in flash */
+	uint32_t crc[NUM_PREDICTIONS];
+
+	/* Whether the stored data of each prediction has been checked against
+	 * its CRC since it was cataloged, so that it is only read once
+	 */
+	bool crc_checked[NUM_PREDICTIONS];
 };
 
 static struct pgps_index index;
@@ -201,6 +210,11 @@ static struct nrf_cloud_pgps_prediction *get_prediction_slot(int slot, off_t *fl
 	return get_cached_prediction(off);
 }
 
+static uint32_t prediction_crc(const struct nrf_cloud_pgps_prediction *p)
+{
+	return crc32_ieee((const uint8_t *)p, sizeof(*p));
+}
+
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
 				    struct nrf_cloud_pgps_prediction *p)
 {
@@ -392,6 +406,8 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 			break;
 		}
 
+		index.crc[pnum] = prediction_crc(pred);
+		index.crc_checked[pnum] = true;
 		i = get_prediction_block(pnum);
 		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", pred);
@@ -416,6 +432,72 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	return pnum;
 }
 
+/* Catalog the stored predictions using the index saved with them, instead of
+ * reading and validating each of them. Their CRC is checked when they are used.
+ */
+static int load_stored_index(void)
+{
+	const struct npgps_stored_index *stored = npgps_get_saved_index();
+	uint16_t count = index.header.prediction_count;
+	int last = -1;
+	int pnum;
+
+	if ((stored->count != count) ||
+	    (stored->gps_day != index.header.gps_day) ||
+	    (stored->gps_time_of_day != index.header.gps_time_of_day)) {
+		LOG_DBG("No stored index for the saved predictions");
+		return -ENODATA;
+	}
+
+	discard_prediction_buffer();
+	memset(index.predictions, 0, sizeof(index.predictions));
+	npgps_reset_block_pool();
+
+	for (pnum = 0; pnum < count; pnum++) {
+		int block = stored->slot[pnum];
+
+		if ((block >= NUM_BLOCKS) || npgps_block_used(block)) {
+			break;
+		}
+
+		index.predictions[pnum] = npgps_block_to_pointer(block);
+		index.crc[pnum] = stored->crc[pnum];
+		index.crc_checked[pnum] = false;
+		npgps_mark_block_used(block, true);
+		last = block;
+	}
+
+	if (last != -1) {
+		(void)npgps_find_first_free(last);
+	}
+
+	LOG_INF("Loaded index of %d stored predictions", pnum);
+	npgps_print_blocks();
+	return pnum;
+}
+
+static void save_stored_index(void)
+{
+	struct npgps_stored_index *stored = npgps_get_saved_index();
+	int block;
+	int err;
+
+	stored->gps_day = index.header.gps_day;
+	stored->gps_time_of_day = index.header.gps_time_of_day;
+	stored->count = index.header.prediction_count;
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		block = index.predictions[pnum] ? get_prediction_block(pnum) : NO_BLOCK;
+		stored->slot[pnum] = (block == NO_BLOCK) ? NO_SLOT : block;
+		stored->crc[pnum] = index.crc[pnum];
+	}
+
+	err = npgps_save_index(stored);
+	if (err) {
+		LOG_ERR("Error saving P-GPS index:%d", err);
+	}
+}
+
 static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_day,
 				    uint32_t *gps_time_of_day)
 {
@@ -456,6 +538,8 @@ static void discard_oldest_predictions(int num)
 	for (i = last; i < index.header.prediction_count; i++) {
 		pnum = i - last;
 		index.predictions[pnum] = index.predictions[i];
+		index.crc[pnum] = index.crc[i];
+		index.crc_checked[pnum] = index.crc_checked[i];
 	}
 
 	/* set prediction pointers for 'last' in the newly empty
@@ -695,6 +779,18 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	LOG_DBG("Selected prediction num:%d", pnum);
 	index.cur_pnum = pnum;
 	*prediction = get_prediction(pnum);
+	if (*prediction && !index.crc_checked[pnum]) {
+		if (prediction_crc(*prediction) != index.crc[pnum]) {
+			LOG_ERR("Prediction num:%u is corrupted", pnum);
+			*prediction = NULL;
+			(void)npgps_clear_index();
+			index.cur_pnum = 0xff;
+			state = PGPS_EXPIRED;
+			loading_in_progress = false; /* make sure we request it */
+			return -ENODATA;
+		}
+		index.crc_checked[pnum] = true;
+	}
 	if (*prediction) {
 		err = validate_prediction(*prediction,
 					  cur_gps_day, cur_gps_time_of_day,
@@ -1230,7 +1326,8 @@ static int open_storage(uint32_t offset, bool preserve)
 	return 0;
 }
 
-static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last)
+static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last,
+			    uint32_t *crc)
 {
 	static bool first = true;
 	static uint8_t pad[PGPS_PREDICTION_PAD];
@@ -1243,6 +1340,12 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 		first = false;
 	}
 
+	/* CRC of the prediction as laid out in flash */
+	*crc = crc32_ieee_update(0, p, schema_offset);
+	*crc = crc32_ieee_update(*crc, &schema, sizeof(schema));
+	*crc = crc32_ieee_update(*crc, p + schema_offset, len - schema_offset);
+	*crc = crc32_ieee_update(*crc, (uint8_t *)&sentinel, sizeof(sentinel));
+
 	err = stream_flash_buffered_write(&stream, p, schema_offset, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
@@ -1514,11 +1617,13 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 			index.loading_count++;
 			finished = (index.loading_count == index.expected_count);
 			err = store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
-					       finished || (index.storage_extent == 1));
+					       finished || (index.storage_extent == 1),
+					       &index.crc[pnum]);
 			if (err) {
 				LOG_ERR("Error storing prediction:%d", err);
 				goto fail;
 			}
+			index.crc_checked[pnum] = false;
 			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
 
 			if (!finished) {
@@ -1541,6 +1646,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 				}
 
 				LOG_INF("All P-GPS data received. Done.");
+				save_stored_index();
 				state = PGPS_READY;
 				if (evt_handler) {
 					struct nrf_cloud_pgps_event evt = {
@@ -1610,6 +1716,9 @@ int nrf_cloud_pgps_begin_update(void)
 	/* assume cache is no longer valid */
 	discard_prediction_buffer();
 
+	/* the stored index is saved again once the update is complete */
+	(void)npgps_clear_index();
+
 	index.loading_count = 0;
 	index.store_block = npgps_alloc_block();
 	if (index.store_block == NO_BLOCK) {
@@ -1779,7 +1888,15 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 		 */
 		LOG_INF("Checking stored P-GPS data; count:%u, period_min:%u",
 			count, period_min);
-		num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		err = load_stored_index();
+		if (err >= 0) {
+			num_valid = err;
+		} else {
+			num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+			if (num_valid) {
+				save_stored_index();
+			}
+		}
 	}
 
 	struct nrf_cloud_pgps_prediction *found_prediction = NULL;
@@ -29,6 +29,8 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
 #define SETTINGS_FULL_LEAP_SEC			SETTINGS_NAME "/" SETTINGS_KEY_LEAP_SEC
+#define SETTINGS_KEY_PGPS_INDEX			"pgps_index"
+#define SETTINGS_FULL_PGPS_INDEX		SETTINGS_NAME "/" SETTINGS_KEY_PGPS_INDEX
 
 struct block_pool {
 	int first_free;
@@ -44,6 +46,7 @@ static int num_blocks;
 static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
+static struct npgps_stored_index saved_index;
 
 static K_SEM_DEFINE(dl_active, 1, 1);
 
@@ -79,6 +82,16 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+	if (!strncmp(key, SETTINGS_KEY_PGPS_INDEX,
+		     strlen(SETTINGS_KEY_PGPS_INDEX)) &&
+	    (len_rd == sizeof(saved_index))) {
+		if (read_cb(cb_arg, (void *)&saved_index, len_rd) == len_rd) {
+			LOG_DBG("Read pgps_index: count:%u, day:%u, time:%u",
+				saved_index.count, saved_index.gps_day,
+				saved_index.gps_time_of_day);
+			return 0;
+		}
+	}
 	if (!strncmp(key, SETTINGS_KEY_LOCATION,
 		     strlen(SETTINGS_KEY_LOCATION)) &&
 	    (len_rd == sizeof(saved_location))) {
@@ -133,6 +146,28 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void)
 	return &saved_header;
 }
 
+int npgps_save_index(struct npgps_stored_index *stored)
+{
+	LOG_DBG("Saving pgps index");
+	return settings_save_one(SETTINGS_FULL_PGPS_INDEX, stored, sizeof(*stored));
+}
+
+struct npgps_stored_index *npgps_get_saved_index(void)
+{
+	return &saved_index;
+}
+
+int npgps_clear_index(void)
+{
+	if (!saved_index.count) {
+		return 0;
+	}
+
+	LOG_DBG("Clearing pgps index");
+	memset(&saved_index, 0, sizeof(saved_index));
+	return settings_delete(SETTINGS_FULL_PGPS_INDEX);
+}
+
 /* @TODO: consider rate-limiting these updates to reduce Flash wear */
 static int save_location(void)
 {
@@ -377,6 +412,12 @@ void npgps_mark_block_used(int block, bool used)
 	LOG_DBG("mark idx:%d = %u", block, used);
 }
 
+bool npgps_block_used(int block)
+{
+	__ASSERT((block >= 0) && (block < num_blocks), "block %d out of range", block);
+	return pool.block_used[block];
+}
+
 void npgps_print_blocks(void)
 {
 	char map[num_blocks + 1];
@@ -30,6 +30,98 @@ LOG_MODULE_REGISTER(rest_client, CONFIG_REST_CLIENT_LOG_LEVEL);
 
 #define HTTP_PROTOCOL "HTTP/1.1"
 
+#if defined(CONFIG_REST_CLIENT_CONN_REUSE)
+#define IDLE_CONN_HOST_MAX_LEN 64
+
+/* Connection kept open after a request, for the next request to the same server */
+static struct {
+	int fd;
+	uint16_t port;
+	int sec_tag;
+	int tls_peer_verify;
+	char host[IDLE_CONN_HOST_MAX_LEN + 1];
+} idle_conn = {
+	.fd = REST_CLIENT_SCKT_CONNECT,
+};
+
+static K_MUTEX_DEFINE(idle_conn_lock);
+
+static void idle_conn_close_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&idle_conn_lock, K_FOREVER);
+
+	if (idle_conn.fd != REST_CLIENT_SCKT_CONNECT) {
+		LOG_DBG("Closing idle socket with id: %d", idle_conn.fd);
+		(void)close(idle_conn.fd);
+		idle_conn.fd = REST_CLIENT_SCKT_CONNECT;
+	}
+
+	k_mutex_unlock(&idle_conn_lock);
+}
+
+static K_WORK_DELAYABLE_DEFINE(idle_conn_close_work, idle_conn_close_work_fn);
+
+/* Returns the idle connection if it goes to the same server, otherwise -1. */
+static int idle_conn_take(const struct rest_client_req_context *const req_ctx)
+{
+	int fd = REST_CLIENT_SCKT_CONNECT;
+
+	k_mutex_lock(&idle_conn_lock, K_FOREVER);
+
+	if (idle_conn.fd != REST_CLIENT_SCKT_CONNECT &&
+	    idle_conn.port == req_ctx->port &&
+	    idle_conn.sec_tag == req_ctx->sec_tag &&
+	    idle_conn.tls_peer_verify == req_ctx->tls_peer_verify &&
+	    strcmp(idle_conn.host, req_ctx->host) == 0) {
+		fd = idle_conn.fd;
+		idle_conn.fd = REST_CLIENT_SCKT_CONNECT;
+	}
+
+	k_mutex_unlock(&idle_conn_lock);
+
+	return fd;
+}
+
+/* Keeps the connection of the request as the idle connection. */
+static bool idle_conn_put(const struct rest_client_req_context *const req_ctx)
+{
+	if (strlen(req_ctx->host) > IDLE_CONN_HOST_MAX_LEN) {
+		return false;
+	}
+
+	k_mutex_lock(&idle_conn_lock, K_FOREVER);
+
+	/* The most recently used connection is the most likely to be used again */
+	if (idle_conn.fd != REST_CLIENT_SCKT_CONNECT) {
+		(void)close(idle_conn.fd);
+	}
+
+	idle_conn.fd = req_ctx->connect_socket;
+	idle_conn.port = req_ctx->port;
+	idle_conn.sec_tag = req_ctx->sec_tag;
+	idle_conn.tls_peer_verify = req_ctx->tls_peer_verify;
+	strcpy(idle_conn.host, req_ctx->host);
+
+	k_mutex_unlock(&idle_conn_lock);
+
+	k_work_reschedule(&idle_conn_close_work, K_SECONDS(CONFIG_REST_CLIENT_CONN_IDLE_TIMEOUT));
+
+	return true;
+}
+#else
+static int idle_conn_take(const struct rest_client_req_context *const req_ctx)
+{
+	return REST_CLIENT_SCKT_CONNECT;
+}
+
+static bool idle_conn_put(const struct rest_client_req_context *const req_ctx)
+{
+	return false;
+}
+#endif /* CONFIG_REST_CLIENT_CONN_REUSE */
+
 static void rest_client_http_response_cb(struct http_response *rsp,
 					  enum http_final_call final_data,
 					  void *user_data)
@@ -79,7 +171,7 @@ static int rest_client_sckt_tls_setup(int fd, const char *const tls_hostname,
 	const sec_tag_t tls_sec_tag[] = {
 		sec_tag,
 	};
-	uint8_t cache;
+	int cache;
 
 	if (tls_peer_verify == TLS_PEER_VERIFY_REQUIRED ||
 	    tls_peer_verify == TLS_PEER_VERIFY_OPTIONAL ||
@@ -265,11 +357,16 @@ clean_up:
 }
 
 static void rest_client_close_connection(struct rest_client_req_context *const req_ctx,
-					 struct rest_client_resp_context *const resp_ctx)
+					 struct rest_client_resp_context *const resp_ctx,
+					 bool reusable)
 {
 	int ret;
 
-	if (!req_ctx->keep_alive) {
+	if (!req_ctx->keep_alive && reusable && idle_conn_put(req_ctx)) {
+		LOG_DBG("Socket with id: %d was kept open for reuse", req_ctx->connect_socket);
+
+		req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+	} else if (!req_ctx->keep_alive) {
 		ret = close(req_ctx->connect_socket);
 		if (ret) {
 			LOG_WRN("Failed to close socket, error: %d", errno);
@@ -295,6 +392,46 @@ static void rest_client_init_request(struct rest_client_req_context *const req_c
 
 	req->response = rest_client_http_response_cb;
 	req->method = req_ctx->http_method;
+
+	req->url = req_ctx->url;
+	req->header_fields = req_ctx->header_fields;
+
+	if (req_ctx->body != NULL) {
+		req->payload = req_ctx->body;
+		req->payload_len = req_ctx->body_len ? req_ctx->body_len : strlen(req->payload);
+	}
+}
+
+/* Methods that can be sent again when a reused connection turns out to be closed,
+ * without the risk of the server executing them twice. PUT and DELETE are
+ * idempotent by definition, but not all servers implement them so.
+ */
+static bool rest_client_method_retry_allowed(enum http_method method)
+{
+	return method == HTTP_GET || method == HTTP_HEAD || method == HTTP_OPTIONS;
+}
+
+/* Whether the request failed because the server had closed the connection before
+ * the request reached it: the send failed, or the first read returned EOF or a reset.
+ */
+static bool rest_client_conn_closed(int ret, const struct rest_client_resp_context *resp_ctx)
+{
+	if (resp_ctx->total_response_len != 0) {
+		return false;
+	}
+
+	switch (ret) {
+	case 0:
+		/* EOF: the connection was closed without a response */
+		return resp_ctx->http_status_code == 0;
+	case -ECONNRESET:
+	case -ECONNABORTED:
+	case -EPIPE:
+	case -ENOTCONN:
+		return true;
+	default:
+		return false;
+	}
 }
 
 static int rest_client_do_api_call(struct http_request *http_req,
@@ -372,22 +509,16 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 	__ASSERT_NO_MSG(req_ctx->resp_buff_len > 0);
 
 	struct http_request http_req;
+	bool reused = false;
+	bool reusable;
 	int ret;
 
 	rest_client_init_request(req_ctx, &http_req);
 
-	http_req.url = req_ctx->url;
-
 	LOG_DBG("Requesting destination HOST: %s at port %d, URL: %s",
 		req_ctx->host, req_ctx->port, http_req.url);
 
-	http_req.header_fields = req_ctx->header_fields;
-
 	if (req_ctx->body != NULL) {
-		http_req.payload = req_ctx->body;
-		http_req.payload_len =
-			req_ctx->body_len ? req_ctx->body_len : strlen(http_req.payload);
-
 		if (req_ctx->body_len) {
 			LOG_HEXDUMP_DBG(req_ctx->body, req_ctx->body_len, "Payload:");
 		} else {
@@ -395,7 +526,39 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 		}
 	}
 
+	if (req_ctx->connect_socket == REST_CLIENT_SCKT_CONNECT && !req_ctx->keep_alive) {
+		req_ctx->connect_socket = idle_conn_take(req_ctx);
+		reused = (req_ctx->connect_socket != REST_CLIENT_SCKT_CONNECT);
+	}
+
+	if (reused) {
+		LOG_DBG("Reusing socket with id: %d", req_ctx->connect_socket);
+
+		if (rest_client_sckt_timeouts_set(req_ctx->connect_socket, req_ctx->timeout_ms)) {
+			(void)close(req_ctx->connect_socket);
+			req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+			reused = false;
+		}
+	}
+
 	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+	if (reused && rest_client_conn_closed(ret, resp_ctx)) {
+		(void)close(req_ctx->connect_socket);
+		req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+
+		if (rest_client_method_retry_allowed(req_ctx->http_method)) {
+			/* The server closed the idle connection, retry once on a new one */
+			LOG_DBG("Reused socket was closed by the server, reconnecting");
+
+			rest_client_init_request(req_ctx, &http_req);
+			ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+		} else {
+			/* The request may have reached the server, so it is not sent again */
+			LOG_WRN("Reused socket was closed by the server, not retrying");
+			ret = -ECONNRESET;
+		}
+	}
+
 	if (ret) {
 		LOG_ERR("rest_client_do_api_call() failed, err %d", ret);
 		goto clean_up;
@@ -415,8 +578,14 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 
 clean_up:
 	if (req_ctx->connect_socket != REST_CLIENT_SCKT_CONNECT) {
+		/* The connection can be reused if the whole response was received and
+		 * the server did not ask to close it.
+		 */
+		reusable = (ret == 0) && (resp_ctx->http_status_code != 0) &&
+			   http_should_keep_alive(&http_req.internal.parser);
+
 		/* Socket was not closed yet: */
-		rest_client_close_connection(req_ctx, resp_ctx);
+		rest_client_close_connection(req_ctx, resp_ctx, reusable);
 	}
 	return ret;
 }
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+#include <modem/at_schema.h>
+
+#define BENCHMARK_ITERATIONS 200
+#define NCELLS_MAX 8
+
+struct cereg {
+	int32_t status;
+	uint32_t tac;
+	uint32_t cell_id;
+	int32_t act;
+	struct at_str_view active_time;
+	struct at_str_view tau_ext;
+};
+
+AT_SCHEMA_DEFINE(cereg_schema, "+CEREG",
+	AT_SCHEMA_FIELD(INT, struct cereg, status),
+	AT_SCHEMA_FIELD(HEX, struct cereg, tac),
+	AT_SCHEMA_FIELD(HEX, struct cereg, cell_id),
+	AT_SCHEMA_FIELD(INT, struct cereg, act),
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD_SKIP,
+	AT_SCHEMA_FIELD(STR, struct cereg, active_time),
+	AT_SCHEMA_FIELD(STR, struct cereg, tau_ext));
+
+struct xmonitor {
+	int32_t reg_status;
+	struct at_str_view full_name;
+	struct at_str_view short_name;
+	struct at_str_view plmn;
+	uint32_t tac;
+	int32_t act;
+	int32_t band;
+	uint32_t cell_id;
+	int32_t phys_cell_id;
+	int32_t earfcn;
+	int32_t rsrp;
+	int32_t snr;
+	struct at_str_view edrx;
+	struct at_str_view active_time;
+	struct at_str_view tau_ext;
+	struct at_str_view tau;
+};
+
+AT_SCHEMA_DEFINE(xmonitor_schema, "%XMONITOR",
+	AT_SCHEMA_FIELD(INT, struct xmonitor, reg_status),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, full_name),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, short_name),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, plmn),
+	AT_SCHEMA_FIELD(HEX, struct xmonitor, tac),
+	AT_SCHEMA_FIELD(INT, struct xmonitor, act),
+	AT_SCHEMA_FIELD(INT, struct xmonitor, band),
+	AT_SCHEMA_FIELD(HEX, struct xmonitor, cell_id),
+	AT_SCHEMA_FIELD(INT, struct xmonitor, phys_cell_id),
+	AT_SCHEMA_FIELD(INT, struct xmonitor, earfcn),
+	AT_SCHEMA_FIELD(INT, struct xmonitor, rsrp),
+	AT_SCHEMA_FIELD(INT, struct xmonitor, snr),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, edrx),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, active_time),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, tau_ext),
+	AT_SCHEMA_FIELD(STR, struct xmonitor, tau));
+
+struct ncell {
+	int32_t earfcn;
+	int32_t phys_cell_id;
+	int32_t rsrp;
+	int32_t rsrq;
+	int32_t time_diff;
+};
+
+struct ncellmeas {
+	int32_t status;
+	uint32_t cell_id;
+	struct at_str_view plmn;
+	uint32_t tac;
+	int32_t timing_advance;
+	int32_t earfcn;
+	int32_t phys_cell_id;
+	int32_t rsrp;
+	int32_t rsrq;
+	int64_t measurement_time;
+	struct ncell ncells[NCELLS_MAX];
+	size_t ncell_count;
+};
+
+AT_SCHEMA_DEFINE(ncellmeas_schema, "%NCELLMEAS",
+	AT_SCHEMA_FIELD(INT, struct ncellmeas, status),
+	AT_SCHEMA_FIELD(HEX, struct ncellmeas, cell_id),
+	AT_SCHEMA_FIELD(STR, struct ncellmeas, plmn),
+	AT_SCHEMA_FIELD(HEX, struct ncellmeas, tac),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas, timing_advance),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas, earfcn),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas, phys_cell_id),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas, rsrp),
+	AT_SCHEMA_FIELD(INT, struct ncellmeas, rsrq),
+	AT_SCHEMA_FIELD(INT64, struct ncellmeas, measurement_time));
+
+AT_SCHEMA_DEFINE(ncell_schema, NULL,
+	AT_SCHEMA_FIELD(INT, struct ncell, earfcn),
+	AT_SCHEMA_FIELD(INT, struct ncell, phys_cell_id),
+	AT_SCHEMA_FIELD(INT, struct ncell, rsrp),
+	AT_SCHEMA_FIELD(INT, struct ncell, rsrq),
+	AT_SCHEMA_FIELD(INT, struct ncell, time_diff));
+
+static const char cereg_notif[] =
+	"+CEREG: 5,\"0A0B\",\"01020304\",9,0,0,\"11100000\",\"00011111\"\r\n";
+static const char xmonitor_resp[] =
+	"%XMONITOR: 1,\"Telia N\",\"Telia N\",\"24202\",\"0901\",7,20,\"0011AE36\","
+	"194,6400,44,24,\"0010\",\"00000101\",\"00100110\",\"01001001\"\r\nOK\r\n";
+static const char ncellmeas_resp[] =
+	"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,10891,"
+	"5300,194,46,8,0,1650,292,60,27,24,6400,17,38,5,-12,1650,301,31,2,105\r\n";
+
+static int ncellmeas_parse(const char *str, struct ncellmeas *out)
+{
+	const char *next;
+	int err;
+
+	out->ncell_count = 0;
+
+	err = at_schema_parse(&ncellmeas_schema, str, out, NULL, &next);
+	if (err) {
+		return err;
+	}
+
+	while (*next == ',' && out->ncell_count < NCELLS_MAX) {
+		err = at_schema_parse(&ncell_schema, next, &out->ncells[out->ncell_count], NULL,
+				      &next);
+		if (err) {
+			return err;
+		}
+
+		out->ncell_count++;
+	}
+
+	return 0;
+}
+
+static bool view_equals(const struct at_str_view *view, const char *str)
+{
+	return view->ptr && view->len == strlen(str) && !memcmp(view->ptr, str, view->len);
+}
+
+ZTEST(at_schema, test_invalid_input)
+{
+	struct cereg cereg;
+
+	zassert_equal(at_schema_parse(NULL, cereg_notif, &cereg, NULL, NULL), -EINVAL);
+	zassert_equal(at_schema_parse(&cereg_schema, NULL, &cereg, NULL, NULL), -EINVAL);
+	zassert_equal(at_schema_parse(&cereg_schema, cereg_notif, NULL, NULL, NULL), -EINVAL);
+}
+
+ZTEST(at_schema, test_all_fields)
+{
+	struct cereg cereg = { 0 };
+	uint32_t present;
+	const char *next;
+	int err;
+
+	err = at_schema_parse(&cereg_schema, cereg_notif, &cereg, &present, &next);
+	zassert_ok(err);
+
+	zassert_equal(present, BIT(0) | BIT(1) | BIT(2) | BIT(3) | BIT(6) | BIT(7));
+	zassert_equal(cereg.status, 5);
+	zassert_equal(cereg.tac, 0x0A0B);
+	zassert_equal(cereg.cell_id, 0x01020304);
+	zassert_equal(cereg.act, 9);
+	zassert_true(view_equals(&cereg.active_time, "11100000"));
+	zassert_true(view_equals(&cereg.tau_ext, "00011111"));
+	zassert_equal(*next, '\r');
+
+	/* The views point into the parsed string */
+	zassert_true(cereg.active_time.ptr > cereg_notif &&
+		     cereg.active_time.ptr < cereg_notif + sizeof(cereg_notif));
+}
+
+ZTEST(at_schema, test_empty_and_missing_fields)
+{
+	struct cereg cereg = {
+		.tac = 0xFFFF,
+		.act = -1,
+	};
+	uint32_t present;
+	int err;
+
+	err = at_schema_parse(&cereg_schema, "+CEREG: 90,,\"FFFFFFFF\"", &cereg, &present, NULL);
+	zassert_ok(err);
+
+	zassert_equal(present, BIT(0) | BIT(2));
+	zassert_equal(cereg.status, 90);
+	zassert_equal(cereg.cell_id, 0xFFFFFFFF);
+
+	/* Values of empty and missing parameters are left untouched */
+	zassert_equal(cereg.tac, 0xFFFF);
+	zassert_equal(cereg.act, -1);
+	zassert_is_null(cereg.active_time.ptr);
+
+	/* An empty quoted string is a string */
+	err = at_schema_parse(&xmonitor_schema, "%XMONITOR: 1,\"\",\"OP\"",
+			      &(struct xmonitor){ 0 }, &present, NULL);
+	zassert_ok(err);
+	zassert_equal(present, BIT(0) | BIT(1) | BIT(2));
+}
+
+ZTEST(at_schema, test_spaces_and_result_code)
+{
+	struct cereg cereg = { 0 };
+	int err;
+
+	err = at_schema_parse(&cereg_schema, "\r\n+CEREG: 2, \"76C1\",\"0102DA04\", 7\r\nOK\r\n",
+			      &cereg, NULL, NULL);
+	zassert_ok(err);
+
+	zassert_equal(cereg.status, 2);
+	zassert_equal(cereg.tac, 0x76C1);
+	zassert_equal(cereg.cell_id, 0x0102DA04);
+	zassert_equal(cereg.act, 7);
+}
+
+ZTEST(at_schema, test_wrong_prefix)
+{
+	struct cereg cereg;
+
+	zassert_equal(at_schema_parse(&cereg_schema, "+CSCON: 1", &cereg, NULL, NULL), -ENOMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREGX: 1", &cereg, NULL, NULL), -ENOMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CERE", &cereg, NULL, NULL), -ENOMSG);
+}
+
+ZTEST(at_schema, test_wrong_type)
+{
+	struct cereg cereg;
+
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREG: \"1\"", &cereg, NULL, NULL),
+		      -EBADMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREG: 1a", &cereg, NULL, NULL),
+		      -EBADMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREG: 1,\"XYZ\"", &cereg, NULL, NULL),
+		      -EBADMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREG: 1,\"0A0B\"x", &cereg, NULL, NULL),
+		      -EBADMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREG: 4294967296", &cereg, NULL, NULL),
+		      -EBADMSG);
+	zassert_equal(at_schema_parse(&cereg_schema, "+CEREG: 1,\"100000000\"", &cereg, NULL,
+				      NULL), -EBADMSG);
+}
+
+ZTEST(at_schema, test_repeated_fields)
+{
+	struct ncellmeas meas;
+	int err;
+
+	err = ncellmeas_parse(ncellmeas_resp, &meas);
+	zassert_ok(err);
+
+	zassert_equal(meas.cell_id, 0x021D140C);
+	zassert_true(view_equals(&meas.plmn, "24201"));
+	zassert_equal(meas.measurement_time, 10891);
+	zassert_equal(meas.ncell_count, 4);
+	zassert_equal(meas.ncells[0].earfcn, 5300);
+	zassert_equal(meas.ncells[2].rsrq, 5);
+	zassert_equal(meas.ncells[2].time_diff, -12);
+	zassert_equal(meas.ncells[3].time_diff, 105);
+}
+
+ZTEST(at_schema, test_int64_saturated)
+{
+	struct ncellmeas meas;
+
+	zassert_ok(at_schema_parse(&ncellmeas_schema,
+				   "%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,"
+				   "50,15,18446744073709551614", &meas, NULL, NULL));
+	zassert_equal(meas.measurement_time, INT64_MAX);
+
+	zassert_ok(at_schema_parse(&ncellmeas_schema,
+				   "%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,"
+				   "50,15,-18446744073709551614", &meas, NULL, NULL));
+	zassert_equal(meas.measurement_time, INT64_MIN);
+}
+
+ZTEST(at_schema, test_str_view_copy)
+{
+	struct at_str_view view = { 0 };
+	char buf[9];
+
+	zassert_equal(at_str_view_copy(&view, buf, sizeof(buf)), -ENODATA);
+
+	view.ptr = "0010011011";
+	view.len = 10;
+	zassert_equal(at_str_view_copy(&view, buf, sizeof(buf)), -E2BIG);
+
+	view.len = 8;
+	zassert_ok(at_str_view_copy(&view, buf, sizeof(buf)));
+	zassert_str_equal(buf, "00100110");
+}
+
+/* The heavy responses parsed the way callers of the at_params list do it: parse into
+ * the list, get each parameter, and free the list.
+ */
+static int params_string_get(struct at_param_list *list, size_t index, char *buf,
+			     size_t buf_size)
+{
+	size_t len = buf_size - 1;
+	int err;
+
+	err = at_params_string_get(list, index, buf, &len);
+	if (err) {
+		return err;
+	}
+
+	buf[len] = '\0';
+
+	return 0;
+}
+
+static int xmonitor_params_parse(const char *str, struct xmonitor *out, char bufs[][32])
+{
+	struct at_param_list list;
+	char hex[16];
+	int err;
+
+	err = at_params_list_init(&list, 17);
+	if (err) {
+		return err;
+	}
+
+	err = at_parser_params_from_str(str, NULL, &list);
+	if (err) {
+		goto clean_exit;
+	}
+
+	err = at_params_int_get(&list, 1, &out->reg_status);
+	err |= params_string_get(&list, 2, bufs[0], 32);
+	err |= params_string_get(&list, 3, bufs[1], 32);
+	err |= params_string_get(&list, 4, bufs[2], 32);
+	err |= params_string_get(&list, 5, hex, sizeof(hex));
+	out->tac = strtoul(hex, NULL, 16);
+	err |= at_params_int_get(&list, 6, &out->act);
+	err |= at_params_int_get(&list, 7, &out->band);
+	err |= params_string_get(&list, 8, hex, sizeof(hex));
+	out->cell_id = strtoul(hex, NULL, 16);
+	err |= at_params_int_get(&list, 9, &out->phys_cell_id);
+	err |= at_params_int_get(&list, 10, &out->earfcn);
+	err |= at_params_int_get(&list, 11, &out->rsrp);
+	err |= at_params_int_get(&list, 12, &out->snr);
+	err |= params_string_get(&list, 13, bufs[3], 32);
+	err |= params_string_get(&list, 14, bufs[4], 32);
+	err |= params_string_get(&list, 15, bufs[5], 32);
+	err |= params_string_get(&list, 16, bufs[6], 32);
+
+clean_exit:
+	at_params_list_free(&list);
+
+	return err;
+}
+
+static int ncellmeas_params_parse(const char *str, struct ncellmeas *out, char *plmn)
+{
+	struct at_param_list list;
+	char hex[16];
+	size_t count;
+	int err;
+
+	err = at_params_list_init(&list, 11 + 5 * NCELLS_MAX);
+	if (err) {
+		return err;
+	}
+
+	err = at_parser_params_from_str(str, NULL, &list);
+	if (err) {
+		goto clean_exit;
+	}
+
+	err = at_params_int_get(&list, 1, &out->status);
+	err |= params_string_get(&list, 2, hex, sizeof(hex));
+	out->cell_id = strtoul(hex, NULL, 16);
+	err |= params_string_get(&list, 3, plmn, 8);
+	err |= params_string_get(&list, 4, hex, sizeof(hex));
+	out->tac = strtoul(hex, NULL, 16);
+	err |= at_params_int_get(&list, 5, &out->timing_advance);
+	err |= at_params_int_get(&list, 6, &out->earfcn);
+	err |= at_params_int_get(&list, 7, &out->phys_cell_id);
+	err |= at_params_int_get(&list, 8, &out->rsrp);
+	err |= at_params_int_get(&list, 9, &out->rsrq);
+	err |= at_params_int64_get(&list, 10, &out->measurement_time);
+
+	count = (at_params_valid_count_get(&list) - 11) / 5;
+	out->ncell_count = MIN(count, NCELLS_MAX);
+
+	for (size_t i = 0; i < out->ncell_count; i++) {
+		size_t base = 11 + 5 * i;
+
+		err |= at_params_int_get(&list, base, &out->ncells[i].earfcn);
+		err |= at_params_int_get(&list, base + 1, &out->ncells[i].phys_cell_id);
+		err |= at_params_int_get(&list, base + 2, &out->ncells[i].rsrp);
+		err |= at_params_int_get(&list, base + 3, &out->ncells[i].rsrq);
+		err |= at_params_int_get(&list, base + 4, &out->ncells[i].time_diff);
+	}
+
+clean_exit:
+	at_params_list_free(&list);
+
+	return err;
+}
+
+static uint32_t cycles_to_ns(uint32_t cycles)
+{
+	return k_cyc_to_ns_floor64(cycles) / BENCHMARK_ITERATIONS;
+}
+
+static void benchmark_print(const char *name, uint32_t params_cycles, uint32_t schema_cycles)
+{
+	TC_PRINT("%-10s at_params: %6u ns, at_schema: %6u ns\n", name,
+		 cycles_to_ns(params_cycles), cycles_to_ns(schema_cycles));
+}
+
+ZTEST(at_schema, test_benchmark)
+{
+	struct xmonitor xmon_params, xmon_schema;
+	struct ncellmeas meas_params, meas_schema;
+	char bufs[7][32];
+	char plmn[8];
+	uint32_t start, params_cycles, schema_cycles;
+	int err = 0;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		err |= xmonitor_params_parse(xmonitor_resp, &xmon_params, bufs);
+	}
+	params_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		err |= at_schema_parse(&xmonitor_schema, xmonitor_resp, &xmon_schema, NULL, NULL);
+	}
+	schema_cycles = k_cycle_get_32() - start;
+
+	zassert_ok(err);
+	zassert_equal(xmon_params.cell_id, xmon_schema.cell_id);
+	zassert_equal(xmon_params.snr, xmon_schema.snr);
+	zassert_true(view_equals(&xmon_schema.full_name, bufs[0]));
+	zassert_true(view_equals(&xmon_schema.tau, bufs[6]));
+
+	benchmark_print("%XMONITOR", params_cycles, schema_cycles);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		err |= ncellmeas_params_parse(ncellmeas_resp, &meas_params, plmn);
+	}
+	params_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		err |= ncellmeas_parse(ncellmeas_resp, &meas_schema);
+	}
+	schema_cycles = k_cycle_get_32() - start;
+
+	zassert_ok(err);
+	zassert_equal(meas_params.ncell_count, meas_schema.ncell_count);
+	zassert_mem_equal(meas_params.ncells, meas_schema.ncells,
+			  meas_schema.ncell_count * sizeof(struct ncell));
+	zassert_true(view_equals(&meas_schema.plmn, plmn));
+
+	benchmark_print("%NCELLMEAS", params_cycles, schema_cycles);
+}
+
+ZTEST_SUITE(at_schema, NULL, NULL, NULL, NULL, NULL);
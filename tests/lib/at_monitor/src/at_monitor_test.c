@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <modem/at_monitor.h>
+
+#include "cmock_nrf_modem_at.h"
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT notifications.
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+/* Each handler appends its monitor number, in the order they are called */
+static char calls[16];
+
+static void called(char id)
+{
+	size_t len = strlen(calls);
+
+	TEST_ASSERT_TRUE(len < sizeof(calls) - 1);
+	calls[len] = id;
+}
+
+/* Monitors are defined in the order of their names */
+AT_MONITOR(m1_cereg, "+CEREG", m1_handler);
+AT_MONITOR(m2_prefix, "+CE", m2_handler);
+AT_MONITOR(m3_any, ANY, m3_handler);
+AT_MONITOR(m4_substr, "REG", m4_handler);
+AT_MONITOR_ISR(m5_isr, "%CESQ", m5_handler);
+AT_MONITOR(m6_paused, "+CEREG", m6_handler, PAUSED);
+AT_MONITOR(m7_cmt, "+CMT", m7_handler);
+
+static void m1_handler(const char *notif)
+{
+	called('1');
+}
+
+static void m2_handler(const char *notif)
+{
+	called('2');
+}
+
+static void m3_handler(const char *notif)
+{
+	called('3');
+}
+
+static void m4_handler(const char *notif)
+{
+	called('4');
+}
+
+static void m5_handler(const char *notif)
+{
+	called('5');
+}
+
+static void m6_handler(const char *notif)
+{
+	called('6');
+}
+
+static void m7_handler(const char *notif)
+{
+	TEST_ASSERT_NOT_NULL(strstr(notif, "+CMT"));
+	called('7');
+}
+
+static void dispatch(const char *notif)
+{
+	at_monitor_dispatch(notif);
+
+	/* Let the system workqueue run the deferred handlers */
+	k_sleep(K_MSEC(10));
+}
+
+void setUp(void)
+{
+	memset(calls, 0, sizeof(calls));
+	at_monitor_pause(&m6_paused);
+	at_monitor_resume(&m1_cereg);
+}
+
+void test_indexed_and_unindexed_in_definition_order(void)
+{
+	dispatch("+CEREG: 1,\"4A2B\",\"0123ABCD\",7\r\n");
+
+	TEST_ASSERT_EQUAL_STRING("1234", calls);
+}
+
+void test_isr_monitor_called_first(void)
+{
+	dispatch("%CESQ: 54,2,15,2\r\n");
+
+	TEST_ASSERT_EQUAL_STRING("53", calls);
+}
+
+void test_key_prefix_matches_longer_notification(void)
+{
+	dispatch("+CMTI: \"SM\",1\r\n");
+
+	TEST_ASSERT_EQUAL_STRING("37", calls);
+}
+
+void test_filter_inside_notification(void)
+{
+	/* The filter of an indexed monitor is not at the start of the notification */
+	dispatch("%XFOO: \"+CMT\"\r\n");
+
+	TEST_ASSERT_EQUAL_STRING("37", calls);
+}
+
+void test_short_notification(void)
+{
+	dispatch("+C\r\n");
+
+	TEST_ASSERT_EQUAL_STRING("3", calls);
+
+	memset(calls, 0, sizeof(calls));
+	dispatch("");
+
+	TEST_ASSERT_EQUAL_STRING("3", calls);
+}
+
+void test_resumed_monitor(void)
+{
+	at_monitor_resume(&m6_paused);
+
+	dispatch("+CEREG: 5\r\n");
+
+	TEST_ASSERT_EQUAL_STRING("12346", calls);
+}
+
+void test_paused_before_deferred_dispatch(void)
+{
+	at_monitor_dispatch("+CEREG: 5\r\n");
+	at_monitor_pause(&m1_cereg);
+	k_sleep(K_MSEC(10));
+
+	TEST_ASSERT_EQUAL_STRING("234", calls);
+}
+
+void test_resumed_before_deferred_dispatch(void)
+{
+	at_monitor_dispatch("+CEREG: 5\r\n");
+	at_monitor_resume(&m6_paused);
+	k_sleep(K_MSEC(10));
+
+	TEST_ASSERT_EQUAL_STRING("12346", calls);
+}
+
+void test_dispatch_count(void)
+{
+	uint32_t cereg = at_monitor_dispatch_count_get(&m1_cereg);
+	uint32_t any = at_monitor_dispatch_count_get(&m3_any);
+	uint32_t isr = at_monitor_dispatch_count_get(&m5_isr);
+
+	dispatch("+CEREG: 5\r\n");
+	dispatch("%CESQ: 54,2,15,2\r\n");
+
+	TEST_ASSERT_EQUAL(cereg + 1, at_monitor_dispatch_count_get(&m1_cereg));
+	TEST_ASSERT_EQUAL(any + 2, at_monitor_dispatch_count_get(&m3_any));
+	TEST_ASSERT_EQUAL(isr + 1, at_monitor_dispatch_count_get(&m5_isr));
+	TEST_ASSERT_EQUAL(0, at_monitor_dispatch_count_get(&m6_paused));
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int at_monitor_test_sys_init(void)
+{
+	__cmock_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+SYS_INIT(at_monitor_test_sys_init, POST_KERNEL, 0);
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Cause nrf/lib/location to act as though this config is set. It cannot be set in Kconfig,
+ * because it depends on the A-GNSS configs that are only set in
+ * location_lib_autoconf_ext_agnss.h.
+ */
+#define CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH 1
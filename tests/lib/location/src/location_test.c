@@ -582,6 +582,12 @@ void test_location_gnss(void)
 	int err;
 	struct location_config config = { 0 };
 	enum location_method methods[] = {LOCATION_METHOD_GNSS};
+	struct location_gnss_assistance_stats stats;
+#if defined(CONFIG_LOCATION_TEST_AGNSS)
+	struct location_gnss_assistance_stats stats_before;
+
+	TEST_ASSERT_EQUAL(0, location_gnss_assistance_stats_get(&stats_before));
+#endif
 
 	location_config_defaults_set(&config, 1, methods);
 	config.methods[0].gnss.timeout = 120 * MSEC_PER_SEC;
@@ -787,6 +793,121 @@ void test_location_gnss(void)
 	__cmock_nrf_modem_gnss_stop_ExpectAndReturn(0);
 	method_gnss_event_handler(NRF_MODEM_GNSS_EVT_PVT);
 	k_sleep(K_MSEC(1));
+
+#if defined(CONFIG_LOCATION_TEST_AGNSS)
+	/* Assistance data had expired when GNSS was started */
+	TEST_ASSERT_EQUAL(0, location_gnss_assistance_stats_get(&stats));
+	TEST_ASSERT_EQUAL(1, stats.stale_starts - stats_before.stale_starts);
+	TEST_ASSERT_EQUAL(stats_before.fresh_starts, stats.fresh_starts);
+	TEST_ASSERT_EQUAL(stats_before.prefetches, stats.prefetches);
+	TEST_ASSERT_EQUAL(-EINVAL, location_gnss_assistance_stats_get(NULL));
+#else
+	TEST_ASSERT_EQUAL(-ENOTSUP, location_gnss_assistance_stats_get(&stats));
+#endif
+}
+
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+/* Expect the prefetch triggered by an RRC connection to query the assistance data expiry. */
+static void prefetch_expiry_expect(struct nrf_modem_gnss_agnss_expiry *agnss_expiry)
+{
+	__cmock_nrf_modem_gnss_agnss_expiry_get_ExpectAndReturn(NULL, 0);
+	__cmock_nrf_modem_gnss_agnss_expiry_get_IgnoreArg_agnss_expiry();
+	__cmock_nrf_modem_gnss_agnss_expiry_get_ReturnMemThruPtr_agnss_expiry(
+		agnss_expiry, sizeof(*agnss_expiry));
+}
+
+static struct nrf_modem_gnss_agnss_expiry agnss_expiry_valid = {
+	.utc_expiry = 10000,
+	.klob_expiry = 10000,
+	.neq_expiry = 10000,
+	.integrity_expiry = 10000,
+	.position_expiry = 10000,
+	.sv_count = 0
+};
+
+/* Minimum interval between A-GNSS data requests in the GNSS method. */
+#define AGNSS_REQUEST_MIN_INTERVAL K_HOURS(1)
+
+int nrf_cloud_rest_agnss_data_get_prefetch_Stub(
+	struct nrf_cloud_rest_context *const rest_ctx,
+	struct nrf_cloud_rest_agnss_request const *const request,
+	struct nrf_cloud_rest_agnss_result *const result,
+	int NumCalls)
+{
+	/* All additional assistance data is requested when any of it is needed */
+	TEST_ASSERT_EQUAL(NRF_CLOUD_REST_AGNSS_REQ_CUSTOM, request->type);
+	TEST_ASSERT_EQUAL(0x3f, request->agnss_req->data_flags);
+
+	result->buf = test_agnss_data;
+	result->agnss_sz = sizeof(test_agnss_data);
+
+	return 0;
+}
+#endif
+
+/* Test GNSS assistance data prefetch when the RRC connection is established while no location
+ * request is running. GNSS has been used in the previous test.
+ */
+void test_location_gnss_assistance_prefetch(void)
+{
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	struct location_gnss_assistance_stats stats_before;
+	struct location_gnss_assistance_stats stats;
+	struct nrf_modem_gnss_agnss_expiry agnss_expiry_time = agnss_expiry_valid;
+
+	TEST_ASSERT_EQUAL(0, location_gnss_assistance_stats_get(&stats_before));
+
+	/* Valid assistance data is not fetched */
+	prefetch_expiry_expect(&agnss_expiry_valid);
+	at_monitor_dispatch("+CSCON: 1");
+	k_sleep(K_MSEC(1));
+	at_monitor_dispatch("+CSCON: 0");
+	k_sleep(K_MSEC(1));
+
+	/* GPS time is needed, but A-GNSS data was requested in the previous test, so the request
+	 * is skipped due to the minimum request interval and not counted as a prefetch
+	 */
+	agnss_expiry_time.data_flags = NRF_MODEM_GNSS_AGNSS_GPS_SYS_TIME_AND_SV_TOW_REQUEST;
+	prefetch_expiry_expect(&agnss_expiry_time);
+	at_monitor_dispatch("+CSCON: 1");
+	k_sleep(K_MSEC(1));
+	at_monitor_dispatch("+CSCON: 0");
+	k_sleep(K_MSEC(1));
+
+	TEST_ASSERT_EQUAL(0, location_gnss_assistance_stats_get(&stats));
+	TEST_ASSERT_EQUAL(stats_before.prefetches, stats.prefetches);
+	TEST_ASSERT_EQUAL(stats_before.fresh_starts, stats.fresh_starts);
+	TEST_ASSERT_EQUAL(stats_before.stale_starts, stats.stale_starts);
+
+	/* Once the minimum request interval has passed, the expired data is prefetched */
+	k_sleep(AGNSS_REQUEST_MIN_INTERVAL);
+
+	prefetch_expiry_expect(&agnss_expiry_time);
+	__mock_nrf_modem_at_scanf_ExpectAndReturn(
+		"AT+CEREG?", "+CEREG: %*u,%hu,%*[^,],\"%x\",", 2);
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(LTE_LC_NW_REG_REGISTERED_HOME); /* Status */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(0x10012002); /* Cell ID */
+	__cmock_nrf_cloud_jwt_generate_ExpectAnyArgsAndReturn(0);
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%NCELLMEAS=1", 0);
+	__cmock_nrf_cloud_rest_agnss_data_get_Stub(nrf_cloud_rest_agnss_data_get_prefetch_Stub);
+	__cmock_nrf_cloud_agnss_process_ExpectAndReturn(
+		test_agnss_data, sizeof(test_agnss_data), 0);
+
+	at_monitor_dispatch("+CSCON: 1");
+	k_sleep(K_MSEC(1));
+
+	/* A-GNSS request gets the current cell info using NCELLMEAS */
+	at_monitor_dispatch(ncellmeas_resp_pci1);
+	k_sleep(K_MSEC(1));
+
+	at_monitor_dispatch("+CSCON: 0");
+	k_sleep(K_MSEC(1));
+
+	TEST_ASSERT_EQUAL(0, location_gnss_assistance_stats_get(&stats));
+	TEST_ASSERT_EQUAL(1, stats.prefetches - stats_before.prefetches);
+	TEST_ASSERT_EQUAL(stats_before.fresh_starts, stats.fresh_starts);
+	TEST_ASSERT_EQUAL(stats_before.stale_starts, stats.stale_starts);
+#endif
 }
 
 /* Test timeout for the entire location request during GNSS.
@@ -1308,6 +1429,232 @@ void test_location_wifi_timeout(void)
 #endif
 }
 
+/* Test combined Wi-Fi and cellular location request where Wi-Fi scan finds access points
+ * during the GCI history search, which is then stopped.
+ */
+void test_location_wifi_cellular_gci_search_stop(void)
+{
+#if defined(CONFIG_LOCATION_METHOD_WIFI_CELLULAR_GCI_SKIP)
+#if !defined(CONFIG_LOCATION_SERVICE_EXTERNAL)
+	int err;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_WIFI, LOCATION_METHOD_CELLULAR};
+	static const char ncellmeas_resp_gci_stopped[] =
+		"%NCELLMEAS:0,\"00011B07\",\"26295\",\"00B7\",10512,9034,2300,7,63,31,"
+		"150344527,1,0,"
+		"\"00011B08\",\"26295\",\"00B7\",65535,0,2300,9,62,30,150345527,0,0\r\n";
+
+	location_config_defaults_set(&config, 2, methods);
+	config.methods[1].cellular.cell_count = 4;
+
+#if defined(CONFIG_LOCATION_DATA_DETAILS)
+	test_location_event_data[location_cb_expected].id = LOCATION_EVT_STARTED;
+	test_location_event_data[location_cb_expected].method = LOCATION_METHOD_WIFI_CELLULAR;
+	location_cb_expected++;
+#endif
+	test_location_event_data[location_cb_expected].id = LOCATION_EVT_LOCATION;
+	test_location_event_data[location_cb_expected].method = LOCATION_METHOD_WIFI_CELLULAR;
+	test_location_event_data[location_cb_expected].location.latitude = 51.98765;
+	test_location_event_data[location_cb_expected].location.longitude = 13.12345;
+	test_location_event_data[location_cb_expected].location.accuracy = 50.0;
+#if defined(CONFIG_LOCATION_DATA_DETAILS)
+	test_location_event_data[location_cb_expected].location.details.cellular.ncells_count = 1;
+	test_location_event_data[location_cb_expected].location.details.cellular.gci_cells_count =
+		1;
+	test_location_event_data[location_cb_expected].location.details.wifi.ap_count = 2;
+#endif
+	location_cb_expected++;
+
+	net_mgmt_NET_REQUEST_WIFI_SCAN_expected = true;
+	__cmock_net_mgmt_NET_REQUEST_WIFI_SCAN_ExpectAndReturn(0);
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%NCELLMEAS=1", 0);
+
+	/* Make sure GCI searches are not waiting for RRC idle mode */
+	at_monitor_dispatch("+CSCON: 0");
+	k_sleep(K_MSEC(1));
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(1));
+
+#if defined(CONFIG_LOCATION_DATA_DETAILS)
+	/* Wait for LOCATION_EVT_STARTED */
+	err = k_sem_take(&event_handler_called_sem, K_SECONDS(3));
+	TEST_ASSERT_EQUAL(0, err);
+#endif
+
+	/* Normal neighbor search is followed by GCI history search */
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%NCELLMEAS=3,5", 0);
+	at_monitor_dispatch(ncellmeas_resp_pci1);
+	k_sleep(K_MSEC(1));
+
+	/* Wi-Fi scan finds access points, which stops the GCI history search, and the GCI
+	 * regional search is not done
+	 */
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%NCELLMEASSTOP", 0);
+
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT+CGACT?", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)cgact_resp_active, sizeof(cgact_resp_active));
+
+	cellular_rest_req_resp_handle(location_cb_expected - 1);
+
+	rest_req_ctx.url = "here.api"; /* Needs a fix once rest_req_ctx is verified */
+	rest_req_ctx.sec_tag = CONFIG_LOCATION_SERVICE_HERE_TLS_SEC_TAG;
+	rest_req_ctx.port = HTTPS_PORT;
+	rest_req_ctx.host = CONFIG_LOCATION_SERVICE_HERE_HOSTNAME;
+
+	struct net_mgmt_event_callback cb;
+	const struct wifi_status status = {
+		.status = WIFI_STATUS_CONN_SUCCESS
+	};
+	const struct wifi_scan_result scan_result1 = {
+		.ssid = "TestAP1",
+		.ssid_length = 7,
+		.channel = 36,
+		.mac = {0x12, 0x34, 0x56, 0x78, 0x90, 0xAB},
+		.mac_length = 6
+	};
+	const struct wifi_scan_result scan_result2 = {
+		.ssid = "TestAP2",
+		.ssid_length = 7,
+		.channel = 36,
+		.mac = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66},
+		.mac_length = 6
+	};
+
+	cb.info = &scan_result1;
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_RESULT, NULL);
+	k_sleep(K_MSEC(1));
+
+	cb.info = &scan_result2;
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_RESULT, NULL);
+	k_sleep(K_MSEC(1));
+
+	cb.info = &status;
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_DONE, NULL);
+	k_sleep(K_MSEC(1));
+
+	/* The stopped GCI search reports the cells found so far */
+	at_monitor_dispatch(ncellmeas_resp_gci_stopped);
+	k_sleep(K_MSEC(1));
+#endif
+#endif
+}
+
+/* Test combined Wi-Fi and cellular location request where Wi-Fi scan finds access points
+ * while the GCI searches wait for RRC idle mode, which they then stop waiting for.
+ */
+void test_location_wifi_cellular_gci_search_stop_rrc_connected(void)
+{
+#if defined(CONFIG_LOCATION_METHOD_WIFI_CELLULAR_GCI_SKIP)
+#if !defined(CONFIG_LOCATION_SERVICE_EXTERNAL)
+	int err;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_WIFI, LOCATION_METHOD_CELLULAR};
+
+	location_config_defaults_set(&config, 2, methods);
+	config.methods[1].cellular.cell_count = 4;
+
+#if defined(CONFIG_LOCATION_DATA_DETAILS)
+	test_location_event_data[location_cb_expected].id = LOCATION_EVT_STARTED;
+	test_location_event_data[location_cb_expected].method = LOCATION_METHOD_WIFI_CELLULAR;
+	location_cb_expected++;
+#endif
+	test_location_event_data[location_cb_expected].id = LOCATION_EVT_LOCATION;
+	test_location_event_data[location_cb_expected].method = LOCATION_METHOD_WIFI_CELLULAR;
+	test_location_event_data[location_cb_expected].location.latitude = 51.98765;
+	test_location_event_data[location_cb_expected].location.longitude = 13.12345;
+	test_location_event_data[location_cb_expected].location.accuracy = 50.0;
+#if defined(CONFIG_LOCATION_DATA_DETAILS)
+	test_location_event_data[location_cb_expected].location.details.cellular.ncells_count = 1;
+	test_location_event_data[location_cb_expected].location.details.cellular.gci_cells_count =
+		0;
+	test_location_event_data[location_cb_expected].location.details.wifi.ap_count = 2;
+#endif
+	location_cb_expected++;
+
+	net_mgmt_NET_REQUEST_WIFI_SCAN_expected = true;
+	__cmock_net_mgmt_NET_REQUEST_WIFI_SCAN_ExpectAndReturn(0);
+	__mock_nrf_modem_at_printf_ExpectAndReturn("AT%NCELLMEAS=1", 0);
+
+	/* GCI searches wait for RRC idle mode */
+#if defined(CONFIG_LOCATION_METHOD_GNSS_ASSISTANCE_PREFETCH)
+	prefetch_expiry_expect(&agnss_expiry_valid);
+#endif
+	at_monitor_dispatch("+CSCON: 1");
+	k_sleep(K_MSEC(1));
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(1));
+
+#if defined(CONFIG_LOCATION_DATA_DETAILS)
+	/* Wait for LOCATION_EVT_STARTED */
+	err = k_sem_take(&event_handler_called_sem, K_SECONDS(3));
+	TEST_ASSERT_EQUAL(0, err);
+#endif
+
+	/* Normal neighbor search is followed by the wait for RRC idle mode */
+	at_monitor_dispatch(ncellmeas_resp_pci1);
+	k_sleep(K_MSEC(1));
+
+	/* Wi-Fi scan finds access points, which stops the wait without any GCI searches */
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT+CGACT?", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)cgact_resp_active, sizeof(cgact_resp_active));
+
+	cellular_rest_req_resp_handle(location_cb_expected - 1);
+
+	rest_req_ctx.url = "here.api"; /* Needs a fix once rest_req_ctx is verified */
+	rest_req_ctx.sec_tag = CONFIG_LOCATION_SERVICE_HERE_TLS_SEC_TAG;
+	rest_req_ctx.port = HTTPS_PORT;
+	rest_req_ctx.host = CONFIG_LOCATION_SERVICE_HERE_HOSTNAME;
+
+	struct net_mgmt_event_callback cb;
+	const struct wifi_status status = {
+		.status = WIFI_STATUS_CONN_SUCCESS
+	};
+	const struct wifi_scan_result scan_result1 = {
+		.ssid = "TestAP1",
+		.ssid_length = 7,
+		.channel = 36,
+		.mac = {0x12, 0x34, 0x56, 0x78, 0x90, 0xAB},
+		.mac_length = 6
+	};
+	const struct wifi_scan_result scan_result2 = {
+		.ssid = "TestAP2",
+		.ssid_length = 7,
+		.channel = 36,
+		.mac = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66},
+		.mac_length = 6
+	};
+
+	cb.info = &scan_result1;
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_RESULT, NULL);
+	k_sleep(K_MSEC(1));
+
+	cb.info = &scan_result2;
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_RESULT, NULL);
+	k_sleep(K_MSEC(1));
+
+	cb.info = &status;
+	scan_wifi_net_mgmt_event_handler(&cb, NET_EVENT_WIFI_SCAN_DONE, NULL);
+
+	/* The location is received well before the wait for RRC idle mode would time out */
+	err = k_sem_take(&event_handler_called_sem, K_SECONDS(3));
+	TEST_ASSERT_EQUAL(0, err);
+
+	at_monitor_dispatch("+CSCON: 0");
+	k_sleep(K_MSEC(1));
+#endif
+#endif
+}
+
 /********* GENERAL ERROR TESTS ***********************/
 
 /* Test location request with unknown method. */
@@ -9,15 +9,54 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <zephyr/fff.h>
+#include <nrf_modem_at.h>
+
 #include "lte_lc_helpers.h"
 #include "lte_lc.h"
 
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC_VARARG(int, nrf_modem_at_printf, const char *, ...);
+
 /* The unity_main is not declared in any header file. It is only defined in the generated test
  * runner because of ncs' unity configuration. It is therefore declared here to avoid a compiler
  * warning.
  */
 extern int unity_main(void);
 
+#define AT_CMDS_SENT_MAX 8
+
+static char at_cmds_sent[AT_CMDS_SENT_MAX][64];
+static const char *at_cmd_fail;
+
+static int nrf_modem_at_printf_custom(const char *fmt, va_list args)
+{
+	const char *cmd;
+
+	TEST_ASSERT_EQUAL_STRING("%s", fmt);
+	TEST_ASSERT_LESS_THAN(AT_CMDS_SENT_MAX, nrf_modem_at_printf_fake.call_count - 1);
+
+	cmd = va_arg(args, const char *);
+	strcpy(at_cmds_sent[nrf_modem_at_printf_fake.call_count - 1], cmd);
+
+	/* A positive value is an error reported by the modem. */
+	return (at_cmd_fail != NULL && strcmp(cmd, at_cmd_fail) == 0) ? 65536 : 0;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(nrf_modem_at_printf);
+	nrf_modem_at_printf_fake.custom_fake = nrf_modem_at_printf_custom;
+	at_cmd_fail = NULL;
+
+	at_batch_cache_clear();
+}
+
+void tearDown(void)
+{
+}
+
 void test_parse_edrx(void)
 {
 	int err;
@@ -308,6 +347,7 @@ void test_parse_ncellmeas(void)
 	char *resp3 =
 		"%NCELLMEAS: 0,\"071D340C\",\"24201\",\"0821\",65535,5300,449,50,15,10891,655350";
 	char *resp4 = "%NCELLMEAS: 0,\"071D340C\",\"24202\",\"0762\",65535,5300,449,50,15,10871";
+	char *resp5 = "%NCELLMEAS: 0,\"071D340C\",\"24202\",\"0762\",65535";
 	struct lte_lc_ncell ncells[17];
 	struct lte_lc_cells_info cells = {
 		.neighbor_cells = ncells,
@@ -376,6 +416,14 @@ void test_parse_ncellmeas(void)
 	TEST_ASSERT_EQUAL(10871, cells.current_cell.measurement_time);
 	TEST_ASSERT_EQUAL(449, cells.current_cell.phys_cell_id);
 	TEST_ASSERT_EQUAL(0, cells.ncells_count);
+
+	memset(&cells, 0, sizeof(cells));
+
+	/* Response of a successful measurement with missing parameters. */
+	err = parse_ncellmeas(resp5, &cells);
+	TEST_ASSERT_EQUAL(-EINVAL, err);
+	TEST_ASSERT_EQUAL(LTE_LC_CELL_EUTRAN_ID_INVALID, cells.current_cell.id);
+	TEST_ASSERT_EQUAL(0, cells.ncells_count);
 }
 
 void test_neighborcell_count_get(void)
@@ -886,6 +934,131 @@ void test_parse_periodic_search_pattern(void)
 	TEST_ASSERT_EQUAL(-EBADMSG, err);
 }
 
+void test_at_batch_submit(void)
+{
+	int err;
+	struct at_batch batch;
+
+	at_batch_init(&batch);
+
+	TEST_ASSERT_EQUAL(0, at_batch_add(&batch, 0, "AT+CEREG=%d", 5));
+	TEST_ASSERT_EQUAL(1, at_batch_add(&batch, 0, "AT%%XT3412=1,%d,%d", 5000, 1200000));
+	TEST_ASSERT_EQUAL(2, at_batch_add(&batch, 0, "AT+CSCON=1"));
+
+	err = at_batch_submit(&batch);
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(3, nrf_modem_at_printf_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("AT+CEREG=5", at_cmds_sent[0]);
+	TEST_ASSERT_EQUAL_STRING("AT%XT3412=1,5000,1200000", at_cmds_sent[1]);
+	TEST_ASSERT_EQUAL_STRING("AT+CSCON=1", at_cmds_sent[2]);
+}
+
+void test_at_batch_submit_error(void)
+{
+	int err;
+	struct at_batch batch;
+
+	at_batch_init(&batch);
+
+	TEST_ASSERT_EQUAL(0, at_batch_add(&batch, AT_BATCH_FLAG_OPTIONAL, "AT%%XMODEMSLEEP=1"));
+	TEST_ASSERT_EQUAL(1, at_batch_add(&batch, 0, "AT+CEREG=5"));
+	TEST_ASSERT_EQUAL(2, at_batch_add(&batch, 0, "AT+CSCON=1"));
+
+	/* A failed optional command does not stop the batch. */
+	at_cmd_fail = "AT%XMODEMSLEEP=1";
+	err = at_batch_submit(&batch);
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(3, nrf_modem_at_printf_fake.call_count);
+	TEST_ASSERT_EQUAL(65536, batch.err[0]);
+
+	/* A failed command stops the batch. */
+	RESET_FAKE(nrf_modem_at_printf);
+	nrf_modem_at_printf_fake.custom_fake = nrf_modem_at_printf_custom;
+	at_cmd_fail = "AT+CEREG=5";
+	err = at_batch_submit(&batch);
+	TEST_ASSERT_EQUAL(65536, err);
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_printf_fake.call_count);
+	TEST_ASSERT_EQUAL(65536, batch.err[1]);
+	TEST_ASSERT_EQUAL(-ECANCELED, batch.err[2]);
+}
+
+void test_at_batch_add_full(void)
+{
+	struct at_batch batch;
+	char long_arg[AT_BATCH_BUF_SIZE];
+
+	at_batch_init(&batch);
+
+	memset(long_arg, 'a', sizeof(long_arg) - 1);
+	long_arg[sizeof(long_arg) - 1] = '\0';
+	TEST_ASSERT_EQUAL(-ENOMEM, at_batch_add(&batch, 0, "AT+COPS=1,2,\"%s\"", long_arg));
+
+	for (int i = 0; i < AT_BATCH_CMD_COUNT_MAX; i++) {
+		TEST_ASSERT_EQUAL(i, at_batch_add(&batch, 0, "AT+CSCON=1"));
+	}
+
+	TEST_ASSERT_EQUAL(-ENOMEM, at_batch_add(&batch, 0, "AT+CSCON=1"));
+}
+
+void test_at_cmd_idempotent_printf(void)
+{
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%FEACONF=%d,%d,%d", 0, 3, 1));
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%FEACONF=%d,%d,%d", 0, 3, 1));
+	TEST_ASSERT_EQUAL(1, nrf_modem_at_printf_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("AT%FEACONF=0,3,1", at_cmds_sent[0]);
+
+	/* A different value of the same setting is sent. */
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%FEACONF=%d,%d,%d", 0, 3, 0));
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_printf_fake.call_count);
+
+	/* Other settings are recorded separately. */
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT+CPSMS=1"));
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT+CPSMS=1"));
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%FEACONF=%d,%d,%d", 0, 3, 0));
+	TEST_ASSERT_EQUAL(3, nrf_modem_at_printf_fake.call_count);
+
+	/* Nothing is known to be set after the recorded state is cleared. */
+	at_batch_cache_clear();
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT+CPSMS=1"));
+	TEST_ASSERT_EQUAL(4, nrf_modem_at_printf_fake.call_count);
+}
+
+void test_at_cmd_idempotent_printf_error(void)
+{
+	at_cmd_fail = "AT%RAI=1";
+	TEST_ASSERT_EQUAL(65536, at_cmd_idempotent_printf("AT%%RAI=%d", 1));
+
+	/* A failed command is not recorded as set. */
+	at_cmd_fail = NULL;
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%RAI=%d", 1));
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_printf_fake.call_count);
+}
+
+void test_at_cmd_idempotent_printf_too_long(void)
+{
+	char long_arg[AT_CMD_IDEMPOTENT_LEN];
+
+	memset(long_arg, '1', sizeof(long_arg) - 1);
+	long_arg[sizeof(long_arg) - 1] = '\0';
+	TEST_ASSERT_EQUAL(-ENOMEM, at_cmd_idempotent_printf("AT+CPSMS=1,,,\"%s\"", long_arg));
+	TEST_ASSERT_EQUAL(0, nrf_modem_at_printf_fake.call_count);
+}
+
+void test_at_batch_non_idempotent_updates_state(void)
+{
+	struct at_batch batch;
+
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%RAI=1"));
+
+	at_batch_init(&batch);
+	TEST_ASSERT_EQUAL(0, at_batch_add(&batch, 0, "AT%%RAI=0"));
+	TEST_ASSERT_EQUAL(0, at_batch_submit(&batch));
+
+	/* The setting was changed by the second batch, so it is sent again. */
+	TEST_ASSERT_EQUAL(0, at_cmd_idempotent_printf("AT%%RAI=1"));
+	TEST_ASSERT_EQUAL(3, nrf_modem_at_printf_fake.call_count);
+}
+
 int main(void)
 {
 	(void)unity_main();
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "modem_info.h"
+
+#include <zephyr/fff.h>
+
+#include <nrf_modem_at.h>
+#include <nrf_errno.h>
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, nrf_modem_at_notif_handler_set, nrf_modem_at_notif_handler_t);
+FAKE_VALUE_FUNC_VARARG(int, nrf_modem_at_scanf, const char *, const char *, ...);
+FAKE_VALUE_FUNC_VARARG(int, nrf_modem_at_cmd, void *, size_t, const char *, ...);
+
+#define CEREG_RSP "+CEREG: 5,1,\"0138\",\"0013BEEF\",7\r\nOK\r\n"
+#define XVBAT_RSP "%XVBAT: 3600\r\nOK\r\n"
+#define CCLK_RSP "+CCLK: \"24/02/01,12:00:00+04\"\r\nOK\r\n"
+
+static const char *at_rsp;
+
+static int nrf_modem_at_cmd_custom(void *buf, size_t len, const char *fmt, va_list args)
+{
+	strncpy(buf, at_rsp, len);
+
+	return 0;
+}
+
+static int nrf_modem_at_cmd_custom_error(void *buf, size_t len, const char *fmt, va_list args)
+{
+	return -NRF_EFAULT;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(nrf_modem_at_cmd);
+
+	nrf_modem_at_cmd_fake.custom_fake = nrf_modem_at_cmd_custom;
+
+	TEST_ASSERT_EQUAL(0, modem_info_init());
+	modem_info_cache_invalidate();
+}
+
+void tearDown(void)
+{
+}
+
+void test_modem_info_cache_same_command_sent_once(void)
+{
+	char buf[16];
+
+	at_rsp = CEREG_RSP;
+
+	TEST_ASSERT_EQUAL(4, modem_info_string_get(MODEM_INFO_AREA_CODE, buf, sizeof(buf)));
+	TEST_ASSERT_EQUAL_STRING("0138", buf);
+	TEST_ASSERT_EQUAL(8, modem_info_string_get(MODEM_INFO_CELLID, buf, sizeof(buf)));
+	TEST_ASSERT_EQUAL_STRING("0013BEEF", buf);
+
+	TEST_ASSERT_EQUAL(1, nrf_modem_at_cmd_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("AT+CEREG?", nrf_modem_at_cmd_fake.arg2_val);
+}
+
+void test_modem_info_cache_measurement_max_age(void)
+{
+	uint16_t val;
+
+	at_rsp = XVBAT_RSP;
+
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	TEST_ASSERT_EQUAL(3600, val);
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	TEST_ASSERT_EQUAL(1, nrf_modem_at_cmd_fake.call_count);
+
+	k_sleep(K_MSEC(CONFIG_MODEM_INFO_CACHE_MEASUREMENT_MAX_AGE));
+
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_cmd_fake.call_count);
+}
+
+void test_modem_info_cache_invalidate(void)
+{
+	uint16_t val;
+
+	at_rsp = XVBAT_RSP;
+
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	modem_info_cache_invalidate();
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_cmd_fake.call_count);
+}
+
+void test_modem_info_cache_uncached_command(void)
+{
+	char buf[32];
+
+	at_rsp = CCLK_RSP;
+
+	TEST_ASSERT_GREATER_THAN(0, modem_info_string_get(MODEM_INFO_DATE_TIME, buf, sizeof(buf)));
+	TEST_ASSERT_GREATER_THAN(0, modem_info_string_get(MODEM_INFO_DATE_TIME, buf, sizeof(buf)));
+
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_cmd_fake.call_count);
+}
+
+void test_modem_info_cache_error_not_cached(void)
+{
+	uint16_t val;
+
+	nrf_modem_at_cmd_fake.custom_fake = nrf_modem_at_cmd_custom_error;
+	TEST_ASSERT_EQUAL(-EIO, modem_info_short_get(MODEM_INFO_BATTERY, &val));
+
+	nrf_modem_at_cmd_fake.custom_fake = nrf_modem_at_cmd_custom;
+	at_rsp = XVBAT_RSP;
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	TEST_ASSERT_EQUAL(3600, val);
+
+	TEST_ASSERT_EQUAL(2, nrf_modem_at_cmd_fake.call_count);
+}
+
+void test_modem_info_cache_stats(void)
+{
+	struct modem_info_cache_stats before;
+	struct modem_info_cache_stats stats;
+	uint16_t val;
+
+	TEST_ASSERT_EQUAL(-EINVAL, modem_info_cache_stats_get(NULL));
+	TEST_ASSERT_EQUAL(0, modem_info_cache_stats_get(&before));
+
+	at_rsp = XVBAT_RSP;
+
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+	TEST_ASSERT_EQUAL(sizeof(uint16_t), modem_info_short_get(MODEM_INFO_BATTERY, &val));
+
+	TEST_ASSERT_EQUAL(0, modem_info_cache_stats_get(&stats));
+	TEST_ASSERT_EQUAL(2, stats.hits - before.hits);
+	TEST_ASSERT_EQUAL(1, stats.misses - before.misses);
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -20,6 +20,7 @@
 #define PORT 8080
 #define WRONG_VALUE 4242
 #define NRF_FD 2
+#define DGRAM_CHUNK_SIZE_MAX 100
 
 void setUp(void)
 {
@@ -1629,6 +1630,275 @@ void test_nrf91_socket_offload_sendmsg_not_fits_buf(void)
 	TEST_ASSERT_EQUAL(ret, 0);
 }
 
+void test_nrf91_socket_offload_sendmsg_single_chunk_no_copy(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_STREAM;
+	int proto = IPPROTO_TCP;
+	int flags = ZSOCK_MSG_DONTWAIT;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[3] = { 0 };
+	uint8_t data[4] = { 1, 2, 3, 4 };
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_STREAM, NRF_IPPROTO_TCP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	/* Only the second chunk has data, it is passed to the modem as it is */
+	chunks[1].iov_base = data;
+	chunks[1].iov_len = sizeof(data);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 3;
+
+	__cmock_nrf_sendto_ExpectAndReturn(nrf_fd, data, sizeof(data),
+					   NRF_MSG_DONTWAIT,
+					   NULL, 0, sizeof(data));
+
+	ret = zsock_sendmsg(fd, &msg, flags);
+
+	TEST_ASSERT_EQUAL(ret, sizeof(data));
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_sendmsg_ipv4_fits_buf(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_DGRAM;
+	int proto = IPPROTO_UDP;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[2] = { 0 };
+	struct sockaddr to = { .sa_family = family };
+	int chunk_1 = 42;
+	int chunk_2 = 43;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_DGRAM, NRF_IPPROTO_UDP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = &chunk_2;
+	chunks[1].iov_len = sizeof(int);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 2;
+	msg.msg_name = &to;
+	msg.msg_namelen = sizeof(to);
+
+	/* Both chunks are sent in a single datagram */
+	__cmock_nrf_sendto_ExpectAndReturn(nrf_fd, NULL, 2 * sizeof(int), 0,
+					   NULL, sizeof(struct nrf_sockaddr_in),
+					   2 * sizeof(int));
+	__cmock_nrf_sendto_IgnoreArg_message();
+	__cmock_nrf_sendto_IgnoreArg_dest_addr();
+
+	ret = zsock_sendmsg(fd, &msg, 0);
+
+	TEST_ASSERT_EQUAL(ret, 2 * sizeof(int));
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_recvmsg_msg_null_einval(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_STREAM;
+	int proto = IPPROTO_TCP;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_STREAM, NRF_IPPROTO_TCP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	ret = zsock_recvmsg(fd, NULL, 0);
+
+	TEST_ASSERT_EQUAL(ret, -1);
+	TEST_ASSERT_EQUAL(errno, EINVAL);
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_recvmsg_stream_scatter(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_STREAM;
+	int proto = IPPROTO_TCP;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[3] = { 0 };
+	int chunk_1;
+	int chunk_2;
+	int chunk_3;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_STREAM, NRF_IPPROTO_TCP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = &chunk_2;
+	chunks[1].iov_len = sizeof(int);
+	chunks[2].iov_base = &chunk_3;
+	chunks[2].iov_len = sizeof(int);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 3;
+
+	/* Data is received directly into the chunks. Only the first receive
+	 * blocks, and receiving stops when no more data is available.
+	 */
+	__cmock_nrf_recvfrom_ExpectAndReturn(nrf_fd, &chunk_1, sizeof(int), 0,
+					     NULL, NULL, sizeof(int));
+	__cmock_nrf_recvfrom_ExpectAndReturn(nrf_fd, &chunk_2, sizeof(int), NRF_MSG_DONTWAIT,
+					     NULL, NULL, -1);
+
+	ret = zsock_recvmsg(fd, &msg, 0);
+
+	TEST_ASSERT_EQUAL(ret, sizeof(int));
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+static const char *dgram_stub_data;
+static size_t dgram_stub_length;
+
+static ssize_t nrf_recvfrom_dgram_stub(int zsock_socket, void *buffer, size_t length,
+				       int flags, struct nrf_sockaddr *address,
+				       nrf_socklen_t *address_len,
+				       int cmock_num_calls)
+{
+	size_t len = strlen(dgram_stub_data);
+
+	if (cmock_num_calls == 0) {
+		/* The datagram is waited for without a buffer */
+		TEST_ASSERT_EQUAL(1, length);
+		TEST_ASSERT_EQUAL(NRF_MSG_PEEK, flags);
+	} else {
+		TEST_ASSERT_EQUAL(dgram_stub_length, length);
+		TEST_ASSERT_EQUAL(NRF_MSG_DONTWAIT, flags);
+	}
+
+	len = MIN(len, length);
+	memcpy(buffer, dgram_stub_data, len);
+
+	return len;
+}
+
+/* Receive a datagram into two chunks of chunk_size bytes. */
+static void recvmsg_dgram_scatter(const char *datagram, size_t chunk_size, int expected)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_DGRAM;
+	int proto = IPPROTO_UDP;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[2] = { 0 };
+	char chunk_1[DGRAM_CHUNK_SIZE_MAX] = { 0 };
+	char chunk_2[DGRAM_CHUNK_SIZE_MAX] = { 0 };
+
+	TEST_ASSERT_TRUE(chunk_size <= DGRAM_CHUNK_SIZE_MAX);
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_DGRAM, NRF_IPPROTO_UDP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = chunk_1;
+	chunks[0].iov_len = chunk_size;
+	chunks[1].iov_base = chunk_2;
+	chunks[1].iov_len = chunk_size;
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 2;
+
+	/* The datagram is received at once and scattered over the chunks. The buffer is
+	 * one byte larger than the chunks to detect truncation, but no larger than the
+	 * shared memory the datagram is received in.
+	 */
+	dgram_stub_data = datagram;
+	dgram_stub_length = MIN(2 * chunk_size + 1, CONFIG_NRF_MODEM_LIB_SHMEM_RX_SIZE);
+	__cmock_nrf_recvfrom_Stub(nrf_recvfrom_dgram_stub);
+
+	ret = zsock_recvmsg(fd, &msg, 0);
+
+	TEST_ASSERT_EQUAL(expected, ret);
+	TEST_ASSERT_EQUAL_MEMORY(datagram, chunk_1, chunk_size);
+	TEST_ASSERT_EQUAL_MEMORY(datagram + chunk_size, chunk_2, ret - chunk_size);
+	TEST_ASSERT_EQUAL((int)strlen(datagram) > expected ? MSG_TRUNC : 0, msg.msg_flags);
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_recvmsg_dgram_scatter(void)
+{
+	recvmsg_dgram_scatter("abcdef", sizeof(int), 6);
+}
+
+void test_nrf91_socket_offload_recvmsg_dgram_scatter_fit(void)
+{
+	recvmsg_dgram_scatter("abcdefgh", sizeof(int), 8);
+}
+
+void test_nrf91_socket_offload_recvmsg_dgram_scatter_trunc(void)
+{
+	recvmsg_dgram_scatter("abcdefghijkl", sizeof(int), 8);
+}
+
+void test_nrf91_socket_offload_recvmsg_dgram_scatter_heap(void)
+{
+	/* The chunks are too large for the static buffer, the datagram is received
+	 * into a buffer from the heap.
+	 */
+	recvmsg_dgram_scatter("0123456789abcdefghijklmnopqrstuvwxyz", 32, 36);
+}
+
+void test_nrf91_socket_offload_recvmsg_dgram_scatter_shmem_limit(void)
+{
+	/* The chunks are larger than the shared memory, the buffer is limited to
+	 * the largest datagram that can be received.
+	 */
+	recvmsg_dgram_scatter("0123456789abcdefghijklmnopqrstuvwxyz", 100, 36);
+}
+
 void test_nrf91_socket_offload_fcntl_einval(void)
 {
 	int ret;
@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* generated file copied to simplify building the test */
+#ifndef PM_CONFIG_H__
+#define PM_CONFIG_H__
+#define PM_NRF_MODEM_LIB_TX_ADDRESS 0x20008000
+#endif /* PM_CONFIG_H__ */
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <nrf_modem_os.h>
+#include <nrf_errno.h>
+#include <modem/nrf_modem_lib.h>
+
+#include "cmock_nrf_modem.h"
+
+#define WAITERS_MAX 3
+#define WAITER_STACK_SIZE 1024
+#define WAITER_PRIORITY K_PRIO_PREEMPT(1)
+#define SETTLE_TIME K_MSEC(10)
+
+/* Contexts 1 and 9 are mapped to the same wait queue. */
+#define CONTEXT_A 1
+#define CONTEXT_B 2
+#define CONTEXT_A_COLLISION 9
+
+K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, WAITERS_MAX, WAITER_STACK_SIZE);
+
+static struct waiter {
+	struct k_thread thread;
+	uint32_t context;
+	atomic_t wakeups;
+} waiters[WAITERS_MAX];
+
+static size_t waiter_count;
+static atomic_t waiters_stop;
+
+static void waiter_fn(void *p1, void *p2, void *p3)
+{
+	struct waiter *waiter = p1;
+	int32_t timeout;
+	int err;
+
+	while (!atomic_get(&waiters_stop)) {
+		timeout = NRF_MODEM_OS_FOREVER;
+		err = nrf_modem_os_timedwait(waiter->context, &timeout);
+		if (err) {
+			break;
+		}
+
+		atomic_inc(&waiter->wakeups);
+	}
+}
+
+/* Start threads sleeping on the given contexts, and let them settle. */
+static void waiters_start(const uint32_t *contexts, size_t count)
+{
+	TEST_ASSERT_TRUE(count <= WAITERS_MAX);
+
+	for (size_t i = 0; i < count; i++) {
+		waiters[i].context = contexts[i];
+		k_thread_create(&waiters[i].thread, waiter_stacks[i],
+				K_THREAD_STACK_SIZEOF(waiter_stacks[i]), waiter_fn, &waiters[i],
+				NULL, NULL, WAITER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	waiter_count = count;
+
+	/* A thread returns once without sleeping when events arrived since it last slept. */
+	k_sleep(SETTLE_TIME);
+
+	for (size_t i = 0; i < count; i++) {
+		atomic_clear(&waiters[i].wakeups);
+	}
+
+	nrf_modem_lib_wakeup_stats_reset();
+}
+
+static void waiters_stop_all(void)
+{
+	atomic_set(&waiters_stop, 1);
+	nrf_modem_os_event_notify(0);
+
+	for (size_t i = 0; i < waiter_count; i++) {
+		TEST_ASSERT_EQUAL(0, k_thread_join(&waiters[i].thread, K_SECONDS(1)));
+	}
+
+	waiter_count = 0;
+}
+
+static void event_notify(uint32_t context)
+{
+	nrf_modem_os_event_notify(context);
+	k_sleep(SETTLE_TIME);
+}
+
+void setUp(void)
+{
+	memset(waiters, 0, sizeof(waiters));
+	atomic_clear(&waiters_stop);
+
+	__cmock_nrf_modem_is_initialized_IgnoreAndReturn(true);
+}
+
+void tearDown(void)
+{
+	waiters_stop_all();
+}
+
+void test_event_wakes_threads_on_context(void)
+{
+	const uint32_t contexts[] = { CONTEXT_A, CONTEXT_B, CONTEXT_A_COLLISION };
+	struct nrf_modem_lib_wakeup_stats stats;
+
+	waiters_start(contexts, ARRAY_SIZE(contexts));
+
+	event_notify(CONTEXT_A);
+
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[0].wakeups));
+	TEST_ASSERT_EQUAL(0, atomic_get(&waiters[1].wakeups));
+	TEST_ASSERT_EQUAL(0, atomic_get(&waiters[2].wakeups));
+
+	event_notify(CONTEXT_B);
+
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[0].wakeups));
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[1].wakeups));
+	TEST_ASSERT_EQUAL(0, atomic_get(&waiters[2].wakeups));
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_wakeup_stats_get(&stats));
+	TEST_ASSERT_EQUAL(2, stats.events);
+	TEST_ASSERT_EQUAL(2, stats.wakeups);
+	TEST_ASSERT_EQUAL(0, stats.spurious_wakeups);
+	TEST_ASSERT_EQUAL(1, stats.collisions);
+	TEST_ASSERT_EQUAL(3, stats.max_waiting);
+}
+
+void test_event_on_context_0_wakes_all_threads(void)
+{
+	const uint32_t contexts[] = { CONTEXT_A, CONTEXT_B, CONTEXT_A_COLLISION };
+	struct nrf_modem_lib_wakeup_stats stats;
+
+	waiters_start(contexts, ARRAY_SIZE(contexts));
+
+	event_notify(0);
+
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[0].wakeups));
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[1].wakeups));
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[2].wakeups));
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_wakeup_stats_get(&stats));
+	TEST_ASSERT_EQUAL(1, stats.events);
+	TEST_ASSERT_EQUAL(0, stats.wakeups);
+	TEST_ASSERT_EQUAL(3, stats.spurious_wakeups);
+	TEST_ASSERT_EQUAL(0, stats.collisions);
+}
+
+void test_event_wakes_threads_on_any_context(void)
+{
+	const uint32_t contexts[] = { 0, CONTEXT_B };
+	struct nrf_modem_lib_wakeup_stats stats;
+
+	waiters_start(contexts, ARRAY_SIZE(contexts));
+
+	event_notify(CONTEXT_A);
+
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[0].wakeups));
+	TEST_ASSERT_EQUAL(0, atomic_get(&waiters[1].wakeups));
+
+	event_notify(CONTEXT_B);
+
+	TEST_ASSERT_EQUAL(2, atomic_get(&waiters[0].wakeups));
+	TEST_ASSERT_EQUAL(1, atomic_get(&waiters[1].wakeups));
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_wakeup_stats_get(&stats));
+	TEST_ASSERT_EQUAL(2, stats.events);
+	TEST_ASSERT_EQUAL(1, stats.wakeups);
+	TEST_ASSERT_EQUAL(2, stats.spurious_wakeups);
+}
+
+void test_timedwait_timeout(void)
+{
+	struct nrf_modem_lib_wakeup_stats stats;
+	int32_t timeout = 10;
+	int err;
+
+	nrf_modem_lib_wakeup_stats_reset();
+
+	/* The first call may return without sleeping, if events arrived since the last one. */
+	do {
+		err = nrf_modem_os_timedwait(CONTEXT_A, &timeout);
+	} while (err == 0);
+
+	TEST_ASSERT_EQUAL(-NRF_EAGAIN, err);
+	TEST_ASSERT_EQUAL(0, timeout);
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_wakeup_stats_get(&stats));
+	TEST_ASSERT_EQUAL(1, stats.timeouts);
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <zephyr/random/random.h>
+#include <modem/nrf_modem_lib_trace.h>
+
+#include "trace_backend.h"
+
+extern struct nrf_modem_lib_trace_backend trace_backend;
+
+#define BUF_LENGTH CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_RAM_LENGTH
+#define TRACE_LENGTH (4 * BUF_LENGTH)
+
+static uint8_t trace[TRACE_LENGTH];
+static uint8_t out[TRACE_LENGTH];
+static size_t processed;
+
+static int callback(size_t len)
+{
+	processed += len;
+
+	return 0;
+}
+
+/* Trace-like data: records with a header, a sequence number and a mostly constant payload. */
+static void trace_generate(void)
+{
+	uint16_t seq = 0;
+	size_t i = 0;
+
+	while (i < sizeof(trace)) {
+		uint8_t len = 16 + seq % 32;
+
+		for (uint8_t k = 0; k < len && i < sizeof(trace); k++, i++) {
+			switch (k) {
+			case 0:
+				trace[i] = 0xa5;
+				break;
+			case 1:
+				trace[i] = len;
+				break;
+			case 2:
+				trace[i] = seq;
+				break;
+			case 3:
+				trace[i] = seq >> 8;
+				break;
+			default:
+				trace[i] = (k % 7 == 0) ? sys_rand32_get() : k;
+				break;
+			}
+		}
+
+		seq++;
+	}
+}
+
+/* Write in fragments of varying sizes, like the modem does. */
+static void trace_write(const uint8_t *data, size_t len)
+{
+	size_t offset = 0;
+	size_t frag = 1;
+	int ret;
+
+	while (offset < len) {
+		ret = trace_backend.write(data + offset, MIN(len - offset, frag));
+		TEST_ASSERT_GREATER_THAN(0, ret);
+		offset += ret;
+		frag = (frag * 7 + 13) % 1500 + 1;
+	}
+}
+
+static size_t trace_read_all(void)
+{
+	size_t len = 0;
+	int ret;
+
+	do {
+		ret = trace_backend.read(out + len, MIN(100, sizeof(out) - len));
+		TEST_ASSERT_GREATER_OR_EQUAL(0, ret);
+		len += ret;
+	} while (ret > 0);
+
+	return len;
+}
+
+void setUp(void)
+{
+	TEST_ASSERT_EQUAL(0, trace_backend.init(callback));
+	TEST_ASSERT_EQUAL(0, trace_backend.clear());
+	processed = 0;
+}
+
+void test_trace_backend_ram_compressed_read(void)
+{
+	struct nrf_modem_lib_trace_compress_stats before;
+	struct nrf_modem_lib_trace_compress_stats stats;
+	size_t len = BUF_LENGTH;
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_compress_stats_get(&before));
+
+	trace_write(trace, len);
+
+	TEST_ASSERT_EQUAL(len, processed);
+	TEST_ASSERT_EQUAL(len, trace_backend.data_size());
+
+	TEST_ASSERT_EQUAL(len, trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(trace, out, len);
+	TEST_ASSERT_EQUAL(0, trace_backend.data_size());
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_compress_stats_get(&stats));
+	TEST_ASSERT_EQUAL(len, stats.raw_bytes - before.raw_bytes);
+	TEST_ASSERT_LESS_THAN(len, stats.stored_bytes - before.stored_bytes);
+	TEST_ASSERT_EQUAL(before.dropped_bytes, stats.dropped_bytes);
+}
+
+void test_trace_backend_ram_compressed_keeps_newest(void)
+{
+	struct nrf_modem_lib_trace_compress_stats before;
+	struct nrf_modem_lib_trace_compress_stats stats;
+	size_t len;
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_compress_stats_get(&before));
+
+	trace_write(trace, sizeof(trace));
+
+	len = trace_backend.data_size();
+
+	/* Compression makes the buffer hold more than its size */
+	TEST_ASSERT_GREATER_THAN(BUF_LENGTH, len);
+	TEST_ASSERT_LESS_THAN(sizeof(trace), len);
+
+	TEST_ASSERT_EQUAL(len, trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(trace + sizeof(trace) - len, out, len);
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_compress_stats_get(&stats));
+	TEST_ASSERT_EQUAL(sizeof(trace) - len, stats.dropped_bytes - before.dropped_bytes);
+}
+
+void test_trace_backend_ram_compressed_incompressible(void)
+{
+	static uint8_t noise[BUF_LENGTH / 2];
+
+	sys_rand_get(noise, sizeof(noise));
+
+	trace_write(noise, sizeof(noise));
+
+	TEST_ASSERT_EQUAL(sizeof(noise), trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(noise, out, sizeof(noise));
+}
+
+void test_trace_backend_ram_compressed_freeze(void)
+{
+	struct nrf_modem_lib_trace_compress_stats before;
+	struct nrf_modem_lib_trace_compress_stats stats;
+	size_t len = 1000;
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_compress_stats_get(&before));
+
+	trace_write(trace, len);
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_freeze());
+
+	/* Trace data is still processed, but not stored */
+	trace_write(trace + len, len);
+	TEST_ASSERT_EQUAL(2 * len, processed);
+
+	TEST_ASSERT_EQUAL(len, trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(trace, out, len);
+
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_compress_stats_get(&stats));
+	TEST_ASSERT_EQUAL(len, stats.frozen_bytes - before.frozen_bytes);
+
+	/* Clearing resumes tracing */
+	TEST_ASSERT_EQUAL(0, trace_backend.clear());
+	trace_write(trace, len);
+	TEST_ASSERT_EQUAL(len, trace_read_all());
+}
+
+/* The backend is initialized again after a reboot, with the state kept in noinit RAM. */
+void test_trace_backend_ram_compressed_reboot_pending(void)
+{
+	size_t len = 300;
+
+	/* Less than a block, not compressed yet */
+	trace_write(trace, len);
+
+	TEST_ASSERT_EQUAL(0, trace_backend.init(callback));
+
+	TEST_ASSERT_EQUAL(len, trace_backend.data_size());
+	TEST_ASSERT_EQUAL(len, trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(trace, out, len);
+}
+
+void test_trace_backend_ram_compressed_reboot_partial_read(void)
+{
+	size_t len = 1000;
+	size_t read = 100;
+
+	trace_write(trace, len);
+
+	TEST_ASSERT_EQUAL(read, trace_backend.read(out, read));
+
+	TEST_ASSERT_EQUAL(0, trace_backend.init(callback));
+
+	/* The rest of the block being read is not lost */
+	TEST_ASSERT_EQUAL(len - read, trace_backend.data_size());
+	TEST_ASSERT_EQUAL(len - read, trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(trace + read, out, len - read);
+	TEST_ASSERT_EQUAL(0, trace_backend.data_size());
+}
+
+void test_trace_backend_ram_compressed_reboot_frozen(void)
+{
+	size_t len = 1000;
+
+	trace_write(trace, len);
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_freeze());
+
+	TEST_ASSERT_EQUAL(0, trace_backend.init(callback));
+
+	/* Tracing after the reboot does not overwrite the frozen trace */
+	trace_write(trace + len, len);
+
+	TEST_ASSERT_EQUAL(len, trace_read_all());
+	TEST_ASSERT_EQUAL_MEMORY(trace, out, len);
+}
+
+void test_trace_backend_ram_compressed_stats_einval(void)
+{
+	TEST_ASSERT_EQUAL(-EINVAL, nrf_modem_lib_trace_compress_stats_get(NULL));
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	trace_generate();
+
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/net/socket_offload.h>
+#include <sockets_internal.h>
+#include <zephyr/ztest.h>
+
+#include "mock_socket.h"
+
+#define CHUNKS_MAX CONFIG_MOCK_NET_SOCKET_CHUNKS_MAX
+
+void mock_socket_iface_init(struct net_if *iface);
+
+struct mock_socket_iface_data {
+	struct net_if *iface;
+} mock_socket_iface_data;
+
+struct offloaded_if_api mock_if_api = {
+	.iface_api.init = mock_socket_iface_init,
+};
+
+/* Data received from the peer. A chunk with no data marks the end of a connection,
+ * closed by the peer, or reset if err is set.
+ */
+static struct {
+	const char *data;
+	size_t len;
+	int err;
+} chunks[CHUNKS_MAX];
+static size_t chunk_head;
+static size_t chunk_tail;
+static size_t chunk_off;
+
+static char sent[2048];
+static size_t sent_len;
+static size_t connects;
+static int send_err;
+
+static void chunk_push(const char *data, size_t len, int err)
+{
+	__ASSERT_NO_MSG(chunk_tail < CHUNKS_MAX);
+
+	chunks[chunk_tail].data = data;
+	chunks[chunk_tail].len = len;
+	chunks[chunk_tail].err = err;
+	chunk_tail++;
+}
+
+void mock_socket_recv_push(const char *data, size_t len)
+{
+	chunk_push(data, len, 0);
+}
+
+void mock_socket_close_push(void)
+{
+	chunk_push(NULL, 0, 0);
+}
+
+void mock_socket_reset_push(void)
+{
+	chunk_push(NULL, 0, ECONNRESET);
+}
+
+void mock_socket_send_fail(int err)
+{
+	send_err = err;
+}
+
+const char *mock_socket_sent_get(void)
+{
+	return sent;
+}
+
+size_t mock_socket_connect_count(void)
+{
+	return connects;
+}
+
+void mock_socket_reset(void)
+{
+	chunk_head = 0;
+	chunk_tail = 0;
+	chunk_off = 0;
+	sent_len = 0;
+	sent[0] = '\0';
+	connects = 0;
+	send_err = 0;
+}
+
+/* All the functions contains a delay to avoid endless loops in application code
+ * and simulate a bit the socket api as it would block for a short moment anyway.
+ */
+
+static ssize_t mock_socket_offload_recvfrom(void *obj, void *buf, size_t len, int flags,
+					    struct sockaddr *from, socklen_t *fromlen)
+{
+	size_t n;
+
+	k_sleep(K_MSEC(10));
+
+	if (chunk_head == chunk_tail) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (!chunks[chunk_head].data) {
+		/* Closed by the peer, until the socket is closed */
+		if (chunks[chunk_head].err) {
+			errno = chunks[chunk_head].err;
+			return -1;
+		}
+		return 0;
+	}
+
+	n = MIN(len, chunks[chunk_head].len - chunk_off);
+	memcpy(buf, chunks[chunk_head].data + chunk_off, n);
+
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		chunk_off += n;
+		if (chunk_off == chunks[chunk_head].len) {
+			chunk_head++;
+			chunk_off = 0;
+		}
+	}
+
+	return n;
+}
+
+static ssize_t mock_socket_offload_read(void *obj, void *buffer, size_t count)
+{
+	return mock_socket_offload_recvfrom(obj, buffer, count, 0, NULL, 0);
+}
+
+static ssize_t mock_socket_offload_sendto(void *obj, const void *buf, size_t len, int flags,
+					  const struct sockaddr *to, socklen_t tolen)
+{
+	size_t n = MIN(len, sizeof(sent) - sent_len - 1);
+
+	if (send_err) {
+		/* Fails once, as the connection is then closed */
+		errno = send_err;
+		send_err = 0;
+		return -1;
+	}
+
+	memcpy(sent + sent_len, buf, n);
+	sent_len += n;
+	sent[sent_len] = '\0';
+
+	return len;
+}
+
+static ssize_t mock_socket_offload_write(void *obj, const void *buffer, size_t count)
+{
+	return mock_socket_offload_sendto(obj, buffer, count, 0, NULL, 0);
+}
+
+static int mock_socket_offload_close(void *obj)
+{
+	/* Drop what is left of the connection */
+	while (chunk_head != chunk_tail) {
+		if (!chunks[chunk_head++].data) {
+			break;
+		}
+	}
+	chunk_off = 0;
+
+	return zsock_close_ctx(obj);
+}
+
+static int mock_socket_offload_ioctl(void *obj, unsigned int request, va_list args)
+{
+	struct zsock_pollfd *fds;
+	int nfds;
+
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		return -EXDEV;
+
+	case ZFD_IOCTL_POLL_UPDATE:
+		return -EOPNOTSUPP;
+
+	case ZFD_IOCTL_POLL_OFFLOAD:
+		fds = va_arg(args, struct zsock_pollfd *);
+		nfds = va_arg(args, int);
+
+		/* Readable if there is data, EOF or an error to receive, otherwise
+		 * the poll times out at once.
+		 */
+		k_sleep(K_MSEC(10));
+		for (int i = 0; i < nfds; i++) {
+			fds[i].revents = (chunk_head != chunk_tail) ?
+					 (fds[i].events & ZSOCK_POLLIN) : 0;
+		}
+		return (chunk_head != chunk_tail) ? nfds : 0;
+
+	default:
+		return 0;
+	}
+}
+
+static int mock_socket_offload_connect(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	connects++;
+	return 0;
+}
+
+static int mock_socket_offload_setsockopt(void *obj, int level, int optname, const void *optval,
+					  socklen_t optlen)
+{
+	return 0;
+}
+
+static int mock_socket_offload_getsockopt(void *obj, int level, int optname, void *optval,
+					  socklen_t *optlen)
+{
+	return 0;
+}
+
+static const struct socket_op_vtable mock_socket_fd_op_vtable = {
+	.fd_vtable = {
+		.read = mock_socket_offload_read,
+		.write = mock_socket_offload_write,
+		.close = mock_socket_offload_close,
+		.ioctl = mock_socket_offload_ioctl,
+	},
+	.connect = mock_socket_offload_connect,
+	.sendto = mock_socket_offload_sendto,
+	.recvfrom = mock_socket_offload_recvfrom,
+	.getsockopt = mock_socket_offload_getsockopt,
+	.setsockopt = mock_socket_offload_setsockopt,
+};
+
+/**
+ * There is no support for dns lookup, node has to be a valid ip address
+ * that is parseable via net_ipaddr_parse
+ */
+static int mock_socket_offload_getaddrinfo(const char *node, const char *service,
+					   const struct zsock_addrinfo *hints,
+					   struct zsock_addrinfo **res)
+{
+	struct sockaddr_in *ai_addr;
+	struct zsock_addrinfo *ai;
+
+	if (!node || !res ||
+	    (hints && hints->ai_family != AF_INET && hints->ai_family != AF_UNSPEC)) {
+		return -1;
+	}
+
+	*res = calloc(1, sizeof(struct zsock_addrinfo));
+	ai = *res;
+	if (!ai) {
+		return -1;
+	}
+
+	ai_addr = calloc(1, sizeof(*ai_addr));
+	if (!ai_addr) {
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_family = AF_INET;
+	ai->ai_socktype = SOCK_STREAM;
+	ai->ai_protocol = IPPROTO_TCP;
+	ai->ai_addrlen = sizeof(*ai_addr);
+	ai->ai_addr = (struct sockaddr *)ai_addr;
+
+	if (net_ipaddr_parse(node, strlen(node), (struct sockaddr *)ai_addr)) {
+		return 0;
+	}
+
+	free(ai_addr);
+	free(*res);
+	return -1;
+}
+
+static void mock_socket_offload_freeaddrinfo(struct zsock_addrinfo *res)
+{
+	__ASSERT_NO_MSG(res);
+
+	free(res->ai_addr);
+	free(res);
+}
+
+bool mock_socket_is_supported(int family, int type, int proto)
+{
+	return true;
+}
+
+int mock_socket_create(int family, int type, int proto)
+{
+	int fd = z_reserve_fd();
+	struct net_context *ctx;
+	int res;
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	res = net_context_get(family, type, IPPROTO_TCP, &ctx);
+	if (res < 0) {
+		z_free_fd(fd);
+		errno = -res;
+		return -1;
+	}
+
+	ctx->user_data = NULL;
+	ctx->socket_data = NULL;
+	k_fifo_init(&ctx->recv_q);
+	k_condvar_init(&ctx->cond.recv);
+	net_context_ref(ctx);
+
+	z_finalize_fd(fd, ctx, (const struct fd_op_vtable *)&mock_socket_fd_op_vtable);
+
+	return fd;
+}
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg)
+{
+	return 0;
+}
+
+static const struct socket_dns_offload mock_socket_dns_offload_ops = {
+	.getaddrinfo = mock_socket_offload_getaddrinfo,
+	.freeaddrinfo = mock_socket_offload_freeaddrinfo,
+};
+
+void mock_socket_iface_init(struct net_if *iface)
+{
+	mock_socket_iface_data.iface = iface;
+
+	iface->if_dev->socket_offload = mock_socket_create;
+
+	socket_offload_dns_register(&mock_socket_dns_offload_ops);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MOCK_SOCKET_H_
+#define MOCK_SOCKET_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/offloaded_netdev.h>
+
+extern struct mock_socket_iface_data mock_socket_iface_data;
+extern struct offloaded_if_api mock_if_api;
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg);
+bool mock_socket_is_supported(int family, int type, int proto);
+int mock_socket_create(int family, int type, int proto);
+
+/* Queue data to be received on the connection, in order. The data must stay
+ * valid until it has been received.
+ */
+void mock_socket_recv_push(const char *data, size_t len);
+/* The peer closes the connection once the data queued before has been received.
+ * The data queued after is received on the next connection.
+ */
+void mock_socket_close_push(void);
+/* Like mock_socket_close_push(), but the connection is reset: receiving fails
+ * with ECONNRESET.
+ */
+void mock_socket_reset_push(void);
+/* The next send fails with the given error. */
+void mock_socket_send_fail(int err);
+/* Requests sent by the client since the last reset, as a string. */
+const char *mock_socket_sent_get(void);
+/* Number of connections made since the last reset. */
+size_t mock_socket_connect_count(void);
+void mock_socket_reset(void);
+
+#endif /* MOCK_SOCKET_H_ */
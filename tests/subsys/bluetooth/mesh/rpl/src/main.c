@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+#include <emds/emds.h>
+
+#define BENCH_ROUNDS 8
+
+static struct bt_mesh_net_rx rx_make(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = 1,
+	};
+
+	return rx;
+}
+
+static bool rpl_check(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = rx_make(src, seq, old_iv);
+
+	return bt_mesh_rpl_check(&rx, NULL);
+}
+
+static void setup(void *f)
+{
+	bt_mesh_rpl_clear();
+}
+
+ZTEST(rpl_test, test_replay_detection)
+{
+	zassert_false(rpl_check(0x0001, 10, false));
+	zassert_true(rpl_check(0x0001, 10, false), "Replay not detected");
+	zassert_true(rpl_check(0x0001, 9, false), "Old sequence accepted");
+	zassert_false(rpl_check(0x0001, 11, false));
+
+	/* Other sources are unaffected. */
+	zassert_false(rpl_check(0x0002, 1, false));
+	zassert_false(rpl_check(0x7fff, 1, false));
+	zassert_true(rpl_check(0x0002, 1, false));
+}
+
+ZTEST(rpl_test, test_local_messages_ignored)
+{
+	struct bt_mesh_net_rx rx = rx_make(0x0001, 1, false);
+
+	rx.net_if = BT_MESH_NET_IF_LOCAL;
+	zassert_false(bt_mesh_rpl_check(&rx, NULL));
+	zassert_false(bt_mesh_rpl_check(&rx, NULL));
+
+	rx.net_if = BT_MESH_NET_IF_ADV;
+	rx.local_match = 0;
+	zassert_false(bt_mesh_rpl_check(&rx, NULL));
+	zassert_false(bt_mesh_rpl_check(&rx, NULL));
+}
+
+ZTEST(rpl_test, test_deferred_update)
+{
+	struct bt_mesh_net_rx rx = rx_make(0x0010, 5, false);
+	struct bt_mesh_rpl *match = NULL;
+
+	/* The slot is returned but not updated until the caller does it. */
+	zassert_false(bt_mesh_rpl_check(&rx, &match));
+	zassert_not_null(match);
+	zassert_false(bt_mesh_rpl_check(&rx, &match));
+
+	bt_mesh_rpl_update(match, &rx);
+	zassert_true(bt_mesh_rpl_check(&rx, &match));
+	zassert_false(rpl_check(0x0011, 5, false));
+	zassert_true(rpl_check(0x0010, 5, false));
+}
+
+ZTEST(rpl_test, test_shared_pending_slot)
+{
+	struct bt_mesh_net_rx rx_a = rx_make(0x0020, 1, false);
+	struct bt_mesh_net_rx rx_b = rx_make(0x0021, 1, false);
+	struct bt_mesh_rpl *match_a = NULL;
+	struct bt_mesh_rpl *match_b = NULL;
+
+	/* Two segmented messages from new sources get the same empty slot. The
+	 * last update wins, and the list must stay consistent.
+	 */
+	zassert_false(bt_mesh_rpl_check(&rx_a, &match_a));
+	zassert_false(bt_mesh_rpl_check(&rx_b, &match_b));
+	zassert_equal_ptr(match_a, match_b);
+
+	bt_mesh_rpl_update(match_a, &rx_a);
+	bt_mesh_rpl_update(match_b, &rx_b);
+
+	zassert_true(rpl_check(0x0021, 1, false));
+	zassert_false(rpl_check(0x0020, 1, false));
+	zassert_true(rpl_check(0x0020, 1, false));
+}
+
+ZTEST(rpl_test, test_full)
+{
+	for (uint16_t i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		zassert_false(rpl_check(i + 1, 1, false));
+	}
+
+	zassert_true(rpl_check(CONFIG_BT_MESH_CRPL + 1, 1, false), "Accepted with full RPL");
+
+	for (uint16_t i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		zassert_true(rpl_check(i + 1, 1, false));
+		zassert_false(rpl_check(i + 1, 2, false));
+	}
+}
+
+ZTEST(rpl_test, test_iv_reset)
+{
+	/* Sources seen on the old IV index only are dropped on the next reset,
+	 * and the remaining ones are compacted.
+	 */
+	for (uint16_t i = 1; i <= 64; i++) {
+		zassert_false(rpl_check(i, 100, false));
+	}
+
+	bt_mesh_rpl_reset();
+
+	for (uint16_t i = 1; i <= 64; i += 2) {
+		zassert_true(rpl_check(i, 50, true));
+		zassert_false(rpl_check(i, 1, false), "New IV index not accepted");
+	}
+
+	bt_mesh_rpl_reset();
+
+	for (uint16_t i = 1; i <= 64; i++) {
+		if (i % 2) {
+			/* Refreshed on the new IV index, now old. */
+			zassert_true(rpl_check(i, 1, true));
+			zassert_false(rpl_check(i, 2, false));
+		} else {
+			/* Discarded, so any sequence number is accepted. */
+			zassert_false(rpl_check(i, 1, false));
+		}
+	}
+
+	/* The list can be filled up again after the reset. */
+	for (uint16_t i = 1000; i < 1000 + CONFIG_BT_MESH_CRPL - 64; i++) {
+		zassert_false(rpl_check(i, 1, false));
+	}
+
+	zassert_true(rpl_check(0x7000, 1, false));
+}
+
+/* Overwrite the replay list the way emds_load() does on a power-fail restore. */
+static void rpl_emds_restore(const struct bt_mesh_rpl *list, size_t count)
+{
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		if (entry->id != CONFIG_BT_MESH_RPL_INDEX) {
+			continue;
+		}
+
+		(void)memset(entry->data, 0, entry->len);
+		(void)memcpy(entry->data, list, count * sizeof(*list));
+		entry->state->load_count++;
+	}
+}
+
+ZTEST(rpl_test, test_emds_restore)
+{
+	static const struct bt_mesh_rpl stored[] = {
+		{ .src = 0x0030, .seq = 100 },
+		{ .src = 0x0031, .seq = 200 },
+	};
+
+	/* Use the list before the restore, so that any index is built. */
+	zassert_false(rpl_check(0x0010, 1, false));
+
+	rpl_emds_restore(stored, ARRAY_SIZE(stored));
+
+	zassert_true(rpl_check(0x0030, 50, false), "Replay accepted after restore");
+	zassert_true(rpl_check(0x0031, 200, false), "Replay accepted after restore");
+	zassert_false(rpl_check(0x0031, 201, false));
+	zassert_false(rpl_check(0x0010, 1, false), "Source from before the restore kept");
+	zassert_true(rpl_check(0x0010, 1, false));
+}
+
+ZTEST(rpl_test, test_rx_path_benchmark)
+{
+	static const uint16_t node_counts[] = { 8, 32, 128, 256, CONFIG_BT_MESH_CRPL };
+	uint32_t seq = 1;
+
+	TC_PRINT("RPL check cost, %s:\n",
+		 IS_ENABLED(CONFIG_BT_MESH_RPL_HASH_INDEX) ? "hash index" : "linear scan");
+
+	for (int n = 0; n < ARRAY_SIZE(node_counts); n++) {
+		uint16_t nodes = node_counts[n];
+		uint32_t start;
+		uint32_t cycles;
+
+		bt_mesh_rpl_clear();
+
+		for (uint16_t i = 0; i < nodes; i++) {
+			zassert_false(rpl_check(i + 1, seq, false));
+		}
+
+		seq++;
+		start = k_cycle_get_32();
+
+		for (int round = 0; round < BENCH_ROUNDS; round++, seq++) {
+			for (uint16_t i = 0; i < nodes; i++) {
+				(void)rpl_check(i + 1, seq, false);
+			}
+		}
+
+		cycles = k_cycle_get_32() - start;
+
+		TC_PRINT("  %4u nodes: %u cycles per check\n", nodes,
+			 cycles / (nodes * BENCH_ROUNDS));
+	}
+}
+
+ZTEST_SUITE(rpl_test, NULL, NULL, setup, NULL, NULL);
@@ -528,6 +528,28 @@ ZTEST(sensor_types_test_new, test_format_time_exp_8)
 	check_to_status(fmt, unknown_raw, BT_MESH_SENSOR_VALUE_UNKNOWN);
 }
 
+ZTEST(sensor_types_test_new, test_format_time_exp_8_all_values)
+{
+	const struct bt_mesh_sensor_format *fmt = &bt_mesh_sensor_format_time_exp_8;
+
+	/* Every normal value must decode to 1.1^(encoded - 64) and be encoded
+	 * back to itself, including values halfway to the neighbouring ones.
+	 */
+	for (uint32_t raw = 0x01; raw <= 0xfd; raw++) {
+		double exp_1_1 = pow(1.1, raw - 64.0);
+
+		check_to_float(fmt, raw, BT_MESH_SENSOR_VALUE_NUMBER, exp_1_1, false);
+		check_from_float(fmt, exp_1_1, 0, raw, true);
+		check_from_float(fmt, exp_1_1 * 1.04, 0, raw, true);
+		check_from_float(fmt, exp_1_1 / 1.04, 0, raw, true);
+	}
+
+	/* Values outside the range are clamped. */
+	check_from_float(fmt, pow(1.1, -64.0), -ERANGE, 0x01, true);
+	check_from_float(fmt, -1.0f, -ERANGE, 0x01, true);
+	check_from_float(fmt, pow(1.1, 190.0), -ERANGE, 0xfd, true);
+}
+
 TEST_SCALAR_FORMAT(electric_current,
 		   FORMAT_SPEC(2, 1, -2, 0, 0, 655.34,
 			       SPECIAL(unknown, 0xFFFF)))
@@ -975,4 +997,36 @@ TEST_SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range, 0x0061,
 
 TEST_SENSOR_TYPE(total_dev_runtime, 0x006e, CHANNEL(time_hour_24, 3))
 
+ZTEST(sensor_types_test_new, test_values_micro)
+{
+	const struct bt_mesh_sensor_format *fmt = &bt_mesh_sensor_format_electric_current;
+	const int64_t micro[] = { 0, 10000, 1230000, 655340000, 655350000, 42 };
+	struct bt_mesh_sensor_value vals[ARRAY_SIZE(micro)];
+	int64_t out[ARRAY_SIZE(micro)];
+
+	/* The out of range value is clamped without stopping the conversion. */
+	zassert_equal(bt_mesh_sensor_values_from_micro(fmt, micro, ARRAY_SIZE(micro), vals),
+		      -ERANGE);
+
+	for (int i = 0; i < ARRAY_SIZE(micro); i++) {
+		struct bt_mesh_sensor_value val;
+
+		(void)bt_mesh_sensor_value_from_micro(fmt, micro[i], &val);
+		zassert_equal(vals[i].format, fmt);
+		zassert_mem_equal(vals[i].raw, val.raw, fmt->size);
+	}
+
+	zassert_ok(bt_mesh_sensor_values_from_micro(fmt, micro, 3, vals));
+
+	/* Non-numeric values are counted out and leave the output unchanged. */
+	zassert_ok(bt_mesh_sensor_value_from_special_status(fmt, BT_MESH_SENSOR_VALUE_UNKNOWN,
+							    &vals[3]));
+	out[3] = -1;
+	zassert_equal(bt_mesh_sensor_values_to_micro(vals, 4, out), 3);
+	zassert_equal(out[0], 0);
+	zassert_equal(out[1], 10000);
+	zassert_equal(out[2], 1230000);
+	zassert_equal(out[3], -1);
+}
+
 ZTEST_SUITE(sensor_types_test_new, NULL, NULL, NULL, NULL, NULL);
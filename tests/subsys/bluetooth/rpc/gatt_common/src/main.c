@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include "bt_rpc_gatt_common.h"
+
+#define SVC_COUNT CONFIG_BT_RPC_GATT_SRV_MAX
+#define ATTR_COUNT 8
+#define BENCH_ROUNDS 16
+
+static struct bt_gatt_attr attrs[SVC_COUNT][ATTR_COUNT];
+static struct bt_gatt_service services[SVC_COUNT];
+static struct bt_gatt_attr unregistered_attr;
+
+/* Registration order, so that the order of the service pool differs from the
+ * order of the attribute addresses.
+ */
+static size_t svc_order(size_t i)
+{
+	return (i * 7 + 3) % SVC_COUNT;
+}
+
+static void services_add(size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		uint32_t index;
+
+		zassert_ok(bt_rpc_gatt_add_service(&services[svc_order(i)], &index));
+		zassert_equal(index, i);
+	}
+}
+
+static void *setup(void)
+{
+	for (size_t i = 0; i < SVC_COUNT; i++) {
+		services[i].attrs = attrs[i];
+		services[i].attr_count = ATTR_COUNT;
+	}
+
+	return NULL;
+}
+
+static void after(void *f)
+{
+	for (size_t i = 0; i < SVC_COUNT; i++) {
+		(void)bt_rpc_gatt_remove_service(&services[i]);
+	}
+}
+
+ZTEST(bt_rpc_gatt_common, test_attr_index_mapping)
+{
+	services_add(SVC_COUNT);
+
+	for (size_t i = 0; i < SVC_COUNT; i++) {
+		const struct bt_gatt_service *svc = &services[svc_order(i)];
+		uint16_t svc_index;
+
+		zassert_ok(bt_rpc_gatt_service_to_index(svc, &svc_index));
+		zassert_equal(svc_index, i);
+		zassert_equal_ptr(bt_rpc_gatt_get_service_by_index(i), svc);
+
+		for (size_t j = 0; j < ATTR_COUNT; j++) {
+			uint32_t index;
+
+			zassert_ok(bt_rpc_gatt_attr_to_index(&svc->attrs[j], &index));
+			zassert_equal(index, (i << 16) | j);
+			zassert_equal_ptr(bt_rpc_gatt_index_to_attr(index), &svc->attrs[j]);
+		}
+	}
+}
+
+ZTEST(bt_rpc_gatt_common, test_unknown_attr)
+{
+	struct bt_gatt_service unregistered_svc = {
+		.attrs = &unregistered_attr,
+		.attr_count = 1,
+	};
+	uint32_t index;
+	uint16_t svc_index;
+
+	zassert_equal(bt_rpc_gatt_attr_to_index(&attrs[0][0], &index), -EINVAL);
+
+	services_add(SVC_COUNT / 2);
+
+	zassert_equal(bt_rpc_gatt_attr_to_index(NULL, &index), -EINVAL);
+	zassert_equal(bt_rpc_gatt_attr_to_index(&unregistered_attr, &index), -EINVAL);
+	zassert_equal(bt_rpc_gatt_service_to_index(&unregistered_svc, &svc_index), -EFAULT);
+
+	for (size_t i = SVC_COUNT / 2; i < SVC_COUNT; i++) {
+		const struct bt_gatt_service *svc = &services[svc_order(i)];
+
+		zassert_equal(bt_rpc_gatt_attr_to_index(&svc->attrs[0], &index), -EINVAL);
+		zassert_equal(bt_rpc_gatt_service_to_index(svc, &svc_index), -EFAULT);
+	}
+}
+
+ZTEST(bt_rpc_gatt_common, test_remove_service)
+{
+	const struct bt_gatt_service *removed = &services[svc_order(2)];
+	uint32_t index;
+	uint16_t svc_index;
+
+	services_add(8);
+
+	zassert_ok(bt_rpc_gatt_remove_service(removed));
+	zassert_equal(bt_rpc_gatt_attr_to_index(&removed->attrs[1], &index), -EINVAL);
+	zassert_equal(bt_rpc_gatt_service_to_index(removed, &svc_index), -EFAULT);
+
+	/* Services registered after the removed one move down one index. */
+	for (size_t i = 0; i < 8; i++) {
+		const struct bt_gatt_service *svc = &services[svc_order(i)];
+		uint32_t expected = (i < 2) ? i : i - 1;
+
+		if (svc == removed) {
+			continue;
+		}
+
+		zassert_ok(bt_rpc_gatt_service_to_index(svc, &svc_index));
+		zassert_equal(svc_index, expected);
+		zassert_ok(bt_rpc_gatt_attr_to_index(&svc->attrs[ATTR_COUNT - 1], &index));
+		zassert_equal(index, (expected << 16) | (ATTR_COUNT - 1));
+	}
+}
+
+ZTEST(bt_rpc_gatt_common, test_attr_to_index_benchmark)
+{
+	static const size_t svc_counts[] = { 1, 4, 16, SVC_COUNT };
+
+	for (size_t n = 0; n < ARRAY_SIZE(svc_counts); n++) {
+		uint32_t start;
+		uint32_t cycles;
+		uint32_t index;
+
+		after(NULL);
+		services_add(svc_counts[n]);
+
+		start = k_cycle_get_32();
+
+		for (int round = 0; round < BENCH_ROUNDS; round++) {
+			for (size_t i = 0; i < svc_counts[n]; i++) {
+				(void)bt_rpc_gatt_attr_to_index(&services[svc_order(i)].attrs[1],
+								&index);
+			}
+		}
+
+		cycles = k_cycle_get_32() - start;
+
+		TC_PRINT("%2u services: %u cycles per attribute lookup\n",
+			 (unsigned int)svc_counts[n],
+			 (unsigned int)(cycles / (svc_counts[n] * BENCH_ROUNDS)));
+	}
+}
+
+static const struct bt_gatt_attr *notified_attrs[BT_RPC_GATT_NOTIFY_BATCH_COUNT_MAX];
+static size_t notified_count;
+static size_t notify_fail_at;
+
+static int notify_fake(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+		       const void *data, uint16_t len)
+{
+	zassert_equal(len, 1);
+	zassert_equal(*(const uint8_t *)data, notified_count);
+
+	if (notified_count == notify_fail_at) {
+		return -ENOMEM;
+	}
+
+	notified_attrs[notified_count++] = attr;
+
+	return 0;
+}
+
+ZTEST(bt_rpc_gatt_common, test_notify_batch_send)
+{
+	static const uint8_t values[] = { 0, 1, 2, 3 };
+	struct bt_rpc_gatt_notify_batch_entry entries[ARRAY_SIZE(values)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		entries[i].attr = &attrs[0][i];
+		entries[i].data = &values[i];
+		entries[i].len = 1;
+	}
+
+	notified_count = 0;
+	notify_fail_at = SIZE_MAX;
+	zassert_ok(bt_rpc_gatt_notify_batch_send(NULL, entries, ARRAY_SIZE(entries),
+						 notify_fake));
+	zassert_equal(notified_count, ARRAY_SIZE(entries));
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		zassert_equal_ptr(notified_attrs[i], entries[i].attr, "Wrong order");
+	}
+
+	/* Sending stops at the first failed notification. */
+	notified_count = 0;
+	notify_fail_at = 2;
+	zassert_equal(bt_rpc_gatt_notify_batch_send(NULL, entries, ARRAY_SIZE(entries),
+						    notify_fake), -ENOMEM);
+	zassert_equal(notified_count, 2);
+
+	/* A notification without an attribute is an error too. */
+	notified_count = 0;
+	notify_fail_at = SIZE_MAX;
+	entries[1].attr = NULL;
+	zassert_equal(bt_rpc_gatt_notify_batch_send(NULL, entries, ARRAY_SIZE(entries),
+						    notify_fake), -EINVAL);
+	zassert_equal(notified_count, 1);
+}
+
+ZTEST_SUITE(bt_rpc_gatt_common, NULL, setup, NULL, after, NULL);
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_RPC_CBOR_H_
+#define NRF_RPC_CBOR_H_
+
+/* The attribute index mapping does not use nRF RPC, only the declarations in
+ * bt_rpc_gatt_common.h refer to the CBOR context.
+ */
+struct nrf_rpc_cbor_ctx;
+
+#endif /* NRF_RPC_CBOR_H_ */
@@ -50,6 +50,16 @@ int dfu_target_mcuboot_write(const void *const buf, size_t len)
 	return write_retval;
 }
 
+int dfu_target_mcuboot_buf_get(void **buf, size_t *len)
+{
+	return -ENOTSUP;
+}
+
+int dfu_target_mcuboot_buf_commit(size_t len)
+{
+	return -ENOTSUP;
+}
+
 int dfu_target_mcuboot_done(bool successful)
 {
 	int ret = done_retval;
@@ -26,6 +26,11 @@ static uint8_t read_buf[BUF_LEN];
 static uint8_t write_buf[BUF_LEN] = {[0 ... BUF_LEN - 1] = 0xaa};
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+#include <zephyr/settings/settings.h>
+
+#define PROGRESS_KEY "dfu/" TEST_ID_1
+#define POWER_LOSS_ROUNDS 8
+
 static int page_size;
 #endif
 
@@ -94,6 +99,57 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream)
 	zassert_mem_equal(read_buf, write_buf, BUF_LEN, "Incorrect value");
 }
 
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_buf_get)
+{
+	int err;
+	uint8_t *buf;
+	size_t len;
+	size_t written = 0;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_buf_get(&buf, &len);
+	zassert_equal(err, -EACCES, "Unexpected result: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_buf_commit(sizeof(sbuf) + 1);
+	zassert_equal(err, -ENOMEM, "Unexpected result: %d", err);
+
+	/* Place the data directly in the lent buffer, in chunks that are not
+	 * aligned with the buffer size.
+	 */
+	while (written < BUF_LEN) {
+		err = dfu_target_stream_buf_get(&buf, &len);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		zassert_true(len > 0 && len <= sizeof(sbuf), "Invalid length %d", len);
+		zassert_true(buf >= sbuf && buf + len <= sbuf + sizeof(sbuf),
+			     "Buffer not within the stream buffer");
+
+		len = MIN(len, MIN(37, BUF_LEN - written));
+		for (size_t i = 0; i < len; i++) {
+			buf[i] = (uint8_t)(written + i);
+		}
+
+		err = dfu_target_stream_buf_commit(len);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		written += len;
+	}
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = flash_read(fdev, FLASH_BASE, read_buf, BUF_LEN);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	for (size_t i = 0; i < BUF_LEN; i++) {
+		zassert_equal(read_buf[i], (uint8_t)i, "Incorrect value at %d", i);
+	}
+}
+
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 {
@@ -246,6 +302,112 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 		      "Expected last erased page offset to be unchanged.");
 }
 
+static int checkpoint_read(const char *key, size_t len, settings_read_cb read_cb,
+			   void *cb_arg, void *param)
+{
+	ssize_t rc = read_cb(cb_arg, param, sizeof(size_t));
+
+	return (rc == sizeof(size_t)) ? 0 : -EINVAL;
+}
+
+static uint32_t rand_next(uint32_t *state)
+{
+	*state = *state * 1103515245 + 12345;
+
+	return *state >> 8;
+}
+
+static void pattern_write(size_t from, size_t to, uint8_t seed, uint32_t *rand)
+{
+	static uint8_t chunk[512];
+	size_t len;
+	int err;
+
+	while (from < to) {
+		len = MIN(1 + rand_next(rand) % sizeof(chunk), to - from);
+		for (size_t i = 0; i < len; i++) {
+			chunk[i] = (uint8_t)(from + i) ^ seed;
+		}
+
+		err = dfu_target_stream_write(chunk, len);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		from += len;
+	}
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_power_loss)
+{
+	int err;
+	uint32_t rand = 0xdf0;
+	size_t loss_offset;
+	size_t checkpoint;
+	size_t offset;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	for (int round = 0; round < POWER_LOSS_ROUNDS; round++) {
+		err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+					     FLASH_BASE, 0, NULL);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		err = dfu_target_stream_reset();
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+					     FLASH_BASE, 0, NULL);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+		loss_offset = rand_next(&rand) % BUF_LEN;
+		pattern_write(0, loss_offset, 0, &rand);
+
+		/* Let the checkpoint be stored in some rounds only */
+		if (round % 2) {
+			k_sleep(K_MSEC(10));
+		}
+
+		/* Power loss: only the stored checkpoint survives */
+		checkpoint = 0;
+		(void)settings_load_subtree_direct(PROGRESS_KEY, checkpoint_read, &checkpoint);
+
+		err = dfu_target_stream_offset_get(&offset);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		zassert_true(checkpoint <= offset, "Checkpoint %d past written data %d",
+			     checkpoint, offset);
+		zassert_equal(checkpoint % page_size, 0, "Checkpoint %d not page aligned",
+			      checkpoint);
+
+		err = dfu_target_stream_done(false);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		err = settings_save_one(PROGRESS_KEY, &checkpoint, sizeof(checkpoint));
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+		/* Resume with different data, so that any data not erased
+		 * before being written again is detected.
+		 */
+		err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+					     FLASH_BASE, 0, NULL);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+		err = dfu_target_stream_offset_get(&offset);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		zassert_equal(offset, checkpoint, "Not resumed from the checkpoint");
+
+		pattern_write(checkpoint, BUF_LEN, 0x5a, &rand);
+
+		err = dfu_target_stream_done(true);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+		err = flash_read(fdev, FLASH_BASE, read_buf, BUF_LEN);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		for (size_t i = 0; i < BUF_LEN; i++) {
+			uint8_t expected = (uint8_t)i ^ ((i < checkpoint) ? 0 : 0x5a);
+
+			zassert_equal(read_buf[i], expected, "Round %d: incorrect value at %d",
+				      round, i);
+		}
+	}
+}
+
 static size_t get_flash_page_size(const struct device *dev)
 {
 	struct flash_driver_api *api = (struct flash_driver_api *) dev->api;
@@ -274,6 +436,11 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 	ztest_test_skip();
 }
 
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_power_loss)
+{
+	ztest_test_skip();
+}
+
 #endif
 
 static void *setup(void)
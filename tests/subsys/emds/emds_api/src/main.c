@@ -52,7 +52,8 @@ static enum test_states state[] = {
 	EMDS_TS_CLEAR_FLASH,
 	EMDS_TS_EMPTY_FLASH,
 	EMDS_TS_NO_STORE,
-	EMDS_TS_EMPTY_FLASH,
+	/* The incremental store keeps the previously stored data if nothing is stored. */
+	IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE) ? EMDS_TS_STORE_DATA : EMDS_TS_EMPTY_FLASH,
 	EMDS_TS_CLEAR_FLASH,
 };
 
@@ -180,6 +181,18 @@ static void load_flash(void)
 			  "Data has changed");
 }
 
+/* After prepare, the incremental store keeps the entries valid in flash, while
+ * the full store invalidates them.
+ */
+static void load_prepared_flash(void)
+{
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE)) {
+		load_flash();
+	} else {
+		load_empty_flash();
+	}
+}
+
 static void prepare(void)
 {
 	zassert_equal(emds_store(), -ECANCELED, "Prepare must be done before store");
@@ -191,6 +204,28 @@ static void prepare(void)
 	zassert_true(emds_is_ready(), "EMDS should be ready");
 }
 
+static void store_unchanged(void)
+{
+	uint32_t expected_us = emds_store_time_get();
+
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE)) {
+		/* The data was just loaded, so only the entries are hashed. */
+		expected_us = emds_store_time_dirty_get();
+		zassert_true(expected_us > CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US,
+			     "Hashing time missing");
+		zassert_true(expected_us < emds_store_time_get(), "Unchanged entries counted");
+	}
+
+	zassert_equal(emds_store_time_dirty_get(), expected_us, "Wrong dirty store time");
+
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL_STORE)) {
+		s_data[0]++;
+		zassert_true(emds_store_time_dirty_get() > expected_us,
+			     "Changed entry not detected");
+		s_data[0]--;
+	}
+}
+
 static void store(void)
 {
 	zassert_true(emds_is_ready(), "Store should be ready to execute");
@@ -316,6 +351,7 @@ ZTEST(store_data, test_store_data)
 {
 	load_flash();
 	prepare();
+	store_unchanged();
 	store();
 	load_flash();
 }
@@ -333,18 +369,18 @@ ZTEST(no_store, test_no_store)
 {
 	load_flash();
 	prepare();
-	load_empty_flash();
+	load_prepared_flash();
 }
 
 ZTEST(several_store, test_several_store)
 {
 	load_flash();
 	prepare();
-	load_empty_flash();
+	load_prepared_flash();
 	store();
 	load_flash();
 	prepare();
-	load_empty_flash();
+	load_prepared_flash();
 	store();
 	load_flash();
 }
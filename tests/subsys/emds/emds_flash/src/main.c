@@ -467,6 +467,50 @@ ZTEST(emds_flash_tests, test_invalidate_on_prepare)
 	zassert_false(ctx.force_erase, "Force erase should be false");
 }
 
+ZTEST(emds_flash_tests, test_keep_entries_on_prepare)
+{
+	char data_in[9] = "Deadbeef";
+	char data_new[9] = "Cafebabe";
+	char data_out[9] = {0};
+	size_t entry_size = align_size(sizeof(data_in)) + align_size(sizeof(struct test_ate));
+
+	flash_clear();
+	device_reset();
+	ctx.keep_entries = true;
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_true(emds_flash_is_empty(&ctx), "Expected empty flash");
+	zassert_false(emds_flash_prepare(&ctx, 2 * entry_size), "Prepare failed");
+	zassert_equal(emds_flash_write(&ctx, 1, data_in, sizeof(data_in)), sizeof(data_in),
+		      "Write failed");
+	zassert_equal(emds_flash_write(&ctx, 2, data_in, sizeof(data_in)), sizeof(data_in),
+		      "Write failed");
+
+	device_reset();
+	ctx.keep_entries = true;
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(ctx.force_erase, "Force erase should be false");
+	zassert_false(emds_flash_prepare(&ctx, 2 * entry_size), "Prepare failed");
+	zassert_false(emds_flash_is_empty(&ctx), "Entries should be kept");
+
+	/* Only the changed entry is written, the other one stays valid */
+	zassert_equal(emds_flash_write(&ctx, 2, data_new, sizeof(data_new)), sizeof(data_new),
+		      "Write failed");
+
+	device_reset();
+	ctx.keep_entries = true;
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(ctx.force_erase, "Force erase should be false");
+	zassert_equal(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)), sizeof(data_in),
+		      "Could not read");
+	zassert_mem_equal(data_out, data_in, sizeof(data_in), "Not same data");
+	zassert_equal(emds_flash_read(&ctx, 2, data_out, sizeof(data_out)), sizeof(data_new),
+		      "Could not read");
+	zassert_mem_equal(data_out, data_new, sizeof(data_new), "Not same data");
+}
+
 ZTEST(emds_flash_tests, test_clear_on_strange_flash)
 {
 	flash_clear();
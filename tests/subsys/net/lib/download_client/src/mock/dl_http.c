@@ -14,6 +14,16 @@ int http_parse(struct download_client *client, size_t len)
 	return 0;
 }
 
+int http_parse_lent(struct download_client *client, size_t len)
+{
+	return 0;
+}
+
+bool http_buf_lend(struct download_client *client)
+{
+	return false;
+}
+
 int http_get_request_send(struct download_client *client)
 {
 	return 0;
@@ -10,6 +10,8 @@
 #include <zephyr/kernel.h>
 
 int http_parse(struct download_client *client, size_t len);
+int http_parse_lent(struct download_client *client, size_t len);
+bool http_buf_lend(struct download_client *client);
 int http_get_request_send(struct download_client *client);
 
 #endif /* _DL_HTTP_H_ */
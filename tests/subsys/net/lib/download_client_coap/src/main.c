@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/logging/log.h>
+
+#include <zephyr/ztest.h>
+#include <download_client.h>
+#include "download_client_internal.h"
+
+LOG_MODULE_REGISTER(download_client, LOG_LEVEL_DBG);
+
+#define FILE_SIZE_MAX 2048
+#define REQUESTS_MAX 48
+#define REQUEST_SIZE 64
+
+static struct download_client client;
+
+static uint8_t file[FILE_SIZE_MAX];
+static size_t file_size;
+static uint8_t received[FILE_SIZE_MAX];
+static size_t received_len;
+/* Offset in the file of the first byte received */
+static size_t received_from;
+
+/* Requests sent by the client */
+static struct {
+	uint8_t data[REQUEST_SIZE];
+	size_t len;
+} sent[REQUESTS_MAX];
+static size_t sent_count;
+/* Requests before this one were answered, or are not to be answered */
+static size_t answered;
+
+int socket_send_buf(const struct download_client *dl, const char *buf, size_t len, int timeout)
+{
+	zassert_true(sent_count < REQUESTS_MAX);
+	zassert_true(len <= REQUEST_SIZE);
+
+	memcpy(sent[sent_count].data, buf, len);
+	sent[sent_count].len = len;
+	sent_count++;
+
+	return 0;
+}
+
+/* Send the requests of the window, as the download thread does after a block
+ * was delivered or a retransmission was scheduled.
+ */
+static void requests_send(void)
+{
+	client.offset = 0;
+	zassert_ok(coap_request_send(&client));
+}
+
+static void request_parse(size_t n, struct coap_packet *request)
+{
+	zassert_true(n < sent_count);
+	zassert_ok(coap_packet_parse(request, sent[n].data, sent[n].len, NULL, 0));
+}
+
+/* Block2 option of request n: the block number and size */
+static void request_block(size_t n, uint32_t *num, enum coap_block_size *szx)
+{
+	struct coap_packet request;
+	int block2;
+
+	request_parse(n, &request);
+	block2 = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+	zassert_true(block2 >= 0);
+
+	*num = GET_BLOCK_NUM(block2);
+	*szx = GET_BLOCK_SIZE(block2);
+}
+
+static uint16_t request_id(size_t n)
+{
+	struct coap_packet request;
+
+	request_parse(n, &request);
+
+	return coap_header_get_id(&request);
+}
+
+/* Answer request n with a block of the given size, which may be smaller than
+ * requested, and pass the response to the client where the download thread
+ * receives it. Returns the result of coap_parse().
+ */
+static int respond_szx(size_t n, enum coap_block_size szx)
+{
+	struct coap_packet request;
+	struct coap_packet response;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
+	uint32_t num;
+	enum coap_block_size req_szx;
+	size_t start;
+	size_t len;
+	bool more;
+	int rc;
+
+	request_parse(n, &request);
+	tkl = coap_header_get_token(&request, token);
+	request_block(n, &num, &req_szx);
+
+	start = num * coap_block_size_to_bytes(req_szx);
+	zassert_true(start < file_size);
+	num = start / coap_block_size_to_bytes(szx);
+	len = MIN(coap_block_size_to_bytes(szx), file_size - start);
+	more = (start + len < file_size);
+
+	zassert_ok(coap_packet_init(&response, client.buf + client.offset,
+				    sizeof(client.buf) - client.offset, 1, COAP_TYPE_ACK, tkl,
+				    token, COAP_RESPONSE_CODE_CONTENT,
+				    coap_header_get_id(&request)));
+	zassert_ok(coap_append_option_int(&response, COAP_OPTION_BLOCK2,
+					  (num << 4) | (more << 3) | szx));
+	zassert_ok(coap_append_option_int(&response, COAP_OPTION_SIZE2, file_size));
+	zassert_ok(coap_packet_append_payload_marker(&response));
+	zassert_ok(coap_packet_append_payload(&response, file + start, len));
+
+	rc = coap_parse(&client, response.offset);
+	zassert_true(rc >= 0, "coap_parse() failed, %d", rc);
+
+	if (rc == 0) {
+		/* The blocks received in order are delivered */
+		zassert_true(received_len + client.offset <= sizeof(received));
+		memcpy(received + received_len, client.buf, client.offset);
+		received_len += client.offset;
+		if (client.progress < file_size) {
+			requests_send();
+		}
+	}
+
+	return rc;
+}
+
+static int respond(size_t n)
+{
+	uint32_t num;
+	enum coap_block_size szx;
+
+	request_block(n, &num, &szx);
+
+	return respond_szx(n, szx);
+}
+
+/* Answer the requests that were not answered yet in the order they were sent,
+ * including those sent in the meantime, until the download is complete.
+ */
+static void respond_in_order(void)
+{
+	while (client.progress < file_size) {
+		zassert_true(answered < sent_count, "No request for the rest of the file");
+		respond(answered++);
+	}
+
+	zassert_equal(client.progress, file_size);
+	zassert_equal(client.file_size, file_size);
+}
+
+static void received_check(void)
+{
+	zassert_equal(received_len, file_size - received_from);
+	zassert_mem_equal(received, file + received_from, received_len);
+}
+
+static void download_start(size_t size, size_t from)
+{
+	file_size = size;
+	received_from = from;
+	client.progress = from;
+	coap_block_init(&client, from);
+	requests_send();
+}
+
+static void block_check(size_t n, uint32_t num, enum coap_block_size szx)
+{
+	uint32_t req_num;
+	enum coap_block_size req_szx;
+
+	request_block(n, &req_num, &req_szx);
+	zassert_equal(req_num, num, "Request %zu is for block %u, not %u", n, req_num, num);
+	zassert_equal(req_szx, szx);
+}
+
+static void *suite_setup(void)
+{
+	for (size_t i = 0; i < sizeof(file); i++) {
+		file[i] = i % 251;
+	}
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	memset(&client, 0, sizeof(client));
+	client.file = "coap://192.0.2.1/file";
+	memset(received, 0, sizeof(received));
+	received_len = 0;
+	received_from = 0;
+	sent_count = 0;
+	answered = 0;
+}
+
+ZTEST_SUITE(download_client_coap, NULL, suite_setup, test_before, NULL, NULL);
+
+/* The first block is requested alone, until the file size is known, then a
+ * window of three blocks is kept in flight.
+ */
+ZTEST(download_client_coap, test_in_order)
+{
+	download_start(1024, 0);
+	zassert_equal(sent_count, 1);
+
+	zassert_ok(respond(answered++));
+	zassert_equal(client.coap.window, 3);
+	zassert_equal(sent_count, 4);
+	block_check(1, 1, COAP_BLOCK_256);
+	block_check(2, 2, COAP_BLOCK_256);
+	block_check(3, 3, COAP_BLOCK_256);
+
+	respond_in_order();
+	received_check();
+
+	/* Nothing is requested past the end of the file */
+	zassert_equal(sent_count, 4);
+}
+
+/* Blocks received ahead of the first one are kept in place until it arrives */
+ZTEST(download_client_coap, test_out_of_order)
+{
+	download_start(1024, 0);
+	zassert_ok(respond(0));
+	zassert_equal(received_len, 256);
+
+	zassert_equal(respond(3), 1);
+	zassert_equal(respond(2), 1);
+	zassert_equal(received_len, 256);
+
+	/* All three blocks are delivered at once */
+	zassert_ok(respond(1));
+	zassert_equal(client.progress, 1024);
+	zassert_equal(client.file_size, 1024);
+	received_check();
+}
+
+/* Duplicated responses are dropped, whether their block was delivered or is
+ * still waiting for the blocks before it.
+ */
+ZTEST(download_client_coap, test_late_duplicate)
+{
+	download_start(2048, 0);
+	zassert_ok(respond(0));
+
+	zassert_equal(respond(2), 1);
+	zassert_equal(respond(2), 1);
+	zassert_ok(respond(1));
+	zassert_equal(respond(1), 1);
+	zassert_equal(respond(0), 1);
+
+	/* Requests 1 and 2 were answered, the window has moved on to block 3 */
+	answered = 3;
+	respond_in_order();
+	received_check();
+}
+
+/* When the requests time out, all pending requests of the window are sent
+ * again with their message IDs, and the block size is halved for the next window.
+ */
+ZTEST(download_client_coap, test_retransmit_timeout)
+{
+	size_t window_sent;
+
+	download_start(2048, 0);
+	zassert_ok(respond(0));
+	zassert_equal(sent_count, 4);
+	window_sent = sent_count;
+
+	k_sleep(K_SECONDS(5));
+	zassert_equal(coap_get_recv_timeout(&client), 0);
+	zassert_ok(coap_initiate_retransmission(&client));
+	requests_send();
+
+	zassert_equal(sent_count, window_sent + 3);
+	for (size_t i = 0; i < 3; i++) {
+		zassert_equal(request_id(window_sent + i), request_id(1 + i));
+		block_check(window_sent + i, 1 + i, COAP_BLOCK_256);
+	}
+
+	/* The server answers the retransmissions */
+	answered = window_sent;
+	zassert_ok(respond(answered++));
+	zassert_ok(respond(answered++));
+	zassert_ok(respond(answered++));
+	zassert_equal(client.progress, 1024);
+
+	/* The next window uses the smaller block size */
+	zassert_equal(client.coap.block_ctx.block_size, COAP_BLOCK_128);
+	zassert_equal(client.coap.window, 4);
+	block_check(answered, 8, COAP_BLOCK_128);
+
+	respond_in_order();
+	received_check();
+}
+
+/* The server answers with smaller blocks in the middle of the transfer, and the
+ * requests in flight for larger blocks are dropped.
+ */
+ZTEST(download_client_coap, test_block_size_change)
+{
+	download_start(2048, 0);
+	zassert_ok(respond(0));
+	zassert_equal(sent_count, 4);
+
+	/* Request 1 is for bytes 256 to 511, the server only sends up to 383 */
+	zassert_ok(respond_szx(1, COAP_BLOCK_128));
+	zassert_equal(client.progress, 384);
+	zassert_equal(client.coap.block_ctx.block_size, COAP_BLOCK_128);
+
+	/* Late responses to the requests for larger blocks are dropped */
+	zassert_equal(respond(2), 1);
+	zassert_equal(respond(3), 1);
+
+	zassert_equal(client.coap.window, 4);
+	block_check(4, 3, COAP_BLOCK_128);
+
+	answered = 4;
+	respond_in_order();
+	received_check();
+}
+
+/* A download resumed in the middle of a block requests that block alone, and
+ * continues with the window from the next block.
+ */
+ZTEST(download_client_coap, test_resume_unaligned)
+{
+	download_start(1024, 300);
+	zassert_equal(sent_count, 1);
+	zassert_equal(client.coap.window, 1);
+	block_check(0, 1, COAP_BLOCK_256);
+
+	zassert_ok(respond(answered++));
+	zassert_equal(received_len, 512 - 300);
+	zassert_equal(client.progress, 512);
+
+	zassert_equal(client.coap.window, 3);
+	block_check(1, 2, COAP_BLOCK_256);
+
+	respond_in_order();
+	received_check();
+}
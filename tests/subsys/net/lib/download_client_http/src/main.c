@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket_offload.h>
+
+#include <zephyr/ztest.h>
+#include <download_client.h>
+
+#include "mock_socket.h"
+
+#define FILE_SIZE 96
+#define FRAG_SIZE 32
+#define RESPONSE_SIZE 160
+#define ERRORS_MAX 3
+
+K_MSGQ_DEFINE(event_msgq, sizeof(struct download_client_evt), 16, 4);
+
+static struct download_client client;
+static struct download_client_cfg config;
+
+static char file[FILE_SIZE];
+static char received[FILE_SIZE];
+static size_t received_len;
+static size_t fragments;
+static size_t fragments_lent;
+static size_t errors;
+
+/* Smaller than a fragment, so that a response fills it more than once */
+static uint8_t lend_buf[20];
+
+/* Responses queued on the mock socket, which must outlive the download */
+static char responses[8][RESPONSE_SIZE];
+static size_t responses_used;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	if (event == NULL) {
+		return -EINVAL;
+	}
+
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		zassert_true(received_len + event->fragment.len <= sizeof(received));
+		memcpy(received + received_len, event->fragment.buf, event->fragment.len);
+		received_len += event->fragment.len;
+		fragments++;
+		if (event->fragment.lent) {
+			zassert_equal_ptr(event->fragment.buf, lend_buf);
+			fragments_lent++;
+		}
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		/* Reconnect and resume, unless the download does not make progress */
+		if (++errors > ERRORS_MAX) {
+			return -1;
+		}
+		break;
+	default:
+		break;
+	}
+
+	k_msgq_put(&event_msgq, event, K_NO_WAIT);
+
+	return 0;
+}
+
+static struct download_client_evt wait_for_event(enum download_client_evt_id event,
+						 k_timeout_t timeout)
+{
+	struct download_client_evt evt;
+	int err;
+
+	while (true) {
+		err = k_msgq_get(&event_msgq, &evt, timeout);
+		zassert_ok(err);
+		if (evt.id == event) {
+			break;
+		}
+	}
+
+	return evt;
+}
+
+static int buf_lend(void **buf, size_t *len)
+{
+	*buf = lend_buf;
+	*len = sizeof(lend_buf);
+
+	return 0;
+}
+
+/* A 206 response with bytes first to last of the file, optionally cut after len bytes. */
+static const char *response(size_t first, size_t last, size_t *len)
+{
+	char *buf = responses[responses_used++];
+	int hdr_len;
+
+	zassert_true(responses_used <= ARRAY_SIZE(responses));
+
+	hdr_len = snprintf(buf, RESPONSE_SIZE,
+			   "HTTP/1.1 206 Partial Content\r\n"
+			   "Content-Range: bytes %zu-%zu/%u\r\n"
+			   "Content-Length: %zu\r\n"
+			   "\r\n",
+			   first, last, FILE_SIZE, last - first + 1);
+	zassert_true(hdr_len + last - first + 1 <= RESPONSE_SIZE);
+
+	memcpy(buf + hdr_len, file + first, last - first + 1);
+	*len = MIN(*len, hdr_len + last - first + 1);
+
+	return buf;
+}
+
+static void response_push(size_t first, size_t last)
+{
+	size_t len = SIZE_MAX;
+	const char *buf = response(first, last, &len);
+
+	mock_socket_recv_push(buf, len);
+}
+
+static void download(void)
+{
+	int err;
+
+	err = download_client_get(&client, "http://192.0.2.1/file", &config, NULL, 0);
+	zassert_ok(err);
+
+	wait_for_event(DOWNLOAD_CLIENT_EVT_DONE, K_SECONDS(5));
+	wait_for_event(DOWNLOAD_CLIENT_EVT_CLOSED, K_SECONDS(1));
+
+	zassert_equal(received_len, FILE_SIZE);
+	zassert_mem_equal(received, file, FILE_SIZE);
+}
+
+static void *suite_setup(void)
+{
+	int err;
+
+	for (size_t i = 0; i < sizeof(file); i++) {
+		file[i] = 'a' + i % 26;
+	}
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_ok(err);
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	mock_socket_reset();
+	k_msgq_purge(&event_msgq);
+	memset(&config, 0, sizeof(config));
+	memset(received, 0, sizeof(received));
+	received_len = 0;
+	fragments = 0;
+	fragments_lent = 0;
+	errors = 0;
+	responses_used = 0;
+}
+
+ZTEST_SUITE(download_client_http, NULL, suite_setup, test_before, NULL, NULL);
+
+ZTEST(download_client_http, test_pipeline)
+{
+	response_push(0, 31);
+	response_push(32, 63);
+	response_push(64, 95);
+
+	download();
+
+	zassert_equal(fragments, 3);
+	zassert_equal(errors, 0);
+	zassert_equal(mock_socket_connect_count(), 1);
+	zassert_not_null(strstr(mock_socket_sent_get(), "Range: bytes=64-95\r\n"));
+}
+
+/* Queue the whole file in responses to pipelined requests, received at once */
+static void responses_in_one_chunk_push(void)
+{
+	static char all[3 * RESPONSE_SIZE];
+	size_t all_len = 0;
+	size_t len;
+	const char *buf;
+
+	for (size_t first = 0; first < FILE_SIZE; first += FRAG_SIZE) {
+		len = SIZE_MAX;
+		buf = response(first, first + FRAG_SIZE - 1, &len);
+		memcpy(all + all_len, buf, len);
+		all_len += len;
+	}
+
+	mock_socket_recv_push(all, all_len);
+}
+
+/* The responses to several pipelined requests are received at once */
+ZTEST(download_client_http, test_pipeline_responses_in_one_recv)
+{
+	responses_in_one_chunk_push();
+
+	download();
+
+	zassert_equal(fragments, 3);
+	zassert_equal(errors, 0);
+	zassert_equal(mock_socket_connect_count(), 1);
+}
+
+/* The server sends a shorter range than requested while more requests are
+ * in flight, so the responses that follow are dropped with the connection and
+ * the rest is requested again.
+ */
+ZTEST(download_client_http, test_pipeline_short_range)
+{
+	static char both[2 * RESPONSE_SIZE];
+	size_t both_len;
+	size_t len = SIZE_MAX;
+	const char *buf;
+
+	response_push(0, 31);
+
+	buf = response(32, 47, &len);
+	memcpy(both, buf, len);
+	both_len = len;
+	len = SIZE_MAX;
+	buf = response(64, 95, &len);
+	memcpy(both + both_len, buf, len);
+	both_len += len;
+	mock_socket_recv_push(both, both_len);
+	mock_socket_close_push();
+
+	response_push(48, 79);
+	response_push(80, 95);
+
+	download();
+
+	zassert_equal(errors, 0);
+	zassert_equal(mock_socket_connect_count(), 2);
+	zassert_not_null(strstr(mock_socket_sent_get(), "Range: bytes=48-79\r\n"));
+}
+
+/* The connection is closed in the middle of a pipelined response */
+ZTEST(download_client_http, test_pipeline_connection_closed)
+{
+	size_t len = SIZE_MAX;
+	const char *buf;
+
+	response_push(0, 31);
+	buf = response(32, 63, &len);
+	/* Ten bytes of the payload are received before the connection is closed */
+	len = strstr(buf, "\r\n\r\n") + strlen("\r\n\r\n") - buf + 10;
+	mock_socket_recv_push(buf, len);
+	mock_socket_close_push();
+
+	/* The download resumes from the last byte received, mid fragment */
+	response_push(42, 73);
+	response_push(74, 95);
+
+	download();
+
+	zassert_equal(errors, 1);
+	zassert_equal(mock_socket_connect_count(), 2);
+	zassert_not_null(strstr(mock_socket_sent_get(), "Range: bytes=42-73\r\n"));
+}
+
+/* The payload is received into the buffer lent by the application, and only
+ * the response headers go through the buffer of the client.
+ */
+ZTEST(download_client_http, test_buf_lend)
+{
+	config.buf_lend = buf_lend;
+	responses_in_one_chunk_push();
+
+	download();
+
+	/* Each response fills the lent buffer once and then its rest */
+	zassert_equal(fragments, 6);
+	zassert_equal(fragments_lent, 6);
+	zassert_equal(errors, 0);
+}
+
+/* The connection is closed while the payload is received into the lent buffer */
+ZTEST(download_client_http, test_buf_lend_connection_closed)
+{
+	size_t len = SIZE_MAX;
+	const char *buf;
+
+	config.buf_lend = buf_lend;
+
+	response_push(0, 31);
+	buf = response(32, 63, &len);
+	len = strstr(buf, "\r\n\r\n") + strlen("\r\n\r\n") - buf + 10;
+	mock_socket_recv_push(buf, len);
+	mock_socket_close_push();
+
+	response_push(42, 73);
+	response_push(74, 95);
+
+	download();
+
+	zassert_equal(fragments, fragments_lent);
+	zassert_equal(errors, 1);
+	zassert_not_null(strstr(mock_socket_sent_get(), "Range: bytes=42-73\r\n"));
+}
+
+#define TEST_SOCKET_PRIO 40
+NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
+		    mock_socket_create);
+NET_DEVICE_OFFLOAD_INIT(mock_socket, "mock_socket", mock_nrf_modem_lib_socket_offload_init, NULL,
+			&mock_socket_iface_data, NULL, 0, &mock_if_api, 1280);
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <net/mqtt_helper.h>
+
+#include "zephyr/net/cmock_socket.h"
+#include "cmock_mqtt.h"
+
+#define TEST_MESSAGE_ID		100
+
+#define TEST_TOPIC		"test/topic_1"
+#define TEST_TOPIC_LEN		(sizeof(TEST_TOPIC) - 1)
+
+#define TEST_PAYLOAD		"This is a test payload"
+#define TEST_PAYLOAD_LEN	(sizeof(TEST_PAYLOAD) - 1)
+
+#define SENT_MAX		32
+
+/* Pull in variables and functions from the MQTT helper library. */
+extern struct mqtt_client mqtt_client;
+extern enum mqtt_state mqtt_state;
+extern k_tid_t mqtt_helper_thread;
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+extern void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
+			     const struct mqtt_evt *mqtt_evt);
+
+/* Messages seen by mqtt_publish(), in order */
+static struct {
+	uint16_t message_id;
+	uint8_t dup_flag;
+	char payload[TEST_PAYLOAD_LEN + 1];
+} sent[SENT_MAX];
+static int sent_count;
+static int puback_count;
+static int error_count;
+static enum mqtt_helper_error last_error;
+
+static int mqtt_publish_stub(struct mqtt_client *client, const struct mqtt_publish_param *param,
+			     int num_calls)
+{
+	TEST_ASSERT_TRUE(sent_count < SENT_MAX);
+	TEST_ASSERT_EQUAL(TEST_TOPIC_LEN, param->message.topic.topic.size);
+	TEST_ASSERT_EQUAL_MEMORY(TEST_TOPIC, param->message.topic.topic.utf8, TEST_TOPIC_LEN);
+	TEST_ASSERT_TRUE(param->message.payload.len <= TEST_PAYLOAD_LEN);
+
+	sent[sent_count].message_id = param->message_id;
+	sent[sent_count].dup_flag = param->dup_flag;
+	memcpy(sent[sent_count].payload, param->message.payload.data, param->message.payload.len);
+	sent[sent_count].payload[param->message.payload.len] = '\0';
+	sent_count++;
+
+	return 0;
+}
+
+static void cb_on_puback(uint16_t message_id, int result)
+{
+	puback_count++;
+}
+
+static void cb_on_error(enum mqtt_helper_error error)
+{
+	last_error = error;
+	error_count++;
+}
+
+void setUp(void)
+{
+	struct mqtt_helper_cfg cfg = {
+		.cb = {
+			.on_puback = cb_on_puback,
+			.on_error = cb_on_error,
+		},
+	};
+
+	__cmock_mqtt_keepalive_time_left_IgnoreAndReturn(0);
+	__cmock_mqtt_publish_Stub(mqtt_publish_stub);
+
+	/* Suspend the polling thread to have full control over polling. */
+	k_thread_suspend(mqtt_helper_thread);
+
+	mqtt_state = MQTT_STATE_UNINIT;
+
+	memset(sent, 0, sizeof(sent));
+	sent_count = 0;
+	puback_count = 0;
+	error_count = 0;
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+}
+
+void tearDown(void)
+{
+	mqtt_state = MQTT_STATE_DISCONNECTED;
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_deinit());
+}
+
+/* Helper functions */
+static int publish(uint16_t message_id, enum mqtt_qos qos, const char *payload)
+{
+	struct mqtt_publish_param param = {
+		.message = {
+			.payload = {
+				.data = (uint8_t *)payload,
+				.len = strlen(payload),
+			},
+			.topic = {
+				.topic = {
+					.utf8 = TEST_TOPIC,
+					.size = TEST_TOPIC_LEN,
+				},
+				.qos = qos,
+			},
+		},
+		.message_id = message_id,
+	};
+
+	return mqtt_helper_publish(&param);
+}
+
+static void send_mqtt_event(enum mqtt_evt_type type, int optional_data)
+{
+	struct mqtt_evt evt = {
+		.type = type,
+		.result = 0,
+	};
+
+	switch (type) {
+	case MQTT_EVT_CONNACK:
+		evt.param.connack.return_code = optional_data;
+		break;
+	case MQTT_EVT_DISCONNECT:
+		break;
+	case MQTT_EVT_PUBACK:
+		evt.param.puback.message_id = optional_data;
+		break;
+	default:
+		/* Unhandled event type, should not happen and considered bug
+		 * in the test.
+		 */
+		TEST_ASSERT_TRUE(false);
+	}
+
+	mqtt_evt_handler(&mqtt_client, &evt);
+}
+
+static struct mqtt_helper_queue_stats stats_get(void)
+{
+	struct mqtt_helper_queue_stats stats;
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_queue_stats_get(&stats));
+
+	return stats;
+}
+
+/* Tests */
+
+void test_publish_when_uninitialized(void)
+{
+	mqtt_state = MQTT_STATE_UNINIT;
+
+	TEST_ASSERT_EQUAL(-EOPNOTSUPP, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+	TEST_ASSERT_EQUAL(0, sent_count);
+}
+
+void test_publish_qos2_not_supported(void)
+{
+	mqtt_state = MQTT_STATE_CONNECTED;
+
+	TEST_ASSERT_EQUAL(-ENOTSUP, publish(TEST_MESSAGE_ID, MQTT_QOS_2_EXACTLY_ONCE, "a"));
+	TEST_ASSERT_EQUAL(0, sent_count);
+}
+
+void test_publish_when_connected(void)
+{
+	mqtt_state = MQTT_STATE_CONNECTED;
+
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_0_AT_MOST_ONCE, TEST_PAYLOAD));
+	TEST_ASSERT_EQUAL(1, sent_count);
+	TEST_ASSERT_EQUAL_STRING(TEST_PAYLOAD, sent[0].payload);
+
+	/* QoS 0 messages leave the queue once sent. */
+	TEST_ASSERT_EQUAL(1, stats_get().sent);
+	TEST_ASSERT_EQUAL(0, stats_get().depth);
+	TEST_ASSERT_EQUAL(0, stats_get().inflight);
+}
+
+void test_publish_when_disconnected_is_sent_on_connack(void)
+{
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID + 1, MQTT_QOS_0_AT_MOST_ONCE, "b"));
+	TEST_ASSERT_EQUAL(0, sent_count);
+	TEST_ASSERT_EQUAL(2, stats_get().depth);
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(2, sent_count);
+	TEST_ASSERT_EQUAL_STRING("a", sent[0].payload);
+	TEST_ASSERT_EQUAL_STRING("b", sent[1].payload);
+	TEST_ASSERT_EQUAL(1, stats_get().depth);
+	TEST_ASSERT_EQUAL(1, stats_get().inflight);
+}
+
+void test_publish_copies_message(void)
+{
+	char payload[] = "a";
+
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, payload));
+	payload[0] = 'x';
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(1, sent_count);
+	TEST_ASSERT_EQUAL_STRING("a", sent[0].payload);
+}
+
+void test_inflight_window(void)
+{
+	mqtt_state = MQTT_STATE_CONNECTED;
+
+	for (int i = 0; i < CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX + 1; i++) {
+		TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID + i, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+	}
+
+	/* QoS 0 messages keep their place behind the QoS 1 ones. */
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID + 100, MQTT_QOS_0_AT_MOST_ONCE, "b"));
+
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX, sent_count);
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX, stats_get().inflight);
+
+	/* Acknowledging one message opens the window for the next ones. */
+	send_mqtt_event(MQTT_EVT_PUBACK, TEST_MESSAGE_ID + 1);
+
+	TEST_ASSERT_EQUAL(1, puback_count);
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX + 2, sent_count);
+	TEST_ASSERT_EQUAL(TEST_MESSAGE_ID + CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX,
+			  sent[CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX].message_id);
+	TEST_ASSERT_EQUAL(TEST_MESSAGE_ID + 100,
+			  sent[CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX + 1].message_id);
+	TEST_ASSERT_EQUAL(1, stats_get().acked);
+	TEST_ASSERT_EQUAL(CONFIG_MQTT_HELPER_QOS1_INFLIGHT_MAX, stats_get().inflight);
+
+	/* Unknown message IDs are passed on but do not change the window. */
+	send_mqtt_event(MQTT_EVT_PUBACK, TEST_MESSAGE_ID + 1);
+
+	TEST_ASSERT_EQUAL(2, puback_count);
+	TEST_ASSERT_EQUAL(1, stats_get().acked);
+}
+
+void test_unacked_messages_resent_after_reconnect(void)
+{
+	mqtt_state = MQTT_STATE_CONNECTED;
+
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID + 1, MQTT_QOS_1_AT_LEAST_ONCE, "b"));
+	send_mqtt_event(MQTT_EVT_PUBACK, TEST_MESSAGE_ID);
+
+	send_mqtt_event(MQTT_EVT_DISCONNECT, 0);
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID + 2, MQTT_QOS_1_AT_LEAST_ONCE, "c"));
+	TEST_ASSERT_EQUAL(2, sent_count);
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(4, sent_count);
+	TEST_ASSERT_EQUAL(TEST_MESSAGE_ID + 1, sent[2].message_id);
+	TEST_ASSERT_EQUAL(1, sent[2].dup_flag);
+	TEST_ASSERT_EQUAL(TEST_MESSAGE_ID + 2, sent[3].message_id);
+	TEST_ASSERT_EQUAL(0, sent[3].dup_flag);
+	TEST_ASSERT_EQUAL(1, stats_get().resent);
+	TEST_ASSERT_EQUAL(2, stats_get().inflight);
+}
+
+static int mqtt_publish_encode_error_stub(struct mqtt_client *client,
+					  const struct mqtt_publish_param *param, int num_calls)
+{
+	/* The first message cannot be encoded, the client stays connected. */
+	if (num_calls == 0) {
+		return -ENOMEM;
+	}
+
+	return mqtt_publish_stub(client, param, num_calls);
+}
+
+void test_publish_error_while_connected_drops_message(void)
+{
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID + 1, MQTT_QOS_1_AT_LEAST_ONCE, "b"));
+
+	__cmock_mqtt_publish_Stub(mqtt_publish_encode_error_stub);
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(1, error_count);
+	TEST_ASSERT_EQUAL(MQTT_HELPER_ERROR_PUBLISH_DROPPED, last_error);
+	TEST_ASSERT_EQUAL(1, sent_count);
+	TEST_ASSERT_EQUAL(TEST_MESSAGE_ID + 1, sent[0].message_id);
+	TEST_ASSERT_EQUAL(1, stats_get().dropped);
+	TEST_ASSERT_EQUAL(1, stats_get().depth);
+	TEST_ASSERT_EQUAL(1, stats_get().inflight);
+}
+
+static int mqtt_publish_disconnect_stub(struct mqtt_client *client,
+					const struct mqtt_publish_param *param, int num_calls)
+{
+	/* A transport error disconnects the client before mqtt_publish() returns. */
+	send_mqtt_event(MQTT_EVT_DISCONNECT, 0);
+
+	return -EIO;
+}
+
+void test_publish_error_when_disconnected_keeps_message(void)
+{
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+
+	__cmock_mqtt_publish_Stub(mqtt_publish_disconnect_stub);
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(0, error_count);
+	TEST_ASSERT_EQUAL(0, stats_get().dropped);
+	TEST_ASSERT_EQUAL(1, stats_get().depth);
+
+	__cmock_mqtt_publish_Stub(mqtt_publish_stub);
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(1, sent_count);
+	TEST_ASSERT_EQUAL_STRING("a", sent[0].payload);
+}
+
+void test_connack_refused_keeps_queue(void)
+{
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_NOT_AUTHORIZED);
+
+	TEST_ASSERT_EQUAL(0, sent_count);
+	TEST_ASSERT_EQUAL(1, stats_get().depth);
+}
+
+void test_queue_full(void)
+{
+	int err = 0;
+	int i;
+
+	for (i = 0; i < 1000 && !err; i++) {
+		err = publish(TEST_MESSAGE_ID + i, MQTT_QOS_1_AT_LEAST_ONCE, TEST_PAYLOAD);
+	}
+
+	TEST_ASSERT_EQUAL(-ENOMEM, err);
+	TEST_ASSERT_EQUAL(1, stats_get().dropped);
+	TEST_ASSERT_EQUAL(i - 1, stats_get().queued);
+	TEST_ASSERT_EQUAL(i - 1, stats_get().depth_max);
+}
+
+void test_deinit_clears_queue(void)
+{
+	TEST_ASSERT_EQUAL(0, publish(TEST_MESSAGE_ID, MQTT_QOS_1_AT_LEAST_ONCE, "a"));
+	TEST_ASSERT_EQUAL(0, mqtt_helper_deinit());
+	TEST_ASSERT_EQUAL(0, stats_get().depth);
+	TEST_ASSERT_EQUAL(0, stats_get().queued);
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&(struct mqtt_helper_cfg){ 0 }));
+
+	mqtt_state = MQTT_STATE_CONNECTING;
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(0, sent_count);
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
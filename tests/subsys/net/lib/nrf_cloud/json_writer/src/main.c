@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <cJSON.h>
+
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_alert.h>
+
+#include "nrf_cloud_json_writer.h"
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_log_internal.h"
+
+#define BENCH_ROUNDS 32
+
+/* Allocation hooks that keep track of the peak heap usage */
+static size_t heap_used;
+static size_t heap_peak;
+
+static void *count_malloc(size_t size)
+{
+	size_t *p = malloc(sizeof(size_t) + size);
+
+	if (!p) {
+		return NULL;
+	}
+
+	*p = size;
+	heap_used += size;
+	heap_peak = MAX(heap_peak, heap_used);
+
+	return p + 1;
+}
+
+static void count_free(void *ptr)
+{
+	size_t *p = ptr;
+
+	if (!p) {
+		return;
+	}
+
+	heap_used -= p[-1];
+	free(p - 1);
+}
+
+static void heap_reset(void)
+{
+	heap_used = 0;
+	heap_peak = 0;
+}
+
+static const struct nrf_cloud_gnss_data pvt = {
+	.type = NRF_CLOUD_GNSS_TYPE_PVT,
+	.ts_ms = 1700000000123,
+	.pvt = {
+		.lat = 63.42123456789,
+		.lon = 10.437165,
+		.accuracy = 3.14f,
+		.alt = 121.5f,
+		.has_alt = 1,
+		.speed = 0.25f,
+		.has_speed = 1,
+		.heading = 271.9f,
+		.has_heading = 1,
+	},
+};
+
+static const struct nrf_cloud_gnss_data nmea = {
+	.type = NRF_CLOUD_GNSS_TYPE_NMEA,
+	.ts_ms = NRF_CLOUD_NO_TIMESTAMP,
+	.nmea.sentence = "$GPGGA,181908.00,3404.7041778,N,07044.3966270,W,4,13,1.00,"
+			 "495.144,M,29.200,M,0.10,0000*40",
+};
+
+static const char sensor_str[] = "Temperature \"ambient\"\t\\ 21.5\n";
+
+static const struct nrf_cloud_sensor_data sensor = {
+	.type = NRF_CLOUD_SENSOR_TEMP,
+	.data.ptr = sensor_str,
+	.data.len = sizeof(sensor_str) - 1,
+	.ts_ms = NRF_CLOUD_NO_TIMESTAMP,
+};
+
+static const struct nrf_cloud_alert_info alert = {
+	.type = ALERT_TYPE_DEVICE_NOW_ONLINE,
+	.value = 42.125f,
+	.description = "Door \x01 opened",
+	.sequence = 4096,
+	.ts_ms = NRF_CLOUD_NO_TIMESTAMP,
+};
+
+static struct nrf_cloud_log_context log_ctx = {
+	.dom_id = 1,
+	.src_name = "app",
+	.level = 3,
+	.ts = 1700000000456,
+	.sequence = 17,
+};
+
+static uint8_t log_str[] = "Connected to \"nRF Cloud\" after 3 tries";
+
+static int gnss_encode(const void *data, struct nrf_cloud_data *output)
+{
+	return nrf_cloud_gnss_msg_encode(data, output);
+}
+
+/* The cJSON encoder of the same message, printed like the codec used to */
+static char *gnss_cjson(const void *data)
+{
+	cJSON *root = cJSON_CreateObject();
+	char *out = NULL;
+
+	if (root && !nrf_cloud_gnss_msg_json_encode(data, root)) {
+		out = cJSON_PrintUnformatted(root);
+	}
+
+	cJSON_Delete(root);
+
+	return out;
+}
+
+static int sensor_encode(const void *data, struct nrf_cloud_data *output)
+{
+	return nrf_cloud_sensor_data_encode(data, output);
+}
+
+static int alert_encode(const void *data, struct nrf_cloud_data *output)
+{
+	return nrf_cloud_alert_encode(data, output);
+}
+
+static int log_encode(const void *data, struct nrf_cloud_data *output)
+{
+	ARG_UNUSED(data);
+
+	return nrf_cloud_log_json_encode(&log_ctx, log_str, sizeof(log_str) - 1, output);
+}
+
+/* Parse the output of the writer and print it again with cJSON. The writer must produce
+ * valid JSON formatted byte for byte like cJSON, so the round trip must not change it.
+ */
+static void cjson_round_trip_check(const char *name, const struct nrf_cloud_data *output)
+{
+	cJSON *root = cJSON_Parse(output->ptr);
+	char *printed;
+
+	zassert_not_null(root, "%s: invalid JSON: %s", name, (const char *)output->ptr);
+	printed = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+	zassert_not_null(printed);
+
+	zassert_equal(output->len, strlen(output->ptr));
+	zassert_str_equal(output->ptr, printed, "%s: %s != %s", name,
+			  (const char *)output->ptr, printed);
+	cJSON_free(printed);
+}
+
+static uint32_t encode_cycles(int (*encode)(const void *data, struct nrf_cloud_data *output),
+			      const void *data)
+{
+	struct nrf_cloud_data output;
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		if (!encode(data, &output)) {
+			cJSON_free((void *)output.ptr);
+		}
+	}
+
+	return (k_cycle_get_32() - start) / BENCH_ROUNDS;
+}
+
+/* Encode a message with the codec, check it and print the cost of the encoding. If the
+ * codec still has a cJSON encoder for the message, its output must be the same.
+ */
+static void check(const char *name,
+		  int (*encode)(const void *data, struct nrf_cloud_data *output),
+		  char *(*cjson_encode)(const void *data),
+		  const void *data)
+{
+	struct nrf_cloud_data output;
+	char *expected;
+	uint32_t start;
+	uint32_t cjson_cycles;
+	size_t cjson_peak;
+	size_t writer_peak;
+
+	heap_reset();
+	zassert_ok(encode(data, &output));
+	writer_peak = heap_peak;
+	cjson_round_trip_check(name, &output);
+
+	if (!cjson_encode) {
+		cJSON_free((void *)output.ptr);
+		TC_PRINT("%-7s writer: %6u cycles, %4u bytes peak heap\n",
+			 name, encode_cycles(encode, data), (unsigned int)writer_peak);
+		return;
+	}
+
+	heap_reset();
+	expected = cjson_encode(data);
+	cjson_peak = heap_peak;
+	zassert_not_null(expected);
+
+	zassert_str_equal(output.ptr, expected, "%s: %s != %s", name,
+			  (const char *)output.ptr, expected);
+	cJSON_free(expected);
+	cJSON_free((void *)output.ptr);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		cJSON_free(cjson_encode(data));
+	}
+	cjson_cycles = (k_cycle_get_32() - start) / BENCH_ROUNDS;
+
+	TC_PRINT("%-7s cJSON: %6u cycles, %4u bytes peak heap; "
+		 "writer: %6u cycles, %4u bytes peak heap\n",
+		 name, cjson_cycles, (unsigned int)cjson_peak,
+		 encode_cycles(encode, data), (unsigned int)writer_peak);
+}
+
+static void *setup(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = count_malloc,
+		.free_fn = count_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+
+	return NULL;
+}
+
+ZTEST(nrf_cloud_json_writer, test_pvt)
+{
+	check("pvt", gnss_encode, gnss_cjson, &pvt);
+}
+
+ZTEST(nrf_cloud_json_writer, test_nmea)
+{
+	check("nmea", gnss_encode, gnss_cjson, &nmea);
+}
+
+ZTEST(nrf_cloud_json_writer, test_sensor)
+{
+	check("sensor", sensor_encode, NULL, &sensor);
+}
+
+ZTEST(nrf_cloud_json_writer, test_alert)
+{
+	check("alert", alert_encode, NULL, &alert);
+}
+
+ZTEST(nrf_cloud_json_writer, test_log)
+{
+	check("log", log_encode, NULL, NULL);
+}
+
+ZTEST(nrf_cloud_json_writer, test_numbers)
+{
+	static const double values[] = {
+		0, -0.5, 1e-7, 123456789012.0, 2147483648.0, -2147483649.0, 0.1, 1.0 / 3,
+		(float)0.1, 6.02214076e23,
+	};
+	char buf[32];
+	struct nrf_cloud_json_writer w;
+
+	for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+		cJSON *num = cJSON_CreateNumber(values[i]);
+		char *expected = cJSON_PrintUnformatted(num);
+
+		nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+		nrf_cloud_json_num_add(&w, NULL, values[i]);
+		zassert_ok(nrf_cloud_json_writer_finish(&w));
+		zassert_str_equal(buf, expected);
+
+		cJSON_free(expected);
+		cJSON_Delete(num);
+	}
+}
+
+ZTEST(nrf_cloud_json_writer, test_too_small)
+{
+	char buf[8];
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_str_add(&w, "appId", "TEMP");
+	nrf_cloud_json_str_add(&w, "data", sensor_str);
+	nrf_cloud_json_obj_end(&w);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -ENOMEM);
+	zassert_mem_equal(buf, "{\"appId", sizeof(buf));
+	zassert_true(w.len > sizeof(buf));
+}
+
+ZTEST_SUITE(nrf_cloud_json_writer, NULL, setup, NULL, NULL, NULL);
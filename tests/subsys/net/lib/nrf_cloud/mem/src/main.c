@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <net/nrf_cloud_os.h>
+#include <cJSON.h>
+
+#include "nrf_cloud_mem.h"
+
+#define MINUTES_PER_DAY (24 * 60)
+#define BATCH_MAX 32
+
+/* Messages of an asset tracker, encoded the same way as by the nRF Cloud codec */
+enum msg_type {
+	MSG_GNSS,
+	MSG_CELL_POS,
+	MSG_TEMP,
+	MSG_BATTERY,
+	MSG_ALERT,
+	MSG_SHADOW,
+};
+
+/* One day of a tracker on a delivery route. It moves in the hours marked here and
+ * reports its position every five minutes while moving. One fix in eight fails,
+ * and the position is then requested from the cell information. Sensor data is
+ * sampled every half hour. The messages are batched and sent on the hour.
+ */
+static const bool moving[24] = {
+	[6] = true, [7] = true, [8] = true, [10] = true, [11] = true,
+	[13] = true, [14] = true, [16] = true, [17] = true,
+};
+
+/* Minutes of the day when the cloud sent a shadow delta and the device raised an alert */
+static const uint16_t shadow_at[] = { 2, 481, 1207 };
+static const uint16_t alert_at[] = { 397, 1033 };
+
+static const char *const shadow_delta =
+	"{\"state\":{\"config\":{\"activeMode\":true,\"locationTimeout\":300,"
+	"\"activeWaitTime\":120,\"movementResolution\":120,\"movementTimeout\":3600,"
+	"\"accelerometerActivityThreshold\":10,\"accelerometerInactivityThreshold\":5,"
+	"\"accelerometerInactivityTimeout\":80,\"nod\":[]}},\"timestamp\":1700000000}";
+
+/* nrf_cloud_mem.c calls this from nrf_cloud_os_mem_hooks_init(), which is not used here. */
+int nrf_cloud_codec_init(struct nrf_cloud_os_mem_hooks *hooks)
+{
+	return 0;
+}
+
+static bool in_list(const uint16_t *list, size_t len, uint16_t minute)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (list[i] == minute) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static char *encode(enum msg_type type, uint16_t minute)
+{
+	int64_t ts = 1700000000000LL + minute * 60000LL;
+	cJSON *root = cJSON_CreateObject();
+	cJSON *data;
+	char *out;
+
+	switch (type) {
+	case MSG_GNSS:
+		cJSON_AddStringToObject(root, "appId", "GNSS");
+		cJSON_AddStringToObject(root, "messageType", "DATA");
+		data = cJSON_AddObjectToObject(root, "data");
+		cJSON_AddNumberToObject(data, "lng", 10.437165 + minute * 1e-4);
+		cJSON_AddNumberToObject(data, "lat", 63.421234 - minute * 1e-4);
+		cJSON_AddNumberToObject(data, "acc", 4.2 + (minute % 7));
+		cJSON_AddNumberToObject(data, "alt", 121.5);
+		cJSON_AddNumberToObject(data, "spd", 11.3);
+		cJSON_AddNumberToObject(data, "hdg", minute % 360);
+		break;
+	case MSG_CELL_POS: {
+		cJSON *cell = cJSON_CreateObject();
+
+		cJSON_AddStringToObject(root, "appId", "CELL_POS");
+		cJSON_AddStringToObject(root, "messageType", "DATA");
+		data = cJSON_AddObjectToObject(root, "data");
+		cJSON_AddNumberToObject(cell, "mcc", 242);
+		cJSON_AddNumberToObject(cell, "mnc", 1);
+		cJSON_AddNumberToObject(cell, "eci", 21858829 + minute);
+		cJSON_AddNumberToObject(cell, "tac", 3002);
+		cJSON_AddNumberToObject(cell, "earfcn", 6300);
+		cJSON_AddNumberToObject(cell, "rsrp", -97);
+		cJSON_AddNumberToObject(cell, "rsrq", -9);
+		cJSON_AddItemToArray(cJSON_AddArrayToObject(data, "lte"), cell);
+		break;
+	}
+	case MSG_TEMP:
+		cJSON_AddStringToObject(root, "appId", "TEMP");
+		cJSON_AddStringToObject(root, "messageType", "DATA");
+		cJSON_AddNumberToObject(root, "data", 18.5 + (minute % 60) / 10.0);
+		break;
+	case MSG_BATTERY:
+		cJSON_AddStringToObject(root, "appId", "VOLTAGE");
+		cJSON_AddStringToObject(root, "messageType", "DATA");
+		cJSON_AddNumberToObject(root, "data", 4200 - minute / 2);
+		break;
+	case MSG_ALERT:
+		cJSON_AddStringToObject(root, "appId", "ALERT");
+		cJSON_AddNumberToObject(root, "type", 2);
+		cJSON_AddNumberToObject(root, "value", 42.125);
+		cJSON_AddStringToObject(root, "description", "Door opened");
+		break;
+	case MSG_SHADOW: {
+		/* Parse the delta and report the configuration back */
+		cJSON *delta = cJSON_Parse(shadow_delta);
+		cJSON *state;
+
+		zassert_not_null(delta);
+
+		state = cJSON_AddObjectToObject(root, "state");
+		data = cJSON_AddObjectToObject(state, "reported");
+		cJSON_AddItemToObject(data, "config",
+				      cJSON_DetachItemFromObject(
+					      cJSON_GetObjectItem(delta, "state"), "config"));
+		cJSON_Delete(delta);
+		break;
+	}
+	}
+
+	cJSON_AddNumberToObject(root, "ts", ts);
+
+	out = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	return out;
+}
+
+/* cJSON does not allocate from the pool. The library keeps the encoded messages in
+ * its own memory until the batch is sent.
+ */
+static void batch_add(char **batch, size_t *count, enum msg_type type, uint16_t minute)
+{
+	char *json = encode(type, minute);
+	size_t len;
+
+	zassert_true(*count < BATCH_MAX);
+	zassert_not_null(json);
+
+	len = strlen(json) + 1;
+	batch[*count] = nrf_cloud_malloc(len);
+	zassert_not_null(batch[*count], "Out of memory at minute %u", minute);
+
+	memcpy(batch[*count], json, len);
+	cJSON_free(json);
+	(*count)++;
+}
+
+static void batch_send(char **batch, size_t *count)
+{
+	for (size_t i = 0; i < *count; i++) {
+		nrf_cloud_free(batch[i]);
+	}
+
+	*count = 0;
+}
+
+ZTEST(nrf_cloud_mem, test_day_of_tracker_traffic)
+{
+	struct nrf_cloud_mem_site_stats site;
+	struct nrf_cloud_mem_stats stats;
+	char *batch[BATCH_MAX];
+	size_t count = 0;
+	uint32_t messages = 0;
+
+	for (uint16_t minute = 0; minute < MINUTES_PER_DAY; minute++) {
+		if (moving[minute / 60] && minute % 5 == 0) {
+			batch_add(batch, &count, (minute / 5) % 8 == 3 ? MSG_CELL_POS : MSG_GNSS,
+				  minute);
+		}
+
+		if (minute % 30 == 0) {
+			batch_add(batch, &count, MSG_TEMP, minute);
+			batch_add(batch, &count, MSG_BATTERY, minute);
+		}
+
+		if (in_list(alert_at, ARRAY_SIZE(alert_at), minute)) {
+			batch_add(batch, &count, MSG_ALERT, minute);
+		}
+
+		if (in_list(shadow_at, ARRAY_SIZE(shadow_at), minute)) {
+			batch_add(batch, &count, MSG_SHADOW, minute);
+		}
+
+		if (minute % 60 == 59) {
+			messages += count;
+			batch_send(batch, &count);
+		}
+	}
+
+	zassert_ok(nrf_cloud_mem_stats_get(&stats));
+
+	TC_PRINT("%u messages: %u allocations, peak %zu of %d bytes\n",
+		 messages, stats.allocs, stats.peak, CONFIG_NRF_CLOUD_MEM_POOL_SIZE);
+
+	for (size_t i = 0; nrf_cloud_mem_site_stats_get(i, &site) == 0; i++) {
+		TC_PRINT("  %s:%u: %6u allocations, peak %5zu bytes\n",
+			 site.file ? site.file : "other", site.line, site.allocs, site.peak);
+	}
+
+	zassert_equal(stats.failures, 0);
+	zassert_equal(stats.used, 0, "Leaked %zu bytes", stats.used);
+	zassert_true(stats.peak <= CONFIG_NRF_CLOUD_MEM_POOL_SIZE);
+}
+
+ZTEST(nrf_cloud_mem, test_pool_exhausted)
+{
+	struct nrf_cloud_mem_stats before;
+	struct nrf_cloud_mem_stats stats;
+	void *blocks[CONFIG_NRF_CLOUD_MEM_POOL_SIZE / 256];
+	size_t count = 0;
+
+	zassert_ok(nrf_cloud_mem_stats_get(&before));
+
+	while (count < ARRAY_SIZE(blocks)) {
+		blocks[count] = nrf_cloud_malloc(256);
+		if (!blocks[count]) {
+			break;
+		}
+
+		count++;
+	}
+
+	zassert_true(count < ARRAY_SIZE(blocks), "Pool larger than configured");
+
+	zassert_ok(nrf_cloud_mem_stats_get(&stats));
+	zassert_equal(stats.failures, before.failures + 1);
+	zassert_true(stats.largest_free < 2 * 256);
+
+	/* Free every other block: plenty of free memory, but only in small pieces */
+	for (size_t i = 0; i < count; i += 2) {
+		nrf_cloud_free(blocks[i]);
+	}
+
+	zassert_ok(nrf_cloud_mem_stats_get(&stats));
+	zassert_true(stats.free >= (count / 2) * 256);
+	zassert_true(stats.largest_free < 3 * 256);
+	zassert_is_null(nrf_cloud_malloc(3 * 256));
+
+	for (size_t i = 1; i < count; i += 2) {
+		nrf_cloud_free(blocks[i]);
+	}
+
+	zassert_ok(nrf_cloud_mem_stats_get(&stats));
+	zassert_equal(stats.used, 0);
+	zassert_true(stats.largest_free >= count * 256);
+}
+
+ZTEST(nrf_cloud_mem, test_calloc)
+{
+	uint8_t *ptr = nrf_cloud_calloc(16, 4);
+
+	zassert_not_null(ptr);
+
+	for (size_t i = 0; i < 64; i++) {
+		zassert_equal(ptr[i], 0);
+	}
+
+	nrf_cloud_free(ptr);
+
+	zassert_is_null(nrf_cloud_calloc(SIZE_MAX / 2, 4));
+}
+
+ZTEST(nrf_cloud_mem, test_free_cjson_memory)
+{
+	struct nrf_cloud_mem_stats before;
+	struct nrf_cloud_mem_stats stats;
+	char *str = cJSON_malloc(32);
+
+	zassert_not_null(str);
+	zassert_ok(nrf_cloud_mem_stats_get(&before));
+
+	/* The library frees some strings printed by cJSON with nrf_cloud_free() */
+	nrf_cloud_free(str);
+
+	zassert_ok(nrf_cloud_mem_stats_get(&stats));
+	zassert_equal(stats.used, before.used);
+	zassert_equal(stats.free, before.free);
+}
+
+ZTEST(nrf_cloud_mem, test_site_overflow)
+{
+	struct nrf_cloud_mem_site_stats site;
+	void *ptr[CONFIG_NRF_CLOUD_MEM_STATS_SITES + 1];
+	size_t other_used;
+
+	/* More call sites than the table holds, so that the table is full afterwards */
+	for (size_t i = 0; i < ARRAY_SIZE(ptr); i++) {
+		ptr[i] = nrf_cloud_mem_malloc_at(8, "overflow.c", i + 1);
+		zassert_not_null(ptr[i]);
+	}
+
+	zassert_ok(nrf_cloud_mem_site_stats_get(CONFIG_NRF_CLOUD_MEM_STATS_SITES, &site));
+	zassert_is_null(site.file);
+	zassert_true(site.allocs >= 1);
+	zassert_true(site.used >= 8);
+	other_used = site.used;
+
+	/* The call sites in the table keep their own statistics */
+	for (size_t i = 0; i < CONFIG_NRF_CLOUD_MEM_STATS_SITES; i++) {
+		zassert_ok(nrf_cloud_mem_site_stats_get(i, &site));
+		zassert_not_null(site.file);
+
+		if (strcmp(site.file, "overflow.c") == 0) {
+			zassert_equal(site.allocs, 1);
+			zassert_equal(site.used, 8);
+		}
+	}
+
+	zassert_equal(nrf_cloud_mem_site_stats_get(CONFIG_NRF_CLOUD_MEM_STATS_SITES + 1, &site),
+		      -ENOENT);
+
+	/* The last call site did not fit in the table */
+	nrf_cloud_free(ptr[ARRAY_SIZE(ptr) - 1]);
+
+	zassert_ok(nrf_cloud_mem_site_stats_get(CONFIG_NRF_CLOUD_MEM_STATS_SITES, &site));
+	zassert_equal(site.used, other_used - 8);
+
+	for (size_t i = 0; i < ARRAY_SIZE(ptr) - 1; i++) {
+		nrf_cloud_free(ptr[i]);
+	}
+}
+
+ZTEST_SUITE(nrf_cloud_mem, NULL, NULL, NULL, NULL, NULL);
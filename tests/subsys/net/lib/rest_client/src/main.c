@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket_offload.h>
+
+#include <zephyr/ztest.h>
+#include <net/rest_client.h>
+
+#include "mock_socket.h"
+
+#define RESP_BUF_SIZE 256
+
+static const char response_keep_alive[] =
+	"HTTP/1.1 200 OK\r\n"
+	"Content-Length: 5\r\n"
+	"\r\n"
+	"first";
+
+/* The last response of each test closes the connection, so that no idle
+ * connection is left for the next test.
+ */
+static const char response_close[] =
+	"HTTP/1.1 200 OK\r\n"
+	"Connection: close\r\n"
+	"Content-Length: 6\r\n"
+	"\r\n"
+	"second";
+
+static char resp_buf[RESP_BUF_SIZE];
+static struct rest_client_req_context req_ctx;
+static struct rest_client_resp_context resp_ctx;
+
+static int request(enum http_method method)
+{
+	rest_client_request_defaults_set(&req_ctx);
+	req_ctx.http_method = method;
+	req_ctx.host = "192.0.2.1";
+	req_ctx.port = 80;
+	req_ctx.url = "/resource";
+	req_ctx.resp_buff = resp_buf;
+	req_ctx.resp_buff_len = sizeof(resp_buf);
+	if (method == HTTP_POST) {
+		req_ctx.body = "{}";
+	}
+
+	return rest_client_request(&req_ctx, &resp_ctx);
+}
+
+/* Make a request that leaves its connection idle, to be reused by the next one. */
+static void idle_connection_open(void)
+{
+	int err;
+
+	mock_socket_recv_push(response_keep_alive, strlen(response_keep_alive));
+
+	err = request(HTTP_GET);
+	zassert_ok(err);
+	zassert_equal(resp_ctx.http_status_code, REST_CLIENT_HTTP_STATUS_OK);
+	zassert_equal(resp_ctx.response_len, strlen("first"));
+	zassert_mem_equal(resp_ctx.response, "first", strlen("first"));
+	zassert_equal(mock_socket_connect_count(), 1);
+}
+
+/* The request on the reused connection is answered, possibly after a retry. */
+static void response_check(size_t connects)
+{
+	zassert_equal(resp_ctx.http_status_code, REST_CLIENT_HTTP_STATUS_OK);
+	zassert_equal(resp_ctx.response_len, strlen("second"));
+	zassert_mem_equal(resp_ctx.response, "second", strlen("second"));
+	zassert_equal(mock_socket_connect_count(), connects);
+}
+
+static void test_before(void *fixture)
+{
+	mock_socket_reset();
+	memset(resp_buf, 0, sizeof(resp_buf));
+	memset(&req_ctx, 0, sizeof(req_ctx));
+	memset(&resp_ctx, 0, sizeof(resp_ctx));
+}
+
+ZTEST_SUITE(rest_client, NULL, NULL, test_before, NULL, NULL);
+
+/* The connection is kept open after a request and used for the next one */
+ZTEST(rest_client, test_keep_alive_reuse)
+{
+	int err;
+
+	idle_connection_open();
+	mock_socket_recv_push(response_close, strlen(response_close));
+
+	err = request(HTTP_GET);
+	zassert_ok(err);
+	response_check(1);
+}
+
+/* The server has closed the idle connection, and sending the request fails */
+ZTEST(rest_client, test_retry_send_failed)
+{
+	int err;
+
+	idle_connection_open();
+	mock_socket_close_push();
+	mock_socket_send_fail(EPIPE);
+	mock_socket_recv_push(response_close, strlen(response_close));
+
+	err = request(HTTP_GET);
+	zassert_ok(err);
+	response_check(2);
+}
+
+/* The server closes the idle connection when the request is sent */
+ZTEST(rest_client, test_retry_eof)
+{
+	int err;
+
+	idle_connection_open();
+	mock_socket_close_push();
+	mock_socket_recv_push(response_close, strlen(response_close));
+
+	err = request(HTTP_GET);
+	zassert_ok(err);
+	response_check(2);
+}
+
+/* The server resets the idle connection when the request is sent */
+ZTEST(rest_client, test_retry_reset)
+{
+	int err;
+
+	idle_connection_open();
+	mock_socket_reset_push();
+	mock_socket_recv_push(response_close, strlen(response_close));
+
+	err = request(HTTP_GET);
+	zassert_ok(err);
+	response_check(2);
+}
+
+/* A POST may have been executed by the server, so it is not sent again */
+ZTEST(rest_client, test_no_retry_post)
+{
+	int err;
+
+	idle_connection_open();
+	mock_socket_close_push();
+
+	err = request(HTTP_POST);
+	zassert_equal(err, -ECONNRESET);
+	zassert_equal(mock_socket_connect_count(), 1);
+
+	/* Sent once, on the reused connection */
+	zassert_not_null(strstr(mock_socket_sent_get(), "POST /resource"));
+	zassert_is_null(strstr(strstr(mock_socket_sent_get(), "POST /resource") + 1,
+			       "POST /resource"));
+}
+
+/* A request that times out on the reused connection is not sent again */
+ZTEST(rest_client, test_no_retry_timeout)
+{
+	int err;
+
+	idle_connection_open();
+
+	err = request(HTTP_GET);
+	zassert_equal(err, -ETIMEDOUT);
+	zassert_equal(mock_socket_connect_count(), 1);
+}
+
+/* A request on a new connection is not sent again */
+ZTEST(rest_client, test_no_retry_new_connection)
+{
+	int err;
+
+	mock_socket_close_push();
+	mock_socket_recv_push(response_close, strlen(response_close));
+
+	err = request(HTTP_GET);
+	zassert_ok(err);
+	zassert_equal(resp_ctx.http_status_code, 0);
+	zassert_equal(mock_socket_connect_count(), 1);
+}
+
+#define TEST_SOCKET_PRIO 40
+NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
+		    mock_socket_create);
+NET_DEVICE_OFFLOAD_INIT(mock_socket, "mock_socket", mock_nrf_modem_lib_socket_offload_init, NULL,
+			&mock_socket_iface_data, NULL, 0, &mock_if_api, 1280);